@@ -0,0 +1,247 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+#include "benchharness.h"
+
+// system includes <>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+using namespace eutelescope;
+using namespace eutelescope::bench;
+
+namespace {
+  typedef std::chrono::steady_clock Clock;
+
+  //! Written by escape(), volatile so the store is always done
+  void const *volatile escaped = nullptr;
+
+  //! Escape a string for JSON output
+  std::string jsonString(std::string const &s) {
+    std::string out = "\"";
+    for (char c : s) {
+      if (c == '"' || c == '\\') {
+        out += '\\';
+      }
+      out += c;
+    }
+    return out + "\"";
+  }
+
+  //! Value of "key": in a line written by writeJSON()
+  bool field(std::string const &line, std::string const &key,
+             std::string &value) {
+    std::string const tag = "\"" + key + "\": ";
+    size_t pos = line.find(tag);
+    if (pos == std::string::npos) {
+      return false;
+    }
+    pos += tag.size();
+    if (line[pos] == '"') {
+      size_t const end = line.find('"', pos + 1);
+      value = line.substr(pos + 1, end - pos - 1);
+    } else {
+      size_t const end = line.find_first_of(",}", pos);
+      value = line.substr(pos, end - pos);
+    }
+    return true;
+  }
+
+  double numberField(std::string const &line, std::string const &key) {
+    std::string value;
+    return field(line, key, value) ? std::strtod(value.c_str(), nullptr)
+                                   : 0.;
+  }
+}
+
+void bench::escape(void const *pointer) { escaped = pointer; }
+
+Harness::Harness()
+    : _benchmarks(), _minTime(0.5), _repetitions(5), _filter() {}
+
+void Harness::add(std::string const &name, Setup setup, Report report) {
+  _benchmarks.push_back(Benchmark{name, setup, report});
+}
+
+bool Harness::selected(std::string const &name) const {
+  return _filter.empty() || name.find(_filter) != std::string::npos;
+}
+
+void Harness::list(std::ostream &os) const {
+  for (auto const &benchmark : _benchmarks) {
+    if (selected(benchmark.name)) {
+      os << benchmark.name << std::endl;
+    }
+  }
+}
+
+std::vector<Result> Harness::run(std::ostream &os) const {
+  std::vector<Result> results;
+
+  os << std::left << std::setw(32) << "Benchmark" << std::right
+     << std::setw(14) << "Time [ns]" << std::setw(12) << "+- [%]"
+     << std::setw(12) << "Iterations" << std::setw(16) << "Items/s"
+     << std::endl;
+
+  for (auto const &benchmark : _benchmarks) {
+    if (!selected(benchmark.name)) {
+      continue;
+    }
+    Kernel kernel = benchmark.setup();
+
+    // warm up caches and lazily allocated buffers
+    doNotOptimize(kernel());
+
+    std::vector<double> times;
+    size_t iterations = 0;
+    size_t items = 0;
+    double totalTime = 0.;
+    for (unsigned rep = 0; rep < std::max(1u, _repetitions); ++rep) {
+      size_t calls = 0;
+      double elapsed = 0.;
+      Clock::time_point const start = Clock::now();
+      do {
+        items += kernel();
+        ++calls;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+      } while (elapsed < _minTime);
+      times.push_back(1e9 * elapsed / calls);
+      iterations = std::max(iterations, calls);
+      totalTime += elapsed;
+    }
+
+    Result result;
+    result.name = benchmark.name;
+    result.iterations = iterations;
+    std::vector<double> sorted(times);
+    std::sort(sorted.begin(), sorted.end());
+    result.realTime = sorted[sorted.size() / 2];
+    result.minTime = sorted.front();
+    double mean = 0., var = 0.;
+    for (double t : times) {
+      mean += t / times.size();
+    }
+    for (double t : times) {
+      var += (t - mean) * (t - mean) / times.size();
+    }
+    result.stddev = std::sqrt(var);
+    result.itemsPerSecond = totalTime > 0. ? items / totalTime : 0.;
+    if (benchmark.report) {
+      result.counters = benchmark.report();
+    }
+    results.push_back(result);
+
+    os << std::left << std::setw(32) << result.name << std::right
+       << std::setw(14) << std::setprecision(4) << result.realTime
+       << std::setw(12) << std::setprecision(2)
+       << 100. * result.stddev / result.realTime << std::setw(12)
+       << result.iterations << std::setw(16) << std::setprecision(4)
+       << result.itemsPerSecond << std::endl;
+    for (auto const &counter : result.counters) {
+      os << "    " << counter.first << " = " << counter.second << std::endl;
+    }
+  }
+  return results;
+}
+
+void bench::writeJSON(std::ostream &os, Context const &context,
+                      std::vector<Result> const &results) {
+  os << "{\n  \"context\": {";
+  char const *separator = "\n    ";
+  for (auto const &entry : context) {
+    os << separator << jsonString(entry.first) << ": "
+       << jsonString(entry.second);
+    separator = ",\n    ";
+  }
+  os << "\n  },\n  \"benchmarks\": [";
+  separator = "\n    ";
+  os << std::setprecision(8);
+  for (auto const &result : results) {
+    os << separator << "{\"name\": " << jsonString(result.name)
+       << ", \"iterations\": " << result.iterations
+       << ", \"real_time_ns\": " << result.realTime
+       << ", \"min_time_ns\": " << result.minTime
+       << ", \"stddev_ns\": " << result.stddev
+       << ", \"items_per_second\": " << result.itemsPerSecond;
+    if (!result.counters.empty()) {
+      os << ", \"counters\": {";
+      char const *counterSeparator = "";
+      for (auto const &counter : result.counters) {
+        os << counterSeparator << jsonString(counter.first) << ": "
+           << counter.second;
+        counterSeparator = ", ";
+      }
+      os << "}";
+    }
+    os << "}";
+    separator = ",\n    ";
+  }
+  os << "\n  ]\n}\n";
+}
+
+std::vector<Result> bench::readJSON(std::istream &is) {
+  std::vector<Result> results;
+  std::string line;
+  while (std::getline(is, line)) {
+    Result result;
+    if (!field(line, "name", result.name) ||
+        line.find("\"real_time_ns\"") == std::string::npos) {
+      continue;
+    }
+    result.iterations =
+        static_cast<size_t>(numberField(line, "iterations"));
+    result.realTime = numberField(line, "real_time_ns");
+    result.minTime = numberField(line, "min_time_ns");
+    result.stddev = numberField(line, "stddev_ns");
+    result.itemsPerSecond = numberField(line, "items_per_second");
+    results.push_back(result);
+  }
+  return results;
+}
+
+int bench::compare(std::vector<Result> const &baseline,
+                   std::vector<Result> const &results, double tolerance,
+                   std::ostream &os) {
+  std::map<std::string, Result const *> byName;
+  for (auto const &result : baseline) {
+    byName[result.name] = &result;
+  }
+
+  os << std::left << std::setw(32) << "Benchmark" << std::right
+     << std::setw(14) << "Baseline [ns]" << std::setw(14) << "Now [ns]"
+     << std::setw(10) << "Ratio" << std::endl;
+
+  int regressions = 0;
+  for (auto const &result : results) {
+    os << std::left << std::setw(32) << result.name << std::right;
+    auto it = byName.find(result.name);
+    if (it == byName.end() || it->second->realTime <= 0.) {
+      os << std::setw(14) << "-" << std::setw(14) << std::setprecision(4)
+         << result.realTime << std::setw(10) << "new" << std::endl;
+      continue;
+    }
+    double const ratio = result.realTime / it->second->realTime;
+    os << std::setw(14) << std::setprecision(4) << it->second->realTime
+       << std::setw(14) << result.realTime << std::setw(10)
+       << std::setprecision(3) << ratio;
+    if (ratio > 1. + tolerance) {
+      os << "  SLOWER";
+      ++regressions;
+    } else if (ratio < 1. - tolerance) {
+      os << "  faster";
+    }
+    os << std::endl;
+  }
+  return regressions;
+}
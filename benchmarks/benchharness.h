@@ -0,0 +1,139 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef BENCHHARNESS_H
+#define BENCHHARNESS_H
+
+// system includes <>
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace eutelescope {
+  namespace bench {
+
+    //! One call of a benchmark, returns the number of processed items
+    /*! The items are the inputs of the kernel (pixels, clusters, hits,
+     *  events, ...), so Items/s is the input rate. Everything the
+     *  kernel computes has to be passed to doNotOptimize(). */
+    typedef std::function<size_t()> Kernel;
+
+    //! Out of line sink for compilers without GNU inline assembly
+    void escape(void const *pointer);
+
+    //! Keeps the compiler from dropping the computation of value
+    /*! The value is treated as read by unknown code, so the loops
+     *  producing it can be neither folded nor removed. */
+    template <class T> inline void doNotOptimize(T const &value) {
+#if defined(__GNUC__)
+      asm volatile("" : : "r,m"(value) : "memory");
+#else
+      escape(&value);
+#endif
+    }
+
+    //! Prepares the input of a benchmark and returns its kernel
+    /*! Only called if the benchmark is selected, so expensive input
+     *  generation is not done for filtered out benchmarks. */
+    typedef std::function<Kernel()> Setup;
+
+    //! Key/value pairs describing the run (configuration, host, ...)
+    typedef std::vector<std::pair<std::string, std::string>> Context;
+
+    //! Named values a kernel measures besides its timing
+    typedef std::vector<std::pair<std::string, double>> Counters;
+
+    //! Returns the counters of the last kernel call
+    typedef std::function<Counters()> Report;
+
+    //! Timing of one benchmark
+    struct Result {
+      std::string name;
+      //! Kernel calls per repetition
+      size_t iterations;
+      //! Median over the repetitions of the wall time per call in ns
+      double realTime;
+      //! Fastest repetition in ns per call
+      double minTime;
+      //! Spread of the repetitions in ns per call
+      double stddev;
+      //! Processed items per second of wall time
+      double itemsPerSecond;
+      //! Counters reported after the last call, not read back by
+      //! readJSON()
+      Counters counters;
+    };
+
+    //! Minimal benchmark runner
+    /*! Each selected kernel is called once to warm up, then the given
+     *  number of repetitions is run. A repetition calls the kernel
+     *  until at least the minimum time has passed.
+     */
+    class Harness {
+    public:
+      Harness();
+
+      //! Register a benchmark
+      /*! @param report Optional, called after the timing to print and
+       *  record the counters of the benchmark
+       */
+      void add(std::string const &name, Setup setup,
+               Report report = Report());
+
+      //! Minimum time per repetition in seconds
+      void setMinTime(double seconds) { _minTime = seconds; }
+
+      //! Number of repetitions
+      void setRepetitions(unsigned repetitions) {
+        _repetitions = repetitions;
+      }
+
+      //! Only run the benchmarks whose name contains the filter
+      void setFilter(std::string const &filter) { _filter = filter; }
+
+      //! Print the names of the selected benchmarks
+      void list(std::ostream &os) const;
+
+      //! Run the selected benchmarks, printing a table to os
+      std::vector<Result> run(std::ostream &os) const;
+
+    private:
+      bool selected(std::string const &name) const;
+
+      struct Benchmark {
+        std::string name;
+        Setup setup;
+        Report report;
+      };
+
+      std::vector<Benchmark> _benchmarks;
+      double _minTime;
+      unsigned _repetitions;
+      std::string _filter;
+    };
+
+    //! Write the results as JSON, one benchmark per line
+    void writeJSON(std::ostream &os, Context const &context,
+                   std::vector<Result> const &results);
+
+    //! Read the results of a file written by writeJSON()
+    std::vector<Result> readJSON(std::istream &is);
+
+    //! Compare results to a baseline and print the ratios
+    /*! @param tolerance Allowed relative slow down, e.g. 0.1 for 10 %
+     *  @return The number of benchmarks slower than the tolerance
+     */
+    int compare(std::vector<Result> const &baseline,
+                std::vector<Result> const &results, double tolerance,
+                std::ostream &os);
+  }
+}
+#endif
@@ -0,0 +1,941 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+// Benchmark suite of the reconstruction kernels on synthetic events,
+// see INFO for the usage
+
+#include "benchharness.h"
+
+// eutelescope includes ""
+#include "EUTELESCOPE.h"
+#include "EUTelCommonMode.h"
+#include "EUTelDafTrackerSystem.h"
+#include "EUTelEventPipeline.h"
+#include "EUTelGenericSparseClusterImpl.h"
+#include "EUTelGenericSparsePixel.h"
+#include "EUTelGeometricPixel.h"
+#include "EUTelGeometryPlaneTable.h"
+#include "EUTelNeighbourClustering.h"
+#include "EUTelSelection.h"
+#include "EUTelSyntheticEventGenerator.h"
+#include "EUTelTripletGBLUtility.h"
+#include "anyoption.h"
+
+#ifdef USE_GBL
+#include "include/GblTrajectory.h"
+#endif
+
+// lcio includes <>
+#include <IMPL/TrackerDataImpl.h>
+
+// system includes <>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace std;
+using namespace eutelescope;
+using namespace eutelescope::bench;
+
+namespace {
+
+  typedef vector<vector<vector<EUTelGenericSparsePixel>>> PixelStore;
+  typedef vector<vector<EUTelTripletGBLUtility::hit>> HitStore;
+  typedef vector<reference_wrapper<EUTelBaseSparsePixel const>> PixelRefs;
+
+  //! Six Mimosa26 planes of an idealised telescope, 150 mm apart and
+  //! perpendicular to the beam along z
+  vector<geo::PlaneConstants> makePlanes() {
+    vector<geo::PlaneConstants> planes(6);
+    for (size_t i = 0; i < planes.size(); ++i) {
+      geo::PlaneConstants &pl = planes[i];
+      pl.sensorID = static_cast<int>(i);
+      pl.xPitch = pl.yPitch = 0.0184;
+      pl.xNpixels = 1152;
+      pl.yNpixels = 576;
+      pl.xSize = pl.xPitch * pl.xNpixels;
+      pl.ySize = pl.yPitch * pl.yNpixels;
+      pl.zSize = 0.05;
+      pl.xResolution = pl.yResolution = 0.0035;
+      pl.position = Eigen::Vector3d(0., 0., 150. * i);
+      pl.rotationAngles.setZero();
+      pl.rotation.setIdentity();
+      pl.local2Master.setIdentity();
+      pl.translation = pl.position;
+      pl.normal = Eigen::Vector3d::UnitZ();
+      pl.xAxis = Eigen::Vector3d::UnitX();
+      pl.yAxis = Eigen::Vector3d::UnitY();
+      pl.radLength = 93.65;
+      pl.thicknessX0 = pl.zSize / pl.radLength;
+    }
+    return planes;
+  }
+
+  //! Cluster size probabilities for a Poisson number of pixels next
+  //! to the seed, up to the 3x3 pixels the generator supports
+  vector<double> clusterSizeProbabilities(double meanClusterSize) {
+    double const mean = max(meanClusterSize - 1., 1e-9);
+    vector<double> probabilities(9);
+    double probability = exp(-mean);
+    for (size_t i = 0; i < probabilities.size(); ++i) {
+      probabilities[i] = probability;
+      probability *= mean / (i + 1);
+    }
+    return probabilities;
+  }
+
+  //! A hit as the hit maker makes it from a generated cluster, in the
+  //! global frame
+  struct SyntheticHit {
+    unsigned plane;
+    double x, y, z;
+    int clusterSize;
+  };
+
+  //! A generated event and the hits of its clusters
+  struct SyntheticEvent {
+    EUTelSyntheticEventGenerator::Event generated;
+    vector<SyntheticHit> hits;
+  };
+
+  //! Centre of gravity hits of the generated clusters
+  void makeClusterHits(SyntheticEvent &event, geo::PlaneTable const &planes) {
+    event.hits.clear();
+    for (size_t iPlane = 0; iPlane < event.generated.planes.size();
+         ++iPlane) {
+      auto const &plane = event.generated.planes[iPlane];
+      geo::PlaneConstants const &pl = planes[iPlane];
+      for (auto const &cluster : plane.clusters) {
+        double sumX = 0., sumY = 0.;
+        for (size_t i = cluster.begin; i < cluster.end; ++i) {
+          sumX += plane.pixels[i].getXCoord();
+          sumY += plane.pixels[i].getYCoord();
+        }
+        int const size = static_cast<int>(cluster.end - cluster.begin);
+        array<double, 3> const localPos{
+            {(sumX / size + 0.5) * pl.xPitch - pl.xSize / 2.,
+             (sumY / size + 0.5) * pl.yPitch - pl.ySize / 2., 0.}};
+        array<double, 3> globalPos;
+        geo::PlaneTable::local2Master(pl, localPos, globalPos);
+        event.hits.push_back(SyntheticHit{static_cast<unsigned>(iPlane),
+                                          globalPos[0], globalPos[1],
+                                          globalPos[2], size});
+      }
+    }
+  }
+
+  //! Input shared by all benchmarks, generated on first use
+  struct Inputs {
+    Inputs()
+        : planes(make_shared<geo::PlaneTable const>(makePlanes())),
+          nEvents(200), meanClusterSize(3.), config() {
+      config.tracksPerEvent = 2.;
+      config.noiseOccupancy = 1e-4;
+      // no material budget without GEAR file
+      config.multipleScattering = false;
+    }
+
+    shared_ptr<geo::PlaneTable const> planes;
+    size_t nEvents;
+    double meanClusterSize;
+    EUTelSyntheticEventGenerator::Config config;
+
+    vector<SyntheticEvent> const &events() {
+      if (_events.empty()) {
+        EUTelSyntheticEventGenerator::Config generatorConfig = config;
+        generatorConfig.clusterSizeProbabilities =
+            clusterSizeProbabilities(meanClusterSize);
+        EUTelSyntheticEventGenerator generator(planes, nullptr,
+                                               generatorConfig);
+        _events.resize(nEvents);
+        for (auto &event : _events) {
+          generator.generate(event.generated);
+          makeClusterHits(event, *planes);
+        }
+      }
+      return _events;
+    }
+
+  private:
+    vector<SyntheticEvent> _events;
+  };
+
+  //! The fired pixels of each event and plane
+  PixelStore makePixels(vector<SyntheticEvent> const &events) {
+    PixelStore store(events.size());
+    for (size_t iEvent = 0; iEvent < events.size(); ++iEvent) {
+      for (auto const &plane : events[iEvent].generated.planes) {
+        store[iEvent].push_back(plane.pixels);
+      }
+    }
+    return store;
+  }
+
+  //! The hits of each event as used by the triplet finder
+  HitStore makeHits(vector<SyntheticEvent> const &events,
+                    geo::PlaneTable const &planes) {
+    HitStore store(events.size());
+    for (size_t iEvent = 0; iEvent < events.size(); ++iEvent) {
+      int id = 0;
+      for (auto const &synthetic : events[iEvent].hits) {
+        EUTelTripletGBLUtility::hit hit;
+        hit.x = hit.locx = synthetic.x;
+        hit.y = hit.locy = synthetic.y;
+        hit.z = synthetic.z;
+        hit.ex = planes[synthetic.plane].xResolution;
+        hit.ey = planes[synthetic.plane].yResolution;
+        hit.ez = 0.;
+        hit.plane = synthetic.plane;
+        hit.clustersize = hit.clustersizex = hit.clustersizey =
+            synthetic.clusterSize;
+        hit.id = id++;
+        store[iEvent].push_back(hit);
+      }
+    }
+    return store;
+  }
+
+  //! Telescope triplets and driplets of each event
+  struct Triplets {
+    vector<vector<EUTelTripletGBLUtility::triplet>> upstream, downstream;
+  };
+
+  double const tripletResCut = 0.1;
+  double const tripletSlopeCut = 0.002;
+  double const trackMatchCut = 0.15;
+
+  double matchZ(geo::PlaneTable const &planes) {
+    return 0.5 *
+           (planes[planes.size() - 3].position.z() + planes[2].position.z());
+  }
+
+  Triplets findTriplets(EUTelTripletGBLUtility &util, HitStore const &hits) {
+    Triplets triplets;
+    for (auto const &eventHits : hits) {
+      triplets.upstream.emplace_back();
+      triplets.downstream.emplace_back();
+      util.FindTriplets(eventHits, 0, 1, 2, tripletResCut, tripletSlopeCut,
+                        triplets.upstream.back());
+      util.FindTriplets(eventHits, 3, 4, 5, tripletResCut, tripletSlopeCut,
+                        triplets.downstream.back());
+    }
+    return triplets;
+  }
+
+  //! Tracker system configured as by EUTelDafFitter with the
+  //! fitter steering of the examples, lengths in um
+  shared_ptr<daffitter::TrackerSystem<float, 4>>
+  makeTrackerSystem(geo::PlaneTable const &planes, double eBeam) {
+    auto system = make_shared<daffitter::TrackerSystem<float, 4>>();
+    float const radLength = 0.05 / 93.65;
+    float const scatterTheta = 0.0136f / eBeam * sqrt(radLength) *
+                               (1.0f + 0.038f * std::log(radLength));
+    for (size_t i = 0; i < planes.size(); ++i) {
+      system->addPlane(static_cast<int>(i), planes[i].position.z() * 1000.f,
+                       planes[i].xResolution * 1000.f,
+                       planes[i].yResolution * 1000.f,
+                       scatterTheta * scatterTheta, false);
+    }
+    system->setCKFChi2Cut(500.f * 500.f);
+    system->setNominalXdz(0.f);
+    system->setNominalYdz(0.f);
+    system->setXdzMaxDeviance(0.01f);
+    system->setYdzMaxDeviance(0.01f);
+    system->setChi2OverNdofCut(50.f);
+    system->setDAFChi2Cut(1000.f);
+    system->init(true);
+    return system;
+  }
+
+  void loadEvent(daffitter::TrackerSystem<float, 4> &system,
+                 SyntheticEvent const &event) {
+    system.clear();
+    size_t iHit = 0;
+    for (auto const &hit : event.hits) {
+      system.addMeasurement(hit.plane, hit.x * 1000.f, hit.y * 1000.f,
+                            hit.z * 1000.f, true, iHit++);
+    }
+  }
+
+  void addClusteringBenchmarks(Harness &harness, shared_ptr<Inputs> inputs) {
+    harness.add("clustering/sparse", [inputs]() -> Kernel {
+      auto pixels = make_shared<PixelStore>(makePixels(inputs->events()));
+      return [pixels]() {
+        size_t nPixels = 0, nClusters = 0;
+        for (auto const &event : *pixels) {
+          for (auto const &plane : event) {
+            PixelRefs refs(plane.begin(), plane.end());
+            nClusters += Utility::findNeighbourClusters(
+                             refs, Utility::SparsePixelNeighbours{2})
+                             .size();
+            nPixels += plane.size();
+          }
+        }
+        doNotOptimize(nClusters);
+        return nPixels;
+      };
+    });
+
+    harness.add("clustering/geometric", [inputs]() -> Kernel {
+      geo::PlaneTable const &planes = *inputs->planes;
+      auto pixels = make_shared<vector<vector<EUTelGeometricPixel>>>();
+      for (auto const &event : makePixels(inputs->events())) {
+        for (size_t iPlane = 0; iPlane < event.size(); ++iPlane) {
+          geo::PlaneConstants const &pl = planes[iPlane];
+          pixels->emplace_back();
+          for (auto const &pixel : event[iPlane]) {
+            EUTelGeometricPixel geoPixel(pixel);
+            geoPixel.setBoundaryX(pl.xPitch / 2.);
+            geoPixel.setBoundaryY(pl.yPitch / 2.);
+            geoPixel.setPosX((pixel.getXCoord() + 0.5) * pl.xPitch -
+                             pl.xSize / 2.);
+            geoPixel.setPosY((pixel.getYCoord() + 0.5) * pl.yPitch -
+                             pl.ySize / 2.);
+            pixels->back().push_back(geoPixel);
+          }
+        }
+      }
+      return [pixels]() {
+        size_t nPixels = 0, nClusters = 0;
+        for (auto const &plane : *pixels) {
+          nClusters += Utility::findNeighbourClusters(
+                           plane, Utility::GeometricPixelNeighbours{1.f})
+                           .size();
+          nPixels += plane.size();
+        }
+        doNotOptimize(nClusters);
+        return nPixels;
+      };
+    });
+  }
+
+  void addHitMakerBenchmark(Harness &harness, shared_ptr<Inputs> inputs) {
+    harness.add("hitmaker/cog", [inputs]() -> Kernel {
+      struct Cluster {
+        unique_ptr<IMPL::TrackerDataImpl> data;
+        size_t plane;
+      };
+      auto clusters = make_shared<vector<Cluster>>();
+      auto planes = inputs->planes;
+
+      // the clusters as the sparse clustering stores them
+      for (auto const &event : makePixels(inputs->events())) {
+        for (size_t iPlane = 0; iPlane < event.size(); ++iPlane) {
+          PixelRefs refs(event[iPlane].begin(), event[iPlane].end());
+          for (auto const &pixels : Utility::findNeighbourClusters(
+                   refs, Utility::SparsePixelNeighbours{2})) {
+            Cluster cluster{unique_ptr<IMPL::TrackerDataImpl>(
+                new IMPL::TrackerDataImpl), iPlane};
+            EUTelGenericSparseClusterImpl<EUTelGenericSparsePixel> impl(
+                cluster.data.get());
+            for (auto const &pixel : pixels) {
+              impl.push_back(pixel.get());
+            }
+            clusters->push_back(std::move(cluster));
+          }
+        }
+      }
+
+      return [clusters, planes]() {
+        double sum = 0.;
+        for (auto &cluster : *clusters) {
+          geo::PlaneConstants const &pl = (*planes)[cluster.plane];
+          EUTelGenericSparseClusterImpl<EUTelGenericSparsePixel> impl(
+              cluster.data.get());
+          float xPos = 0, yPos = 0;
+          impl.getCenterOfGravity(xPos, yPos);
+          xPos = (xPos + 0.5) * pl.xPitch - pl.xSize / 2.;
+          yPos = (yPos + 0.5) * pl.yPitch - pl.ySize / 2.;
+          array<double, 3> const localPos{{xPos, yPos, 0.}};
+          array<double, 3> globalPos;
+          geo::PlaneTable::local2Master(pl, localPos, globalPos);
+          sum += globalPos[2];
+        }
+        doNotOptimize(sum);
+        return clusters->size();
+      };
+    });
+  }
+
+  void addSelectionBenchmark(Harness &harness, shared_ptr<Inputs> inputs) {
+    harness.add("selection/hits", [inputs]() -> Kernel {
+      geo::PlaneConstants const &pl = (*inputs->planes)[0];
+      auto tables = make_shared<vector<selection::Table>>();
+      for (auto const &event : inputs->events()) {
+        tables->emplace_back();
+        for (auto const &hit : event.hits) {
+          tables->back().sensorID.push_back(static_cast<int>(hit.plane));
+          tables->back().x.push_back(hit.x);
+          tables->back().y.push_back(hit.y);
+          tables->back().nPixels.push_back(hit.clusterSize);
+        }
+      }
+
+      // upstream arm, central half of the sensor, single pixel hits
+      // kept on the first plane only
+      EUTelROI const roi(-pl.xSize / 4., -pl.ySize / 4., pl.xSize / 4.,
+                         pl.ySize / 4.);
+      auto const cut =
+          selection::SensorIn({0, 1, 2}) && selection::InsideROI(roi) &&
+          selection::SizeAtLeast(std::map<int, int>{{1, 2}, {2, 2}});
+      return [tables, cut]() {
+        size_t nHits = 0, nSelected = 0;
+        for (auto const &table : *tables) {
+          nSelected += selection::select(cut, table).count();
+          nHits += table.rows();
+        }
+        doNotOptimize(nSelected);
+        return nHits;
+      };
+    });
+  }
+
+  void addTripletBenchmarks(Harness &harness, shared_ptr<Inputs> inputs) {
+    harness.add("triplets/find", [inputs]() -> Kernel {
+      auto hits =
+          make_shared<HitStore>(makeHits(inputs->events(), *inputs->planes));
+      auto util = make_shared<EUTelTripletGBLUtility>();
+      return [hits, util]() {
+        size_t nHits = 0, nTriplets = 0;
+        for (auto const &eventHits : *hits) {
+          vector<EUTelTripletGBLUtility::triplet> up, down;
+          util->FindTriplets(eventHits, 0, 1, 2, tripletResCut,
+                             tripletSlopeCut, up);
+          util->FindTriplets(eventHits, 3, 4, 5, tripletResCut,
+                             tripletSlopeCut, down);
+          nTriplets += up.size() + down.size();
+          nHits += eventHits.size();
+        }
+        doNotOptimize(nTriplets);
+        return nHits;
+      };
+    });
+
+    harness.add("triplets/match", [inputs]() -> Kernel {
+      auto util = make_shared<EUTelTripletGBLUtility>();
+      auto triplets = make_shared<Triplets>(
+          findTriplets(*util, makeHits(inputs->events(), *inputs->planes)));
+      double const zMid = matchZ(*inputs->planes);
+      return [util, triplets, zMid]() {
+        size_t nTracks = 0;
+        for (size_t i = 0; i < triplets->upstream.size(); ++i) {
+          vector<EUTelTripletGBLUtility::track> tracks;
+          util->MatchTriplets(triplets->upstream[i], triplets->downstream[i],
+                              zMid, trackMatchCut, tracks);
+          nTracks += tracks.size();
+        }
+        doNotOptimize(nTracks);
+        return triplets->upstream.size();
+      };
+    });
+  }
+
+  //! Track finding and DAF fit, reporting the mean number of DAF
+  //! iterations per track which the adaptive annealing is to lower
+  void addDafFitBenchmark(Harness &harness, shared_ptr<Inputs> inputs,
+                          string const &name, bool adaptive) {
+    auto iterationsPerTrack = make_shared<double>(0.);
+    harness.add(
+        name,
+        [inputs, adaptive, iterationsPerTrack]() -> Kernel {
+          auto system = makeTrackerSystem(*inputs->planes, 5.);
+          system->setAdaptiveDaf(adaptive);
+          return [inputs, system, iterationsPerTrack]() {
+            float chi2 = 0.f;
+            size_t nTracks = 0, nIterations = 0;
+            for (auto const &event : inputs->events()) {
+              loadEvent(*system, event);
+              system->combinatorialKF();
+              for (size_t i = 0; i < system->getNtracks(); ++i) {
+                system->fitPlanesInfoDaf(system->tracks.at(i));
+                chi2 += system->tracks.at(i).chi2;
+                nIterations += system->tracks.at(i).dafIterations;
+              }
+              nTracks += system->getNtracks();
+            }
+            doNotOptimize(chi2);
+            *iterationsPerTrack =
+                nTracks > 0 ? static_cast<double>(nIterations) / nTracks : 0.;
+            return inputs->events().size();
+          };
+        },
+        [iterationsPerTrack]() {
+          return Counters{{"DAF iterations per track", *iterationsPerTrack}};
+        });
+  }
+
+  void addDafBenchmarks(Harness &harness, shared_ptr<Inputs> inputs) {
+    harness.add("daf/ckf", [inputs]() -> Kernel {
+      auto system = makeTrackerSystem(*inputs->planes, 5.);
+      return [inputs, system]() {
+        size_t nCandidates = 0;
+        for (auto const &event : inputs->events()) {
+          loadEvent(*system, event);
+          system->combinatorialKF();
+          nCandidates += system->getNtracks();
+        }
+        doNotOptimize(nCandidates);
+        return inputs->events().size();
+      };
+    });
+
+    addDafFitBenchmark(harness, inputs, "daf/ckf+fit", false);
+    addDafFitBenchmark(harness, inputs, "daf/ckf+adaptivefit", true);
+  }
+
+#ifdef USE_GBL
+  //! GBL fit of a matched track, with the trajectory of EUTelGBLFitter
+  double fitGBL(EUTelTripletGBLUtility &util,
+                EUTelTripletGBLUtility::track &track,
+                geo::PlaneTable const &planes, double eBeam) {
+    size_t const nPlanes = planes.size();
+    double const radLengthSi = 0.05 / 93.65;
+    double const radLengthAir = 0.5 * 150. / 304200.;
+    double const totalRadLength =
+        nPlanes * radLengthSi + 2 * (nPlanes - 1) * radLengthAir;
+    double const tetSi = 0.0136 * sqrt(radLengthSi) / eBeam *
+                         (1 + 0.038 * std::log(totalRadLength));
+    double const tetAir = 0.0136 * sqrt(radLengthAir) / eBeam *
+                          (1 + 0.038 * std::log(totalRadLength));
+    Eigen::Vector2d const wscatSi(1. / (tetSi * tetSi),
+                                  1. / (tetSi * tetSi));
+    Eigen::Vector2d const wscatAir(1. / (tetAir * tetAir),
+                                   1. / (tetAir * tetAir));
+    Eigen::Vector2d const measPrec(
+        1. / (planes[0].xResolution * planes[0].xResolution),
+        1. / (planes[0].yResolution * planes[0].yResolution));
+    Eigen::Matrix2d const proL2m = Eigen::Matrix2d::Identity();
+    Eigen::Vector2d const scat = Eigen::Vector2d::Zero();
+
+    EUTelTripletGBLUtility::triplet seed(track.gethit(0), track.gethit(2),
+                                         track.gethit(5));
+    std::vector<gbl::GblPoint> points;
+    double step = 0.;
+    for (size_t ipl = 0; ipl < nPlanes; ++ipl) {
+      auto const &hit = track.gethit(ipl);
+      double const dz = hit.z - seed.base().z;
+      auto point = gbl::GblPoint(util.JacobianPointToPoint(step));
+      Eigen::Vector2d const meas(hit.x - seed.base().x - seed.slope().x * dz,
+                                 hit.y - seed.base().y - seed.slope().y * dz);
+      point.addMeasurement(proL2m, meas, measPrec);
+      point.addScatterer(scat, wscatSi);
+      points.push_back(point);
+      if (ipl + 1 < nPlanes) {
+        double const distance =
+            planes[ipl + 1].position.z() - planes[ipl].position.z();
+        auto air1 = gbl::GblPoint(util.JacobianPointToPoint(0.21 * distance));
+        air1.addScatterer(scat, wscatAir);
+        points.push_back(air1);
+        auto air2 = gbl::GblPoint(util.JacobianPointToPoint(0.58 * distance));
+        air2.addScatterer(scat, wscatAir);
+        points.push_back(air2);
+        step = 0.21 * distance;
+      }
+    }
+
+    double chi2 = 0., lostWeight = 0.;
+    int ndf = 0;
+    gbl::GblTrajectory trajectory(points, false);
+    trajectory.fit(chi2, ndf, lostWeight, "");
+    return chi2;
+  }
+
+  void addGBLBenchmark(Harness &harness, shared_ptr<Inputs> inputs) {
+    harness.add("gbl/fit", [inputs]() -> Kernel {
+      auto util = make_shared<EUTelTripletGBLUtility>();
+      Triplets triplets =
+          findTriplets(*util, makeHits(inputs->events(), *inputs->planes));
+      auto tracks = make_shared<vector<EUTelTripletGBLUtility::track>>();
+      for (size_t i = 0; i < triplets.upstream.size(); ++i) {
+        util->MatchTriplets(triplets.upstream[i], triplets.downstream[i],
+                            matchZ(*inputs->planes), trackMatchCut, *tracks);
+      }
+      return [inputs, util, tracks]() {
+        double chi2 = 0.;
+        for (auto &track : *tracks) {
+          chi2 += fitGBL(*util, track, *inputs->planes, 5.);
+        }
+        doNotOptimize(chi2);
+        return tracks->size();
+      };
+    });
+  }
+#endif
+
+  //! Raw frame of one sensor for the pedestal and common mode loops
+  struct RawFrame {
+    vector<short> adcValues;
+    vector<float> pedestal;
+    vector<float> noise;
+    vector<short> status;
+    size_t nRows, rowLength;
+  };
+
+  //! Raw frame with Gaussian noise, a common mode shift and hits at the
+  //! given occupancy
+  RawFrame generateRawFrame(geo::PlaneConstants const &pl, double occupancy,
+                            unsigned seed) {
+    mt19937 rng(seed);
+    normal_distribution<float> pedestal(100.f, 5.f);
+    normal_distribution<float> noise(3.f, 0.5f);
+    normal_distribution<float> gauss(0.f, 1.f);
+    uniform_real_distribution<double> uniform(0., 1.);
+
+    RawFrame frame;
+    frame.rowLength = pl.xNpixels;
+    frame.nRows = pl.yNpixels;
+    size_t const nPixels = frame.rowLength * frame.nRows;
+    frame.adcValues.resize(nPixels);
+    frame.pedestal.resize(nPixels);
+    frame.noise.resize(nPixels);
+    frame.status.resize(nPixels);
+
+    float const commonMode = 2.f * gauss(rng);
+    for (size_t i = 0; i < nPixels; ++i) {
+      frame.pedestal[i] = pedestal(rng);
+      frame.noise[i] = max(0.5f, noise(rng));
+      frame.status[i] = uniform(rng) < 1e-3 ? EUTELESCOPE::BADPIXEL
+                                            : EUTELESCOPE::GOODPIXEL;
+      float signal =
+          frame.pedestal[i] + commonMode + frame.noise[i] * gauss(rng);
+      if (uniform(rng) < occupancy) {
+        signal += 50.f * frame.noise[i];
+      }
+      frame.adcValues[i] = static_cast<short>(lround(signal));
+    }
+    return frame;
+  }
+
+  void addCommonModeBenchmarks(Harness &harness, shared_ptr<Inputs> inputs) {
+    harness.add("pedestal/commonmode-fullframe", [inputs]() -> Kernel {
+      auto frame = make_shared<RawFrame>(
+          generateRawFrame((*inputs->planes)[0], inputs->config.noiseOccupancy,
+                           inputs->config.seed));
+      return [frame]() {
+        double commonMode = 0.;
+        int skipped = 0;
+        Utility::fullFrameCommonMode(
+            frame->adcValues, frame->pedestal, frame->noise, frame->status,
+            frame->nRows * frame->rowLength, 3.5f, 1000, commonMode, skipped);
+        doNotOptimize(commonMode);
+        doNotOptimize(skipped);
+        return frame->adcValues.size();
+      };
+    });
+
+    harness.add("pedestal/commonmode-rowwise", [inputs]() -> Kernel {
+      auto frame = make_shared<RawFrame>(
+          generateRawFrame((*inputs->planes)[0], inputs->config.noiseOccupancy,
+                           inputs->config.seed));
+      auto correction = make_shared<vector<float>>();
+      auto rowCommonModes = make_shared<vector<double>>();
+      return [frame, correction, rowCommonModes]() {
+        int skipped = 0;
+        int skippedRows = Utility::rowWiseCommonMode(
+            frame->adcValues, frame->pedestal, frame->noise, frame->status,
+            frame->nRows, frame->rowLength, 3.5f, 10, *correction,
+            *rowCommonModes, skipped);
+        doNotOptimize(skippedRows);
+        doNotOptimize(*correction);
+        return frame->adcValues.size();
+      };
+    });
+  }
+
+  //! Clusters and global hits of one event, as the hit maker makes them
+  vector<EUTelTripletGBLUtility::hit>
+  makeEventHits(vector<vector<EUTelGenericSparsePixel>> const &event,
+                geo::PlaneTable const &planes) {
+    vector<EUTelTripletGBLUtility::hit> hits;
+    for (size_t iPlane = 0; iPlane < event.size(); ++iPlane) {
+      geo::PlaneConstants const &pl = planes[iPlane];
+      PixelRefs refs(event[iPlane].begin(), event[iPlane].end());
+      for (auto const &clusterPixels : Utility::findNeighbourClusters(
+               refs, Utility::SparsePixelNeighbours{2})) {
+        IMPL::TrackerDataImpl data;
+        EUTelGenericSparseClusterImpl<EUTelGenericSparsePixel> cluster(&data);
+        for (auto const &pixel : clusterPixels) {
+          cluster.push_back(pixel.get());
+        }
+        float xPos = 0, yPos = 0;
+        cluster.getCenterOfGravity(xPos, yPos);
+        array<double, 3> const localPos{
+            {(xPos + 0.5) * pl.xPitch - pl.xSize / 2.,
+             (yPos + 0.5) * pl.yPitch - pl.ySize / 2., 0.}};
+        array<double, 3> globalPos;
+        geo::PlaneTable::local2Master(pl, localPos, globalPos);
+        hits.emplace_back(globalPos.data(), pl.sensorID);
+        hits.back().ex = pl.xResolution;
+        hits.back().ey = pl.yResolution;
+        hits.back().clustersize = static_cast<int>(clusterPixels.size());
+      }
+    }
+    return hits;
+  }
+
+  //! Number of matched triplet tracks of one event
+  size_t countTracks(EUTelTripletGBLUtility &util,
+                     vector<EUTelTripletGBLUtility::hit> const &hits,
+                     double zMid) {
+    vector<EUTelTripletGBLUtility::triplet> up, down;
+    util.FindTriplets(hits, 0, 1, 2, tripletResCut, tripletSlopeCut, up);
+    util.FindTriplets(hits, 3, 4, 5, tripletResCut, tripletSlopeCut, down);
+    vector<EUTelTripletGBLUtility::track> tracks;
+    util.MatchTriplets(up, down, zMid, trackMatchCut, tracks);
+    return tracks.size();
+  }
+
+  //! An event in flight in the pipelined chain
+  struct ChainEvent {
+    size_t index;
+    vector<EUTelTripletGBLUtility::hit> hits;
+    size_t nTracks;
+  };
+
+  //! Clustering, hit making, triplet finding and matching of whole
+  //! events, as the GBL telescope chain runs them, one event after the
+  //! other and overlapped in an EUTelEventPipeline
+  void addChainBenchmarks(Harness &harness, shared_ptr<Inputs> inputs,
+                          unsigned int nThreads) {
+    harness.add("chain/telescope", [inputs]() -> Kernel {
+      auto pixels = make_shared<PixelStore>(makePixels(inputs->events()));
+      auto planes = inputs->planes;
+      auto util = make_shared<EUTelTripletGBLUtility>();
+      double const zMid = matchZ(*planes);
+      return [pixels, planes, util, zMid]() {
+        size_t nTracks = 0;
+        for (auto const &event : *pixels) {
+          nTracks += countTracks(*util, makeEventHits(event, *planes), zMid);
+        }
+        doNotOptimize(nTracks);
+        return pixels->size();
+      };
+    });
+
+    harness.add("chain/pipelined", [inputs, nThreads]() -> Kernel {
+      auto pixels = make_shared<PixelStore>(makePixels(inputs->events()));
+      auto planes = inputs->planes;
+      double const zMid = matchZ(*planes);
+      return [pixels, planes, zMid, nThreads]() {
+        EUTelEventPipeline<ChainEvent> pipeline(16, nThreads);
+        size_t next = 0;
+        pipeline.setSource([pixels, &next](ChainEvent &event) {
+          if (next == pixels->size()) {
+            return false;
+          }
+          event.index = next++;
+          event.nTracks = 0;
+          return true;
+        });
+        pipeline.addStage("hits",
+                          [pixels, planes](ChainEvent &event) {
+                            event.hits = makeEventHits(
+                                (*pixels)[event.index], *planes);
+                          },
+                          EUTelEventPipeline<ChainEvent>::kParallelStage);
+        pipeline.addStage("tracks",
+                          [zMid](ChainEvent &event) {
+                            EUTelTripletGBLUtility util;
+                            event.nTracks = countTracks(util, event.hits, zMid);
+                          },
+                          EUTelEventPipeline<ChainEvent>::kParallelStage);
+        size_t nTracks = 0;
+        pipeline.setCommit(
+            [&nTracks](ChainEvent &event) { nTracks += event.nTracks; });
+        size_t const nEvents = pipeline.run();
+        doNotOptimize(nTracks);
+        return nEvents;
+      };
+    });
+  }
+
+  Context makeContext(Inputs const &inputs, double minTime,
+                      unsigned repetitions, unsigned int nThreads) {
+    Context context;
+    char host[256] = "unknown";
+    gethostname(host, sizeof(host) - 1);
+    time_t const now = time(nullptr);
+    char date[64];
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    context.emplace_back("date", date);
+    context.emplace_back("host", host);
+#ifdef __VERSION__
+    context.emplace_back("compiler", __VERSION__);
+#endif
+    context.emplace_back("events", to_string(inputs.nEvents));
+    context.emplace_back("tracks_per_event",
+                         to_string(inputs.config.tracksPerEvent));
+    ostringstream occupancy;
+    occupancy << inputs.config.noiseOccupancy;
+    context.emplace_back("noise_occupancy", occupancy.str());
+    context.emplace_back("mean_cluster_size",
+                         to_string(inputs.meanClusterSize));
+    context.emplace_back("seed", to_string(inputs.config.seed));
+    context.emplace_back("min_time", to_string(minTime));
+    context.emplace_back("repetitions", to_string(repetitions));
+    unsigned int const workers =
+        nThreads > 0 ? nThreads : thread::hardware_concurrency();
+    context.emplace_back("threads", to_string(workers));
+    return context;
+  }
+}
+
+int main(int argc, char **argv) {
+
+  unique_ptr<AnyOption> option(new AnyOption);
+
+  string usageString =
+      "\n"
+      "Times the reconstruction kernels on synthetic events\n"
+      "\n"
+      "eutelbench [options]\n"
+      "\n"
+      "-h --help             Print this help\n"
+      "-l --list             List the benchmarks and exit\n"
+      "-f --filter <text>    Only run benchmarks whose name contains text\n"
+      "-o --output <file>    Write the results as JSON\n"
+      "-b --baseline <file>  Compare to the results of an earlier run\n"
+      "-t --tolerance <x>    Allowed slow down for -b, default 0.1\n"
+      "-e --events <n>       Number of events, default 200\n"
+      "   --tracks <x>       Mean number of tracks per event, default 2\n"
+      "   --occupancy <x>    Noise occupancy per pixel, default 1e-4\n"
+      "   --clustersize <x>  Mean cluster size, default 3\n"
+      "   --seed <n>         Random seed\n"
+      "   --mintime <s>      Minimum time per repetition, default 0.5\n"
+      "   --repetitions <n>  Number of repetitions, default 5\n"
+      "   --threads <n>      Workers per stage of chain/pipelined, default\n"
+      "                      the number of hardware threads\n"
+      "\n"
+      "Returns 1 if a benchmark is slower than the baseline by more than\n"
+      "the tolerance.\n";
+
+  option->addUsage(usageString.c_str());
+  option->setFlag("help", 'h');
+  option->setFlag("list", 'l');
+  option->setOption("filter", 'f');
+  option->setOption("output", 'o');
+  option->setOption("baseline", 'b');
+  option->setOption("tolerance", 't');
+  option->setOption("events", 'e');
+  option->setOption("tracks");
+  option->setOption("occupancy");
+  option->setOption("clustersize");
+  option->setOption("seed");
+  option->setOption("mintime");
+  option->setOption("repetitions");
+  option->setOption("threads");
+
+  option->processCommandArgs(argc, argv);
+
+  if (option->getFlag('h') || option->getFlag("help")) {
+    option->printUsage();
+    return 0;
+  }
+
+  auto inputs = make_shared<Inputs>();
+  if (option->getValue("events")) {
+    inputs->nEvents = strtoul(option->getValue("events"), nullptr, 10);
+  }
+  if (option->getValue("tracks")) {
+    inputs->config.tracksPerEvent = atof(option->getValue("tracks"));
+  }
+  if (option->getValue("occupancy")) {
+    inputs->config.noiseOccupancy = atof(option->getValue("occupancy"));
+  }
+  if (option->getValue("clustersize")) {
+    inputs->meanClusterSize = atof(option->getValue("clustersize"));
+  }
+  if (option->getValue("seed")) {
+    inputs->config.seed = strtoul(option->getValue("seed"), nullptr, 10);
+  }
+  unsigned int nThreads = 0;
+  if (option->getValue("threads")) {
+    nThreads = strtoul(option->getValue("threads"), nullptr, 10);
+  }
+
+  Harness harness;
+  double minTime = 0.5;
+  unsigned repetitions = 5;
+  if (option->getValue("mintime")) {
+    minTime = atof(option->getValue("mintime"));
+  }
+  if (option->getValue("repetitions")) {
+    repetitions = strtoul(option->getValue("repetitions"), nullptr, 10);
+  }
+  harness.setMinTime(minTime);
+  harness.setRepetitions(repetitions);
+  if (option->getValue("filter")) {
+    harness.setFilter(option->getValue("filter"));
+  }
+
+  addClusteringBenchmarks(harness, inputs);
+  addHitMakerBenchmark(harness, inputs);
+  addSelectionBenchmark(harness, inputs);
+  addTripletBenchmarks(harness, inputs);
+  addDafBenchmarks(harness, inputs);
+#ifdef USE_GBL
+  addGBLBenchmark(harness, inputs);
+#endif
+  addCommonModeBenchmarks(harness, inputs);
+  addChainBenchmarks(harness, inputs, nThreads);
+
+  if (option->getFlag('l') || option->getFlag("list")) {
+    harness.list(cout);
+    return 0;
+  }
+
+  // read the baseline first, so a bad file name does not waste a run
+  vector<Result> baseline;
+  if (option->getValue("baseline")) {
+    ifstream is(option->getValue("baseline"));
+    if (!is) {
+      cerr << "Cannot read the baseline " << option->getValue("baseline")
+           << endl;
+      return 2;
+    }
+    baseline = readJSON(is);
+  }
+
+  vector<Result> results = harness.run(cout);
+
+  if (option->getValue("output")) {
+    ofstream os(option->getValue("output"));
+    if (!os) {
+      cerr << "Cannot write " << option->getValue("output") << endl;
+      return 2;
+    }
+    writeJSON(os, makeContext(*inputs, minTime, repetitions, nThreads), results);
+  }
+
+  if (option->getValue("baseline")) {
+    double tolerance = 0.1;
+    if (option->getValue("tolerance")) {
+      tolerance = atof(option->getValue("tolerance"));
+    }
+    cout << endl;
+    if (compare(baseline, results, tolerance, cout) > 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,137 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+#ifndef EUTELSYNTHETICEVENTSOURCE_H
+#define EUTELSYNTHETICEVENTSOURCE_H
+
+// personal includes ".h"
+#include "EUTELESCOPE.h"
+#include "EUTelSyntheticEventGenerator.h"
+
+// marlin includes ".h"
+#include "marlin/DataSourceProcessor.h"
+
+// lcio includes <.h>
+#include <EVENT/LCEvent.h>
+
+// system includes <>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace eutelescope {
+
+  //!  Generates synthetic telescope events
+  /*!  This Marlin data source generates events with known truth for
+   *   the telescope described by the GEAR/TGeo geometry, see
+   *   EUTelSyntheticEventGenerator for the generated physics. It is
+   *   meant to stress test the clustering, tracking and alignment at
+   *   any occupancy and to validate them against the truth, without
+   *   any input data.
+   *
+   *   <h4>Output</h4>
+   *   Zero suppressed data of all planes (generic sparse pixels), as
+   *   written by the converters. Optionally the true crossing points
+   *   and the hits as the hit maker would reconstruct them, in the
+   *   global frame. The true hits can be compared to the reconstructed
+   *   ones with EUTelProcessorTrueHitAnalysis.
+   *
+   *   @param NumberOfEvents Number of events if MaxRecordNumber is not set
+   *   @param TracksPerEvent Mean number of tracks per event
+   *   @param BeamEnergy Beam energy in GeV
+   *   @param BeamSpotSize Gaussian beam spot size in x and y in mm
+   *   @param BeamDivergence Gaussian spread of the track slopes
+   *   @param MultipleScattering Deflect tracks in the planes and air
+   *   @param NoiseOccupancy Noise hit probability per pixel and event
+   *   @param ClusterSizeProbabilities Relative probabilities of the
+   *   cluster sizes 1, 2, ...
+   *   @param EfficiencySensorIDs Sensors with an efficiency below 1
+   *   @param Efficiencies Efficiencies of these sensors
+   *   @param MisalignedSensorIDs Sensors displaced from the geometry
+   *   @param MisalignmentX, MisalignmentY Shifts of these sensors in mm
+   *   @param MisalignmentRotZ Rotations of these sensors in rad
+   */
+
+  class EUTelSyntheticEventSource : public marlin::DataSourceProcessor {
+
+  public:
+    //! Default constructor
+    EUTelSyntheticEventSource();
+
+    //! New processor
+    /*! Return a new instance of a EUTelSyntheticEventSource. It is
+     *  called by the Marlin execution framework and shouldn't be used
+     *  by the final user.
+     */
+    virtual EUTelSyntheticEventSource *newProcessor();
+
+    //! Generates the events
+    /*! Writes the run header, numEvents events (or NumberOfEvents if
+     *  numEvents is not positive) and an end of run event.
+     */
+    virtual void readDataSource(int numEvents);
+
+    //! Init method
+    /*! Initializes the geometry and the generator.
+     */
+    virtual void init();
+
+    //! End method
+    virtual void end();
+
+  protected:
+    //! Write the run header describing the planes
+    void processRunHeader();
+
+    //! Add the output collections of a generated event
+    void addCollections(lcio::LCEvent *event,
+                        EUTelSyntheticEventGenerator::Event const &generated);
+
+    //! Add the hits and their clusters of a generated event
+    void addHits(lcio::LCEvent *event,
+                 EUTelSyntheticEventGenerator::Event const &generated);
+
+    //! Add the true hits of a generated event
+    void addTrueHits(lcio::LCEvent *event,
+                     EUTelSyntheticEventGenerator::Event const &generated);
+
+    int _runNumber;
+    int _noOfEvents;
+    float _tracksPerEvent;
+    float _beamEnergy;
+    std::vector<float> _beamSpotSize;
+    float _beamDivergence;
+    bool _multipleScattering;
+    float _noiseOccupancy;
+    std::vector<float> _clusterSizeProbabilities;
+    std::vector<int> _efficiencySensorIDs;
+    std::vector<float> _efficiencies;
+    std::vector<int> _misalignedSensorIDs;
+    std::vector<float> _misalignmentX;
+    std::vector<float> _misalignmentY;
+    std::vector<float> _misalignmentRotZ;
+    int _seed;
+
+    std::string _zsDataCollectionName;
+    std::string _clusterCollectionName;
+    std::string _hitCollectionName;
+    std::string _trueHitCollectionName;
+
+  private:
+    DISALLOW_COPY_AND_ASSIGN(EUTelSyntheticEventSource)
+
+    std::shared_ptr<geo::PlaneTable const> _planeTable;
+    std::unique_ptr<EUTelSyntheticEventGenerator> _generator;
+  };
+
+  //! A global instance of the processor
+  EUTelSyntheticEventSource gEUTelSyntheticEventSource;
+
+} // end namespace eutelescope
+#endif
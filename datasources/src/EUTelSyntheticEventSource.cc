@@ -0,0 +1,369 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+// personal includes
+#include "EUTelSyntheticEventSource.h"
+#include "EUTELESCOPE.h"
+#include "EUTelEventImpl.h"
+#include "EUTelExceptions.h"
+#include "EUTelGeometryTelescopeGeoDescription.h"
+#include "EUTelRunHeaderImpl.h"
+
+// marlin includes
+#include "marlin/DataSourceProcessor.h"
+#include "marlin/Processor.h"
+#include "marlin/ProcessorMgr.h"
+
+// lcio includes
+#include <IMPL/LCCollectionVec.h>
+#include <IMPL/LCEventImpl.h>
+#include <IMPL/LCRunHeaderImpl.h>
+#include <IMPL/TrackerDataImpl.h>
+#include <IMPL/TrackerHitImpl.h>
+#include <UTIL/CellIDEncoder.h>
+#include <UTIL/LCTime.h>
+
+// system includes
+#include <array>
+#include <memory>
+
+using namespace std;
+using namespace lcio;
+using namespace marlin;
+using namespace eutelescope;
+
+// Write the pixels directly into the charge values, in the layout of
+// EUTelTrackerDataInterfacerImpl<EUTelGenericSparsePixel> (x, y,
+// signal, time), without the local copy the interfacer keeps.
+static void addPixels(TrackerDataImpl *data,
+                      vector<EUTelGenericSparsePixel> const &pixels,
+                      size_t begin, size_t end) {
+  FloatVec &charges = data->chargeValues();
+  charges.reserve(charges.size() + 4 * (end - begin));
+  for (size_t i = begin; i < end; ++i) {
+    charges.push_back(pixels[i].getXCoord());
+    charges.push_back(pixels[i].getYCoord());
+    charges.push_back(pixels[i].getSignal());
+    charges.push_back(pixels[i].getTime());
+  }
+}
+
+EUTelSyntheticEventSource::EUTelSyntheticEventSource()
+    : DataSourceProcessor("EUTelSyntheticEventSource"), _runNumber(0),
+      _noOfEvents(1000), _tracksPerEvent(1.f), _beamEnergy(5.f),
+      _beamSpotSize(), _beamDivergence(1e-4f), _multipleScattering(true),
+      _noiseOccupancy(1e-5f), _clusterSizeProbabilities(),
+      _efficiencySensorIDs(), _efficiencies(), _misalignedSensorIDs(),
+      _misalignmentX(), _misalignmentY(), _misalignmentRotZ(), _seed(4357),
+      _zsDataCollectionName(), _clusterCollectionName(),
+      _hitCollectionName(), _trueHitCollectionName(), _planeTable(),
+      _generator() {
+
+  _description = "Generates synthetic telescope events with known truth "
+                 "for the telescope described in the GEAR file.\n"
+                 "Make sure to not specify any LCIOInputFiles in the steering "
+                 "in order to generate events.";
+
+  registerProcessorParameter("RunNumber", "Run number of the generated events",
+                             _runNumber, 0);
+  registerProcessorParameter(
+      "NumberOfEvents",
+      "Number of events to generate if MaxRecordNumber is not set",
+      _noOfEvents, 1000);
+  registerProcessorParameter("TracksPerEvent",
+                             "Mean number of tracks per event (Poisson)",
+                             _tracksPerEvent, 1.f);
+  registerProcessorParameter("BeamEnergy", "Beam energy in GeV", _beamEnergy,
+                             5.f);
+  registerProcessorParameter(
+      "BeamSpotSize", "Gaussian beam spot size in x and y in mm",
+      _beamSpotSize, vector<float>{5.f, 3.f});
+  registerProcessorParameter("BeamDivergence",
+                             "Gaussian spread of the track slopes in rad",
+                             _beamDivergence, 1e-4f);
+  registerProcessorParameter(
+      "MultipleScattering",
+      "Deflect the tracks in the planes and air gaps (Highland)",
+      _multipleScattering, true);
+  registerProcessorParameter("NoiseOccupancy",
+                             "Probability of a noise hit per pixel and event",
+                             _noiseOccupancy, 1e-5f);
+  registerProcessorParameter(
+      "ClusterSizeProbabilities",
+      "Relative probabilities of the cluster sizes 1, 2, ... (up to 9)",
+      _clusterSizeProbabilities, vector<float>{0.3f, 0.3f, 0.25f, 0.15f});
+  registerOptionalParameter("EfficiencySensorIDs",
+                            "Sensor IDs with an efficiency below 1, e.g. "
+                            "the DUT",
+                            _efficiencySensorIDs, vector<int>());
+  registerOptionalParameter("Efficiencies",
+                            "Efficiencies of the EfficiencySensorIDs",
+                            _efficiencies, vector<float>());
+  registerOptionalParameter(
+      "MisalignedSensorIDs",
+      "Sensor IDs displaced with respect to the geometry description",
+      _misalignedSensorIDs, vector<int>());
+  registerOptionalParameter("MisalignmentX",
+                            "Local x shifts of the MisalignedSensorIDs in mm",
+                            _misalignmentX, vector<float>());
+  registerOptionalParameter("MisalignmentY",
+                            "Local y shifts of the MisalignedSensorIDs in mm",
+                            _misalignmentY, vector<float>());
+  registerOptionalParameter(
+      "MisalignmentRotZ",
+      "Rotations around the local z axis of the MisalignedSensorIDs in rad",
+      _misalignmentRotZ, vector<float>());
+  registerProcessorParameter("Seed", "Seed of the random number generator",
+                             _seed, 4357);
+
+  registerOutputCollection(LCIO::TRACKERDATA, "ZSDataCollectionName",
+                           "Zero suppressed data collection name",
+                           _zsDataCollectionName, string("zsdata"));
+  registerOptionalParameter(
+      "HitCollectionName",
+      "Hit collection name, in the global frame. Not written if empty",
+      _hitCollectionName, string(""));
+  registerOptionalParameter(
+      "ClusterCollectionName",
+      "Collection of the cluster data the hits point to",
+      _clusterCollectionName, string("synthetic_cluster"));
+  registerOptionalParameter(
+      "TrueHitCollectionName",
+      "True crossing points, in the global frame. Not written if empty",
+      _trueHitCollectionName, string("true_hit"));
+}
+
+EUTelSyntheticEventSource *EUTelSyntheticEventSource::newProcessor() {
+  return new EUTelSyntheticEventSource;
+}
+
+void EUTelSyntheticEventSource::init() {
+  printParameters();
+
+  geo::gGeometry().initializeTGeoDescription(EUTELESCOPE::GEOFILENAME,
+                                             EUTELESCOPE::DUMPGEOROOT);
+  _planeTable = geo::gGeometry().planeTable();
+
+  if (_beamSpotSize.size() != 2) {
+    throw InvalidParameterException("BeamSpotSize needs the x and y size");
+  }
+  if (_efficiencies.size() != _efficiencySensorIDs.size()) {
+    throw InvalidParameterException(
+        "Efficiencies needs one entry per EfficiencySensorIDs");
+  }
+  if (_misalignmentX.size() != _misalignedSensorIDs.size() ||
+      _misalignmentY.size() != _misalignedSensorIDs.size() ||
+      _misalignmentRotZ.size() != _misalignedSensorIDs.size()) {
+    throw InvalidParameterException("MisalignmentX, MisalignmentY and "
+                                    "MisalignmentRotZ need one entry per "
+                                    "MisalignedSensorIDs");
+  }
+
+  EUTelSyntheticEventGenerator::Config config;
+  config.beamEnergy = _beamEnergy;
+  config.tracksPerEvent = _tracksPerEvent;
+  config.beamSpotX = _beamSpotSize[0];
+  config.beamSpotY = _beamSpotSize[1];
+  config.beamDivergence = _beamDivergence;
+  config.multipleScattering = _multipleScattering;
+  config.noiseOccupancy = _noiseOccupancy;
+  config.clusterSizeProbabilities.assign(_clusterSizeProbabilities.begin(),
+                                         _clusterSizeProbabilities.end());
+  for (size_t i = 0; i < _efficiencySensorIDs.size(); ++i) {
+    config.efficiency[_efficiencySensorIDs[i]] = _efficiencies[i];
+  }
+  for (size_t i = 0; i < _misalignedSensorIDs.size(); ++i) {
+    config.misalignment[_misalignedSensorIDs[i]] = {
+        _misalignmentX[i], _misalignmentY[i], _misalignmentRotZ[i]};
+  }
+  config.seed = static_cast<unsigned>(_seed);
+
+  _generator = std::make_unique<EUTelSyntheticEventGenerator>(
+      _planeTable,
+      _multipleScattering ? geo::gGeometry().materialBudget() : nullptr,
+      config);
+}
+
+void EUTelSyntheticEventSource::processRunHeader() {
+  auto lcHeader = std::make_unique<IMPL::LCRunHeaderImpl>();
+  auto runHeader = std::make_unique<EUTelRunHeaderImpl>(lcHeader.get());
+  runHeader->addProcessor(type());
+  runHeader->lcRunHeader()->setDescription(
+      " Synthetic events generated by " + name());
+  runHeader->lcRunHeader()->setRunNumber(_runNumber);
+  runHeader->setHeaderVersion(0.0001);
+  runHeader->setDataType(EUTELESCOPE::SIMULDATA);
+  runHeader->setDateTime();
+  runHeader->setSimulSWName(type());
+  runHeader->setSimulSWVersion(0.0001);
+
+  size_t const nPlanes = _planeTable->size();
+  IntVec maxX, maxY;
+  for (auto const &pl : _planeTable->planes()) {
+    maxX.push_back(pl.xNpixels - 1);
+    maxY.push_back(pl.yNpixels - 1);
+  }
+  runHeader->setNoOfDetector(static_cast<int>(nPlanes));
+  runHeader->setMinX(IntVec(nPlanes, 0));
+  runHeader->setMaxX(maxX);
+  runHeader->setMinY(IntVec(nPlanes, 0));
+  runHeader->setMaxY(maxY);
+  runHeader->lcRunHeader()->setDetectorName("Synthetic");
+
+  ProcessorMgr::instance()->processRunHeader(
+      static_cast<lcio::LCRunHeader *>(lcHeader.release()));
+}
+
+void EUTelSyntheticEventSource::readDataSource(int numEvents) {
+  int const nEvents = (numEvents > 0) ? numEvents : _noOfEvents;
+
+  // reused for all events to avoid reallocating the pixel buffers
+  EUTelSyntheticEventGenerator::Event generated;
+
+  int eventNumber = 0;
+  for (; eventNumber < nEvents; ++eventNumber) {
+
+    if (isFirstEvent()) {
+      processRunHeader();
+      _isFirstEvent = false;
+    }
+
+    if (eventNumber % 1000 == 0) {
+      streamlog_out(MESSAGE4) << "Generating event " << eventNumber << endl;
+    }
+
+    _generator->generate(generated);
+
+    auto event = std::make_unique<EUTelEventImpl>();
+    event->setDetectorName("Synthetic");
+    event->setEventType(kDE);
+    LCTime now;
+    event->setTimeStamp(now.timeStamp());
+    event->setRunNumber(_runNumber);
+    event->setEventNumber(eventNumber);
+
+    addCollections(event.get(), generated);
+
+    ProcessorMgr::instance()->processEvent(
+        static_cast<LCEventImpl *>(event.get()));
+  }
+
+  auto event = std::make_unique<EUTelEventImpl>();
+  event->setDetectorName("Synthetic");
+  LCTime now;
+  event->setTimeStamp(now.timeStamp());
+  event->setRunNumber(_runNumber);
+  event->setEventNumber(eventNumber);
+  event->setEventType(kEORE);
+  ProcessorMgr::instance()->processEvent(
+      static_cast<LCEventImpl *>(event.get()));
+}
+
+void EUTelSyntheticEventSource::addCollections(
+    LCEvent *event, EUTelSyntheticEventGenerator::Event const &generated) {
+
+  LCCollectionVec *zsDataCollection = new LCCollectionVec(LCIO::TRACKERDATA);
+  CellIDEncoder<TrackerDataImpl> zsDataEncoder(
+      EUTELESCOPE::ZSDATADEFAULTENCODING, zsDataCollection);
+
+  for (auto const &plane : generated.planes) {
+    TrackerDataImpl *zsData = new TrackerDataImpl;
+    zsDataEncoder["sensorID"] = plane.sensorID;
+    zsDataEncoder["sparsePixelType"] =
+        static_cast<int>(kEUTelGenericSparsePixel);
+    zsDataEncoder.setCellID(zsData);
+    addPixels(zsData, plane.pixels, 0, plane.pixels.size());
+    zsDataCollection->push_back(zsData);
+  }
+  event->addCollection(zsDataCollection, _zsDataCollectionName);
+
+  if (!_hitCollectionName.empty()) {
+    addHits(event, generated);
+  }
+  if (!_trueHitCollectionName.empty()) {
+    addTrueHits(event, generated);
+  }
+}
+
+void EUTelSyntheticEventSource::addHits(
+    LCEvent *event, EUTelSyntheticEventGenerator::Event const &generated) {
+
+  LCCollectionVec *clusterCollection = new LCCollectionVec(LCIO::TRACKERDATA);
+  CellIDEncoder<TrackerDataImpl> clusterEncoder(
+      EUTELESCOPE::ZSDATADEFAULTENCODING, clusterCollection);
+  LCCollectionVec *hitCollection = new LCCollectionVec(LCIO::TRACKERHIT);
+  CellIDEncoder<TrackerHitImpl> hitEncoder(EUTELESCOPE::HITENCODING,
+                                           hitCollection);
+
+  for (size_t iPlane = 0; iPlane < generated.planes.size(); ++iPlane) {
+    auto const &plane = generated.planes[iPlane];
+    geo::PlaneConstants const &pl = (*_planeTable)[iPlane];
+
+    for (auto const &cluster : plane.clusters) {
+      TrackerDataImpl *clusterData = new TrackerDataImpl;
+      clusterEncoder["sensorID"] = plane.sensorID;
+      clusterEncoder["sparsePixelType"] =
+          static_cast<int>(kEUTelGenericSparsePixel);
+      clusterEncoder.setCellID(clusterData);
+      addPixels(clusterData, plane.pixels, cluster.begin, cluster.end);
+      clusterCollection->push_back(clusterData);
+
+      // centre of gravity, all pixels have the same signal
+      double xCoG = 0., yCoG = 0.;
+      for (size_t i = cluster.begin; i < cluster.end; ++i) {
+        xCoG += plane.pixels[i].getXCoord();
+        yCoG += plane.pixels[i].getYCoord();
+      }
+      size_t const size = cluster.end - cluster.begin;
+      std::array<double, 3> const localPos{
+          {(xCoG / size + 0.5) * pl.xPitch - pl.xSize / 2.,
+           (yCoG / size + 0.5) * pl.yPitch - pl.ySize / 2., 0.}};
+      std::array<double, 3> globalPos;
+      geo::PlaneTable::local2Master(pl, localPos, globalPos);
+
+      TrackerHitImpl *hit = new TrackerHitImpl;
+      hit->setPosition(globalPos.data());
+      float cov[TRKHITNCOVMATRIX] = {0., 0., 0., 0., 0., 0.};
+      cov[0] = pl.xResolution * pl.xResolution;
+      cov[2] = pl.yResolution * pl.yResolution;
+      hit->setCovMatrix(cov);
+      hit->setType(kEUTelGenericSparseClusterImpl);
+      hit->rawHits().push_back(clusterData);
+      hitEncoder["sensorID"] = plane.sensorID;
+      hitEncoder["properties"] = kHitInGlobalCoord;
+      hitEncoder.setCellID(hit);
+      hitCollection->push_back(hit);
+    }
+  }
+  event->addCollection(clusterCollection, _clusterCollectionName);
+  event->addCollection(hitCollection, _hitCollectionName);
+}
+
+void EUTelSyntheticEventSource::addTrueHits(
+    LCEvent *event, EUTelSyntheticEventGenerator::Event const &generated) {
+
+  LCCollectionVec *trueHitCollection = new LCCollectionVec(LCIO::TRACKERHIT);
+  CellIDEncoder<TrackerHitImpl> hitEncoder(EUTELESCOPE::HITENCODING,
+                                           trueHitCollection);
+
+  // all crossings, including the ones the sensor did not detect
+  for (auto const &trueHit : generated.trueHits) {
+    TrackerHitImpl *hit = new TrackerHitImpl;
+    hit->setPosition(trueHit.position.data());
+    hitEncoder["sensorID"] = trueHit.sensorID;
+    hitEncoder["properties"] = kHitInGlobalCoord;
+    hitEncoder.setCellID(hit);
+    trueHitCollection->push_back(hit);
+  }
+  event->addCollection(trueHitCollection, _trueHitCollectionName);
+}
+
+void EUTelSyntheticEventSource::end() {
+  streamlog_out(MESSAGE4) << "Successfully finished" << endl;
+}
@@ -0,0 +1,96 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+#ifndef EUTELPACKEDPIXEL_H
+#define EUTELPACKEDPIXEL_H
+
+// personal includes ".h"
+#include "EUTELESCOPE.h"
+#include "EUTelMuPixel.h"
+
+// system includes <>
+#include <vector>
+
+namespace eutelescope {
+
+  //! Sparse pixel stored in a compact lossless encoding
+  /*! The pixel carries the same information as an EUTelMuPixel, but a
+   *  TrackerData of this type holds the pixels in a byte stream
+   *  instead of one float per field:
+   *
+   *  - the coordinates, time, hit time and frame time are written as
+   *    differences to the previous pixel of the same TrackerData,
+   *  - the signal is written as an integer if it is one, otherwise
+   *    as the bit pattern of the float,
+   *  - every value is a zigzag variable length integer, so small
+   *    values take one byte.
+   *
+   *  Every stored float holds three bytes of the stream as an integer
+   *  below 2^24, which a float represents exactly. The data therefore
+   *  survive any float handling unchanged, unlike raw bit patterns
+   *  which could be altered as NaN or denormals. The first float is
+   *  the format version, the second the length of the stream in
+   *  bytes.
+   *
+   *  A typical pixel of a hit on consecutive columns needs 6 to 8
+   *  bytes instead of 16 (EUTelGenericSparsePixel) or 28
+   *  (EUTelMuPixel), and the 64 bit frame time is kept exactly, which
+   *  the two floats of EUTelMuPixel cannot do.
+   *
+   *  Any pixel type except EUTelGeometricPixel, whose geometry is not
+   *  stored, can be pushed into a TrackerData of this type, and a
+   *  pixel read from it can be pushed into an EUTelMuPixel or
+   *  EUTelGenericSparsePixel TrackerData. This is how
+   *  EUTelProcessorConvertSparsePixels converts existing files.
+   */
+
+  class EUTelPackedPixel : public EUTelMuPixel {
+
+  public:
+    //! Default constructor with all arguments (individually)
+    EUTelPackedPixel(short xCoord, short yCoord, float signal, short time,
+                     short hitTime, long long unsigned frameTime);
+
+    //! Constructor copying all the fields of an EUTelMuPixel
+    EUTelPackedPixel(EUTelMuPixel const &pixel);
+
+    //! Constructor converting any other sparse pixel
+    /*! Fields not present in the pixel type are set to 0.
+     *
+     *  @throw std::bad_cast for EUTelGeometricPixel and unknown types
+     */
+    explicit EUTelPackedPixel(EUTelBaseSparsePixel const &pixel);
+
+    //! Default constructor with no args (all values are set to 0)
+    EUTelPackedPixel();
+
+    //! Destructor
+    virtual ~EUTelPackedPixel() {}
+
+    //! Append a pixel to the encoded data of a TrackerData
+    /*! @param chargeValues The charge values of the TrackerData
+     *  @param pixel The pixel to be added
+     *  @param previous The last pixel already in chargeValues, nullptr
+     *  if it is empty
+     *
+     *  @throw std::length_error if the stream exceeds 2^24 bytes
+     */
+    static void encode(std::vector<float> &chargeValues,
+                       EUTelMuPixel const &pixel,
+                       EUTelMuPixel const *previous);
+
+    //! Decode all the pixels of a TrackerData
+    /*! @throw std::runtime_error if the data are not in this format
+     */
+    static void decode(std::vector<float> const &chargeValues,
+                       std::vector<EUTelPackedPixel> &pixels);
+  };
+} // namespace eutelescope
+
+#endif
@@ -0,0 +1,246 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+// personal includes ".h"
+#include "EUTelPackedPixel.h"
+#include "EUTELESCOPE.h"
+
+// system includes <>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <typeinfo>
+
+using namespace eutelescope;
+
+namespace {
+  //! Written into the first float, to be increased on format changes
+  unsigned int const kFormatVersion = 1;
+
+  //! Format version and stream length
+  size_t const kHeaderSize = 2;
+
+  //! Every integer below 2^24 is exactly representable as a float
+  size_t const kBytesPerValue = 3;
+
+  size_t const kMaxBytes = (size_t(1) << 24) - 1;
+
+  //! Enough for the six fields of a pixel
+  size_t const kMaxPixelBytes = 6 * 10;
+
+  std::uint64_t zigzag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^
+           static_cast<std::uint64_t>(value >> 63);
+  }
+
+  std::int64_t unzigzag(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^
+           -static_cast<std::int64_t>(value & 1);
+  }
+
+  void putVarint(unsigned char *bytes, size_t &n, std::uint64_t value) {
+    while (value >= 0x80) {
+      bytes[n++] = static_cast<unsigned char>(value | 0x80);
+      value >>= 7;
+    }
+    bytes[n++] = static_cast<unsigned char>(value);
+  }
+
+  //! Integral signals as zigzag integers with a 0 flag bit, all
+  //! others as float bit pattern with a 1 flag bit
+  void putSignal(unsigned char *bytes, size_t &n, float signal) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &signal, sizeof(bits));
+    if (signal >= -2147483648.f && signal < 2147483648.f) {
+      std::int64_t const integral = static_cast<std::int64_t>(signal);
+      float const back = static_cast<float>(integral);
+      std::uint32_t backBits;
+      std::memcpy(&backBits, &back, sizeof(backBits));
+      // compares bits to keep -0
+      if (backBits == bits) {
+        putVarint(bytes, n, zigzag(integral) << 1);
+        return;
+      }
+    }
+    putVarint(bytes, n, (static_cast<std::uint64_t>(bits) << 1) | 1);
+  }
+
+  //! Reads the byte stream from the stored floats
+  class ByteReader {
+  public:
+    ByteReader(std::vector<float> const &chargeValues, size_t nBytes)
+        : _next(chargeValues.data() + kHeaderSize), _remaining(nBytes),
+          _value(0), _bytesInValue(0) {}
+
+    bool atEnd() const { return _remaining == 0; }
+
+    unsigned char get() {
+      if (_remaining == 0) {
+        throw std::runtime_error("Truncated packed pixel data");
+      }
+      if (_bytesInValue == 0) {
+        _value = static_cast<std::uint32_t>(*_next++);
+        _bytesInValue = kBytesPerValue;
+      }
+      --_remaining;
+      --_bytesInValue;
+      unsigned char const byte = static_cast<unsigned char>(_value);
+      _value >>= 8;
+      return byte;
+    }
+
+    std::uint64_t getVarint() {
+      std::uint64_t value = 0;
+      for (unsigned int shift = 0; shift < 64; shift += 7) {
+        unsigned char const byte = get();
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+          return value;
+        }
+      }
+      throw std::runtime_error("Corrupt packed pixel data");
+    }
+
+    float getSignal() {
+      std::uint64_t const value = getVarint();
+      if (value & 1) {
+        std::uint32_t const bits = static_cast<std::uint32_t>(value >> 1);
+        float signal;
+        std::memcpy(&signal, &bits, sizeof(signal));
+        return signal;
+      }
+      return static_cast<float>(unzigzag(value >> 1));
+    }
+
+  private:
+    float const *_next;
+    size_t _remaining;
+    std::uint32_t _value;
+    size_t _bytesInValue;
+  };
+}
+
+EUTelPackedPixel::EUTelPackedPixel() : EUTelMuPixel() {
+  _typeDerived = kEUTelPackedPixel;
+}
+
+EUTelPackedPixel::EUTelPackedPixel(short xCoord, short yCoord, float signal,
+                                   short time, short hitTime,
+                                   long long unsigned frameTime)
+    : EUTelMuPixel(xCoord, yCoord, signal, time, hitTime, frameTime) {
+  _typeDerived = kEUTelPackedPixel;
+}
+
+EUTelPackedPixel::EUTelPackedPixel(EUTelMuPixel const &pixel)
+    : EUTelMuPixel(pixel) {
+  _typeDerived = kEUTelPackedPixel;
+}
+
+EUTelPackedPixel::EUTelPackedPixel(EUTelBaseSparsePixel const &pixel)
+    : EUTelMuPixel() {
+  _typeDerived = kEUTelPackedPixel;
+  _xCoord = pixel.getXCoord();
+  _yCoord = pixel.getYCoord();
+  _signal = pixel.getSignal();
+
+  switch (pixel.getSparsePixelType()) {
+  case kEUTelSimpleSparsePixel:
+    break;
+  case kEUTelGenericSparsePixel:
+    _time = static_cast<short>(
+        static_cast<EUTelGenericSparsePixel const &>(pixel).getTime());
+    break;
+  case kEUTelMuPixel:
+  case kEUTelPackedPixel: {
+    auto const &muPixel = static_cast<EUTelMuPixel const &>(pixel);
+    _time = static_cast<short>(muPixel.getTime());
+    _hitTime = muPixel.getHitTime();
+    _frameTime = muPixel.getFrameTime();
+    break;
+  }
+  default:
+    throw std::bad_cast();
+  }
+}
+
+void EUTelPackedPixel::encode(std::vector<float> &chargeValues,
+                              EUTelMuPixel const &pixel,
+                              EUTelMuPixel const *previous) {
+  EUTelMuPixel const zero;
+  if (!previous) {
+    previous = &zero;
+  }
+
+  unsigned char bytes[kMaxPixelBytes];
+  size_t n = 0;
+  putVarint(bytes, n, zigzag(pixel.getXCoord() - previous->getXCoord()));
+  putVarint(bytes, n, zigzag(pixel.getYCoord() - previous->getYCoord()));
+  putSignal(bytes, n, pixel.getSignal());
+  putVarint(bytes, n,
+            zigzag(static_cast<std::int64_t>(pixel.getTime()) -
+                   static_cast<std::int64_t>(previous->getTime())));
+  putVarint(bytes, n, zigzag(pixel.getHitTime() - previous->getHitTime()));
+  // modulo 2^64, which restores any frame time on decoding
+  putVarint(bytes, n, zigzag(static_cast<std::int64_t>(
+                          pixel.getFrameTime() - previous->getFrameTime())));
+
+  if (chargeValues.empty()) {
+    chargeValues.push_back(static_cast<float>(kFormatVersion));
+    chargeValues.push_back(0.f);
+  }
+  size_t position = static_cast<size_t>(chargeValues[1]);
+  if (position + n > kMaxBytes) {
+    throw std::length_error("Too many pixels for the packed encoding");
+  }
+
+  for (size_t i = 0; i < n; ++i, ++position) {
+    size_t const byte = position % kBytesPerValue;
+    std::uint32_t value = bytes[i];
+    if (byte == 0) {
+      chargeValues.push_back(0.f);
+    } else {
+      value = static_cast<std::uint32_t>(chargeValues.back()) |
+              (value << (8 * byte));
+    }
+    chargeValues.back() = static_cast<float>(value);
+  }
+  chargeValues[1] = static_cast<float>(position);
+}
+
+void EUTelPackedPixel::decode(std::vector<float> const &chargeValues,
+                              std::vector<EUTelPackedPixel> &pixels) {
+  if (chargeValues.empty()) {
+    return;
+  }
+  if (chargeValues.size() < kHeaderSize ||
+      chargeValues[0] != static_cast<float>(kFormatVersion)) {
+    throw std::runtime_error("Unknown packed pixel data format");
+  }
+  size_t const nBytes = static_cast<size_t>(chargeValues[1]);
+  if (chargeValues.size() !=
+      kHeaderSize + (nBytes + kBytesPerValue - 1) / kBytesPerValue) {
+    throw std::runtime_error("Inconsistent packed pixel data length");
+  }
+
+  ByteReader reader(chargeValues, nBytes);
+  short xCoord = 0;
+  short yCoord = 0;
+  short time = 0;
+  short hitTime = 0;
+  std::uint64_t frameTime = 0;
+  while (!reader.atEnd()) {
+    xCoord += static_cast<short>(unzigzag(reader.getVarint()));
+    yCoord += static_cast<short>(unzigzag(reader.getVarint()));
+    float const signal = reader.getSignal();
+    time += static_cast<short>(unzigzag(reader.getVarint()));
+    hitTime += static_cast<short>(unzigzag(reader.getVarint()));
+    frameTime += static_cast<std::uint64_t>(unzigzag(reader.getVarint()));
+    pixels.emplace_back(xCoord, yCoord, signal, time, hitTime, frameTime);
+  }
+}
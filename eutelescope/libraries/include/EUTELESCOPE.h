@@ -593,6 +593,7 @@ namespace eutelescope {
     kEUTelGeometricPixel = 3,
     // add here your implementation
     kEUTelMuPixel = 4,
+    kEUTelPackedPixel = 5,
     kUnknownPixelType = 31
   };
 
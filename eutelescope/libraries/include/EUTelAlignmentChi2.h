@@ -0,0 +1,106 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELALIGNMENTCHI2_H
+#define EUTELALIGNMENTCHI2_H 1
+
+// system includes <>
+#include <cstddef>
+#include <vector>
+
+namespace eutelescope {
+
+  //! Chi2 of the two plane alignment with analytic gradient
+  /*! The objective minimised by EUTelAlign: the measured hits of the
+   *  aligned plane are rotated by the angles theta_x, theta_y and
+   *  theta_z and shifted by off_x and off_y, and compared with the
+   *  positions predicted from the reference planes. Each hit pair
+   *  contributes its squared distance divided by 100, pairs above an
+   *  optional cut are dropped.
+   *
+   *  The hit pairs are kept as a structure of arrays, the rotation
+   *  matrix and its derivatives are computed once per evaluation and
+   *  the loop over the pairs is branch free, so it can be
+   *  vectorised by the compiler. The chi2 depends on the angles only
+   *  through the four sums dx*u, dx*v, dy*u, dy*v (dx, dy the
+   *  residuals, u, v the measured position), which gives the
+   *  gradient at the cost of a few more additions per pair. Large
+   *  samples are split over several threads and the partial sums are
+   *  added in a fixed order, so the result does not depend on the
+   *  scheduling.
+   *
+   *  The parameter vector is the one of the EUTelAlign Minuit fit:
+   *  off_x, off_y, theta_x, theta_y, theta_z.
+   */
+  class EUTelAlignmentChi2 {
+
+  public:
+    //! Number of fit parameters
+    static const int nParameters = 5;
+
+    //! Constructor
+    /*! @param nThreads Maximal number of threads used for an
+     *  evaluation, 0 to use the number of hardware threads
+     */
+    explicit EUTelAlignmentChi2(unsigned int nThreads = 0);
+
+    //! Reserve space for a number of hit pairs
+    void reserve(size_t n);
+
+    //! Add a hit pair
+    /*! @param measX Measured x on the aligned plane
+     *  @param measY Measured y on the aligned plane
+     *  @param predX Predicted x on the aligned plane
+     *  @param predY Predicted y on the aligned plane
+     */
+    void addHitPair(double measX, double measY, double predX, double predY);
+
+    //! Remove all hit pairs
+    void clear();
+
+    //! Number of hit pairs
+    size_t size() const { return _measX.size(); }
+
+    //! Evaluate the chi2 and optionally its gradient
+    /*! @param par The nParameters fit parameters
+     *  @param cut Pairs with a contribution not below cut are not
+     *  used, 0 to use all pairs
+     *  @param grad If not null, filled with the nParameters
+     *  derivatives of the chi2
+     *  @param nUsed If not null, set to the number of pairs used
+     *  @return The chi2
+     */
+    double evaluate(double const *par, double cut, double *grad = nullptr,
+                    size_t *nUsed = nullptr) const;
+
+  private:
+    //! Partial sums over a range of pairs
+    struct Sums {
+      double chi2;
+      double dx;
+      double dy;
+      double dxu;
+      double dxv;
+      double dyu;
+      double dyv;
+      double n;
+    };
+
+    //! Accumulate the pairs [first, last)
+    void accumulate(double const *rot, double const *off, double cut,
+                    size_t first, size_t last, Sums &sums) const;
+
+    unsigned int _nThreads;
+
+    std::vector<double> _measX;
+    std::vector<double> _measY;
+    std::vector<double> _predX;
+    std::vector<double> _predY;
+  };
+}
+#endif
@@ -0,0 +1,110 @@
+#ifndef EUTELANALYTICPIXGEODESCR_H
+#define EUTELANALYTICPIXGEODESCR_H
+
+/** @class EUTelAnalyticPixGeoDescr
+      * Base class for pixel geometry descriptions which, in addition to
+      * the TGeo volumes, provide the analytic interface of
+      * @class EUTelGenericPixGeoDescr.
+      * Along each axis the sensor is described by a few regions of equal
+      * pitch (@class EUTelPixelAxisRegion). The regions of a sensor type
+      * are given by specialising @class EUTelPixelLayout for it, the
+      * conversions are then plain arithmetic over a compile time number
+      * of regions.
+  */
+
+// STL
+#include <cmath>
+#include <cstddef>
+
+// EUTELESCOPE
+#include "EUTelGenericPixGeoDescr.h"
+
+namespace eutelescope {
+  namespace geo {
+
+    /** A range of pixels of equal pitch along one axis.
+          * Pixel firstIndex+i covers [start+i*step, start+(i+1)*step] in the
+          * local plane frame. A negative step describes indices running
+          * against the local axis. */
+    struct EUTelPixelAxisRegion {
+      int firstIndex;
+      int nPixels;
+      double start;
+      double step;
+    };
+
+    /** Centre and size of pixel @param index along an axis of @param
+          * nRegions regions, returns false if there is no such pixel */
+    inline bool pixelAxisCenter(EUTelPixelAxisRegion const *regions,
+                                size_t nRegions, int index, double &pos,
+                                double &pitch) {
+      for (size_t i = 0; i < nRegions; ++i) {
+        EUTelPixelAxisRegion const &region = regions[i];
+        int const offset = index - region.firstIndex;
+        if (offset >= 0 && offset < region.nPixels) {
+          pos = region.start + (offset + 0.5) * region.step;
+          pitch = std::fabs(region.step);
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /** Pixel index at @param pos along an axis of @param nRegions regions,
+          * returns false if the position is not on a pixel */
+    inline bool pixelAxisIndex(EUTelPixelAxisRegion const *regions,
+                               size_t nRegions, double pos, int &index) {
+      for (size_t i = 0; i < nRegions; ++i) {
+        EUTelPixelAxisRegion const &region = regions[i];
+        double const t = (pos - region.start) / region.step;
+        if (t >= 0. && t < region.nPixels) {
+          index = region.firstIndex + static_cast<int>(t);
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /** Pixel regions of a sensor type, to be specialised as
+      *
+      *   template <> struct EUTelPixelLayout<MySensor> {
+      *     static const size_t nRegionsX = ..., nRegionsY = ...;
+      *     static EUTelPixelAxisRegion const regionsX[nRegionsX];
+      *     static EUTelPixelAxisRegion const regionsY[nRegionsY];
+      *   };
+      *
+      * with the arrays defined in the source file of the sensor. */
+    template <class Sensor> struct EUTelPixelLayout;
+
+    template <class Sensor>
+    class EUTelAnalyticPixGeoDescr : public EUTelGenericPixGeoDescr {
+
+    public:
+      typedef EUTelPixelLayout<Sensor> Layout;
+
+      EUTelAnalyticPixGeoDescr(double sizeX, double sizeY, double sizeZ,
+                               int minX, int maxX, int minY, int maxY,
+                               double radLen)
+          : EUTelGenericPixGeoDescr(sizeX, sizeY, sizeZ, minX, maxX, minY,
+                                    maxY, radLen) {}
+
+      bool hasAnalyticPixels() const { return true; }
+
+      bool getPixelCenter(int x, int y, double &posX, double &posY,
+                          double &pitchX, double &pitchY) const {
+        return pixelAxisCenter(Layout::regionsX, Layout::nRegionsX, x, posX,
+                               pitchX) &&
+               pixelAxisCenter(Layout::regionsY, Layout::nRegionsY, y, posY,
+                               pitchY);
+      }
+
+      bool getPixelIndex(double posX, double posY, int &x, int &y) const {
+        return pixelAxisIndex(Layout::regionsX, Layout::nRegionsX, posX, x) &&
+               pixelAxisIndex(Layout::regionsY, Layout::nRegionsY, posY, y);
+      }
+    };
+
+  } // namespace geo
+} // namespace eutelescope
+
+#endif // EUTELANALYTICPIXGEODESCR_H
@@ -0,0 +1,151 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELASYNCLCIOREADER_H
+#define EUTELASYNCLCIOREADER_H 1
+
+// eutelescope includes ".h"
+#include "EUTELESCOPE.h"
+#include "EUTelBoundedQueue.h"
+
+// lcio includes <.h>
+#include <EVENT/LCEvent.h>
+#include <IMPL/LCEventImpl.h>
+#include <IMPL/LCRunHeaderImpl.h>
+
+// system includes <>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace eutelescope {
+
+  //! LCIO reader decoding the upcoming records on background threads
+  /*! Reading an LCIO file mostly means decompressing the SIO records
+   *  and building the event objects. This reader does it on its own
+   *  threads while the caller processes the previous events, and
+   *  hands the run headers and events over in file order through
+   *  bounded queues.
+   *
+   *  Every file is decoded by a single thread, since an SIO stream
+   *  can only be read sequentially. With several threads, thread i
+   *  reads the files i, i + nThreads, ... so that the next files of
+   *  a multi-file job are decoded in parallel. At most readAhead
+   *  records per thread are kept in memory.
+   *
+   *  The records are detached from the LCIO reader: the collections
+   *  are taken over by a new event, without copying any element, and
+   *  the run header is copied. The caller owns them and they stay
+   *  valid after the next read.
+   *
+   *  LCIO has to be thread safe for this, i.e. version 2.13 or later
+   *  whose SIO layer has no global state. Any other reader or writer
+   *  of the job may then be used at the same time. Built against an
+   *  older LCIO, the reader refuses to start.
+   *
+   *  Typical usage:
+   *  \code{.cpp}
+   *  EUTelAsyncLCIOReader reader(fileNames);
+   *  while (auto event = reader.readNextEvent()) {
+   *    ...
+   *  }
+   *  \endcode
+   */
+  class EUTelAsyncLCIOReader {
+
+  public:
+    //! A run header or an event, the other one is null
+    struct Record {
+      std::unique_ptr<IMPL::LCRunHeaderImpl> runHeader;
+      std::unique_ptr<IMPL::LCEventImpl> event;
+    };
+
+    //! Start reading ahead
+    /*! @param fileNames The files, read in this order
+     *  @param readAhead Records buffered per thread
+     *  @param nThreads Files decoded at the same time
+     *
+     *  @throw lcio::Exception if LCIO is older than 2.13
+     */
+    explicit EUTelAsyncLCIOReader(std::vector<std::string> const &fileNames,
+                                  size_t readAhead = 16,
+                                  unsigned int nThreads = 1);
+
+    //! Stops the threads, the records not read are dropped
+    ~EUTelAsyncLCIOReader();
+
+    //! Get the next run header or event
+    /*! @return false at the end of the last file
+     *
+     *  @throw lcio::IOException if a file could not be read, after
+     *  the records read before the error
+     */
+    bool readNextRecord(Record &record);
+
+    //! Get the next event, skipping the run headers
+    /*! @return The event or nullptr at the end of the last file
+     *
+     *  @throw lcio::IOException as readNextRecord()
+     */
+    std::unique_ptr<IMPL::LCEventImpl> readNextEvent();
+
+    //! Stop reading, also done by the destructor
+    void close();
+
+    //! True if the LCIO version is thread safe, i.e. 2.13 or later
+    static bool isSupported();
+
+    //! Move the collections of an event into a new one
+    /*! The events of an LCIO reader are owned by the reader and
+     *  deleted on the next read. Taking the collections over keeps
+     *  them, and the pointers between them, alive without copying.
+     *  They are made persistent again, so that the new event can be
+     *  written with all its collections.
+     *
+     *  @param event An event in update mode
+     */
+    static std::unique_ptr<IMPL::LCEventImpl>
+    detachEvent(EVENT::LCEvent *event);
+
+  private:
+    DISALLOW_COPY_AND_ASSIGN(EUTelAsyncLCIOReader)
+
+  public:
+    //! A queued record, or the end of a file if the record is empty
+    struct Entry {
+      Record record;
+
+      //! Why the file failed, set at the end of a file only
+      std::string error;
+    };
+
+  private:
+    //! A decoding thread and its queue
+    struct Worker {
+      explicit Worker(size_t readAhead) : queue(readAhead), thread() {}
+
+      EUTelBoundedQueue<Entry> queue;
+
+      std::thread thread;
+    };
+
+    //! Decode the files of a worker
+    void decode(size_t iWorker);
+
+    //! The files in reading order
+    std::vector<std::string> _fileNames;
+
+    //! The decoding threads
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    //! File of the next record
+    size_t _currentFile;
+  };
+}
+#endif
@@ -0,0 +1,93 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELBOUNDEDQUEUE_H
+#define EUTELBOUNDEDQUEUE_H 1
+
+// system includes <>
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace eutelescope {
+
+  //! Blocking FIFO queue with a maximum size
+  /*! push() waits while the queue is full and pop() while it is
+   *  empty, so a fast producer is throttled to the speed of its
+   *  consumers. After close() no more items are accepted, the
+   *  remaining ones can still be popped.
+   */
+  template <class T> class EUTelBoundedQueue {
+
+  public:
+    explicit EUTelBoundedQueue(size_t capacity)
+        : _items(), _capacity(std::max<size_t>(capacity, 1)), _closed(false),
+          _mutex(), _notFull(), _notEmpty() {}
+
+    EUTelBoundedQueue(EUTelBoundedQueue const &) = delete;
+    EUTelBoundedQueue &operator=(EUTelBoundedQueue const &) = delete;
+
+    //! Append an item, waiting for free space
+    /*! @return false if the queue is closed, the item is dropped then
+     */
+    bool push(T item) {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _notFull.wait(lock,
+                    [this] { return _closed || _items.size() < _capacity; });
+      if (_closed) {
+        return false;
+      }
+      _items.push_back(std::move(item));
+      _notEmpty.notify_one();
+      return true;
+    }
+
+    //! Take the first item, waiting for one to arrive
+    /*! @return false if the queue is closed and empty
+     */
+    bool pop(T &item) {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _notEmpty.wait(lock, [this] { return _closed || !_items.empty(); });
+      if (_items.empty()) {
+        return false;
+      }
+      item = std::move(_items.front());
+      _items.pop_front();
+      _notFull.notify_one();
+      return true;
+    }
+
+    //! Refuse further items and wake up all waiting threads
+    void close() {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _closed = true;
+      _notFull.notify_all();
+      _notEmpty.notify_all();
+    }
+
+    size_t size() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _items.size();
+    }
+
+    size_t capacity() const { return _capacity; }
+
+  private:
+    std::deque<T> _items;
+    size_t const _capacity;
+    bool _closed;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _notFull;
+    std::condition_variable _notEmpty;
+  };
+}
+#endif
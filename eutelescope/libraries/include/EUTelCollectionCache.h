@@ -0,0 +1,112 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELCOLLECTIONCACHE_H
+#define EUTELCOLLECTIONCACHE_H 1
+
+// eutelescope includes ".h"
+#include "EUTELESCOPE.h"
+
+// lcio includes <.h>
+#include <EVENT/LCEvent.h>
+#include <IMPL/LCCollectionVec.h>
+
+// system includes <>
+#include <map>
+#include <string>
+
+namespace eutelescope {
+
+  //! Exception free, per event cache of LCIO collection lookups
+  /*! LCEvent::getCollection throws a DataNotAvailableException if
+   *  the requested collection is not present. Many processors used
+   *  this to find out whether a collection exists in the current
+   *  event, paying for a throw/catch on every event lacking it (e.g.
+   *  DUT-less events).
+   *
+   *  This class first checks the list of collection names of the
+   *  event and only calls getCollection if the collection is
+   *  actually there, so a missing collection simply results in a
+   *  nullptr. Resolved collections are cached by name until the
+   *  next event is seen.
+   *
+   *  Each lookup is also recorded so that a processor can report at
+   *  the end of the job which collections it touched and how often
+   *  they were missing.
+   *
+   *  Typical usage:
+   *  \code{.cpp}
+   *  LCCollectionVec *col = _collectionCache.get(event, _inputName);
+   *  if (!col) return;
+   *  ...
+   *  // in end()
+   *  _collectionCache.printSummary(name());
+   *  \endcode
+   */
+  class EUTelCollectionCache {
+
+  public:
+    //! Default constructor
+    EUTelCollectionCache();
+
+    //! Get a collection from the event
+    /*! @param event The event to look into
+     *  @param name The collection name
+     *  @return The collection or nullptr if not available
+     */
+    IMPL::LCCollectionVec *get(EVENT::LCEvent *event, std::string const &name);
+
+    //! Check if a collection is available
+    bool has(EVENT::LCEvent *event, std::string const &name) {
+      return get(event, name) != nullptr;
+    }
+
+    //! Add a collection to the event and to the cache
+    /*! Use this instead of LCEvent::addCollection for collections
+     *  which are looked up again via the cache in the same event.
+     */
+    void add(EVENT::LCEvent *event, IMPL::LCCollectionVec *collection,
+             std::string const &name);
+
+    //! Print the collection usage summary
+    /*! Meant to be called from the end() of the owning processor.
+     *
+     *  @param owner The name of the owning processor
+     */
+    void printSummary(std::string const &owner) const;
+
+  private:
+    DISALLOW_COPY_AND_ASSIGN(EUTelCollectionCache)
+
+    //! Drop the cached lookups if @c event is not the cached one
+    void syncEvent(EVENT::LCEvent *event);
+
+    //! Per collection lookup statistics
+    struct Usage {
+      Usage() : found(0), missing(0) {}
+      long found;
+      long missing;
+    };
+
+    //! The event the cached lookups belong to
+    EVENT::LCEvent const *_event;
+
+    //! Run number of the cached event
+    int _runNumber;
+
+    //! Event number of the cached event
+    int _eventNumber;
+
+    //! Resolved collections of the current event
+    std::map<std::string, IMPL::LCCollectionVec *> _cache;
+
+    //! Lookup statistics per collection name
+    std::map<std::string, Usage> _usage;
+  };
+}
+#endif
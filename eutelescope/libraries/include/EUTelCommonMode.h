@@ -0,0 +1,72 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELCOMMONMODE_H
+#define EUTELCOMMONMODE_H 1
+
+// lcio includes <.h>
+#include "LCIOSTLTypes.h"
+
+// system includes <>
+#include <cstddef>
+#include <vector>
+
+namespace eutelescope {
+
+  namespace Utility {
+
+    //! Full frame common mode of one sensor
+    /*! The common mode is the mean pedestal subtracted signal of all
+     *  good pixels which are not hit candidates. A pixel is a hit
+     *  candidate if its pedestal subtracted signal is above
+     *  hitRejectionCut times its noise.
+     *
+     *  @param adcValues Raw signals of the first nPixels pixels
+     *  @param pedestal Pedestals, same order as the signals
+     *  @param noise Noise values, same order as the signals
+     *  @param status Pixel status, only EUTELESCOPE::GOODPIXEL pixels
+     *  are used
+     *  @param nPixels Number of pixels of the sensor
+     *  @param hitRejectionCut Hit candidate threshold in units of noise
+     *  @param maxRejectedPixels The frame is rejected if this many hit
+     *  candidates are found
+     *  @param commonMode The common mode, if the frame is accepted
+     *  @param skippedPixels Incremented by the number of hit candidates
+     *  @return true if the frame is accepted
+     */
+    bool fullFrameCommonMode(EVENT::ShortVec const &adcValues,
+                             EVENT::FloatVec const &pedestal,
+                             EVENT::FloatVec const &noise,
+                             EVENT::ShortVec const &status, size_t nPixels,
+                             float hitRejectionCut, int maxRejectedPixels,
+                             double &commonMode, int &skippedPixels);
+
+    //! Row wise common mode of one sensor
+    /*! The common mode is computed as in fullFrameCommonMode() for each
+     *  row separately. Rows with at least maxRejectedPixelsPerRow hit
+     *  candidates, or without good pixels, are skipped and get a zero
+     *  correction.
+     *
+     *  @param correction The common mode correction of each pixel,
+     *  resized to nRows times rowLength
+     *  @param rowCommonModes The common mode of each accepted row
+     *  @param skippedPixels Incremented by the number of hit candidates
+     *  @return The number of skipped rows
+     */
+    int rowWiseCommonMode(EVENT::ShortVec const &adcValues,
+                          EVENT::FloatVec const &pedestal,
+                          EVENT::FloatVec const &noise,
+                          EVENT::ShortVec const &status, size_t nRows,
+                          size_t rowLength, float hitRejectionCut,
+                          int maxRejectedPixelsPerRow,
+                          std::vector<float> &correction,
+                          std::vector<double> &rowCommonModes,
+                          int &skippedPixels);
+  }
+}
+#endif
@@ -0,0 +1,96 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELETATABLE_H
+#define EUTELETATABLE_H 1
+
+// system includes <>
+#include <cstddef>
+#include <vector>
+
+namespace eutelescope {
+
+  class EUTelEtaFunctionImpl;
+
+  //! Uniformly binned eta correction table
+  /*! EUTelEtaFunctionImpl::getEtaFromCoG performs a binary search
+   *  over the stored bin centers for every call. The eta functions
+   *  produced by EUTelCalculateEtaProcessor are however always
+   *  uniformly binned, so the bin can be computed directly.
+   *
+   *  This class keeps the eta values on a uniform grid together with
+   *  the slope of each bin, so that a correction is one
+   *  multiplication and one addition. Values outside the first and
+   *  last bin center are clamped, as done by getEtaFromCoG.
+   *
+   *  Eta functions with a non uniform binning are resampled onto a
+   *  uniform grid with the same number of bins.
+   */
+  class EUTelEtaTable {
+
+  public:
+    //! Default constructor, an empty table is the identity
+    EUTelEtaTable();
+
+    //! Construct from a stored eta function
+    explicit EUTelEtaTable(EUTelEtaFunctionImpl const &etaFunction);
+
+    //! Construct from the eta values at uniformly spaced bin centers
+    /*! @param firstCenter The center of the first bin
+     *  @param lastCenter The center of the last bin
+     *  @param values The eta values at the bin centers
+     */
+    EUTelEtaTable(double firstCenter, double lastCenter,
+                  std::vector<double> values);
+
+    //! Get Eta for a given CoG value
+    double getEtaFromCoG(double x) const {
+      if (_values.empty())
+        return x;
+      double pos = (x - _firstCenter) * _invBinWidth;
+      if (pos <= 0.)
+        return _values.front();
+      if (pos >= _lastBin)
+        return _values.back();
+      auto bin = static_cast<size_t>(pos);
+      return _values[bin] + _slopes[bin] * (x - _centers[bin]);
+    }
+
+    //! Correct a batch of CoG values in place
+    /*! Meant to correct all the clusters of one sensor in a single
+     *  call.
+     */
+    void getEtaFromCoG(std::vector<double> &xs) const;
+
+    //! The number of bins
+    size_t getNoOfBin() const { return _values.size(); }
+
+  private:
+    //! Precompute the bin centers and slopes
+    void fillSlopes();
+
+    //! Center of the first bin
+    double _firstCenter;
+
+    //! Inverse of the bin width
+    double _invBinWidth;
+
+    //! Index of the last bin as floating point number
+    double _lastBin;
+
+    //! The bin centers
+    std::vector<double> _centers;
+
+    //! The eta values at the bin centers
+    std::vector<double> _values;
+
+    //! The slope between bin i and bin i+1
+    std::vector<double> _slopes;
+  };
+}
+#endif
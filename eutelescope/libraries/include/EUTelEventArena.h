@@ -0,0 +1,183 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELEVENTARENA_H
+#define EUTELEVENTARENA_H 1
+
+// eutelescope includes ".h"
+#include "EUTELESCOPE.h"
+
+// system includes <>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace eutelescope {
+
+  //! Monotonic memory arena for the temporaries of one event
+  /*! Memory is handed out by moving a pointer through large blocks
+   *  and is never freed individually: reset() releases everything at
+   *  once, typically at the beginning of processEvent. Objects made
+   *  with create() are destroyed by reset() in reverse order of
+   *  creation. The blocks are kept, and if an event needed more than
+   *  one block they are replaced by a single one of the total size, so
+   *  after the first busy events the arena does not touch the heap at
+   *  all.
+   *
+   *  This is the equivalent of a std::pmr::monotonic_buffer_resource
+   *  for C++11; EUTelArenaAllocator makes it usable by the standard
+   *  containers. Only temporaries may live in the arena: objects
+   *  handed to LCIO are deleted by the collections and must stay on
+   *  the heap.
+   *
+   *  Typical usage:
+   *  \code{.cpp}
+   *  void MyProcessor::processEvent(LCEvent *event) {
+   *    _eventArena.reset();
+   *    EUTelVirtualCluster *cluster =
+   *        _eventArena.create<EUTelFFClusterImpl>(data);
+   *    ...
+   *  }
+   *  ...
+   *  // in end()
+   *  _eventArena.summarize(name());
+   *  \endcode
+   */
+  class EUTelEventArena {
+
+  public:
+    //! Allocation statistics
+    struct Statistics {
+      //! Number of reset() calls, i.e. events
+      long resets;
+      //! Number of allocate() calls
+      long allocations;
+      //! Bytes handed out in total
+      long long bytes;
+      //! Largest number of bytes used within one event
+      size_t peakBytes;
+      //! Blocks allocated on the heap
+      long blockAllocations;
+      //! Bytes currently reserved in blocks
+      size_t capacity;
+    };
+
+    //! Constructor
+    /*! @param blockSize Size of the first block, the following ones
+     *  are at least as large as the previous one
+     */
+    explicit EUTelEventArena(size_t blockSize = 64 * 1024);
+
+    ~EUTelEventArena();
+
+    //! Uninitialised memory, valid until the next reset()
+    void *allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    //! Construct an object in the arena
+    /*! Its destructor is called by reset(), it must not be deleted.
+     */
+    template <class T, class... Args> T *create(Args &&... args) {
+      void *memory = allocate(sizeof(T), alignof(T));
+      T *object = new (memory) T(std::forward<Args>(args)...);
+      if (!std::is_trivially_destructible<T>::value) {
+        Destructor *destructor = static_cast<Destructor *>(
+            allocate(sizeof(Destructor), alignof(Destructor)));
+        destructor->destroy = &destroy<T>;
+        destructor->object = object;
+        destructor->next = _destructors;
+        _destructors = destructor;
+      }
+      return object;
+    }
+
+    //! Destroy the created objects and release all memory
+    void reset();
+
+    //! Bytes in use since the last reset()
+    size_t used() const { return _usedBefore + _offset; }
+
+    Statistics const &getStatistics() const { return _statistics; }
+
+    //! Write the statistics to the log
+    void summarize(std::string const &owner) const;
+
+  private:
+    DISALLOW_COPY_AND_ASSIGN(EUTelEventArena)
+
+    struct Block {
+      std::unique_ptr<char[]> memory;
+      size_t size;
+    };
+
+    //! Destructor record of a created object, stored in the arena
+    struct Destructor {
+      void (*destroy)(void *);
+      void *object;
+      Destructor *next;
+    };
+
+    template <class T> static void destroy(void *object) {
+      static_cast<T *>(object)->~T();
+    }
+
+    //! Continue in a new block with room for bytes
+    void addBlock(size_t bytes);
+
+    std::vector<Block> _blocks;
+    //! Offset in the last block
+    size_t _offset;
+    //! Bytes used in the blocks before the last one
+    size_t _usedBefore;
+    Destructor *_destructors;
+    Statistics _statistics;
+  };
+
+  //! STL allocator taking its memory from an EUTelEventArena
+  /*! Deallocation is a no-op, containers using it must not outlive
+   *  the next reset() of the arena.
+   */
+  template <class T> class EUTelArenaAllocator {
+
+  public:
+    typedef T value_type;
+
+    explicit EUTelArenaAllocator(EUTelEventArena &arena) : _arena(&arena) {}
+
+    template <class U>
+    EUTelArenaAllocator(EUTelArenaAllocator<U> const &other)
+        : _arena(other.arena()) {}
+
+    T *allocate(size_t n) {
+      return static_cast<T *>(_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *, size_t) {}
+
+    EUTelEventArena *arena() const { return _arena; }
+
+  private:
+    EUTelEventArena *_arena;
+  };
+
+  template <class T, class U>
+  bool operator==(EUTelArenaAllocator<T> const &a,
+                  EUTelArenaAllocator<U> const &b) {
+    return a.arena() == b.arena();
+  }
+
+  template <class T, class U>
+  bool operator!=(EUTelArenaAllocator<T> const &a,
+                  EUTelArenaAllocator<U> const &b) {
+    return !(a == b);
+  }
+}
+#endif
@@ -0,0 +1,263 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELEVENTPIPELINE_H
+#define EUTELEVENTPIPELINE_H 1
+
+// eutelescope includes ".h"
+#include "EUTelBoundedQueue.h"
+
+// system includes <>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace eutelescope {
+
+  //! Event parallel pipeline of processing stages
+  /*! The events are read by a source, passed through a chain of
+   *  stages and handed to a commit function, each step running on its
+   *  own threads and connected by bounded queues. Reading, clustering,
+   *  fitting etc. of different events therefore overlap.
+   *
+   *  Parallel stages are run by several workers which each take the
+   *  next waiting event, so they must not modify shared state. Serial
+   *  stages see one event at a time in input order and may keep state
+   *  (histograms, counters, anything not thread safe). The commit
+   *  function runs on the thread calling run(), also in input order,
+   *  so outputs are written in the same order as by a serial job.
+   *
+   *  The memory is bounded by a fixed number of Event objects which
+   *  are allocated once and recycled: when all of them are in flight
+   *  the source waits until the commit releases one. The source must
+   *  therefore fully overwrite the Event it is given, which at the
+   *  same time lets the events keep their buffers between uses.
+   *
+   *  If any step throws, the pipeline stops, the events in flight are
+   *  dropped and the first exception is rethrown by run().
+   *
+   *  lciomerge runs its matching, merging and writing on it. Marlin
+   *  jobs do not, their processors are called by Marlin one event at
+   *  a time.
+   */
+  template <class Event> class EUTelEventPipeline {
+
+  public:
+    //! Fill the next event, return false at the end of the input
+    typedef std::function<bool(Event &)> Source;
+
+    //! Process or commit one event
+    typedef std::function<void(Event &)> Stage;
+
+    enum StageMode { kParallelStage, kSerialStage };
+
+    //! Constructor
+    /*! @param maxInFlight Number of events between source and commit
+     *  @param nThreads Workers of each parallel stage, 0 to use the
+     *  number of hardware threads
+     */
+    explicit EUTelEventPipeline(size_t maxInFlight = 16,
+                                unsigned int nThreads = 0)
+        : _maxInFlight(std::max<size_t>(maxInFlight, 1)),
+          _nThreads(nThreads > 0
+                        ? nThreads
+                        : std::max(1u, std::thread::hardware_concurrency())),
+          _source(), _stages(), _commit(), _aborted(false), _errorMutex(),
+          _error() {}
+
+    EUTelEventPipeline(EUTelEventPipeline const &) = delete;
+    EUTelEventPipeline &operator=(EUTelEventPipeline const &) = delete;
+
+    void setSource(Source source) { _source = std::move(source); }
+
+    //! Append a stage, the stages are run in the order of addition
+    void addStage(std::string const &name, Stage stage, StageMode mode) {
+      _stages.push_back(StageInfo{name, std::move(stage), mode});
+    }
+
+    void setCommit(Stage commit) { _commit = std::move(commit); }
+
+    //! Process all events of the source
+    /*! @return The number of committed events
+     */
+    size_t run();
+
+  private:
+    //! An event in flight with its position in the input
+    struct Slot {
+      size_t sequence;
+      std::unique_ptr<Event> event;
+    };
+
+    typedef EUTelBoundedQueue<Slot> Queue;
+
+    struct StageInfo {
+      std::string name;
+      Stage stage;
+      StageMode mode;
+    };
+
+    //! Hands out slots in input order from an unordered queue
+    class Reorder {
+    public:
+      Reorder() : _next(0), _waiting() {}
+
+      //! Pop slots from in and call f for each one that is in order
+      template <class F> void drain(Queue &in, F f) {
+        Slot slot;
+        while (in.pop(slot)) {
+          _waiting.emplace(slot.sequence, std::move(slot));
+          auto it = _waiting.begin();
+          while (it != _waiting.end() && it->first == _next) {
+            f(it->second);
+            it = _waiting.erase(it);
+            ++_next;
+          }
+        }
+      }
+
+    private:
+      size_t _next;
+      std::map<size_t, Slot> _waiting;
+    };
+
+    //! Record the first error and unblock all threads
+    void abort(std::vector<std::unique_ptr<Queue>> &queues) {
+      {
+        std::lock_guard<std::mutex> lock(_errorMutex);
+        if (!_error) {
+          _error = std::current_exception();
+        }
+      }
+      _aborted = true;
+      for (auto &queue : queues) {
+        queue->close();
+      }
+    }
+
+    size_t const _maxInFlight;
+    unsigned int const _nThreads;
+
+    Source _source;
+    std::vector<StageInfo> _stages;
+    Stage _commit;
+
+    std::atomic<bool> _aborted;
+    std::mutex _errorMutex;
+    std::exception_ptr _error;
+  };
+
+  template <class Event> size_t EUTelEventPipeline<Event>::run() {
+    _aborted = false;
+    _error = nullptr;
+
+    // queue 0 holds the free events, queue i+1 the input of stage i
+    // and the last one the input of the commit
+    std::vector<std::unique_ptr<Queue>> queues;
+    for (size_t i = 0; i < _stages.size() + 2; ++i) {
+      queues.emplace_back(new Queue(_maxInFlight));
+    }
+    for (size_t i = 0; i < _maxInFlight; ++i) {
+      queues[0]->push(Slot{0, std::unique_ptr<Event>(new Event)});
+    }
+
+    std::vector<std::thread> threads;
+
+    threads.emplace_back([this, &queues] {
+      try {
+        Slot slot;
+        size_t sequence = 0;
+        while (!_aborted && queues[0]->pop(slot)) {
+          if (!_source(*slot.event)) {
+            break;
+          }
+          slot.sequence = sequence++;
+          queues[1]->push(std::move(slot));
+        }
+      } catch (...) {
+        abort(queues);
+      }
+      queues[1]->close();
+    });
+
+    // the last worker of a stage to finish closes the next queue
+    std::vector<std::unique_ptr<std::atomic<unsigned int>>> running;
+    for (size_t iStage = 0; iStage < _stages.size(); ++iStage) {
+      StageInfo const &info = _stages[iStage];
+      Queue &in = *queues[iStage + 1];
+      Queue &out = *queues[iStage + 2];
+      unsigned int const nWorkers =
+          (info.mode == kParallelStage) ? _nThreads : 1;
+      running.emplace_back(new std::atomic<unsigned int>(nWorkers));
+      std::atomic<unsigned int> &nRunning = *running.back();
+
+      for (unsigned int iWorker = 0; iWorker < nWorkers; ++iWorker) {
+        threads.emplace_back([this, &info, &in, &out, &nRunning, &queues] {
+          try {
+            if (info.mode == kParallelStage) {
+              Slot slot;
+              while (in.pop(slot)) {
+                if (!_aborted) {
+                  info.stage(*slot.event);
+                  out.push(std::move(slot));
+                }
+              }
+            } else {
+              Reorder reorder;
+              reorder.drain(in, [this, &info, &out](Slot &slot) {
+                if (!_aborted) {
+                  info.stage(*slot.event);
+                  out.push(std::move(slot));
+                }
+              });
+            }
+          } catch (...) {
+            abort(queues);
+          }
+          if (--nRunning == 0) {
+            out.close();
+          }
+        });
+      }
+    }
+
+    size_t nCommitted = 0;
+    try {
+      Reorder reorder;
+      reorder.drain(*queues.back(), [this, &queues, &nCommitted](Slot &slot) {
+        if (!_aborted) {
+          if (_commit) {
+            _commit(*slot.event);
+          }
+          ++nCommitted;
+          queues[0]->push(std::move(slot));
+        }
+      });
+    } catch (...) {
+      abort(queues);
+    }
+
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    if (_error) {
+      std::rethrow_exception(_error);
+    }
+    return nCommitted;
+  }
+}
+#endif
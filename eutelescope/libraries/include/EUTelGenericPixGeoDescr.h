@@ -85,6 +85,31 @@ namespace eutelescope {
         return this->getPixIndex(path.c_str());
       };
 
+      /** Returns true if the description implements the analytic
+            * interface @see getPixelCenter() and @see getPixelIndex().
+            * Users can then skip the TGeo navigation for single pixels. */
+      virtual bool hasAnalyticPixels() const { return false; }
+
+      /** Analytic position of pixel @param x, @param y: the centre in
+            * the local plane frame is stored in @param posX, @param posY
+            * and the full pixel size in @param pitchX, @param pitchY (all
+            * in mm). Returns false if the pixel does not exist or the
+            * description has no analytic interface. */
+      virtual bool getPixelCenter(int /*x*/, int /*y*/, double & /*posX*/,
+                                  double & /*posY*/, double & /*pitchX*/,
+                                  double & /*pitchY*/) const {
+        return false;
+      }
+
+      /** Analytic pixel index at the local position @param posX, @param
+            * posY (in mm), stored in @param x, @param y. Returns false if
+            * the position is not on a pixel or the description has no
+            * analytic interface. */
+      virtual bool getPixelIndex(double /*posX*/, double /*posY*/, int & /*x*/,
+                                 int & /*y*/) const {
+        return false;
+      }
+
     protected:
       TGeoManager *_tGeoManager;
 
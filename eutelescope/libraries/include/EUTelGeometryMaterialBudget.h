@@ -0,0 +1,125 @@
+/*
+ * File:   EUTelGeometryMaterialBudget.h
+ *
+ */
+#ifndef EUTELGEOMETRYMATERIALBUDGET_H
+#define EUTELGEOMETRYMATERIALBUDGET_H
+
+// EUTELESCOPE
+#include "EUTelGeometryPlaneTable.h"
+
+// Eigen
+#include <Eigen/Core>
+
+// C++
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace eutelescope {
+  namespace geo {
+
+    class EUTelGeometryTelescopeGeoDescription;
+
+    /** @class MaterialBudget
+     * Tabulated material budget (in units of radiation length) of the
+     * telescope planes and of the air gaps between them.
+     *
+     * EUTelGeometryTelescopeGeoDescription::FindRad steps a ray
+     * through the global TGeo navigator, which is slow and not
+     * reentrant. This class does all the ray stepping once at
+     * construction: for every plane X/X0 is sampled over the incidence
+     * angle (uniformly in cos(theta) up to the maximum angle given)
+     * and for every pair of consecutive planes the material between
+     * their surfaces is integrated along the line joining their
+     * centers. A gap spans the full distance between the centers, the
+     * half plane thicknesses at its ends being counted as air.
+     * Lookups are then a table interpolation and do not touch TGeo.
+     *
+     * The incidence angle is assumed to be the only relevant
+     * parameter, i.e. the planes are taken to be homogeneous over
+     * their surface and azimuthally symmetric. If the TGeo description
+     * is not initialized, the planes are treated as slabs of thickness
+     * zSize and radiation length as given in GEAR, the gaps as air.
+     * Processors using it should therefore initialize the TGeo
+     * description first, so that the values do not depend on the
+     * processors run before them.
+     *
+     * Usually obtained via
+     * EUTelGeometryTelescopeGeoDescription::materialBudget()
+     */
+    class MaterialBudget {
+    public:
+      /** Radiation length of air in mm */
+      static constexpr double airRadLength = 304200.;
+
+      /** Build the tables
+       * @param geo The geometry, used for the TGeo ray stepping
+       * @param planeTable The plane constants
+       * @param nBins Number of cos(theta) bins per plane
+       * @param maxAngle Largest tabulated incidence angle in radians,
+       *        larger angles use the value at maxAngle
+       */
+      MaterialBudget(EUTelGeometryTelescopeGeoDescription &geo,
+                     std::shared_ptr<PlaneTable const> planeTable,
+                     size_t nBins = 64, double maxAngle = 1.4);
+
+      /** X/X0 of a plane at normal incidence */
+      double planeX0(int sensorID) const {
+        return _planes[ordinal(sensorID)].front();
+      }
+
+      /** X/X0 of a plane for a given cosine of the incidence angle */
+      double planeX0(int sensorID, double cosIncidence) const;
+
+      /** X/X0 of a plane for a direction given in the local frame */
+      double planeX0Local(int sensorID, Eigen::Vector3d const &localDir) const {
+        return planeX0(sensorID, std::abs(localDir(2)) / localDir.norm());
+      }
+
+      /** X/X0 of a plane for a direction given in the global frame */
+      double planeX0Global(int sensorID,
+                           Eigen::Vector3d const &globalDir) const {
+        auto const &pl = (*_planeTable)[ordinal(sensorID)];
+        return planeX0(sensorID,
+                       std::abs(globalDir.dot(pl.normal)) / globalDir.norm());
+      }
+
+      /** Number of gaps, i.e. number of planes - 1 */
+      size_t nGaps() const { return _gaps.size(); }
+
+      /** X/X0 of the air between the planes with ordinal gap and gap+1
+       *  (the planes being ordered along z as in sensorIDsVec()),
+       *  scaled by 1/cosIncidence */
+      double gapX0(size_t gap, double cosIncidence = 1.) const {
+        return _gaps[gap] / cosIncidence;
+      }
+
+      /** Total X/X0 of all planes and gaps at normal incidence */
+      double totalX0() const;
+
+    private:
+      /** Table index of a sensor ID
+       * @throw InvalidGeometryException if the sensor ID is unknown
+       */
+      int ordinal(int sensorID) const;
+
+      /** The plane constants used to build the tables */
+      std::shared_ptr<PlaneTable const> _planeTable;
+
+      /** Per plane X/X0*cos(theta) sampled uniformly in cos(theta),
+       *  the first entry being normal incidence */
+      std::vector<std::vector<double>> _planes;
+
+      /** Air gaps X/X0 at normal incidence */
+      std::vector<double> _gaps;
+
+      /** Smallest tabulated cos(theta) */
+      double _cosMin;
+
+      /** Width of a cos(theta) bin */
+      double _binWidth;
+    };
+  } // namespace geo
+} // namespace eutelescope
+#endif /* EUTELGEOMETRYMATERIALBUDGET_H */
@@ -0,0 +1,146 @@
+/*
+ * File:   EUTelGeometryPlaneTable.h
+ *
+ */
+#ifndef EUTELGEOMETRYPLANETABLE_H
+#define EUTELGEOMETRYPLANETABLE_H
+
+// EUTELESCOPE
+#include "EUTELESCOPE.h"
+
+// Eigen
+#include <Eigen/Core>
+
+// C++
+#include <array>
+#include <vector>
+
+namespace eutelescope {
+  namespace geo {
+
+    class EUTelGeometryTelescopeGeoDescription;
+
+    /** @struct PlaneConstants
+     * Constants of a single active plane as needed by the per hit/per
+     * track hot paths. All lengths are in mm, angles in radians.
+     */
+    struct PlaneConstants {
+      /** Sensor ID of the plane */
+      int sensorID;
+
+      /** Pixel pitch */
+      double xPitch, yPitch;
+
+      /** Number of pixels */
+      int xNpixels, yNpixels;
+
+      /** Sensor dimensions, zSize being the thickness */
+      double xSize, ySize, zSize;
+
+      /** Intrinsic resolution */
+      double xResolution, yResolution;
+
+      /** Position of the sensor center in the global frame */
+      Eigen::Vector3d position;
+
+      /** Global rotation angles (around X, Y and Z) */
+      Eigen::Vector3d rotationAngles;
+
+      /** Global rotation matrix (excluding the integer flips) */
+      Eigen::Matrix3d rotation;
+
+      /** Full local to global rotation (including the integer flips)
+       *  and translation, identical to the ones of the TGeo description */
+      Eigen::Matrix3d local2Master;
+      Eigen::Vector3d translation;
+
+      /** Plane axes in the global frame */
+      Eigen::Vector3d normal, xAxis, yAxis;
+
+      /** Radiation length of the sensor material */
+      double radLength;
+
+      /** Thickness in units of radiation length at normal incidence */
+      double thicknessX0;
+    };
+
+    /** @class PlaneTable
+     * Immutable snapshot of the active plane constants.
+     *
+     * The geometry getters of EUTelGeometryTelescopeGeoDescription
+     * each perform a std::map lookup into the active plane map. This
+     * class copies all constants once (per run or after an alignment
+     * update) into a dense array indexed by the plane ordinal (the
+     * position of the plane in sensorIDsVec()) plus a dense
+     * sensorID -> ordinal table. Since the snapshot is never modified
+     * after construction it can be shared read-only between threads.
+     *
+     * Usually obtained via EUTelGeometryTelescopeGeoDescription::planeTable()
+     */
+    class PlaneTable {
+    public:
+      /** Build the snapshot. If the TGeo description is initialized
+       *  the local to global transformations are taken from it,
+       *  otherwise they are computed from the GEAR angles and flips */
+      explicit PlaneTable(EUTelGeometryTelescopeGeoDescription &geo);
+
+      /** Build the table from given constants, e.g. of an idealised
+       *  telescope without GEAR file. The planes keep their order
+       * @throw InvalidGeometryException if a sensor ID is repeated
+       */
+      explicit PlaneTable(std::vector<PlaneConstants> const &planes);
+
+      /** Number of planes */
+      size_t size() const { return _planes.size(); }
+
+      /** Ordinal of the plane with given sensor ID, -1 if unknown */
+      int ordinal(int sensorID) const {
+        auto idx = static_cast<size_t>(sensorID - _minSensorID);
+        return (sensorID < _minSensorID || idx >= _ordinals.size())
+                   ? -1
+                   : _ordinals[idx];
+      }
+
+      /** Plane constants by ordinal, no bounds check */
+      PlaneConstants const &operator[](size_t ordinal) const {
+        return _planes[ordinal];
+      }
+
+      /** Plane constants by sensor ID
+       * @throw InvalidGeometryException if the sensor ID is unknown
+       */
+      PlaneConstants const &plane(int sensorID) const;
+
+      /** Transform a point from the local frame into the global one */
+      static void local2Master(PlaneConstants const &pl,
+                               std::array<double, 3> const &localPos,
+                               std::array<double, 3> &globalPos) {
+        Eigen::Map<Eigen::Vector3d const> local(localPos.data());
+        Eigen::Map<Eigen::Vector3d> global(globalPos.data());
+        global = pl.translation + pl.local2Master * local;
+      }
+
+      /** Transform a point from the global frame into the local one */
+      static void master2Local(PlaneConstants const &pl,
+                               std::array<double, 3> const &globalPos,
+                               std::array<double, 3> &localPos) {
+        Eigen::Map<Eigen::Vector3d const> global(globalPos.data());
+        Eigen::Map<Eigen::Vector3d> local(localPos.data());
+        local = pl.local2Master.transpose() * (global - pl.translation);
+      }
+
+      std::vector<PlaneConstants> const &planes() const { return _planes; }
+
+    private:
+      /** Dense array of plane constants */
+      std::vector<PlaneConstants> _planes;
+
+      /** Dense sensorID - _minSensorID -> ordinal table */
+      std::vector<int> _ordinals;
+
+      /** Smallest sensor ID */
+      int _minSensorID;
+    };
+  } // namespace geo
+} // namespace eutelescope
+#endif /* EUTELGEOMETRYPLANETABLE_H */
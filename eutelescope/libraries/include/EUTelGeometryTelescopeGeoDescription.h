@@ -25,6 +25,8 @@
 // EUTELESCOPE
 #include "EUTelGenericPixGeoMgr.h"
 #include "EUTelGeoSupportClasses.h"
+#include "EUTelGeometryMaterialBudget.h"
+#include "EUTelGeometryPlaneTable.h"
 #include "EUTelUtility.h"
 
 // ROOT
@@ -133,7 +135,12 @@ namespace eutelescope {
       std::map<int, TVector3> _planeNormalMap;
       std::map<int, TVector3> _planeXMap;
       std::map<int, TVector3> _planeYMap;
-      std::map<int, double> _planeRadMap;
+
+      /** Snapshot of the plane constants, rebuilt on demand */
+      std::shared_ptr<PlaneTable const> _planeTable;
+
+      /** Tabulated material budget, rebuilt on demand */
+      std::shared_ptr<MaterialBudget const> _materialBudget;
 
       std::vector<std::unique_ptr<EUTelLayer>> _telescopeLayers;
       std::map<int, EUTelLayer *> _telescopeLayerMap;
@@ -393,6 +400,20 @@ namespace eutelescope {
       /** Vector of all sensor IDs */
       const std::vector<int> &sensorIDsVec() const { return _sensorIDVec; };
 
+      /** Immutable snapshot of all plane constants.
+       * Built on first request and rebuilt after any alignment update
+       * or TGeo initialization. Processors should fetch
+       * it once per run and keep the returned pointer.
+       */
+      std::shared_ptr<PlaneTable const> planeTable();
+
+      /** Tabulated material budget of the planes and air gaps.
+       * All TGeo ray stepping is done when building it, so lookups
+       * are cheap and do not touch the global TGeo navigator. Built
+       * on first request, dropped together with the plane table.
+       */
+      std::shared_ptr<MaterialBudget const> materialBudget();
+
       Eigen::Matrix3d rotationMatrixFromAngles(int sensorID);
 
       Eigen::Vector3d getOffsetVector(int sensorID);
@@ -418,6 +439,9 @@ namespace eutelescope {
       void initializeTGeoDescription(std::string const &geomName,
                                      bool dumpRoot);
 
+      /** Whether initializeTGeoDescription has been called */
+      bool isTGeoInitialized() const { return _isGeoInitialized; }
+
       double FindRad(Eigen::Vector3d const &startPt,
                      Eigen::Vector3d const &endPt);
 
@@ -512,7 +536,8 @@ namespace eutelescope {
         _planeNormalMap.clear();
         _planeXMap.clear();
         _planeYMap.clear();
-        _planeRadMap.clear();
+        _planeTable.reset();
+        _materialBudget.reset();
       }
     };
 
@@ -0,0 +1,73 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELMERGINGCLUSTERS_H
+#define EUTELMERGINGCLUSTERS_H 1
+
+// system includes <>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace eutelescope {
+
+  namespace Utility {
+
+    //! Disjoint set forest over the integers 0 ... n-1
+    /*! Union by size with path halving, so any sequence of unite()
+     *  and find() calls takes practically linear time.
+     */
+    class DisjointSets {
+    public:
+      explicit DisjointSets(size_t n);
+
+      //! Representative of the set containing i
+      size_t find(size_t i);
+
+      //! Merge the sets containing i and j
+      void unite(size_t i, size_t j);
+
+      //! The sets with more than one element
+      /*! The elements of each set are sorted and the sets are ordered
+       *  by their smallest element.
+       */
+      std::vector<std::vector<int>> groups();
+
+    private:
+      std::vector<size_t> _parent;
+      std::vector<size_t> _size;
+    };
+
+    //! What the merging cluster search needs to know of a cluster
+    /*! Center and external radius in pixel units, as returned by
+     *  EUTelVirtualCluster::getCenterCoord() and getExternalRadius().
+     */
+    struct ClusterFootprint {
+      int sensorID;
+      int xCenter;
+      int yCenter;
+      float radius;
+    };
+
+    //! Find all pairs of merging clusters
+    /*! Two clusters on the same sensor are merging if the distance of
+     *  their centers is below minimumDistance or, if minimumDistance
+     *  is 0, below the sum of their external radii. The centers are
+     *  sorted into a grid of cells as large as the longest merging
+     *  distance, so only clusters in neighbouring cells are compared
+     *  and the search is linear in the number of clusters.
+     *
+     *  @return The index pairs (i, j), i < j, into clusters in
+     *  lexicographic order
+     */
+    std::vector<std::pair<int, int>>
+    findMergingPairs(std::vector<ClusterFootprint> const &clusters,
+                     float minimumDistance);
+  }
+}
+#endif
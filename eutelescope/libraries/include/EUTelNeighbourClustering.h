@@ -0,0 +1,359 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELNEIGHBOURCLUSTERING_H
+#define EUTELNEIGHBOURCLUSTERING_H 1
+
+// eutelescope includes ".h"
+#include "EUTELESCOPE.h"
+#include "EUTelBaseSparsePixel.h"
+#include "EUTelGeometricPixel.h"
+#include "EUTelMuPixel.h"
+
+// system includes <>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace eutelescope {
+
+  namespace Utility {
+
+    //! Group pixels into clusters of neighbours
+    /*! A cluster is seeded with the first unassigned pixel, every
+     *  unassigned pixel which is a neighbour of a cluster pixel is then
+     *  added to it until no more neighbours are found. The clusters and
+     *  the pixels within them are returned in the order in which they
+     *  were found, which is the order the clustering processors have
+     *  always produced.
+     *
+     *  @param pixels The pixels to cluster, taken by value
+     *  @param areNeighbours Binary predicate on two pixels
+     *  @return The pixels of each cluster
+     */
+    template <class Pixel, class Neighbours>
+    std::vector<std::vector<Pixel>>
+    findNeighbourClusters(std::vector<Pixel> pixels,
+                          Neighbours const &areNeighbours) {
+      std::vector<std::vector<Pixel>> clusters;
+      std::vector<Pixel> newlyAdded;
+
+      while (!pixels.empty()) {
+        // seed a new cluster with the first remaining pixel
+        clusters.emplace_back();
+        std::vector<Pixel> &cluster = clusters.back();
+        newlyAdded.push_back(pixels.front());
+        cluster.push_back(pixels.front());
+        pixels.erase(pixels.begin());
+
+        // process all newly added pixels, new neighbours are appended
+        // while we go
+        while (!newlyAdded.empty()) {
+          bool newlyDone = true;
+          for (auto it = pixels.begin(); it != pixels.end(); ++it) {
+            if (areNeighbours(newlyAdded.front(), *it)) {
+              newlyAdded.push_back(*it);
+              cluster.push_back(*it);
+              pixels.erase(it);
+              newlyDone = false;
+              break;
+            }
+          }
+          // we tested against all remaining pixels, there are no more
+          // neighbours of this one
+          if (newlyDone) {
+            newlyAdded.erase(newlyAdded.begin());
+          }
+        }
+      }
+      return clusters;
+    }
+
+    //! Neighbour criterion of EUTelProcessorSparseClustering
+    /*! Two pixels are neighbours if their squared distance in pixel
+     *  indices is not larger than the cut, 1 for side and 2 for side
+     *  or corner neighbours.
+     */
+    struct SparsePixelNeighbours {
+      int maxDistanceSquared;
+
+      bool operator()(EUTelBaseSparsePixel const &a,
+                      EUTelBaseSparsePixel const &b) const {
+        auto dX = a.getXCoord() - b.getXCoord();
+        auto dY = a.getYCoord() - b.getYCoord();
+        int distance = dX * dX + dY * dY;
+        return distance <= maxDistanceSquared;
+      }
+    };
+
+    //! Neighbour criterion of EUTelProcessorGeometricClustering
+    /*! Two pixels are neighbours if their boxes touch, with 1 % margin
+     *  for the precision of the geometry framework, and their times are
+     *  not further apart than the time cut.
+     */
+    struct GeometricPixelNeighbours {
+      float cutT;
+
+      bool operator()(EUTelGeometricPixel const &a,
+                      EUTelGeometricPixel const &b) const {
+        float dX = a.getPosX() - b.getPosX();
+        float dY = a.getPosY() - b.getPosY();
+        float dT = a.getTime() - b.getTime();
+        float cutX = (a.getBoundaryX() + b.getBoundaryX()) * 1.01;
+        float cutY = (a.getBoundaryY() + b.getBoundaryY()) * 1.01;
+        return (dX * dX <= cutX * cutX) && (dY * dY <= cutY * cutY) &&
+               (dT * dT <= cutT * cutT);
+      }
+    };
+
+    //! Timestamp of a sparse pixel for the time window clustering
+    /*! The hit time of an EUTelMuPixel or EUTelPackedPixel, the time
+     *  of the generic and geometric pixels and 0 for the pixel types
+     *  without time.
+     */
+    inline double sparsePixelTime(EUTelBaseSparsePixel const &pixel,
+                                  SparsePixelType type) {
+      if (type == kEUTelMuPixel || type == kEUTelPackedPixel) {
+        return static_cast<EUTelMuPixel const &>(pixel).getHitTime();
+      } else if (type == kEUTelGenericSparsePixel ||
+                 type == kEUTelGeometricPixel) {
+        return static_cast<EUTelGenericSparsePixel const &>(pixel).getTime();
+      }
+      return 0.;
+    }
+
+    //! Incremental clustering of a time ordered pixel stream
+    /*! Two pixels are neighbours if their squared distance in pixel
+     *  indices is not larger than maxDistanceSquared, as for
+     *  SparsePixelNeighbours, and their times differ by at most
+     *  timeWindow. The pixels have to be added in non-decreasing time
+     *  order.
+     *
+     *  A cluster is complete, and handed to the sink, as soon as a
+     *  pixel arrives more than timeWindow after its last pixel. Only
+     *  the clusters of the last timeWindow are kept, so streams of any
+     *  length can be clustered in bounded memory. The open pixels are
+     *  hashed by position and each new pixel only looks at its own
+     *  neighbourhood, clusters it connects are merged.
+     *
+     *  The sink is called with a std::vector<Pixel> const & holding
+     *  the pixels of a cluster in order of arrival. The clusters are
+     *  completed in the order of their last pixel, flush() completes
+     *  the remaining ones in the order of their first pixel.
+     */
+    template <class Pixel> class TimeWindowClusterer {
+
+    public:
+      TimeWindowClusterer(int maxDistanceSquared, double timeWindow)
+          : _maxDistanceSquared(maxDistanceSquared),
+            _radius(static_cast<int>(
+                std::sqrt(static_cast<double>(maxDistanceSquared)))),
+            _timeWindow(timeWindow), _clusters(), _free(), _positions(),
+            _expiry(), _touched(), _nAdded(0) {}
+
+      //! Add a pixel at index coordinates (x, y) and the given time
+      template <class Sink>
+      void add(Pixel const &pixel, short x, short y, double time,
+               Sink &&sink) {
+        double const windowStart = time - _timeWindow;
+
+        // complete the clusters which nothing can join any more
+        while (!_expiry.empty() && _expiry.front().time < windowStart) {
+          Expiry const expiry = _expiry.front();
+          _expiry.pop_front();
+          Cluster const &cluster = _clusters[expiry.slot];
+          if (cluster.generation == expiry.generation &&
+              cluster.lastTime == expiry.time) {
+            complete(expiry.slot, sink);
+          }
+        }
+
+        // the open clusters this pixel touches
+        _touched.clear();
+        for (int dX = -_radius; dX <= _radius; ++dX) {
+          for (int dY = -_radius; dY <= _radius; ++dY) {
+            if (dX * dX + dY * dY > _maxDistanceSquared) {
+              continue;
+            }
+            auto found = _positions.find(key(x + dX, y + dY));
+            if (found == _positions.end()) {
+              continue;
+            }
+            for (auto const &open : found->second) {
+              if (open.time >= windowStart &&
+                  std::find(_touched.begin(), _touched.end(), open.slot) ==
+                      _touched.end()) {
+                _touched.push_back(open.slot);
+              }
+            }
+          }
+        }
+
+        size_t slot;
+        if (_touched.empty()) {
+          slot = newCluster();
+        } else {
+          // merge into the largest cluster, so each pixel moves rarely
+          slot = _touched.front();
+          for (size_t other : _touched) {
+            if (_clusters[other].pixels.size() >
+                _clusters[slot].pixels.size()) {
+              slot = other;
+            }
+          }
+          for (size_t other : _touched) {
+            if (other != slot) {
+              merge(other, slot);
+            }
+          }
+        }
+
+        Cluster &cluster = _clusters[slot];
+        cluster.pixels.push_back(pixel);
+        cluster.coordinates.emplace_back(x, y);
+        cluster.lastTime = time;
+        _positions[key(x, y)].push_back(OpenPixel{slot, time});
+        _expiry.push_back(Expiry{time, slot, cluster.generation});
+      }
+
+      //! Complete all open clusters
+      template <class Sink> void flush(Sink &&sink) {
+        std::vector<std::pair<size_t, size_t>> open;
+        for (size_t slot = 0; slot < _clusters.size(); ++slot) {
+          if (!_clusters[slot].pixels.empty()) {
+            open.emplace_back(_clusters[slot].firstPixel, slot);
+          }
+        }
+        std::sort(open.begin(), open.end());
+        for (auto const &cluster : open) {
+          complete(cluster.second, sink);
+        }
+        _expiry.clear();
+      }
+
+      //! Number of pixels in open clusters
+      size_t openPixels() const {
+        size_t n = 0;
+        for (auto const &cluster : _clusters) {
+          n += cluster.pixels.size();
+        }
+        return n;
+      }
+
+    private:
+      struct Cluster {
+        std::vector<Pixel> pixels;
+        std::vector<std::pair<short, short>> coordinates;
+        double lastTime;
+        size_t firstPixel;
+        unsigned int generation;
+      };
+
+      struct OpenPixel {
+        size_t slot;
+        double time;
+      };
+
+      struct Expiry {
+        double time;
+        size_t slot;
+        unsigned int generation;
+      };
+
+      static unsigned long long key(int x, int y) {
+        return (static_cast<unsigned long long>(static_cast<unsigned int>(x))
+                << 32) |
+               static_cast<unsigned int>(y);
+      }
+
+      size_t newCluster() {
+        size_t slot;
+        if (_free.empty()) {
+          slot = _clusters.size();
+          _clusters.emplace_back();
+          _clusters.back().generation = 0;
+        } else {
+          slot = _free.back();
+          _free.pop_back();
+        }
+        _clusters[slot].firstPixel = _nAdded++;
+        return slot;
+      }
+
+      //! Move the pixels of cluster from into cluster to
+      void merge(size_t from, size_t to) {
+        Cluster &source = _clusters[from];
+        Cluster &target = _clusters[to];
+        for (auto const &coordinate : source.coordinates) {
+          for (auto &open :
+               _positions[key(coordinate.first, coordinate.second)]) {
+            if (open.slot == from) {
+              open.slot = to;
+            }
+          }
+        }
+        target.pixels.insert(target.pixels.end(), source.pixels.begin(),
+                             source.pixels.end());
+        target.coordinates.insert(target.coordinates.end(),
+                                  source.coordinates.begin(),
+                                  source.coordinates.end());
+        target.lastTime = std::max(target.lastTime, source.lastTime);
+        target.firstPixel = std::min(target.firstPixel, source.firstPixel);
+        release(from);
+      }
+
+      template <class Sink> void complete(size_t slot, Sink &sink) {
+        Cluster &cluster = _clusters[slot];
+        for (auto const &coordinate : cluster.coordinates) {
+          // a pixel firing twice has its position listed twice
+          auto found =
+              _positions.find(key(coordinate.first, coordinate.second));
+          if (found == _positions.end()) {
+            continue;
+          }
+          auto &open = found->second;
+          open.erase(std::remove_if(open.begin(), open.end(),
+                                    [slot](OpenPixel const &pixel) {
+                                      return pixel.slot == slot;
+                                    }),
+                     open.end());
+          if (open.empty()) {
+            _positions.erase(found);
+          }
+        }
+        std::vector<Pixel> const &pixels = cluster.pixels;
+        sink(pixels);
+        release(slot);
+      }
+
+      void release(size_t slot) {
+        Cluster &cluster = _clusters[slot];
+        cluster.pixels.clear();
+        cluster.coordinates.clear();
+        ++cluster.generation;
+        _free.push_back(slot);
+      }
+
+      int const _maxDistanceSquared;
+      int const _radius;
+      double const _timeWindow;
+
+      std::vector<Cluster> _clusters;
+      std::vector<size_t> _free;
+      std::unordered_map<unsigned long long, std::vector<OpenPixel>> _positions;
+      std::deque<Expiry> _expiry;
+      std::vector<size_t> _touched;
+      size_t _nAdded;
+    };
+  }
+}
+#endif
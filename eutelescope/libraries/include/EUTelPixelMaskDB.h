@@ -0,0 +1,152 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELPIXELMASKDB_H
+#define EUTELPIXELMASKDB_H 1
+
+// system includes <>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace eutelescope {
+
+  //! Dense bitmap of the masked pixels of one sensor
+  /*! Pixels outside the index range given at construction are never
+   *  masked.
+   */
+  class EUTelPixelMask {
+
+  public:
+    //! Default constructor, an empty mask
+    EUTelPixelMask();
+
+    //! Construct an empty mask covering the given pixel index range
+    EUTelPixelMask(int xMin, int yMin, int xSize, int ySize);
+
+    //! Check if a pixel is masked
+    bool isMasked(int x, int y) const {
+      auto const dx = static_cast<unsigned>(x - _xMin);
+      auto const dy = static_cast<unsigned>(y - _yMin);
+      if (dx >= static_cast<unsigned>(_xSize) ||
+          dy >= static_cast<unsigned>(_ySize)) {
+        return false;
+      }
+      size_t const bit = static_cast<size_t>(dy) * _xSize + dx;
+      return (_bits[bit >> 6] >> (bit & 63)) & 1u;
+    }
+
+    //! Mask a pixel
+    /*! @return false if the pixel is out of range
+     */
+    bool mask(int x, int y);
+
+    //! Merge another mask of the same range into this one
+    void merge(EUTelPixelMask const &other);
+
+    //! The number of masked pixels
+    size_t count() const;
+
+    int getXMin() const { return _xMin; }
+    int getYMin() const { return _yMin; }
+    int getXSize() const { return _xSize; }
+    int getYSize() const { return _ySize; }
+
+  private:
+    friend class EUTelPixelMaskDB;
+
+    //! Mask the pixels [first, first+length) in row major order
+    void maskRange(size_t first, size_t length);
+
+    //! Check a bit by its row major index
+    bool test(size_t bit) const { return (_bits[bit >> 6] >> (bit & 63)) & 1u; }
+
+    int _xMin;
+    int _yMin;
+    int _xSize;
+    int _ySize;
+
+    //! The bitmap, row major (x running fastest)
+    std::vector<uint64_t> _bits;
+  };
+
+  //! Compact noisy pixel / dead column mask database
+  /*! The noisy pixel and dead column finders store their result as an
+   *  LCIO collection of sparse pixels, which is converted back on the
+   *  first event of every job. For many runs and short jobs this
+   *  conversion is a noticeable part of the startup.
+   *
+   *  This class stores the masks of all sensors in a small binary
+   *  file: a header with the format version and free form provenance
+   *  (key, value) pairs, a sensor directory and per sensor the run
+   *  lengths of alternating unmasked/masked pixels in row major
+   *  order. The file is memory mapped on reading and the run lengths
+   *  are expanded directly into the dense bitmaps.
+   *
+   *  The file layout (version 1, all integers 32 bit little endian):
+   *  \li magic "EUTMASK" + '\\0', version, number of sensors, number
+   *  of provenance bytes, reserved
+   *  \li provenance: "key=value\n" lines padded to 4 bytes
+   *  \li per sensor: sensorID, xMin, yMin, xSize, ySize, number of runs
+   *  \li per sensor: the run lengths, starting with an unmasked run
+   *
+   *  The LCIO collections remain the default and are still written
+   *  by the finder processors.
+   */
+  class EUTelPixelMaskDB {
+
+  public:
+    //! Current file format version
+    static const uint32_t formatVersion = 1;
+
+    //! Default constructor
+    EUTelPixelMaskDB();
+
+    //! Add a sensor, or get the existing mask of it
+    EUTelPixelMask &addSensor(int sensorID, int xMin, int yMin, int xSize,
+                              int ySize);
+
+    //! The mask of a sensor or nullptr if there is none
+    EUTelPixelMask const *getMask(int sensorID) const {
+      auto it = _masks.find(sensorID);
+      return it == _masks.end() ? nullptr : &it->second;
+    }
+
+    //! All masks by sensor ID
+    std::map<int, EUTelPixelMask> const &getMasks() const { return _masks; }
+
+    //! Set a provenance entry (e.g. run number, processor, cuts)
+    /*! Keys must not contain '=' and neither keys nor values may
+     *  contain new lines.
+     */
+    void setProvenance(std::string const &key, std::string const &value);
+
+    //! The provenance entries
+    std::map<std::string, std::string> const &getProvenance() const {
+      return _provenance;
+    }
+
+    //! Write the database to a file
+    /*! @throw lcio::IOException if the file cannot be written
+     */
+    void write(std::string const &fileName) const;
+
+    //! Read a database file via mmap
+    /*! @throw lcio::IOException if the file cannot be read or is not
+     *  a valid mask file of a supported version
+     */
+    static EUTelPixelMaskDB read(std::string const &fileName);
+
+  private:
+    std::map<int, EUTelPixelMask> _masks;
+    std::map<std::string, std::string> _provenance;
+  };
+}
+#endif
@@ -0,0 +1,177 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELPROCESSORPROFILE_H
+#define EUTELPROCESSORPROFILE_H 1
+
+// eutelescope includes ".h"
+#include "EUTELESCOPE.h"
+
+// system includes <>
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace eutelescope {
+
+  //! Per processor timing and counters
+  /*! Collects the wall and CPU time spent in processEvent, the time
+   *  of named sub-phases and arbitrary counters (pixels, clusters,
+   *  hits, tracks, ...), and summarises them at the end of the job.
+   *
+   *  The times are kept in logarithmic histograms (10 bins per
+   *  decade from 1 us to 100 s), which give the mean, the maximum and
+   *  the 50, 90 and 99 % quantiles without storing every value.
+   *
+   *  If the library is built with EUTEL_COUNT_ALLOCATIONS, the global
+   *  operator new counts the heap allocations and the event timer
+   *  reports the number of allocations per event as the counter
+   *  "allocations".
+   *
+   *  At the end of the job the summary is written to the log, printed
+   *  as CDash measurements (see EUTelCDashMeasurement.h) and, if the
+   *  environment variable EUTEL_PROFILE_DIR is set, written as JSON to
+   *  $EUTEL_PROFILE_DIR/<processor name>.profile.json.
+   *
+   *  Typical usage:
+   *  \code{.cpp}
+   *  void MyProcessor::processEvent(LCEvent *event) {
+   *    EUTelProcessorProfile::EventTimer eventTimer(_profile);
+   *    ...
+   *    EUTelProcessorProfile::PhaseTimer fitTimer(_profile, "fit");
+   *    ...
+   *    fitTimer.stop();
+   *    _profile.count("tracks", tracks.size());
+   *  }
+   *  ...
+   *  // in end()
+   *  _profile.summarize(name());
+   *  \endcode
+   */
+  class EUTelProcessorProfile {
+
+  public:
+    //! Logarithmic histogram of durations
+    class TimeHistogram {
+    public:
+      //! Number of bins per decade
+      static const int binsPerDecade = 10;
+      //! Number of decades above 1 us
+      static const int nDecades = 8;
+
+      TimeHistogram();
+
+      //! Add a duration in seconds
+      void fill(double seconds);
+
+      //! Number of entries
+      long entries() const { return _entries; }
+      //! Sum of all durations in seconds
+      double sum() const { return _sum; }
+      //! Mean duration in seconds
+      double mean() const { return _entries ? _sum / _entries : 0.; }
+      //! Longest duration in seconds
+      double max() const { return _max; }
+      //! Approximate quantile in seconds, @c q in [0, 1]
+      double quantile(double q) const;
+
+    private:
+      //! Upper edge of a bin in seconds
+      static double upperEdge(size_t bin);
+
+      //! Bin 0 is the underflow, the last bin the overflow
+      std::vector<long> _bins;
+      long _entries;
+      double _sum;
+      double _max;
+    };
+
+    //! Times one processEvent call, from construction to destruction
+    class EventTimer {
+    public:
+      explicit EventTimer(EUTelProcessorProfile &profile);
+      ~EventTimer();
+
+    private:
+      DISALLOW_COPY_AND_ASSIGN(EventTimer)
+
+      EUTelProcessorProfile &_profile;
+      std::chrono::steady_clock::time_point _wallStart;
+      double _cpuStart;
+      unsigned long _allocationsStart;
+    };
+
+    //! Times a named phase until stop() or destruction
+    class PhaseTimer {
+    public:
+      PhaseTimer(EUTelProcessorProfile &profile, std::string const &phase);
+      ~PhaseTimer() { stop(); }
+
+      //! Stop the timer, further calls have no effect
+      void stop();
+
+    private:
+      DISALLOW_COPY_AND_ASSIGN(PhaseTimer)
+
+      TimeHistogram *_histogram;
+      std::chrono::steady_clock::time_point _start;
+    };
+
+    //! Default constructor
+    EUTelProcessorProfile();
+
+    //! Add to a counter
+    void count(std::string const &counter, long n = 1) {
+      _counters[counter] += n;
+    }
+
+    //! Wall time histogram of processEvent
+    TimeHistogram const &getWallTime() const { return _wallTime; }
+
+    //! CPU time histogram of processEvent
+    TimeHistogram const &getCPUTime() const { return _cpuTime; }
+
+    //! Histogram of a named phase, created if needed
+    TimeHistogram &phase(std::string const &name) { return _phases[name]; }
+
+    //! Events per second of processEvent wall time
+    double getThroughput() const;
+
+    //! True if the library counts heap allocations
+    static bool countsAllocations();
+
+    //! Summarise the profile at the end of the job
+    /*! Writes the log summary, the CDash measurements and, if
+     *  requested by EUTEL_PROFILE_DIR, the JSON file.
+     *
+     *  @param owner The name of the owning processor
+     */
+    void summarize(std::string const &owner) const;
+
+    //! Print the summary to the log
+    void printSummary(std::string const &owner) const;
+
+    //! Write the profile as a JSON object
+    void writeJSON(std::ostream &os, std::string const &owner) const;
+
+    //! Print the main numbers as CDash measurements
+    void printCDash(std::ostream &os, std::string const &owner) const;
+
+  private:
+    DISALLOW_COPY_AND_ASSIGN(EUTelProcessorProfile)
+
+    TimeHistogram _wallTime;
+    TimeHistogram _cpuTime;
+    std::map<std::string, TimeHistogram> _phases;
+    std::map<std::string, long> _counters;
+  };
+}
+#endif
@@ -0,0 +1,429 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELSELECTION_H
+#define EUTELSELECTION_H 1
+
+// eutelescope includes ".h"
+#include "EUTelROI.h"
+
+// system includes <>
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace eutelescope {
+
+  //! Selection of hits and clusters by composable predicates
+  /*! The properties of the objects to be selected are copied into the
+   *  columns of a Table, and a predicate is evaluated over all its rows
+   *  at once, giving a Mask with one bit per object. Predicates are
+   *  combined with &&, || and !, which build the combined predicate as
+   *  a type, so the whole selection is inlined into one loop without
+   *  virtual calls or branches:
+   *
+   *  \code{.cpp}
+   *  selection::Table table;
+   *  for (auto cluster : clusters) {
+   *    table.sensorID.push_back(cluster->getDetectorID());
+   *    table.charge.push_back(cluster->getTotalCharge());
+   *    table.nPixels.push_back(cluster->size());
+   *  }
+   *  auto const cut = selection::SensorIn({0, 1, 2}) &&
+   *                   (selection::ChargeAbove(chargeCuts) ||
+   *                    selection::SizeAtLeast(3));
+   *  selection::Mask mask = selection::select(cut, table);
+   *  for (size_t i : mask.indices()) {
+   *    ...
+   *  }
+   *  \endcode
+   *
+   *  As opposed to the && and || of bool, both operands are always
+   *  evaluated.
+   */
+  namespace selection {
+
+    //! Columns of the objects to be selected
+    /*! The sensorID column defines the number of rows and has to be
+     *  filled, the other ones only if a predicate uses them.
+     */
+    struct Table {
+      std::vector<int> sensorID;
+      //! Position, in the coordinates of the ROIs used
+      std::vector<float> x;
+      std::vector<float> y;
+      std::vector<float> charge;
+      std::vector<float> snr;
+      //! Number of pixels of a cluster
+      std::vector<int> nPixels;
+
+      size_t rows() const { return sensorID.size(); }
+
+      void clear() {
+        sensorID.clear();
+        x.clear();
+        y.clear();
+        charge.clear();
+        snr.clear();
+        nPixels.clear();
+      }
+    };
+
+    //! Result of a selection, one bit per row of a Table
+    class Mask {
+    public:
+      explicit Mask(size_t size = 0)
+          : _words((size + 63) / 64), _size(size) {}
+
+      size_t size() const { return _size; }
+
+      bool operator[](size_t i) const {
+        return (_words[i / 64] >> (i % 64)) & 1;
+      }
+
+      //! Number of selected rows
+      size_t count() const {
+        size_t n = 0;
+        for (std::uint64_t word : _words) {
+          n += std::bitset<64>(word).count();
+        }
+        return n;
+      }
+
+      //! The selected rows in increasing order
+      std::vector<size_t> indices() const {
+        std::vector<size_t> result;
+        result.reserve(count());
+        for (size_t iWord = 0; iWord < _words.size(); ++iWord) {
+          size_t row = iWord * 64;
+          for (std::uint64_t word = _words[iWord]; word; word >>= 1, ++row) {
+            if (word & 1) {
+              result.push_back(row);
+            }
+          }
+        }
+        return result;
+      }
+
+      Mask &operator&=(Mask const &other) {
+        checkSize(other);
+        for (size_t i = 0; i < _words.size(); ++i) {
+          _words[i] &= other._words[i];
+        }
+        return *this;
+      }
+
+      Mask &operator|=(Mask const &other) {
+        checkSize(other);
+        for (size_t i = 0; i < _words.size(); ++i) {
+          _words[i] |= other._words[i];
+        }
+        return *this;
+      }
+
+      //! The bits of the rows 64 i ... 64 i + 63
+      std::uint64_t &word(size_t i) { return _words[i]; }
+
+    private:
+      void checkSize(Mask const &other) const {
+        if (other._size != _size) {
+          throw std::invalid_argument("Selection masks of different size");
+        }
+      }
+
+      std::vector<std::uint64_t> _words;
+      size_t _size;
+    };
+
+    //! Base of all predicates
+    /*! A predicate Derived provides
+     *  - bool operator()(Table const &table, size_t row) const, which
+     *    should be free of branches,
+     *  - void check(Table const &table) const, throwing
+     *    std::invalid_argument if a column it needs is not filled.
+     */
+    template <class Derived> struct Predicate {
+      Derived const &derived() const {
+        return static_cast<Derived const &>(*this);
+      }
+    };
+
+    template <class L, class R> class And : public Predicate<And<L, R>> {
+    public:
+      And(L const &l, R const &r) : _l(l), _r(r) {}
+      bool operator()(Table const &table, size_t row) const {
+        return _l(table, row) & _r(table, row);
+      }
+      void check(Table const &table) const {
+        _l.check(table);
+        _r.check(table);
+      }
+
+    private:
+      L _l;
+      R _r;
+    };
+
+    template <class L, class R> class Or : public Predicate<Or<L, R>> {
+    public:
+      Or(L const &l, R const &r) : _l(l), _r(r) {}
+      bool operator()(Table const &table, size_t row) const {
+        return _l(table, row) | _r(table, row);
+      }
+      void check(Table const &table) const {
+        _l.check(table);
+        _r.check(table);
+      }
+
+    private:
+      L _l;
+      R _r;
+    };
+
+    template <class P> class Not : public Predicate<Not<P>> {
+    public:
+      explicit Not(P const &p) : _p(p) {}
+      bool operator()(Table const &table, size_t row) const {
+        return !_p(table, row);
+      }
+      void check(Table const &table) const { _p.check(table); }
+
+    private:
+      P _p;
+    };
+
+    template <class L, class R>
+    And<L, R> operator&&(Predicate<L> const &l, Predicate<R> const &r) {
+      return And<L, R>(l.derived(), r.derived());
+    }
+
+    template <class L, class R>
+    Or<L, R> operator||(Predicate<L> const &l, Predicate<R> const &r) {
+      return Or<L, R>(l.derived(), r.derived());
+    }
+
+    template <class P> Not<P> operator!(Predicate<P> const &p) {
+      return Not<P>(p.derived());
+    }
+
+    //! Evaluate a predicate for all rows of a table
+    template <class P>
+    Mask select(Predicate<P> const &predicate, Table const &table) {
+      P const &p = predicate.derived();
+      p.check(table);
+      size_t const rows = table.rows();
+      Mask mask(rows);
+      for (size_t begin = 0; begin < rows; begin += 64) {
+        size_t const end = std::min(rows, begin + 64);
+        std::uint64_t bits = 0;
+        for (size_t row = begin; row < end; ++row) {
+          bits |= static_cast<std::uint64_t>(p(table, row)) << (row - begin);
+        }
+        mask.word(begin / 64) = bits;
+      }
+      return mask;
+    }
+
+    //! The elements of objects selected by mask
+    template <class T>
+    std::vector<T> selected(Mask const &mask, std::vector<T> const &objects) {
+      if (mask.size() != objects.size()) {
+        throw std::invalid_argument("Selection mask of different size");
+      }
+      std::vector<T> result;
+      result.reserve(mask.count());
+      for (size_t i : mask.indices()) {
+        result.push_back(objects[i]);
+      }
+      return result;
+    }
+
+    //! Value per sensorID with a default for all other sensors
+    /*! Stored densely, the look up clamps the sensorID to the default
+     *  entry at the end instead of testing it.
+     */
+    template <class T> class SensorTable {
+    public:
+      SensorTable(std::map<int, T> const &values, T defaultValue)
+          : _values() {
+        int maxID = -1;
+        for (auto const &entry : values) {
+          if (entry.first < 0) {
+            throw std::invalid_argument("Negative sensorID in a selection");
+          }
+          maxID = std::max(maxID, entry.first);
+        }
+        _values.assign(maxID + 2, defaultValue);
+        for (auto const &entry : values) {
+          _values[entry.first] = entry.second;
+        }
+      }
+
+      T operator[](int sensorID) const {
+        // negative IDs become large and are clamped as well
+        return _values[std::min(static_cast<size_t>(
+                                    static_cast<unsigned int>(sensorID)),
+                                _values.size() - 1)];
+      }
+
+    private:
+      std::vector<T> _values;
+    };
+
+    namespace detail {
+      template <class T>
+      void requireColumn(Table const &table, std::vector<T> const &column,
+                         char const *name) {
+        if (column.size() != table.rows()) {
+          throw std::invalid_argument(std::string("Selection column ") +
+                                      name + " is not filled");
+        }
+      }
+
+      inline std::map<int, unsigned char>
+      sensorFlags(std::vector<int> const &sensorIDs) {
+        std::map<int, unsigned char> flags;
+        for (int id : sensorIDs) {
+          flags[id] = 1;
+        }
+        return flags;
+      }
+    }
+
+    //! Objects on one of the given sensors
+    class SensorIn : public Predicate<SensorIn> {
+    public:
+      explicit SensorIn(std::vector<int> const &sensorIDs)
+          : _flags(detail::sensorFlags(sensorIDs), 0) {}
+      bool operator()(Table const &table, size_t row) const {
+        return _flags[table.sensorID[row]];
+      }
+      void check(Table const &) const {}
+
+    private:
+      SensorTable<unsigned char> _flags;
+    };
+
+    //! Objects inside a region of interest
+    /*! Same as EUTelROI::isInside, with the detector ID if the ROI has
+     *  one.
+     */
+    class InsideROI : public Predicate<InsideROI> {
+    public:
+      explicit InsideROI(EUTelROI const &roi)
+          : _sensorID(roi.getDetectorID()),
+            _anySensor(roi.getDetectorID() ==
+                       std::numeric_limits<int>::min()),
+            _xBottomLeft(0), _yBottomLeft(0), _xTopRight(0), _yTopRight(0) {
+        roi.getCorners(&_xBottomLeft, &_yBottomLeft, &_xTopRight,
+                       &_yTopRight);
+      }
+      bool operator()(Table const &table, size_t row) const {
+        float const x = table.x[row];
+        float const y = table.y[row];
+        return (x >= _xBottomLeft) & (x <= _xTopRight) &
+               (y >= _yBottomLeft) & (y <= _yTopRight) &
+               (_anySensor | (table.sensorID[row] == _sensorID));
+      }
+      void check(Table const &table) const {
+        detail::requireColumn(table, table.x, "x");
+        detail::requireColumn(table, table.y, "y");
+      }
+
+    private:
+      int _sensorID;
+      bool _anySensor;
+      float _xBottomLeft;
+      float _yBottomLeft;
+      float _xTopRight;
+      float _yTopRight;
+    };
+
+    //! Objects with a charge above a threshold, optionally per sensor
+    class ChargeAbove : public Predicate<ChargeAbove> {
+    public:
+      explicit ChargeAbove(float threshold)
+          : _thresholds(std::map<int, float>(), threshold) {}
+      //! Sensors not in thresholds are not cut on
+      explicit ChargeAbove(std::map<int, float> const &thresholds)
+          : _thresholds(thresholds, -std::numeric_limits<float>::infinity()) {
+      }
+      bool operator()(Table const &table, size_t row) const {
+        return table.charge[row] > _thresholds[table.sensorID[row]];
+      }
+      void check(Table const &table) const {
+        detail::requireColumn(table, table.charge, "charge");
+      }
+
+    private:
+      SensorTable<float> _thresholds;
+    };
+
+    //! Objects with a signal to noise ratio above a threshold,
+    //! optionally per sensor
+    class SNRAbove : public Predicate<SNRAbove> {
+    public:
+      explicit SNRAbove(float threshold)
+          : _thresholds(std::map<int, float>(), threshold) {}
+      //! Sensors not in thresholds are not cut on
+      explicit SNRAbove(std::map<int, float> const &thresholds)
+          : _thresholds(thresholds, -std::numeric_limits<float>::infinity()) {
+      }
+      bool operator()(Table const &table, size_t row) const {
+        return table.snr[row] > _thresholds[table.sensorID[row]];
+      }
+      void check(Table const &table) const {
+        detail::requireColumn(table, table.snr, "snr");
+      }
+
+    private:
+      SensorTable<float> _thresholds;
+    };
+
+    //! Clusters with at least a number of pixels, optionally per sensor
+    class SizeAtLeast : public Predicate<SizeAtLeast> {
+    public:
+      explicit SizeAtLeast(int minPixels)
+          : _minPixels(std::map<int, int>(), minPixels) {}
+      //! Sensors not in minPixels are not cut on
+      explicit SizeAtLeast(std::map<int, int> const &minPixels)
+          : _minPixels(minPixels, std::numeric_limits<int>::min()) {}
+      bool operator()(Table const &table, size_t row) const {
+        return table.nPixels[row] >= _minPixels[table.sensorID[row]];
+      }
+      void check(Table const &table) const {
+        detail::requireColumn(table, table.nPixels, "nPixels");
+      }
+
+    private:
+      SensorTable<int> _minPixels;
+    };
+
+    //! Clusters with at most a number of pixels
+    class SizeAtMost : public Predicate<SizeAtMost> {
+    public:
+      explicit SizeAtMost(int maxPixels) : _maxPixels(maxPixels) {}
+      bool operator()(Table const &table, size_t row) const {
+        return table.nPixels[row] <= _maxPixels;
+      }
+      void check(Table const &table) const {
+        detail::requireColumn(table, table.nPixels, "nPixels");
+      }
+
+    private:
+      int _maxPixels;
+    };
+  }
+}
+#endif
@@ -0,0 +1,174 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELSYNTHETICEVENTGENERATOR_H
+#define EUTELSYNTHETICEVENTGENERATOR_H 1
+
+// eutelescope includes ".h"
+#include "EUTelGenericSparsePixel.h"
+#include "EUTelGeometryMaterialBudget.h"
+#include "EUTelGeometryPlaneTable.h"
+
+// Eigen
+#include <Eigen/Core>
+
+// system includes <>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace eutelescope {
+
+  /** @class EUTelSyntheticEventGenerator
+   * Generates telescope events with known truth for load tests and for
+   * validating the reconstruction.
+   *
+   * Straight tracks are started in front of the first plane with a
+   * Gaussian beam spot and divergence and propagated through the
+   * planes of a PlaneTable in the order of sensorIDsVec(). Optionally
+   * they are deflected by multiple scattering in the planes and in the
+   * air gaps, using the X/X0 of a MaterialBudget and Highland's
+   * formula.
+   *
+   * Each crossing inside a sensor is recorded as a true hit and, if
+   * the plane is efficient for this crossing, fires a cluster of the
+   * pixels closest to the impact point. Cluster sizes follow a given
+   * distribution (at most the 3x3 pixels around the seed). Each plane
+   * additionally gets uniformly distributed single pixel noise on the
+   * pixels not fired yet.
+   *
+   * Misalignments are applied to the true planes only: the pixels are
+   * fired where the particle crosses the misaligned sensor, so a
+   * reconstruction with the nominal geometry sees the misalignment.
+   *
+   * All lengths are in mm, angles in radians, energies in GeV. The
+   * output is reproducible for a given seed.
+   */
+  class EUTelSyntheticEventGenerator {
+  public:
+    /** Shift and rotation of a true plane in its local frame */
+    struct Misalignment {
+      double x, y, rotZ;
+    };
+
+    /** Parameters of the generated events */
+    struct Config {
+      Config();
+
+      /** Beam energy, used for the multiple scattering */
+      double beamEnergy;
+
+      /** Mean number of tracks per event (Poisson) */
+      double tracksPerEvent;
+
+      /** Gaussian beam spot size in x and y at the first plane */
+      double beamSpotX, beamSpotY;
+
+      /** Gaussian spread of the track slopes */
+      double beamDivergence;
+
+      /** Deflect the tracks in the planes and air gaps */
+      bool multipleScattering;
+
+      /** Probability of a noise hit per pixel and event */
+      double noiseOccupancy;
+
+      /** Relative probabilities of cluster sizes 1, 2, ... 9 */
+      std::vector<double> clusterSizeProbabilities;
+
+      /** Hit efficiency per sensor ID, default 1 */
+      std::map<int, double> efficiency;
+
+      /** Misalignment per sensor ID, default none */
+      std::map<int, Misalignment> misalignment;
+
+      /** Seed of the random number generator */
+      unsigned seed;
+    };
+
+    /** A particle crossing a sensor */
+    struct TrueHit {
+      int sensorID;
+      /** Track number within the event */
+      int track;
+      /** Crossing point in the global frame */
+      Eigen::Vector3d position;
+      /** False if the plane was inefficient for this crossing */
+      bool detected;
+    };
+
+    /** A cluster, given as range of the pixels of its plane */
+    struct Cluster {
+      size_t begin, end;
+      /** Index into Event::trueHits, -1 for noise */
+      int trueHit;
+    };
+
+    /** Fired pixels and clusters of one plane */
+    struct PlaneData {
+      int sensorID;
+      std::vector<EUTelGenericSparsePixel> pixels;
+      std::vector<Cluster> clusters;
+    };
+
+    struct Event {
+      /** One entry per plane, in the order of the plane table */
+      std::vector<PlaneData> planes;
+      std::vector<TrueHit> trueHits;
+      int nTracks;
+    };
+
+    /** @param planeTable The nominal geometry
+     *  @param materialBudget Needed for multiple scattering only, may
+     *         be null otherwise
+     *  @param config The event parameters
+     */
+    EUTelSyntheticEventGenerator(
+        std::shared_ptr<geo::PlaneTable const> planeTable,
+        std::shared_ptr<geo::MaterialBudget const> materialBudget,
+        Config const &config);
+
+    /** Generate the next event. The buffers of event are reused, so
+     *  passing the same event each time avoids reallocations. */
+    void generate(Event &event);
+
+  private:
+    /** Misalignment of a plane, as rotation cosine and sine */
+    struct TruePlane {
+      double efficiency;
+      double shiftX, shiftY;
+      double cosRot, sinRot;
+    };
+
+    void addTrack(Event &event, int track);
+
+    void addCluster(PlaneData &plane, geo::PlaneConstants const &pl,
+                    double x, double y, int trueHit);
+
+    void addNoise(PlaneData &plane, geo::PlaneConstants const &pl);
+
+    /** Deflect the direction by a Gaussian kink of given X/X0 */
+    void scatter(Eigen::Vector3d &direction, double radLength);
+
+    std::shared_ptr<geo::PlaneTable const> _planeTable;
+    std::shared_ptr<geo::MaterialBudget const> _materialBudget;
+    Config _config;
+    std::vector<TruePlane> _truePlanes;
+
+    /** Sorted addresses of the fired pixels of a plane, for addNoise */
+    std::vector<int> _occupied;
+
+    std::mt19937 _rng;
+    std::discrete_distribution<int> _clusterSize;
+    std::normal_distribution<double> _gauss;
+    std::uniform_real_distribution<double> _uniform;
+  };
+}
+#endif
@@ -0,0 +1,94 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELTHREADPOOL_H
+#define EUTELTHREADPOOL_H 1
+
+// system includes <>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace eutelescope {
+
+  //! Fixed size pool of worker threads for data parallel loops
+  /*! The workers are started once and sleep between calls, so that
+   *  iterative procedures evaluating the same function many times
+   *  (minimisers, estimators) do not pay for creating and joining
+   *  threads at every evaluation.
+   *
+   *  run() executes the jobs 0 ... nJobs-1 and blocks until all of
+   *  them are done; the calling thread takes part in the work. The
+   *  jobs are handed out in increasing order, which job ends up on
+   *  which thread is not defined. Results should therefore be written
+   *  to per job slots and combined by the caller afterwards.
+   *
+   *  run() must not be called concurrently or from inside a job.
+   */
+  class EUTelThreadPool {
+
+  public:
+    //! Constructor
+    /*! @param nThreads Number of threads working on a run() including
+     *  the calling one, 0 to use the number of hardware threads
+     */
+    explicit EUTelThreadPool(unsigned int nThreads = 0);
+
+    //! Destructor, stops and joins the workers
+    ~EUTelThreadPool();
+
+    EUTelThreadPool(EUTelThreadPool const &) = delete;
+    EUTelThreadPool &operator=(EUTelThreadPool const &) = delete;
+
+    //! Number of threads working on a run(), including the caller
+    size_t size() const { return _workers.size() + 1; }
+
+    //! Execute job(i) for i in [0, nJobs) and wait for all of them
+    /*! If a job throws, the remaining jobs are still executed and the
+     *  first exception is rethrown to the caller.
+     */
+    void run(std::function<void(size_t)> const &job, size_t nJobs);
+
+  private:
+    //! Main loop of the worker threads
+    void work();
+
+    //! Execute jobs of the current run until none is left
+    /*! Called with _mutex held through lock, returns with it held.
+     */
+    void drain(std::unique_lock<std::mutex> &lock);
+
+    std::vector<std::thread> _workers;
+
+    std::mutex _mutex;
+
+    //! Signals a new run or the stop request to the workers
+    std::condition_variable _wake;
+
+    //! Signals the completion of the last job to the caller
+    std::condition_variable _done;
+
+    std::function<void(size_t)> const *_job;
+    size_t _nJobs;
+    size_t _nextJob;
+    size_t _nPending;
+
+    //! Counts the runs, lets the workers tell a new run from a
+    //! spurious wake up
+    unsigned long _generation;
+
+    bool _stop;
+
+    std::exception_ptr _error;
+  };
+}
+#endif
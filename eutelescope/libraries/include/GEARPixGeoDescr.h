@@ -14,7 +14,7 @@
 #include <utility> //std::pair
 
 // EUTELESCOPE
-#include "EUTelGenericPixGeoDescr.h"
+#include "EUTelAnalyticPixGeoDescr.h"
 
 // ROOT
 #include "TGeoMaterial.h"
@@ -35,10 +35,17 @@ namespace eutelescope {
       std::string getPixName(int, int);
       std::pair<int, int> getPixIndex(char const *);
 
+      bool hasAnalyticPixels() const { return true; }
+      bool getPixelCenter(int x, int y, double &posX, double &posY,
+                          double &pitchX, double &pitchY) const;
+      bool getPixelIndex(double posX, double posY, int &x, int &y) const;
+
     protected:
       TGeoMaterial *matSi;
       TGeoMedium *Si;
       TGeoVolume *plane;
+      // The uniform pixel matrix, set up at run time from the GEAR file
+      EUTelPixelAxisRegion _regionX, _regionY;
     };
 
   } // namespace geo
@@ -139,6 +139,10 @@ namespace eutelescope {
       os << "kEUTelGenericSparsePixel";
     else if (type == kEUTelGeometricPixel)
       os << "kEUTelGeometricPixel";
+    else if (type == kEUTelMuPixel)
+      os << "kEUTelMuPixel";
+    else if (type == kEUTelPackedPixel)
+      os << "kEUTelPackedPixel";
     // add here your type
     else if (type == kUnknownPixelType)
       os << "kUnknownPixelType";
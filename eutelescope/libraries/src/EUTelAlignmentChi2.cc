@@ -0,0 +1,165 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+// eutelescope includes ".h"
+#include "EUTelAlignmentChi2.h"
+
+// system includes <>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <thread>
+
+using namespace eutelescope;
+
+namespace {
+  //! Smallest number of pairs worth a thread of its own
+  size_t const minPairsPerThread = 1 << 16;
+}
+
+EUTelAlignmentChi2::EUTelAlignmentChi2(unsigned int nThreads)
+    : _nThreads(nThreads), _measX(), _measY(), _predX(), _predY() {
+  if (_nThreads == 0) {
+    _nThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+}
+
+void EUTelAlignmentChi2::reserve(size_t n) {
+  _measX.reserve(n);
+  _measY.reserve(n);
+  _predX.reserve(n);
+  _predY.reserve(n);
+}
+
+void EUTelAlignmentChi2::addHitPair(double measX, double measY, double predX,
+                                    double predY) {
+  _measX.push_back(measX);
+  _measY.push_back(measY);
+  _predX.push_back(predX);
+  _predY.push_back(predY);
+}
+
+void EUTelAlignmentChi2::clear() {
+  _measX.clear();
+  _measY.clear();
+  _predX.clear();
+  _predY.clear();
+}
+
+void EUTelAlignmentChi2::accumulate(double const *rot, double const *off,
+                                    double cut, size_t first, size_t last,
+                                    Sums &sums) const {
+  double const *const mx = _measX.data();
+  double const *const my = _measY.data();
+  double const *const px = _predX.data();
+  double const *const py = _predY.data();
+
+  double const r00 = rot[0], r01 = rot[1], r10 = rot[2], r11 = rot[3];
+  double const ox = off[0], oy = off[1];
+  // a cut of zero means no cut
+  double const maxDistance = (cut == 0.) ? HUGE_VAL : cut;
+
+  double chi2 = 0., sdx = 0., sdy = 0., sdxu = 0., sdxv = 0., sdyu = 0.,
+         sdyv = 0., n = 0.;
+  for (size_t i = first; i < last; ++i) {
+    double const dx = r00 * mx[i] + r01 * my[i] + ox - px[i];
+    double const dy = r10 * mx[i] + r11 * my[i] + oy - py[i];
+    double const distance = (dx * dx + dy * dy) / 100.;
+    double const keep = (distance < maxDistance) ? 1. : 0.;
+    double const kdx = keep * dx;
+    double const kdy = keep * dy;
+    chi2 += keep * distance;
+    sdx += kdx;
+    sdy += kdy;
+    sdxu += kdx * mx[i];
+    sdxv += kdx * my[i];
+    sdyu += kdy * mx[i];
+    sdyv += kdy * my[i];
+    n += keep;
+  }
+  sums.chi2 = chi2;
+  sums.dx = sdx;
+  sums.dy = sdy;
+  sums.dxu = sdxu;
+  sums.dxv = sdxv;
+  sums.dyu = sdyu;
+  sums.dyv = sdyv;
+  sums.n = n;
+}
+
+double EUTelAlignmentChi2::evaluate(double const *par, double cut,
+                                    double *grad, size_t *nUsed) const {
+
+  double const sx = std::sin(par[2]), cx = std::cos(par[2]);
+  double const sy = std::sin(par[3]), cy = std::cos(par[3]);
+  double const sz = std::sin(par[4]), cz = std::cos(par[4]);
+
+  // rotation as used by EUTelAlign, row major
+  double const rot[4] = {cy * cz, -sx * sy * cz + cx * sz, -cy * sz,
+                         sx * sy * sz + cx * cz};
+
+  size_t const n = size();
+  size_t const nChunks = std::max<size_t>(
+      1, std::min<size_t>(_nThreads, n / minPairsPerThread));
+
+  std::vector<Sums> partial(nChunks);
+  if (nChunks == 1) {
+    accumulate(rot, par, cut, 0, n, partial[0]);
+  } else {
+    std::vector<std::thread> threads;
+    threads.reserve(nChunks - 1);
+    size_t const chunk = (n + nChunks - 1) / nChunks;
+    for (size_t c = 1; c < nChunks; ++c) {
+      size_t const first = std::min(n, c * chunk);
+      size_t const last = std::min(n, first + chunk);
+      threads.emplace_back(&EUTelAlignmentChi2::accumulate, this, rot, par,
+                           cut, first, last, std::ref(partial[c]));
+    }
+    accumulate(rot, par, cut, 0, std::min(n, chunk), partial[0]);
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+
+  Sums total = {0., 0., 0., 0., 0., 0., 0., 0.};
+  for (auto const &sums : partial) {
+    total.chi2 += sums.chi2;
+    total.dx += sums.dx;
+    total.dy += sums.dy;
+    total.dxu += sums.dxu;
+    total.dxv += sums.dxv;
+    total.dyu += sums.dyu;
+    total.dyv += sums.dyv;
+    total.n += sums.n;
+  }
+
+  if (grad) {
+    // derivatives of the rotation elements (r00, r01, r10, r11)
+    double const dRdx[4] = {0., -cx * sy * cz - sx * sz, 0.,
+                            cx * sy * sz - sx * cz};
+    double const dRdy[4] = {-sy * cz, -sx * cy * cz, sy * sz, sx * cy * sz};
+    double const dRdz[4] = {-cy * sz, sx * sy * sz + cx * cz, -cy * cz,
+                            sx * sy * cz - cx * sz};
+    double const g[4] = {total.dxu, total.dxv, total.dyu, total.dyv};
+    double const scale = 2. / 100.;
+
+    grad[0] = scale * total.dx;
+    grad[1] = scale * total.dy;
+    grad[2] = scale * (dRdx[0] * g[0] + dRdx[1] * g[1] + dRdx[2] * g[2] +
+                       dRdx[3] * g[3]);
+    grad[3] = scale * (dRdy[0] * g[0] + dRdy[1] * g[1] + dRdy[2] * g[2] +
+                       dRdy[3] * g[3]);
+    grad[4] = scale * (dRdz[0] * g[0] + dRdz[1] * g[1] + dRdz[2] * g[2] +
+                       dRdz[3] * g[3]);
+  }
+  if (nUsed) {
+    *nUsed = static_cast<size_t>(total.n);
+  }
+  return total.chi2;
+}
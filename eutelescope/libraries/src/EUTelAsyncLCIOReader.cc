@@ -0,0 +1,231 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+// eutelescope includes ".h"
+#include "EUTelAsyncLCIOReader.h"
+
+// lcio includes <.h>
+#include <EVENT/LCParameters.h>
+#include <EVENT/LCRunHeader.h>
+#include <Exceptions.h>
+#include <IMPL/LCCollectionVec.h>
+#include <IO/LCEventListener.h>
+#include <IO/LCReader.h>
+#include <IO/LCRunListener.h>
+#include <IOIMPL/LCFactory.h>
+#include <lcio.h>
+
+// system includes <>
+#include <algorithm>
+#include <exception>
+
+// LCIO before 2.13 keeps global state in its SIO layer, reading on
+// other threads would race with any other reader or writer of the job
+#ifdef LCIO_VERSION_GE
+#if LCIO_VERSION_GE(2, 13)
+#define EUTEL_LCIO_THREAD_SAFE 1
+#endif
+#endif
+
+using namespace eutelescope;
+
+namespace {
+  //! Copy the int, float and string parameters
+  void copyParameters(EVENT::LCParameters const &from,
+                      EVENT::LCParameters &to) {
+    EVENT::StringVec keys;
+    from.getIntKeys(keys);
+    for (auto const &key : keys) {
+      EVENT::IntVec values;
+      from.getIntVals(key, values);
+      to.setValues(key, values);
+    }
+    keys.clear();
+    from.getFloatKeys(keys);
+    for (auto const &key : keys) {
+      EVENT::FloatVec values;
+      from.getFloatVals(key, values);
+      to.setValues(key, values);
+    }
+    keys.clear();
+    from.getStringKeys(keys);
+    for (auto const &key : keys) {
+      EVENT::StringVec values;
+      from.getStringVals(key, values);
+      to.setValues(key, values);
+    }
+  }
+
+  //! Thrown out of readStream() when the reader is closed
+  struct Stopped {};
+
+  //! Pushes the records of readStream() into a queue
+  class QueueListener : public IO::LCRunListener, public IO::LCEventListener {
+  public:
+    explicit QueueListener(
+        EUTelBoundedQueue<EUTelAsyncLCIOReader::Entry> &queue)
+        : _queue(queue) {}
+
+    // called in update mode, before the process methods
+    void modifyRunHeader(EVENT::LCRunHeader *input) {
+      auto runHeader = std::make_unique<IMPL::LCRunHeaderImpl>();
+      runHeader->setRunNumber(input->getRunNumber());
+      runHeader->setDetectorName(input->getDetectorName());
+      runHeader->setDescription(input->getDescription());
+      for (auto const &detector : *input->getActiveSubdetectors()) {
+        runHeader->addActiveSubdetector(detector);
+      }
+      copyParameters(input->getParameters(), runHeader->parameters());
+      EUTelAsyncLCIOReader::Entry entry;
+      entry.record.runHeader = std::move(runHeader);
+      push(std::move(entry));
+    }
+
+    void modifyEvent(EVENT::LCEvent *input) {
+      EUTelAsyncLCIOReader::Entry entry;
+      entry.record.event = EUTelAsyncLCIOReader::detachEvent(input);
+      push(std::move(entry));
+    }
+
+    void processRunHeader(EVENT::LCRunHeader *) {}
+    void processEvent(EVENT::LCEvent *) {}
+
+  private:
+    void push(EUTelAsyncLCIOReader::Entry entry) {
+      if (!_queue.push(std::move(entry))) {
+        throw Stopped();
+      }
+    }
+
+    EUTelBoundedQueue<EUTelAsyncLCIOReader::Entry> &_queue;
+  };
+}
+
+EUTelAsyncLCIOReader::EUTelAsyncLCIOReader(
+    std::vector<std::string> const &fileNames, size_t readAhead,
+    unsigned int nThreads)
+    : _fileNames(fileNames), _workers(), _currentFile(0) {
+  if (!isSupported()) {
+    throw lcio::Exception("EUTelAsyncLCIOReader needs LCIO 2.13 or later");
+  }
+  size_t const nWorkers =
+      std::max<size_t>(1, std::min<size_t>(nThreads, _fileNames.size()));
+  for (size_t iWorker = 0; iWorker < nWorkers; ++iWorker) {
+    _workers.push_back(std::make_unique<Worker>(readAhead));
+  }
+  for (size_t iWorker = 0; iWorker < nWorkers; ++iWorker) {
+    _workers[iWorker]->thread =
+        std::thread(&EUTelAsyncLCIOReader::decode, this, iWorker);
+  }
+}
+
+EUTelAsyncLCIOReader::~EUTelAsyncLCIOReader() { close(); }
+
+bool EUTelAsyncLCIOReader::isSupported() {
+#ifdef EUTEL_LCIO_THREAD_SAFE
+  return true;
+#else
+  return false;
+#endif
+}
+
+void EUTelAsyncLCIOReader::decode(size_t iWorker) {
+  Worker &worker = *_workers[iWorker];
+  QueueListener listener(worker.queue);
+
+  for (size_t iFile = iWorker; iFile < _fileNames.size();
+       iFile += _workers.size()) {
+    std::unique_ptr<IO::LCReader> reader(
+        IOIMPL::LCFactory::getInstance()->createLCReader());
+    reader->registerLCRunListener(&listener);
+    reader->registerLCEventListener(&listener);
+    Entry end;
+    try {
+      reader->open(_fileNames[iFile]);
+      reader->readStream();
+      reader->close();
+    } catch (Stopped &) {
+      return;
+    } catch (std::exception &e) {
+      end.error = _fileNames[iFile] + ": " + e.what();
+    }
+
+    // the end of the file, or of the input after an error
+    bool const failed = !end.error.empty();
+    if (!worker.queue.push(std::move(end)) || failed) {
+      return;
+    }
+  }
+}
+
+bool EUTelAsyncLCIOReader::readNextRecord(Record &record) {
+  while (_currentFile < _fileNames.size()) {
+    Worker &worker = *_workers[_currentFile % _workers.size()];
+    Entry next;
+    if (!worker.queue.pop(next)) {
+      // closed
+      return false;
+    }
+    if (next.record.runHeader || next.record.event) {
+      record = std::move(next.record);
+      return true;
+    }
+    if (!next.error.empty()) {
+      _currentFile = _fileNames.size();
+      throw lcio::IOException(next.error);
+    }
+    ++_currentFile;
+  }
+  return false;
+}
+
+std::unique_ptr<IMPL::LCEventImpl> EUTelAsyncLCIOReader::readNextEvent() {
+  Record record;
+  while (readNextRecord(record)) {
+    if (record.event) {
+      return std::move(record.event);
+    }
+  }
+  return nullptr;
+}
+
+void EUTelAsyncLCIOReader::close() {
+  for (auto &worker : _workers) {
+    worker->queue.close();
+  }
+  for (auto &worker : _workers) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+  _currentFile = _fileNames.size();
+}
+
+std::unique_ptr<IMPL::LCEventImpl>
+EUTelAsyncLCIOReader::detachEvent(EVENT::LCEvent *input) {
+  auto event = std::make_unique<IMPL::LCEventImpl>();
+  event->setRunNumber(input->getRunNumber());
+  event->setEventNumber(input->getEventNumber());
+  event->setTimeStamp(input->getTimeStamp());
+  event->setDetectorName(input->getDetectorName());
+  copyParameters(input->getParameters(), event->parameters());
+
+  std::vector<std::string> const names = *input->getCollectionNames();
+  for (auto const &name : names) {
+    EVENT::LCCollection *collection = input->takeCollection(name);
+    // takeCollection() marks the collection transient, an LCWriter would
+    // then leave it out of the output
+    auto collectionVec = dynamic_cast<IMPL::LCCollectionVec *>(collection);
+    if (collectionVec) {
+      collectionVec->setTransient(false);
+    }
+    event->addCollection(collection, name);
+  }
+  return event;
+}
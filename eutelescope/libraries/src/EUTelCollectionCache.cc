@@ -0,0 +1,79 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+// eutelescope includes ".h"
+#include "EUTelCollectionCache.h"
+
+// system includes <>
+#include <algorithm>
+#include <vector>
+
+using namespace eutelescope;
+
+EUTelCollectionCache::EUTelCollectionCache()
+    : _event(nullptr), _runNumber(-1), _eventNumber(-1), _cache(),
+      _usage() {}
+
+void EUTelCollectionCache::syncEvent(EVENT::LCEvent *event) {
+  // the reader might re-use the event object, so the event and run
+  // numbers have to be checked as well
+  if (event == _event && event->getRunNumber() == _runNumber &&
+      event->getEventNumber() == _eventNumber) {
+    return;
+  }
+  _cache.clear();
+  _event = event;
+  _runNumber = event->getRunNumber();
+  _eventNumber = event->getEventNumber();
+}
+
+IMPL::LCCollectionVec *EUTelCollectionCache::get(EVENT::LCEvent *event,
+                                                 std::string const &name) {
+  syncEvent(event);
+
+  Usage &usage = _usage[name];
+  auto it = _cache.find(name);
+  if (it != _cache.end()) {
+    ++usage.found;
+    return it->second;
+  }
+
+  // only missing collections are not cached: the owning processor
+  // might add them to the event later on
+  std::vector<std::string> const *names = event->getCollectionNames();
+  if (std::find(names->begin(), names->end(), name) == names->end()) {
+    ++usage.missing;
+    return nullptr;
+  }
+
+  auto collection =
+      dynamic_cast<IMPL::LCCollectionVec *>(event->getCollection(name));
+  _cache[name] = collection;
+  ++usage.found;
+  return collection;
+}
+
+void EUTelCollectionCache::add(EVENT::LCEvent *event,
+                               IMPL::LCCollectionVec *collection,
+                               std::string const &name) {
+  syncEvent(event);
+  event->addCollection(collection, name);
+  _cache[name] = collection;
+}
+
+void EUTelCollectionCache::printSummary(std::string const &owner) const {
+  streamlog_out(MESSAGE4) << owner << " touched " << _usage.size()
+                          << " collection(s):" << std::endl;
+  for (auto const &entry : _usage) {
+    streamlog_out(MESSAGE4) << "  " << entry.first
+                            << ": found " << entry.second.found
+                            << " times, missing " << entry.second.missing
+                            << " times" << std::endl;
+  }
+}
@@ -0,0 +1,91 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+// eutelescope includes ".h"
+#include "EUTelCommonMode.h"
+#include "EUTELESCOPE.h"
+
+// system includes <>
+#include <algorithm>
+
+using namespace eutelescope;
+
+namespace {
+  //! Sum of the pedestal subtracted signals of the accepted pixels in
+  //! [begin, end), returns the number of accepted pixels
+  int sumRange(EVENT::ShortVec const &adcValues,
+               EVENT::FloatVec const &pedestal, EVENT::FloatVec const &noise,
+               EVENT::ShortVec const &status, size_t begin, size_t end,
+               float hitRejectionCut, double &pixelSum, int &hitPixels) {
+    int goodPixel = 0;
+    for (size_t iPixel = begin; iPixel < end; ++iPixel) {
+      bool isHit = ((adcValues[iPixel] - pedestal[iPixel]) >
+                    hitRejectionCut * noise[iPixel]);
+      bool isGood = (status[iPixel] == EUTELESCOPE::GOODPIXEL);
+      if (!isHit && isGood) {
+        pixelSum += adcValues[iPixel] - pedestal[iPixel];
+        ++goodPixel;
+      } else if (isHit) {
+        ++hitPixels;
+      }
+    }
+    return goodPixel;
+  }
+}
+
+bool Utility::fullFrameCommonMode(
+    EVENT::ShortVec const &adcValues, EVENT::FloatVec const &pedestal,
+    EVENT::FloatVec const &noise, EVENT::ShortVec const &status,
+    size_t nPixels, float hitRejectionCut, int maxRejectedPixels,
+    double &commonMode, int &skippedPixels) {
+  double pixelSum = 0.;
+  int hitPixels = 0;
+  int goodPixel = sumRange(adcValues, pedestal, noise, status, 0, nPixels,
+                           hitRejectionCut, pixelSum, hitPixels);
+  skippedPixels += hitPixels;
+
+  if ((hitPixels < maxRejectedPixels) && (goodPixel != 0)) {
+    commonMode = pixelSum / goodPixel;
+    return true;
+  }
+  return false;
+}
+
+int Utility::rowWiseCommonMode(
+    EVENT::ShortVec const &adcValues, EVENT::FloatVec const &pedestal,
+    EVENT::FloatVec const &noise, EVENT::ShortVec const &status,
+    size_t nRows, size_t rowLength, float hitRejectionCut,
+    int maxRejectedPixelsPerRow, std::vector<float> &correction,
+    std::vector<double> &rowCommonModes, int &skippedPixels) {
+  correction.assign(nRows * rowLength, 0.);
+  rowCommonModes.clear();
+
+  int skippedRows = 0;
+  for (size_t iRow = 0; iRow < nRows; ++iRow) {
+    size_t const begin = iRow * rowLength;
+    double pixelSum = 0.;
+    int hitPixels = 0;
+    int goodPixel =
+        sumRange(adcValues, pedestal, noise, status, begin, begin + rowLength,
+                 hitRejectionCut, pixelSum, hitPixels);
+    skippedPixels += hitPixels;
+
+    // we are now at the end of the row, so let's calculate the
+    // common mode
+    if ((hitPixels < maxRejectedPixelsPerRow) && (goodPixel != 0)) {
+      double const commonMode = pixelSum / goodPixel;
+      std::fill(correction.begin() + begin,
+                correction.begin() + begin + rowLength, commonMode);
+      rowCommonModes.push_back(commonMode);
+    } else {
+      ++skippedRows;
+    }
+  }
+  return skippedRows;
+}
@@ -0,0 +1,88 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+// eutelescope includes ".h"
+#include "EUTelEtaTable.h"
+#include "EUTelEtaFunctionImpl.h"
+
+// system includes <>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using namespace eutelescope;
+
+EUTelEtaTable::EUTelEtaTable()
+    : _firstCenter(0.), _invBinWidth(0.), _lastBin(0.), _centers(),
+      _values(), _slopes() {}
+
+EUTelEtaTable::EUTelEtaTable(double firstCenter, double lastCenter,
+                             std::vector<double> values)
+    : _firstCenter(firstCenter), _invBinWidth(0.), _lastBin(0.), _centers(),
+      _values(std::move(values)), _slopes() {
+  if (_values.size() > 1) {
+    _invBinWidth = (_values.size() - 1) / (lastCenter - firstCenter);
+  }
+  fillSlopes();
+}
+
+EUTelEtaTable::EUTelEtaTable(EUTelEtaFunctionImpl const &etaFunction)
+    : _firstCenter(0.), _invBinWidth(0.), _lastBin(0.), _centers(),
+      _values(), _slopes() {
+
+  std::vector<double> const centers = etaFunction.getBinCenterVector();
+  if (centers.empty()) {
+    return;
+  }
+
+  _firstCenter = centers.front();
+  if (centers.size() > 1) {
+    _invBinWidth = (centers.size() - 1) / (centers.back() - centers.front());
+  }
+
+  // check if the binning is uniform, otherwise resample
+  bool uniform = true;
+  double const tolerance = 1e-6 / std::max(_invBinWidth, 1.);
+  for (size_t i = 0; i < centers.size() && uniform; ++i) {
+    uniform = std::abs(centers[i] - (_firstCenter + i / _invBinWidth)) <
+              tolerance;
+  }
+
+  if (uniform || centers.size() < 2) {
+    _values = etaFunction.getEtaValueVector();
+  } else {
+    _values.reserve(centers.size());
+    for (size_t i = 0; i < centers.size(); ++i) {
+      _values.push_back(
+          etaFunction.getEtaFromCoG(_firstCenter + i / _invBinWidth));
+    }
+  }
+  fillSlopes();
+}
+
+void EUTelEtaTable::fillSlopes() {
+  _lastBin = _values.empty() ? 0. : static_cast<double>(_values.size() - 1);
+  _centers.resize(_values.size());
+  _slopes.assign(_values.size(), 0.);
+  for (size_t i = 0; i < _values.size(); ++i) {
+    _centers[i] = (i == 0) ? _firstCenter : _firstCenter + i / _invBinWidth;
+  }
+  for (size_t i = 0; i + 1 < _values.size(); ++i) {
+    _slopes[i] = (_values[i + 1] - _values[i]) * _invBinWidth;
+  }
+}
+
+void EUTelEtaTable::getEtaFromCoG(std::vector<double> &xs) const {
+  if (_values.empty()) {
+    return;
+  }
+  for (auto &x : xs) {
+    x = getEtaFromCoG(x);
+  }
+}
@@ -0,0 +1,93 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+// eutelescope includes ".h"
+#include "EUTelEventArena.h"
+
+// system includes <>
+#include <algorithm>
+#include <cstdint>
+
+using namespace eutelescope;
+
+EUTelEventArena::EUTelEventArena(size_t blockSize)
+    : _blocks(), _offset(0), _usedBefore(0), _destructors(nullptr),
+      _statistics() {
+  addBlock(std::max<size_t>(blockSize, 1));
+}
+
+EUTelEventArena::~EUTelEventArena() {
+  for (Destructor *destructor = _destructors; destructor;
+       destructor = destructor->next) {
+    destructor->destroy(destructor->object);
+  }
+}
+
+void *EUTelEventArena::allocate(size_t bytes, size_t alignment) {
+  ++_statistics.allocations;
+  _statistics.bytes += bytes;
+
+  Block &block = _blocks.back();
+  std::uintptr_t const base =
+      reinterpret_cast<std::uintptr_t>(block.memory.get());
+  size_t offset =
+      (base + _offset + alignment - 1) / alignment * alignment - base;
+  if (offset + bytes > block.size) {
+    addBlock(bytes + alignment);
+    std::uintptr_t const newBase =
+        reinterpret_cast<std::uintptr_t>(_blocks.back().memory.get());
+    offset = (newBase + alignment - 1) / alignment * alignment - newBase;
+  }
+  _offset = offset + bytes;
+  _statistics.peakBytes = std::max(_statistics.peakBytes, used());
+  return _blocks.back().memory.get() + offset;
+}
+
+void EUTelEventArena::reset() {
+  // the destructor records live in the arena, so they stay valid
+  // until the memory is reused below
+  for (Destructor *destructor = _destructors; destructor;
+       destructor = destructor->next) {
+    destructor->destroy(destructor->object);
+  }
+  _destructors = nullptr;
+
+  if (_blocks.size() > 1) {
+    size_t const total = _statistics.capacity;
+    _blocks.clear();
+    _statistics.capacity = 0;
+    addBlock(total);
+  }
+  _offset = 0;
+  _usedBefore = 0;
+  ++_statistics.resets;
+}
+
+void EUTelEventArena::addBlock(size_t bytes) {
+  size_t size = bytes;
+  if (!_blocks.empty()) {
+    _usedBefore += _offset;
+    size = std::max(size, _blocks.back().size);
+  }
+  _blocks.push_back(Block{std::unique_ptr<char[]>(new char[size]), size});
+  _offset = 0;
+  ++_statistics.blockAllocations;
+  _statistics.capacity += size;
+}
+
+void EUTelEventArena::summarize(std::string const &owner) const {
+  streamlog_out(MESSAGE4) << owner << " event arena: "
+                          << _statistics.allocations << " allocations, "
+                          << _statistics.bytes << " bytes in "
+                          << _statistics.resets << " events" << std::endl;
+  streamlog_out(MESSAGE4) << "  peak per event " << _statistics.peakBytes
+                          << " bytes, " << _statistics.blockAllocations
+                          << " heap blocks, " << _statistics.capacity
+                          << " bytes reserved" << std::endl;
+}
@@ -1,6 +0,0 @@
-/**
- *
- * Base for filter classes
- */
-
-#include "EUTelFilter.h"
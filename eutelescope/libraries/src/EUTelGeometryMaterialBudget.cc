@@ -0,0 +1,99 @@
+/*
+ * File:   EUTelGeometryMaterialBudget.cc
+ *
+ */
+#include "EUTelGeometryMaterialBudget.h"
+
+// EUTELESCOPE
+#include "EUTelExceptions.h"
+#include "EUTelGeometryTelescopeGeoDescription.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+
+using namespace eutelescope;
+using namespace geo;
+
+constexpr double MaterialBudget::airRadLength;
+
+MaterialBudget::MaterialBudget(EUTelGeometryTelescopeGeoDescription &geo,
+                               std::shared_ptr<PlaneTable const> planeTable,
+                               size_t nBins, double maxAngle)
+    : _planeTable(std::move(planeTable)), _planes(), _gaps(),
+      _cosMin(std::cos(maxAngle)),
+      _binWidth((1. - std::cos(maxAngle)) / nBins) {
+
+  bool const useTGeo = geo.isTGeoInitialized();
+  auto const &planes = _planeTable->planes();
+
+  _planes.reserve(planes.size());
+  for (auto const &pl : planes) {
+    std::vector<double> table(nBins + 1);
+    for (size_t bin = 0; bin <= nBins; ++bin) {
+      double cosTheta = 1. - bin * _binWidth;
+      if (!useTGeo) {
+        table[bin] = pl.thicknessX0;
+        continue;
+      }
+      double sinTheta = std::sqrt(1. - cosTheta * cosTheta);
+      Eigen::Vector3d dir =
+          pl.local2Master * Eigen::Vector3d(sinTheta, 0., cosTheta);
+      // propagate halfway to the front and halfway back + a minor
+      // safety margin, as done for the normal incidence before
+      double halfChord = 0.51 * pl.zSize / cosTheta;
+      table[bin] = geo.FindRad(pl.position - halfChord * dir,
+                               pl.position + halfChord * dir) *
+                   cosTheta;
+    }
+    _planes.push_back(std::move(table));
+  }
+
+  for (size_t i = 1; i < planes.size(); ++i) {
+    auto const &front = planes[i - 1];
+    auto const &back = planes[i];
+    Eigen::Vector3d dir = back.position - front.position;
+    double distance = dir.norm();
+    dir.normalize();
+    // the gap spans the full distance between the plane centres, the
+    // half planes within it being counted as air as well
+    double length = distance - 0.51 * (front.zSize + back.zSize);
+    if (!useTGeo || length <= 0.) {
+      _gaps.push_back(distance / airRadLength);
+    } else {
+      Eigen::Vector3d start = front.position + 0.51 * front.zSize * dir;
+      Eigen::Vector3d end = back.position - 0.51 * back.zSize * dir;
+      _gaps.push_back(geo.FindRad(start, end) +
+                      (distance - length) / airRadLength);
+    }
+  }
+}
+
+int MaterialBudget::ordinal(int sensorID) const {
+  int idx = _planeTable->ordinal(sensorID);
+  if (idx < 0) {
+    std::stringstream ss;
+    ss << "MaterialBudget: Could not find planeID: " << sensorID;
+    throw InvalidGeometryException(ss.str());
+  }
+  return idx;
+}
+
+double MaterialBudget::planeX0(int sensorID, double cosIncidence) const {
+  auto const &table = _planes[ordinal(sensorID)];
+  double cosTheta = std::min(1., std::max(cosIncidence, _cosMin));
+  double pos = (1. - cosTheta) / _binWidth;
+  size_t bin = std::min(static_cast<size_t>(pos), table.size() - 2);
+  double frac = pos - bin;
+  return ((1. - frac) * table[bin] + frac * table[bin + 1]) / cosTheta;
+}
+
+double MaterialBudget::totalX0() const {
+  double total = std::accumulate(_gaps.begin(), _gaps.end(), 0.);
+  for (auto const &table : _planes) {
+    total += table.front();
+  }
+  return total;
+}
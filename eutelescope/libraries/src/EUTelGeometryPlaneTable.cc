@@ -0,0 +1,121 @@
+/*
+ * File:   EUTelGeometryPlaneTable.cc
+ *
+ */
+#include "EUTelGeometryPlaneTable.h"
+
+// EUTELESCOPE
+#include "EUTelExceptions.h"
+#include "EUTelGeometryTelescopeGeoDescription.h"
+
+// C++
+#include <algorithm>
+#include <sstream>
+
+using namespace eutelescope;
+using namespace geo;
+
+PlaneTable::PlaneTable(EUTelGeometryTelescopeGeoDescription &geo)
+    : _planes(), _ordinals(), _minSensorID(0) {
+
+  auto const &sensorIDs = geo.sensorIDsVec();
+  if (sensorIDs.empty()) {
+    return;
+  }
+
+  auto minMax = std::minmax_element(sensorIDs.begin(), sensorIDs.end());
+  _minSensorID = *minMax.first;
+  _ordinals.assign(*minMax.second - _minSensorID + 1, -1);
+  _planes.reserve(sensorIDs.size());
+
+  std::array<double, 3> const origin{{0, 0, 0}};
+  std::array<double, 3> const unitX{{1, 0, 0}};
+  std::array<double, 3> const unitY{{0, 1, 0}};
+  std::array<double, 3> const unitZ{{0, 0, 1}};
+
+  for (int sensorID : sensorIDs) {
+    PlaneConstants pl;
+    pl.sensorID = sensorID;
+    pl.xPitch = geo.siPlaneXPitch(sensorID);
+    pl.yPitch = geo.siPlaneYPitch(sensorID);
+    pl.xNpixels = geo.siPlaneXNpixels(sensorID);
+    pl.yNpixels = geo.siPlaneYNpixels(sensorID);
+    pl.xSize = geo.siPlaneXSize(sensorID);
+    pl.ySize = geo.siPlaneYSize(sensorID);
+    pl.zSize = geo.siPlaneZSize(sensorID);
+    pl.xResolution = geo.siPlaneXResolution(sensorID);
+    pl.yResolution = geo.siPlaneYResolution(sensorID);
+    pl.position = geo.getOffsetVector(sensorID);
+    pl.rotationAngles << geo.siPlaneXRotationRadians(sensorID),
+        geo.siPlaneYRotationRadians(sensorID),
+        geo.siPlaneZRotationRadians(sensorID);
+    pl.rotation = geo.rotationMatrixFromAngles(sensorID);
+
+    if (geo.isTGeoInitialized()) {
+      // the columns of the local to global rotation are the local axes
+      // expressed in the global frame
+      std::array<double, 3> axis;
+      geo.local2MasterVec(sensorID, unitX, axis);
+      pl.xAxis << axis[0], axis[1], axis[2];
+      geo.local2MasterVec(sensorID, unitY, axis);
+      pl.yAxis << axis[0], axis[1], axis[2];
+      geo.local2MasterVec(sensorID, unitZ, axis);
+      pl.normal << axis[0], axis[1], axis[2];
+      pl.local2Master << pl.xAxis, pl.yAxis, pl.normal;
+      geo.local2Master(sensorID, origin, axis);
+      pl.translation << axis[0], axis[1], axis[2];
+    } else {
+      // same composition as in translateSiPlane2TGeo: the integer
+      // flips (keeping the frame right handed) followed by the rotation
+      Eigen::Matrix3d flip = geo.getFlipMatrix(sensorID);
+      flip(2, 2) = flip.determinant();
+      pl.local2Master = pl.rotation * flip;
+      pl.xAxis = pl.local2Master.col(0);
+      pl.yAxis = pl.local2Master.col(1);
+      pl.normal = pl.local2Master.col(2);
+      pl.translation = pl.position;
+    }
+
+    pl.radLength = geo.siPlaneRadLength(sensorID);
+    pl.thicknessX0 = pl.zSize / pl.radLength;
+
+    _ordinals[sensorID - _minSensorID] = static_cast<int>(_planes.size());
+    _planes.push_back(pl);
+  }
+}
+
+PlaneTable::PlaneTable(std::vector<PlaneConstants> const &planes)
+    : _planes(planes), _ordinals(), _minSensorID(0) {
+
+  if (_planes.empty()) {
+    return;
+  }
+
+  auto minMax = std::minmax_element(
+      _planes.begin(), _planes.end(),
+      [](PlaneConstants const &lhs, PlaneConstants const &rhs) {
+        return lhs.sensorID < rhs.sensorID;
+      });
+  _minSensorID = minMax.first->sensorID;
+  _ordinals.assign(minMax.second->sensorID - _minSensorID + 1, -1);
+
+  for (size_t i = 0; i < _planes.size(); ++i) {
+    int &ordinal = _ordinals[_planes[i].sensorID - _minSensorID];
+    if (ordinal >= 0) {
+      std::stringstream ss;
+      ss << "PlaneTable: Repeated planeID: " << _planes[i].sensorID;
+      throw InvalidGeometryException(ss.str());
+    }
+    ordinal = static_cast<int>(i);
+  }
+}
+
+PlaneConstants const &PlaneTable::plane(int sensorID) const {
+  int idx = ordinal(sensorID);
+  if (idx < 0) {
+    std::stringstream ss;
+    ss << "PlaneTable::plane: Could not find planeID: " << sensorID;
+    throw InvalidGeometryException(ss.str());
+  }
+  return _planes[idx];
+}
@@ -80,6 +80,20 @@ TVector3 EUTelGeometryTelescopeGeoDescription::siPlaneNormal( int planeID )
 	}
 }
 
+std::shared_ptr<PlaneTable const> EUTelGeometryTelescopeGeoDescription::planeTable() {
+	if( !_planeTable ) {
+		_planeTable = std::make_shared<PlaneTable const>(*this);
+	}
+	return _planeTable;
+}
+
+std::shared_ptr<MaterialBudget const> EUTelGeometryTelescopeGeoDescription::materialBudget() {
+	if( !_materialBudget ) {
+		_materialBudget = std::make_shared<MaterialBudget const>(*this, planeTable());
+	}
+	return _materialBudget;
+}
+
 /**TODO: Replace me: NOP*/
 TVector3 EUTelGeometryTelescopeGeoDescription::siPlaneXAxis( int planeID ) {
 	std::map<int, TVector3>::iterator mapIt = _planeXMap.find(planeID);
@@ -672,6 +686,8 @@ void EUTelGeometryTelescopeGeoDescription::initializeTGeoDescription( std::strin
  
     _geoManager->CloseGeometry();
     _isGeoInitialized = true;
+    _planeTable.reset();
+    _materialBudget.reset();
     // Dump ROOT TGeo object into file
     if ( dumpRoot ) _geoManager->Export( geomName.c_str() );
 
@@ -829,57 +845,13 @@ double EUTelGeometryTelescopeGeoDescription::FindRad(Eigen::Vector3d const & sta
 }
 
 double EUTelGeometryTelescopeGeoDescription::planeRadLengthGlobalIncidence(int planeID, Eigen::Vector3d incidenceDir) {
-	
-	incidenceDir.normalize();
-	double normRad;
-	
-	TVector3 planeNormalT = siPlaneNormal(planeID);
-	Eigen::Vector3d planeNormal(planeNormalT(0), planeNormalT(1), planeNormalT(2));
-	
-	std::map<int, double>::iterator mapIt = _planeRadMap.find(planeID);
-	if( mapIt != _planeRadMap.end() ) {
-		normRad = mapIt->second;
-	} else {
-		Eigen::Vector3d planePosition(siPlaneXPosition(planeID), siPlaneYPosition(planeID), siPlaneZPosition(planeID));
-
-		//We have to propagate halfway to to front and halfway back + a minor safety margin
-		Eigen::Vector3d startPoint = planePosition - 0.51*siPlaneZSize(planeID)*planeNormal;
-		Eigen::Vector3d endPoint = planePosition + 0.51*siPlaneZSize(planeID)*planeNormal;
-
-		normRad = FindRad(startPoint, endPoint);
-		_planeRadMap[planeID] = normRad;
-	}
-	double scale = std::abs(incidenceDir.dot(planeNormal));
-	return normRad/scale;
+	return materialBudget()->planeX0Global(planeID, incidenceDir);
 }
 
 double EUTelGeometryTelescopeGeoDescription::planeRadLengthLocalIncidence(int planeID, Eigen::Vector3d incidenceDir) {
-	
-	incidenceDir.normalize();
-	double normRad;
-
-	std::map<int, double>::iterator mapIt = _planeRadMap.find(planeID);
-	if( mapIt != _planeRadMap.end() ) {
-		normRad = mapIt->second;
-	} else {
-		Eigen::Vector3d planePosition(siPlaneXPosition(planeID), siPlaneYPosition(planeID), siPlaneZPosition(planeID));
-
-		TVector3 planeNormalT = siPlaneNormal(planeID);
-		Eigen::Vector3d planeNormal(planeNormalT(0), planeNormalT(1), planeNormalT(2));
-	
-		//We have to propagate halfway to to front and halfway back + a minor safety margin
-		Eigen::Vector3d startPoint = planePosition - 0.51*siPlaneZSize(planeID)*planeNormal;
-		Eigen::Vector3d endPoint = planePosition + 0.51*siPlaneZSize(planeID)*planeNormal;
-
-		normRad = FindRad(startPoint, endPoint);
-		_planeRadMap[planeID] = normRad;
-	}
-	double scale = std::abs(incidenceDir(2));
-	return normRad/scale;
+	return materialBudget()->planeX0Local(planeID, incidenceDir);
 }
 
-
-
 void EUTelGeometryTelescopeGeoDescription::updateSiPlanesLayout() {
 	gear::SiPlanesParameters* siplanesParameters = const_cast< gear::SiPlanesParameters*> (&( _gearManager->getSiPlanesParameters()));
 	gear::SiPlanesLayerLayout* siplanesLayerLayout = const_cast< gear::SiPlanesLayerLayout*> (&(_siPlanesParameters->getSiPlanesLayerLayout()));
@@ -0,0 +1,152 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+// eutelescope includes ".h"
+#include "EUTelMergingClusters.h"
+
+// system includes <>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+
+using namespace eutelescope;
+
+namespace {
+  //! A grid cell of one sensor
+  struct Cell {
+    int sensorID;
+    long x;
+    long y;
+
+    bool operator==(Cell const &other) const {
+      return sensorID == other.sensorID && x == other.x && y == other.y;
+    }
+  };
+
+  struct CellHash {
+    size_t operator()(Cell const &cell) const {
+      std::hash<long> hash;
+      size_t seed = hash(cell.sensorID);
+      seed ^= hash(cell.x) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      seed ^= hash(cell.y) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      return seed;
+    }
+  };
+
+  //! Same arithmetic as EUTelVirtualCluster::getDistance()
+  float centerDistance(Utility::ClusterFootprint const &a,
+                       Utility::ClusterFootprint const &b) {
+    return std::sqrt(std::pow(static_cast<double>(a.xCenter - b.xCenter), 2) +
+                     std::pow(static_cast<double>(a.yCenter - b.yCenter), 2));
+  }
+}
+
+Utility::DisjointSets::DisjointSets(size_t n) : _parent(n), _size(n, 1) {
+  for (size_t i = 0; i < n; ++i) {
+    _parent[i] = i;
+  }
+}
+
+size_t Utility::DisjointSets::find(size_t i) {
+  while (_parent[i] != i) {
+    _parent[i] = _parent[_parent[i]];
+    i = _parent[i];
+  }
+  return i;
+}
+
+void Utility::DisjointSets::unite(size_t i, size_t j) {
+  i = find(i);
+  j = find(j);
+  if (i == j) {
+    return;
+  }
+  if (_size[i] < _size[j]) {
+    std::swap(i, j);
+  }
+  _parent[j] = i;
+  _size[i] += _size[j];
+}
+
+std::vector<std::vector<int>> Utility::DisjointSets::groups() {
+  // the elements are visited in increasing order, so each group is
+  // created by its smallest element and filled in sorted order
+  std::vector<std::vector<int>> groups;
+  std::vector<int> groupOfRoot(_parent.size(), -1);
+  for (size_t i = 0; i < _parent.size(); ++i) {
+    size_t const root = find(i);
+    if (_size[root] < 2) {
+      continue;
+    }
+    if (groupOfRoot[root] < 0) {
+      groupOfRoot[root] = static_cast<int>(groups.size());
+      groups.emplace_back();
+      groups.back().reserve(_size[root]);
+    }
+    groups[groupOfRoot[root]].push_back(static_cast<int>(i));
+  }
+  return groups;
+}
+
+std::vector<std::pair<int, int>>
+Utility::findMergingPairs(std::vector<ClusterFootprint> const &clusters,
+                          float minimumDistance) {
+  std::vector<std::pair<int, int>> pairs;
+
+  // no pair can be further apart than the cell size
+  float cellSize = minimumDistance;
+  if (minimumDistance == 0) {
+    for (auto const &cluster : clusters) {
+      cellSize = std::max(cellSize, 2 * cluster.radius);
+    }
+  }
+  if (!(cellSize > 0)) {
+    return pairs;
+  }
+
+  std::vector<Cell> cells;
+  cells.reserve(clusters.size());
+  std::unordered_map<Cell, std::vector<int>, CellHash> grid;
+  grid.reserve(clusters.size());
+  for (size_t i = 0; i < clusters.size(); ++i) {
+    Cell const cell{
+        clusters[i].sensorID,
+        static_cast<long>(std::floor(clusters[i].xCenter / cellSize)),
+        static_cast<long>(std::floor(clusters[i].yCenter / cellSize))};
+    cells.push_back(cell);
+    grid[cell].push_back(static_cast<int>(i));
+  }
+
+  for (size_t i = 0; i < clusters.size(); ++i) {
+    for (long dX = -1; dX <= 1; ++dX) {
+      for (long dY = -1; dY <= 1; ++dY) {
+        auto const found = grid.find(
+            Cell{cells[i].sensorID, cells[i].x + dX, cells[i].y + dY});
+        if (found == grid.end()) {
+          continue;
+        }
+        for (int j : found->second) {
+          if (j <= static_cast<int>(i)) {
+            continue;
+          }
+          float const limit = (minimumDistance == 0)
+                                  ? clusters[i].radius + clusters[j].radius
+                                  : minimumDistance;
+          if (centerDistance(clusters[i], clusters[j]) < limit) {
+            pairs.emplace_back(static_cast<int>(i), j);
+          }
+        }
+      }
+    }
+  }
+
+  std::sort(pairs.begin(), pairs.end());
+  return pairs;
+}
@@ -0,0 +1,308 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+// eutelescope includes ".h"
+#include "EUTelPixelMaskDB.h"
+
+// lcio includes <.h>
+#include <Exceptions.h>
+
+// system includes <>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace eutelescope;
+
+namespace {
+  char const magic[8] = {'E', 'U', 'T', 'M', 'A', 'S', 'K', '\0'};
+
+  size_t const headerWords = 4;
+  size_t const sensorWords = 6;
+
+  void writeWord(std::ostream &os, uint32_t word) {
+    unsigned char bytes[4] = {
+        static_cast<unsigned char>(word & 0xff),
+        static_cast<unsigned char>((word >> 8) & 0xff),
+        static_cast<unsigned char>((word >> 16) & 0xff),
+        static_cast<unsigned char>((word >> 24) & 0xff)};
+    os.write(reinterpret_cast<char const *>(bytes), 4);
+  }
+
+  uint32_t readWord(unsigned char const *data) {
+    return static_cast<uint32_t>(data[0]) |
+           (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) |
+           (static_cast<uint32_t>(data[3]) << 24);
+  }
+
+  //! Read only memory map of a whole file, unmapped on destruction
+  class MappedFile {
+  public:
+    explicit MappedFile(std::string const &fileName)
+        : _data(nullptr), _size(0) {
+      int fd = ::open(fileName.c_str(), O_RDONLY);
+      if (fd < 0) {
+        throw lcio::IOException("EUTelPixelMaskDB: cannot open " + fileName);
+      }
+      struct stat st;
+      if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw lcio::IOException("EUTelPixelMaskDB: cannot stat " + fileName);
+      }
+      _size = static_cast<size_t>(st.st_size);
+      if (_size > 0) {
+        void *addr = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+          ::close(fd);
+          throw lcio::IOException("EUTelPixelMaskDB: cannot map " + fileName);
+        }
+        _data = static_cast<unsigned char const *>(addr);
+      }
+      ::close(fd);
+    }
+
+    ~MappedFile() {
+      if (_data) {
+        ::munmap(const_cast<unsigned char *>(_data), _size);
+      }
+    }
+
+    MappedFile(MappedFile const &) = delete;
+    MappedFile &operator=(MappedFile const &) = delete;
+
+    unsigned char const *data() const { return _data; }
+    size_t size() const { return _size; }
+
+  private:
+    unsigned char const *_data;
+    size_t _size;
+  };
+}
+
+EUTelPixelMask::EUTelPixelMask()
+    : _xMin(0), _yMin(0), _xSize(0), _ySize(0), _bits() {}
+
+EUTelPixelMask::EUTelPixelMask(int xMin, int yMin, int xSize, int ySize)
+    : _xMin(xMin), _yMin(yMin), _xSize(xSize), _ySize(ySize),
+      _bits((static_cast<size_t>(xSize) * ySize + 63) / 64, 0) {}
+
+bool EUTelPixelMask::mask(int x, int y) {
+  auto const dx = static_cast<unsigned>(x - _xMin);
+  auto const dy = static_cast<unsigned>(y - _yMin);
+  if (dx >= static_cast<unsigned>(_xSize) ||
+      dy >= static_cast<unsigned>(_ySize)) {
+    return false;
+  }
+  size_t const bit = static_cast<size_t>(dy) * _xSize + dx;
+  _bits[bit >> 6] |= uint64_t(1) << (bit & 63);
+  return true;
+}
+
+void EUTelPixelMask::merge(EUTelPixelMask const &other) {
+  if (other._bits.size() != _bits.size()) {
+    return;
+  }
+  for (size_t i = 0; i < _bits.size(); ++i) {
+    _bits[i] |= other._bits[i];
+  }
+}
+
+size_t EUTelPixelMask::count() const {
+  size_t n = 0;
+  for (auto word : _bits) {
+    n += __builtin_popcountll(word);
+  }
+  return n;
+}
+
+void EUTelPixelMask::maskRange(size_t first, size_t length) {
+  size_t const last = first + length;
+  size_t bit = first;
+  // leading partial word
+  while (bit < last && (bit & 63)) {
+    _bits[bit >> 6] |= uint64_t(1) << (bit & 63);
+    ++bit;
+  }
+  // full words
+  while (bit + 64 <= last) {
+    _bits[bit >> 6] = ~uint64_t(0);
+    bit += 64;
+  }
+  // trailing partial word
+  while (bit < last) {
+    _bits[bit >> 6] |= uint64_t(1) << (bit & 63);
+    ++bit;
+  }
+}
+
+EUTelPixelMaskDB::EUTelPixelMaskDB() : _masks(), _provenance() {}
+
+EUTelPixelMask &EUTelPixelMaskDB::addSensor(int sensorID, int xMin, int yMin,
+                                            int xSize, int ySize) {
+  auto it = _masks.find(sensorID);
+  if (it == _masks.end()) {
+    it = _masks
+             .insert(std::make_pair(
+                 sensorID, EUTelPixelMask(xMin, yMin, xSize, ySize)))
+             .first;
+  }
+  return it->second;
+}
+
+void EUTelPixelMaskDB::setProvenance(std::string const &key,
+                                     std::string const &value) {
+  _provenance[key] = value;
+}
+
+void EUTelPixelMaskDB::write(std::string const &fileName) const {
+
+  std::string provenance;
+  for (auto const &entry : _provenance) {
+    provenance += entry.first + "=" + entry.second + "\n";
+  }
+  while (provenance.size() % 4) {
+    provenance += '\0';
+  }
+
+  // run length encode all sensors first, the directory needs the
+  // number of runs
+  std::vector<std::vector<uint32_t>> runs;
+  for (auto const &entry : _masks) {
+    auto const &mask = entry.second;
+    size_t const nBits = static_cast<size_t>(mask._xSize) * mask._ySize;
+    std::vector<uint32_t> sensorRuns;
+    bool current = false;
+    uint32_t length = 0;
+    for (size_t bit = 0; bit < nBits; ++bit) {
+      if (mask.test(bit) != current) {
+        sensorRuns.push_back(length);
+        current = !current;
+        length = 0;
+      }
+      ++length;
+    }
+    sensorRuns.push_back(length);
+    runs.push_back(std::move(sensorRuns));
+  }
+
+  std::ofstream os(fileName.c_str(), std::ios::binary | std::ios::trunc);
+  if (!os) {
+    throw lcio::IOException("EUTelPixelMaskDB: cannot open " + fileName +
+                            " for writing");
+  }
+
+  os.write(magic, sizeof(magic));
+  writeWord(os, formatVersion);
+  writeWord(os, static_cast<uint32_t>(_masks.size()));
+  writeWord(os, static_cast<uint32_t>(provenance.size()));
+  writeWord(os, 0);
+  os.write(provenance.data(), provenance.size());
+
+  size_t iSensor = 0;
+  for (auto const &entry : _masks) {
+    writeWord(os, static_cast<uint32_t>(entry.first));
+    writeWord(os, static_cast<uint32_t>(entry.second._xMin));
+    writeWord(os, static_cast<uint32_t>(entry.second._yMin));
+    writeWord(os, static_cast<uint32_t>(entry.second._xSize));
+    writeWord(os, static_cast<uint32_t>(entry.second._ySize));
+    writeWord(os, static_cast<uint32_t>(runs[iSensor++].size()));
+  }
+  for (auto const &sensorRuns : runs) {
+    for (auto length : sensorRuns) {
+      writeWord(os, length);
+    }
+  }
+
+  if (!os) {
+    throw lcio::IOException("EUTelPixelMaskDB: error writing " + fileName);
+  }
+}
+
+EUTelPixelMaskDB EUTelPixelMaskDB::read(std::string const &fileName) {
+
+  MappedFile file(fileName);
+  unsigned char const *data = file.data();
+  size_t const size = file.size();
+
+  auto corrupted = [&fileName](std::string const &what) {
+    return lcio::IOException("EUTelPixelMaskDB: " + fileName + ": " + what);
+  };
+
+  if (size < sizeof(magic) + 4 * headerWords ||
+      std::memcmp(data, magic, sizeof(magic)) != 0) {
+    throw corrupted("not a pixel mask file");
+  }
+  size_t pos = sizeof(magic);
+  uint32_t const version = readWord(data + pos);
+  if (version != formatVersion) {
+    std::stringstream ss;
+    ss << "unsupported format version " << version;
+    throw corrupted(ss.str());
+  }
+  uint32_t const nSensors = readWord(data + pos + 4);
+  uint32_t const provenanceSize = readWord(data + pos + 8);
+  pos += 4 * headerWords;
+
+  if (pos + provenanceSize + 4 * sensorWords * size_t(nSensors) > size) {
+    throw corrupted("truncated header");
+  }
+
+  EUTelPixelMaskDB db;
+
+  std::string provenance(reinterpret_cast<char const *>(data + pos),
+                         provenanceSize);
+  std::istringstream lines(provenance);
+  std::string line;
+  while (std::getline(lines, line)) {
+    auto eq = line.find('=');
+    if (eq != std::string::npos) {
+      db._provenance[line.substr(0, eq)] = line.substr(eq + 1);
+    }
+  }
+  pos += provenanceSize;
+
+  size_t payload = pos + 4 * sensorWords * size_t(nSensors);
+  for (uint32_t iSensor = 0; iSensor < nSensors; ++iSensor) {
+    unsigned char const *dir = data + pos + 4 * sensorWords * iSensor;
+    int const sensorID = static_cast<int32_t>(readWord(dir));
+    int const xMin = static_cast<int32_t>(readWord(dir + 4));
+    int const yMin = static_cast<int32_t>(readWord(dir + 8));
+    int const xSize = static_cast<int32_t>(readWord(dir + 12));
+    int const ySize = static_cast<int32_t>(readWord(dir + 16));
+    uint32_t const nRuns = readWord(dir + 20);
+
+    if (xSize < 0 || ySize < 0 || payload + 4 * size_t(nRuns) > size) {
+      throw corrupted("truncated or invalid sensor entry");
+    }
+
+    EUTelPixelMask &mask = db.addSensor(sensorID, xMin, yMin, xSize, ySize);
+    size_t const nBits = static_cast<size_t>(xSize) * ySize;
+    size_t bit = 0;
+    for (uint32_t iRun = 0; iRun < nRuns; ++iRun) {
+      size_t const length = readWord(data + payload + 4 * size_t(iRun));
+      if (bit + length > nBits) {
+        throw corrupted("run lengths exceed the sensor size");
+      }
+      // odd runs are the masked ones
+      if (iRun & 1u) {
+        mask.maskRange(bit, length);
+      }
+      bit += length;
+    }
+    payload += 4 * size_t(nRuns);
+  }
+
+  return db;
+}
@@ -0,0 +1,248 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+// eutelescope includes ".h"
+#include "EUTelProcessorProfile.h"
+#include "EUTelCDashMeasurement.h"
+
+// system includes <>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+
+#include <time.h>
+
+using namespace eutelescope;
+
+namespace {
+  std::atomic<unsigned long> allocationCount(0);
+
+  //! CPU time of the calling thread in seconds
+  double threadCPUTime() {
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+      return 0.;
+    }
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+  }
+
+  double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+  }
+
+  //! Escape a string for JSON output
+  std::string jsonString(std::string const &s) {
+    std::string out = "\"";
+    for (char c : s) {
+      if (c == '"' || c == '\\') {
+        out += '\\';
+        out += c;
+      } else if (static_cast<unsigned char>(c) < 0x20) {
+        char buffer[8];
+        snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+        out += buffer;
+      } else {
+        out += c;
+      }
+    }
+    return out + "\"";
+  }
+
+  void writeHistogramJSON(std::ostream &os,
+                          EUTelProcessorProfile::TimeHistogram const &h) {
+    os << "{\"entries\": " << h.entries() << ", \"sum\": " << h.sum()
+       << ", \"mean\": " << h.mean() << ", \"p50\": " << h.quantile(0.5)
+       << ", \"p90\": " << h.quantile(0.9) << ", \"p99\": " << h.quantile(0.99)
+       << ", \"max\": " << h.max() << "}";
+  }
+}
+
+#ifdef EUTEL_COUNT_ALLOCATIONS
+// Counting replacements of the global allocation functions, the array
+// and sized forms forward to these
+void *operator new(std::size_t size) {
+  ++allocationCount;
+  if (void *p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+#endif
+
+EUTelProcessorProfile::TimeHistogram::TimeHistogram()
+    : _bins(binsPerDecade * nDecades + 2, 0), _entries(0), _sum(0.),
+      _max(0.) {}
+
+double EUTelProcessorProfile::TimeHistogram::upperEdge(size_t bin) {
+  return 1e-6 * std::pow(10., static_cast<double>(bin) / binsPerDecade);
+}
+
+void EUTelProcessorProfile::TimeHistogram::fill(double seconds) {
+  size_t bin = 0;
+  if (seconds >= 1e-6) {
+    double const pos = std::log10(seconds * 1e6) * binsPerDecade;
+    bin = std::min(_bins.size() - 1, static_cast<size_t>(pos) + 1);
+  }
+  ++_bins[bin];
+  ++_entries;
+  _sum += seconds;
+  _max = std::max(_max, seconds);
+}
+
+double EUTelProcessorProfile::TimeHistogram::quantile(double q) const {
+  if (_entries == 0) {
+    return 0.;
+  }
+  double const target = q * _entries;
+  long cumulative = 0;
+  for (size_t bin = 0; bin < _bins.size(); ++bin) {
+    cumulative += _bins[bin];
+    if (cumulative >= target && _bins[bin] > 0) {
+      // the upper edge of the bin, but never above the maximum
+      return std::min(_max, upperEdge(bin));
+    }
+  }
+  return _max;
+}
+
+EUTelProcessorProfile::EventTimer::EventTimer(EUTelProcessorProfile &profile)
+    : _profile(profile), _wallStart(std::chrono::steady_clock::now()),
+      _cpuStart(threadCPUTime()), _allocationsStart(allocationCount) {}
+
+EUTelProcessorProfile::EventTimer::~EventTimer() {
+  _profile._wallTime.fill(secondsSince(_wallStart));
+  _profile._cpuTime.fill(threadCPUTime() - _cpuStart);
+  if (countsAllocations()) {
+    _profile.count("allocations", allocationCount - _allocationsStart);
+  }
+}
+
+EUTelProcessorProfile::PhaseTimer::PhaseTimer(EUTelProcessorProfile &profile,
+                                              std::string const &phase)
+    : _histogram(&profile.phase(phase)),
+      _start(std::chrono::steady_clock::now()) {}
+
+void EUTelProcessorProfile::PhaseTimer::stop() {
+  if (_histogram) {
+    _histogram->fill(secondsSince(_start));
+    _histogram = nullptr;
+  }
+}
+
+EUTelProcessorProfile::EUTelProcessorProfile()
+    : _wallTime(), _cpuTime(), _phases(), _counters() {}
+
+double EUTelProcessorProfile::getThroughput() const {
+  return _wallTime.sum() > 0. ? _wallTime.entries() / _wallTime.sum() : 0.;
+}
+
+bool EUTelProcessorProfile::countsAllocations() {
+#ifdef EUTEL_COUNT_ALLOCATIONS
+  return true;
+#else
+  return false;
+#endif
+}
+
+void EUTelProcessorProfile::summarize(std::string const &owner) const {
+  printSummary(owner);
+  printCDash(std::cout, owner);
+
+  char const *dir = std::getenv("EUTEL_PROFILE_DIR");
+  if (dir && *dir) {
+    std::string const fileName =
+        std::string(dir) + "/" + owner + ".profile.json";
+    std::ofstream os(fileName.c_str());
+    if (os) {
+      writeJSON(os, owner);
+      streamlog_out(MESSAGE4) << "Profile of " << owner << " written to "
+                              << fileName << std::endl;
+    } else {
+      streamlog_out(WARNING) << "Cannot write the profile of " << owner
+                             << " to " << fileName << std::endl;
+    }
+  }
+}
+
+void EUTelProcessorProfile::printSummary(std::string const &owner) const {
+  streamlog_out(MESSAGE4) << owner << " profile: " << _wallTime.entries()
+                          << " events, " << std::setprecision(4)
+                          << getThroughput() << " events/s" << std::endl;
+  streamlog_out(MESSAGE4) << "  processEvent wall [ms]: mean "
+                          << 1e3 * _wallTime.mean() << ", median "
+                          << 1e3 * _wallTime.quantile(0.5) << ", 99% "
+                          << 1e3 * _wallTime.quantile(0.99) << ", max "
+                          << 1e3 * _wallTime.max() << std::endl;
+  streamlog_out(MESSAGE4) << "  processEvent CPU  [ms]: mean "
+                          << 1e3 * _cpuTime.mean() << ", total "
+                          << 1e3 * _cpuTime.sum() << std::endl;
+  for (auto const &entry : _phases) {
+    streamlog_out(MESSAGE4) << "  phase " << entry.first << " [ms]: mean "
+                            << 1e3 * entry.second.mean() << ", total "
+                            << 1e3 * entry.second.sum() << " in "
+                            << entry.second.entries() << " calls"
+                            << std::endl;
+  }
+  for (auto const &entry : _counters) {
+    streamlog_out(MESSAGE4) << "  " << entry.first << ": " << entry.second
+                            << std::endl;
+  }
+}
+
+void EUTelProcessorProfile::writeJSON(std::ostream &os,
+                                      std::string const &owner) const {
+  os << "{\n  \"processor\": " << jsonString(owner)
+     << ",\n  \"events\": " << _wallTime.entries()
+     << ",\n  \"throughput\": " << getThroughput() << ",\n  \"wall\": ";
+  writeHistogramJSON(os, _wallTime);
+  os << ",\n  \"cpu\": ";
+  writeHistogramJSON(os, _cpuTime);
+  os << ",\n  \"phases\": {";
+  char const *separator = "\n    ";
+  for (auto const &entry : _phases) {
+    os << separator << jsonString(entry.first) << ": ";
+    writeHistogramJSON(os, entry.second);
+    separator = ",\n    ";
+  }
+  os << "\n  },\n  \"counters\": {";
+  separator = "\n    ";
+  for (auto const &entry : _counters) {
+    os << separator << jsonString(entry.first) << ": " << entry.second;
+    separator = ",\n    ";
+  }
+  os << "\n  }\n}\n";
+}
+
+void EUTelProcessorProfile::printCDash(std::ostream &os,
+                                       std::string const &owner) const {
+  os << CDashMeasurement(owner + "_events",
+                         static_cast<int>(_wallTime.entries()));
+  os << CDashMeasurement(owner + "_throughput", getThroughput());
+  os << CDashMeasurement(owner + "_wall_mean_ms", 1e3 * _wallTime.mean());
+  os << CDashMeasurement(owner + "_cpu_mean_ms", 1e3 * _cpuTime.mean());
+  for (auto const &entry : _phases) {
+    os << CDashMeasurement(owner + "_" + entry.first + "_total_ms",
+                           1e3 * entry.second.sum());
+  }
+  for (auto const &entry : _counters) {
+    os << CDashMeasurement(owner + "_" + entry.first,
+                           static_cast<double>(entry.second));
+  }
+}
@@ -0,0 +1,250 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+// eutelescope includes ".h"
+#include "EUTelSyntheticEventGenerator.h"
+#include "EUTelExceptions.h"
+#include "EUTelUtility.h"
+
+// system includes <>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+using namespace eutelescope;
+
+namespace {
+  //! Largest supported cluster size, the 3x3 pixels around the seed
+  const size_t maxClusterSize = 9;
+}
+
+EUTelSyntheticEventGenerator::Config::Config()
+    : beamEnergy(5.), tracksPerEvent(1.), beamSpotX(5.), beamSpotY(3.),
+      beamDivergence(1e-4), multipleScattering(true), noiseOccupancy(1e-5),
+      clusterSizeProbabilities{0.3, 0.3, 0.25, 0.15}, efficiency(),
+      misalignment(), seed(4357) {}
+
+EUTelSyntheticEventGenerator::EUTelSyntheticEventGenerator(
+    std::shared_ptr<geo::PlaneTable const> planeTable,
+    std::shared_ptr<geo::MaterialBudget const> materialBudget,
+    Config const &config)
+    : _planeTable(planeTable), _materialBudget(materialBudget),
+      _config(config), _truePlanes(), _occupied(), _rng(config.seed),
+      _clusterSize(),
+      _gauss(0., 1.), _uniform(0., 1.) {
+
+  if (!_planeTable || _planeTable->size() == 0) {
+    throw InvalidParameterException("The synthetic event generator needs at "
+                                    "least one plane");
+  }
+  if (_config.multipleScattering && !_materialBudget) {
+    throw InvalidParameterException("Multiple scattering needs the material "
+                                    "budget of the telescope");
+  }
+
+  std::vector<double> probabilities = _config.clusterSizeProbabilities;
+  if (probabilities.size() > maxClusterSize) {
+    probabilities.resize(maxClusterSize);
+  }
+  if (probabilities.empty()) {
+    probabilities.push_back(1.);
+  }
+  _clusterSize = std::discrete_distribution<int>(probabilities.begin(),
+                                                 probabilities.end());
+
+  for (auto const &pl : _planeTable->planes()) {
+    TruePlane plane{1., 0., 0., 1., 0.};
+    auto efficiency = _config.efficiency.find(pl.sensorID);
+    if (efficiency != _config.efficiency.end()) {
+      plane.efficiency = efficiency->second;
+    }
+    auto misalignment = _config.misalignment.find(pl.sensorID);
+    if (misalignment != _config.misalignment.end()) {
+      plane.shiftX = misalignment->second.x;
+      plane.shiftY = misalignment->second.y;
+      plane.cosRot = std::cos(misalignment->second.rotZ);
+      plane.sinRot = std::sin(misalignment->second.rotZ);
+    }
+    _truePlanes.push_back(plane);
+  }
+}
+
+void EUTelSyntheticEventGenerator::generate(Event &event) {
+  size_t const nPlanes = _planeTable->size();
+
+  event.planes.resize(nPlanes);
+  for (size_t i = 0; i < nPlanes; ++i) {
+    event.planes[i].sensorID = (*_planeTable)[i].sensorID;
+    event.planes[i].pixels.clear();
+    event.planes[i].clusters.clear();
+  }
+  event.trueHits.clear();
+
+  event.nTracks = 0;
+  if (_config.tracksPerEvent > 0.) {
+    std::poisson_distribution<int> nTracks(_config.tracksPerEvent);
+    event.nTracks = nTracks(_rng);
+  }
+  for (int track = 0; track < event.nTracks; ++track) {
+    addTrack(event, track);
+  }
+
+  if (_config.noiseOccupancy > 0.) {
+    for (size_t i = 0; i < nPlanes; ++i) {
+      addNoise(event.planes[i], (*_planeTable)[i]);
+    }
+  }
+}
+
+void EUTelSyntheticEventGenerator::addTrack(Event &event, int track) {
+  size_t const nPlanes = _planeTable->size();
+  geo::PlaneConstants const &first = (*_planeTable)[0];
+
+  // start in front of the first plane, even if it is tilted
+  Eigen::Vector3d point(
+      first.position.x() + _config.beamSpotX * _gauss(_rng),
+      first.position.y() + _config.beamSpotY * _gauss(_rng),
+      first.position.z() - 0.5 * std::max(first.xSize, first.ySize) - 1.);
+  Eigen::Vector3d direction(_config.beamDivergence * _gauss(_rng),
+                            _config.beamDivergence * _gauss(_rng), 1.);
+
+  for (size_t i = 0; i < nPlanes; ++i) {
+    geo::PlaneConstants const &pl = (*_planeTable)[i];
+
+    double const cosNormal = pl.normal.dot(direction);
+    if (std::abs(cosNormal) > 1e-9) {
+      point += pl.normal.dot(pl.translation - point) / cosNormal * direction;
+
+      std::array<double, 3> const globalPos{{point.x(), point.y(), point.z()}};
+      std::array<double, 3> localPos;
+      geo::PlaneTable::master2Local(pl, globalPos, localPos);
+
+      // position in the frame of the true, misaligned, sensor
+      TruePlane const &truePlane = _truePlanes[i];
+      double const dX = localPos[0] - truePlane.shiftX;
+      double const dY = localPos[1] - truePlane.shiftY;
+      double const x = truePlane.cosRot * dX + truePlane.sinRot * dY;
+      double const y = -truePlane.sinRot * dX + truePlane.cosRot * dY;
+
+      if (std::abs(x) < 0.5 * pl.xSize && std::abs(y) < 0.5 * pl.ySize) {
+        bool const detected = _uniform(_rng) < truePlane.efficiency;
+        event.trueHits.push_back(TrueHit{pl.sensorID, track, point, detected});
+        if (detected) {
+          addCluster(event.planes[i], pl, x, y,
+                     static_cast<int>(event.trueHits.size()) - 1);
+        }
+        if (_config.multipleScattering) {
+          scatter(direction,
+                  _materialBudget->planeX0Global(pl.sensorID, direction));
+        }
+      }
+    }
+
+    // the air of a gap is lumped into a single kink half way
+    if (_config.multipleScattering && i + 1 < nPlanes) {
+      double const zMid =
+          0.5 * (pl.position.z() + (*_planeTable)[i + 1].position.z());
+      point += (zMid - point.z()) / direction.z() * direction;
+      scatter(direction,
+              _materialBudget->gapX0(i, direction.z() / direction.norm()));
+    }
+  }
+}
+
+void EUTelSyntheticEventGenerator::addCluster(PlaneData &plane,
+                                              geo::PlaneConstants const &pl,
+                                              double x, double y,
+                                              int trueHit) {
+  // impact point in units of pixels, pixel i covering [i, i+1)
+  double const u = (x + 0.5 * pl.xSize) / pl.xPitch;
+  double const v = (y + 0.5 * pl.ySize) / pl.yPitch;
+  int const seedX =
+      std::min(std::max(static_cast<int>(std::floor(u)), 0), pl.xNpixels - 1);
+  int const seedY =
+      std::min(std::max(static_cast<int>(std::floor(v)), 0), pl.yNpixels - 1);
+
+  // the pixels around the seed ordered by distance to the impact point
+  std::array<std::pair<double, std::pair<int, int>>, maxClusterSize> around;
+  size_t nAround = 0;
+  for (int pX = seedX - 1; pX <= seedX + 1; ++pX) {
+    for (int pY = seedY - 1; pY <= seedY + 1; ++pY) {
+      if (pX < 0 || pX >= pl.xNpixels || pY < 0 || pY >= pl.yNpixels) {
+        continue;
+      }
+      double const dU = (pX + 0.5 - u) * pl.xPitch;
+      double const dV = (pY + 0.5 - v) * pl.yPitch;
+      around[nAround++] =
+          std::make_pair(dU * dU + dV * dV, std::make_pair(pX, pY));
+    }
+  }
+  size_t const size =
+      std::min(static_cast<size_t>(_clusterSize(_rng)) + 1, nAround);
+  std::partial_sort(around.begin(), around.begin() + size,
+                    around.begin() + nAround);
+
+  Cluster cluster{plane.pixels.size(), 0, trueHit};
+  for (size_t i = 0; i < size; ++i) {
+    plane.pixels.emplace_back(static_cast<short>(around[i].second.first),
+                              static_cast<short>(around[i].second.second),
+                              1.f, 0);
+  }
+  cluster.end = plane.pixels.size();
+  plane.clusters.push_back(cluster);
+}
+
+void EUTelSyntheticEventGenerator::addNoise(PlaneData &plane,
+                                            geo::PlaneConstants const &pl) {
+  std::poisson_distribution<int> nNoise(_config.noiseOccupancy * pl.xNpixels *
+                                        pl.yNpixels);
+  std::uniform_int_distribution<int> pixelX(0, pl.xNpixels - 1);
+  std::uniform_int_distribution<int> pixelY(0, pl.yNpixels - 1);
+
+  int const n = nNoise(_rng);
+  if (n == 0) {
+    return;
+  }
+
+  // a pixel is read out once per frame, so noise on a pixel fired
+  // already, by a track or by earlier noise, is dropped
+  _occupied.clear();
+  for (auto const &pixel : plane.pixels) {
+    _occupied.push_back(pixel.getXCoord() * pl.yNpixels + pixel.getYCoord());
+  }
+  std::sort(_occupied.begin(), _occupied.end());
+
+  for (int i = 0; i < n; ++i) {
+    int const x = pixelX(_rng);
+    int const y = pixelY(_rng);
+    int const address = x * pl.yNpixels + y;
+    auto const slot =
+        std::lower_bound(_occupied.begin(), _occupied.end(), address);
+    if (slot != _occupied.end() && *slot == address) {
+      continue;
+    }
+    _occupied.insert(slot, address);
+
+    plane.clusters.push_back(
+        Cluster{plane.pixels.size(), plane.pixels.size() + 1, -1});
+    plane.pixels.emplace_back(static_cast<short>(x), static_cast<short>(y),
+                              1.f, 0);
+  }
+}
+
+void EUTelSyntheticEventGenerator::scatter(Eigen::Vector3d &direction,
+                                           double radLength) {
+  if (radLength <= 0.) {
+    return;
+  }
+  double const theta =
+      Utility::getThetaRMSHighland(_config.beamEnergy, radLength);
+  direction /= direction.z();
+  direction.x() += theta * _gauss(_rng);
+  direction.y() += theta * _gauss(_rng);
+}
@@ -0,0 +1,109 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+// eutelescope includes ".h"
+#include "EUTelThreadPool.h"
+
+// system includes <>
+#include <algorithm>
+
+using namespace eutelescope;
+
+EUTelThreadPool::EUTelThreadPool(unsigned int nThreads)
+    : _workers(), _mutex(), _wake(), _done(), _job(nullptr), _nJobs(0),
+      _nextJob(0), _nPending(0), _generation(0), _stop(false), _error() {
+  if (nThreads == 0) {
+    nThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  _workers.reserve(nThreads - 1);
+  for (unsigned int i = 1; i < nThreads; ++i) {
+    _workers.emplace_back(&EUTelThreadPool::work, this);
+  }
+}
+
+EUTelThreadPool::~EUTelThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _wake.notify_all();
+  for (auto &worker : _workers) {
+    worker.join();
+  }
+}
+
+void EUTelThreadPool::run(std::function<void(size_t)> const &job,
+                          size_t nJobs) {
+  if (nJobs == 0) {
+    return;
+  }
+  if (_workers.empty()) {
+    for (size_t i = 0; i < nJobs; ++i) {
+      job(i);
+    }
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(_mutex);
+  _job = &job;
+  _nJobs = nJobs;
+  _nextJob = 0;
+  _nPending = nJobs;
+  _error = nullptr;
+  ++_generation;
+  _wake.notify_all();
+
+  drain(lock);
+  _done.wait(lock, [this] { return _nPending == 0; });
+
+  // late workers must not pick up the finished run
+  _job = nullptr;
+  _nJobs = 0;
+  std::exception_ptr error = _error;
+  _error = nullptr;
+  lock.unlock();
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void EUTelThreadPool::drain(std::unique_lock<std::mutex> &lock) {
+  while (_nextJob < _nJobs) {
+    size_t const index = _nextJob++;
+    std::function<void(size_t)> const &job = *_job;
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+      job(index);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    lock.lock();
+    if (error && !_error) {
+      _error = error;
+    }
+    if (--_nPending == 0) {
+      _done.notify_one();
+    }
+  }
+}
+
+void EUTelThreadPool::work() {
+  unsigned long seen = 0;
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+    _wake.wait(lock, [this, seen] { return _stop || _generation != seen; });
+    if (_stop) {
+      return;
+    }
+    seen = _generation;
+    drain(lock);
+  }
+}
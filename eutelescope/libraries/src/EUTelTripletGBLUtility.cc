@@ -45,7 +45,16 @@ using namespace eutelescope;
 using namespace marlin;
 
 
-EUTelTripletGBLUtility::EUTelTripletGBLUtility(){}
+// the histograms stay null until bookHistos(), the track finding
+// can then be used without a parent processor
+EUTelTripletGBLUtility::EUTelTripletGBLUtility()
+  : parent(nullptr), _inputCollectionTelescope(),
+    sixkxHisto(nullptr), sixkyHisto(nullptr), sixdxHisto(nullptr),
+    sixdyHisto(nullptr), sixdxcHisto(nullptr), sixdycHisto(nullptr),
+    sixkxcHisto(nullptr), sixkycHisto(nullptr), sixxHisto(nullptr),
+    sixyHisto(nullptr), sixxyHisto(nullptr), sixxycHisto(nullptr),
+    kinkx(nullptr), kinky(nullptr), kinkxy(nullptr), kinkxvsxy(nullptr),
+    kinkyvsxy(nullptr), kinkxyvsxy(nullptr), triddaMindutHisto(nullptr) {}
 
 Eigen::Matrix<double, 5,5> EUTelTripletGBLUtility::JacobianPointToPoint( double ds ) {
   /* for GBL:
@@ -184,13 +193,15 @@ void EUTelTripletGBLUtility::MatchTriplets(std::vector<triplet> const & up, std:
       double dx = xB - xA; 
       double dy = yB - yA;
 
-      sixkxHisto->fill( kx*1E3 );
-      sixkyHisto->fill( ky*1E3 );
-      sixdxHisto->fill( dx );
-      sixdyHisto->fill( dy );
+      if( sixkxHisto ) {
+	sixkxHisto->fill( kx*1E3 );
+	sixkyHisto->fill( ky*1E3 );
+	sixdxHisto->fill( dx );
+	sixdyHisto->fill( dy );
 
-      if( abs(dy) < 0.5 ) sixdxcHisto->fill( dx*1E3 );
-      if( abs(dx) < 0.5 ) sixdycHisto->fill( dy*1E3 );
+	if( abs(dy) < 0.5 ) sixdxcHisto->fill( dx*1E3 );
+	if( abs(dx) < 0.5 ) sixdycHisto->fill( dy*1E3 );
+      }
       
 
       // match driplet and triplet:
@@ -210,23 +221,27 @@ void EUTelTripletGBLUtility::MatchTriplets(std::vector<triplet> const & up, std:
       //else hIso->fill(1);
       
 
-      sixkxcHisto->fill( kx*1E3 );
-      sixkycHisto->fill( ky*1E3 );
-      sixxHisto->fill( -xA ); // -xA = x_DP = out
-      sixyHisto->fill( -yA ); // -yA = y_DP = up
-      sixxyHisto->fill( -xA, -yA ); // DP: x_out, y_up
-      // Fill kink map histogram:
-      if( abs( kx ) > 0.002 || abs( ky ) > 0.002 ) sixxycHisto->fill( -xA, -yA );      
+      if( sixkxcHisto ) {
+	sixkxcHisto->fill( kx*1E3 );
+	sixkycHisto->fill( ky*1E3 );
+	sixxHisto->fill( -xA ); // -xA = x_DP = out
+	sixyHisto->fill( -yA ); // -yA = y_DP = up
+	sixxyHisto->fill( -xA, -yA ); // DP: x_out, y_up
+	// Fill kink map histogram:
+	if( abs( kx ) > 0.002 || abs( ky ) > 0.002 ) sixxycHisto->fill( -xA, -yA );
+      }
 
       // apply fiducial cut
       if ( fabs(xA) >  9.0) continue;
       if (     -yA  < -4.0) continue;
-      kinkx->fill( kx*1E3 ); //sqrt(<kink^2>) [mrad]
-      kinky->fill( ky*1E3 ); //sqrt(<kink^2>) [mrad]
-      kinkxy->fill( (fabs(kx)+fabs(ky))/2*1E3 ); // [mrad]
-      kinkxvsxy->fill( -xA, -yA, fabs(kx)*1E3 ); //sqrt(<kink^2>) [mrad]
-      kinkyvsxy->fill( -xA, -yA, fabs(ky)*1E3 ); //sqrt(<kink^2>) [mrad]
-      kinkxyvsxy->fill( -xA, -yA, (fabs(kx) + fabs(ky))/2*1E3 ); // [mrad]
+      if( kinkx ) {
+	kinkx->fill( kx*1E3 ); //sqrt(<kink^2>) [mrad]
+	kinky->fill( ky*1E3 ); //sqrt(<kink^2>) [mrad]
+	kinkxy->fill( (fabs(kx)+fabs(ky))/2*1E3 ); // [mrad]
+	kinkxvsxy->fill( -xA, -yA, fabs(kx)*1E3 ); //sqrt(<kink^2>) [mrad]
+	kinkyvsxy->fill( -xA, -yA, fabs(ky)*1E3 ); //sqrt(<kink^2>) [mrad]
+	kinkxyvsxy->fill( -xA, -yA, (fabs(kx) + fabs(ky))/2*1E3 ); // [mrad]
+      }
 
       // Add the track to the vector if trip/drip are isolated, the triplets are matched, and all other cuts are passed
       tracks.push_back(newtrack);
@@ -256,7 +271,7 @@ bool EUTelTripletGBLUtility::IsTripletIsolated(EUTelTripletGBLUtility::triplet c
 	}
   }
 
-  triddaMindutHisto->fill(ddAMin);
+  if( triddaMindutHisto ) triddaMindutHisto->fill(ddAMin);
   if(ddAMin < isolation_cut && ddAMin > -0.5) IsolatedTrip = false; // if there is only one triplet, ddAmin is still -1.
 
   return IsolatedTrip;
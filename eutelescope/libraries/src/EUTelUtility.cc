@@ -186,6 +186,9 @@ namespace eutelescope {
       case kEUTelMuPixel:
         return std::unique_ptr<EUTelClusterDataInterfacerBase>(
             new EUTelSparseClusterImpl<EUTelMuPixel>(data));
+      case kEUTelPackedPixel:
+        return std::unique_ptr<EUTelClusterDataInterfacerBase>(
+            new EUTelSparseClusterImpl<EUTelPackedPixel>(data));
       default:
         throw UnknownDataTypeException("Unknown sparsified pixel");
       }
@@ -206,6 +209,9 @@ namespace eutelescope {
       case kEUTelMuPixel:
         return std::unique_ptr<EUTelTrackerDataInterfacer>(
             new EUTelTrackerDataInterfacerImpl<EUTelMuPixel>(data));
+      case kEUTelPackedPixel:
+        return std::unique_ptr<EUTelTrackerDataInterfacer>(
+            new EUTelTrackerDataInterfacerImpl<EUTelPackedPixel>(data));
       default:
         throw UnknownDataTypeException("Unknown sparsified pixel");
       }
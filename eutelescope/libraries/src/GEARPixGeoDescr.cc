@@ -10,6 +10,11 @@ namespace eutelescope {
                                   0, xPixel - 1, 0, yPixel - 1, // min max X,Y
                                   radLength)                    // rad length
     {
+      EUTelPixelAxisRegion regionX = {0, xPixel, -xSize / 2., xSize / xPixel};
+      EUTelPixelAxisRegion regionY = {0, yPixel, -ySize / 2., ySize / yPixel};
+      _regionX = regionX;
+      _regionY = regionY;
+
       // Create the material for the sensor
       matSi =
           new TGeoMaterial("Si", 28.0855, 14.0, 2.33, -_radLength, 45.753206);
@@ -47,5 +52,18 @@ namespace eutelescope {
       return std::make_pair(0, 0);
     }
 
+    bool GEARPixGeoDescr::getPixelCenter(int x, int y, double &posX,
+                                         double &posY, double &pitchX,
+                                         double &pitchY) const {
+      return pixelAxisCenter(&_regionX, 1, x, posX, pitchX) &&
+             pixelAxisCenter(&_regionY, 1, y, posY, pitchY);
+    }
+
+    bool GEARPixGeoDescr::getPixelIndex(double posX, double posY, int &x,
+                                        int &y) const {
+      return pixelAxisIndex(&_regionX, 1, posX, x) &&
+             pixelAxisIndex(&_regionY, 1, posY, y);
+    }
+
   } // namespace geo
 } // namespace eutelescope
@@ -0,0 +1,357 @@
+// eutelescope includes ""
+#include "EUTelAsyncLCIOReader.h"
+#include "EUTelEventPipeline.h"
+#include "anyoption.h"
+
+// lcio includes <>
+#include <IO/LCWriter.h>
+#include <lcio.h>
+#include <Exceptions.h>
+#include <IMPL/LCRunHeaderImpl.h>
+#include <IMPL/LCEventImpl.h>
+#include <IMPL/LCCollectionVec.h>
+
+//system includes <>
+#include <glob.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace IMPL;
+
+//! One input file read ahead by an EUTelAsyncLCIOReader
+struct InputStream {
+  InputStream( const string & name, size_t depth )
+    : fileName( name ), reader( vector< string >( 1, name ), depth ), head( NULL ), nRead( 0 ), nDropped( 0 ) { }
+
+  //! Make sure head holds the next event, false at the end of the file
+  bool fetch() {
+    if ( head == NULL ) {
+      try {
+        head = reader.readNextEvent().release();
+      } catch ( lcio::Exception & e ) {
+        // the reader stops at the first error
+        error = e.what();
+      }
+      if ( head != NULL ) ++nRead;
+    }
+    return head != NULL;
+  }
+
+  string fileName;
+  eutelescope::EUTelAsyncLCIOReader reader;
+  LCEventImpl * head;
+  size_t nRead;
+  size_t nDropped;
+  string error;
+};
+
+//! The input events matched to one merged event
+/*! The merged event is built in the first one.
+ */
+struct MatchedEvents {
+  vector< unique_ptr< LCEventImpl > > events;
+  vector< const string * > fileNames;
+};
+
+//! Writes the merged events
+/*! With a positive split, a new output file is started every split
+ *  events, named <base>-<n>.slcio.
+ */
+struct OutputStream {
+  OutputStream( const string & name, size_t split )
+    : fileName( name ), splitEvents( split ), writer( lcio::LCFactory::getInstance()->createLCWriter() ),
+      isOpen( false ), nWritten( 0 ), nFiles( 0 ) { }
+
+  string nextFileName() {
+    if ( splitEvents == 0 ) return fileName;
+    char suffix[16];
+    snprintf( suffix, sizeof( suffix ), "-%06zu.slcio", nFiles );
+    return fileName.substr( 0, fileName.rfind( ".slcio" ) ) + suffix;
+  }
+
+  void open( int runNumber, const string & detectorName ) {
+    writer->open( nextFileName(), lcio::LCIO::WRITE_NEW );
+    ++nFiles;
+    LCRunHeaderImpl runHeader;
+    runHeader.setRunNumber( runNumber );
+    runHeader.setDetectorName( detectorName );
+    writer->writeRunHeader( &runHeader );
+  }
+
+  void write( LCEventImpl * event ) {
+    if ( isOpen && splitEvents != 0 && nWritten % splitEvents == 0 ) {
+      close();
+    }
+    if ( ! isOpen ) {
+      open( event->getRunNumber(), event->getDetectorName() );
+      isOpen = true;
+    }
+    writer->writeEvent( event );
+    ++nWritten;
+  }
+
+  void close() {
+    if ( isOpen ) writer->close();
+    isOpen = false;
+  }
+
+  string fileName;
+  size_t splitEvents;
+  unique_ptr< lcio::LCWriter > writer;
+  bool isOpen;
+  size_t nWritten;
+  size_t nFiles;
+  string error;
+};
+
+//! Move the collections of event into merged
+/*! Collections with a name already in merged are appended to the
+ *  existing one if the types agree: the element pointers are handed
+ *  over and the emptied collection is deleted as a subset, so nothing
+ *  is copied.
+ */
+void mergeInto( LCEventImpl * merged, LCEventImpl * event, const string & fileName ) {
+  vector< string > names = *event->getCollectionNames();
+  for ( size_t iCol = 0; iCol < names.size(); ++iCol ) {
+    const string & name = names[iCol];
+    EVENT::LCCollection * collection = event->takeCollection( name );
+    LCCollectionVec * source = dynamic_cast< LCCollectionVec * >( collection );
+    // takeCollection() marks the collection transient, the writer would skip it
+    if ( source != NULL ) source->setTransient( false );
+    const vector< string > & existing = *merged->getCollectionNames();
+    if ( find( existing.begin(), existing.end(), name ) == existing.end() ) {
+      merged->addCollection( collection, name );
+      continue;
+    }
+    LCCollectionVec * target = dynamic_cast< LCCollectionVec * >( merged->getCollection( name ) );
+    if ( target == NULL || source == NULL || target->getTypeName() != source->getTypeName() ) {
+      // warn once per collection and file
+      static set< string > warned;
+      if ( warned.insert( fileName + ":" + name ).second ) {
+        cerr << "Warning: collection " << name << " from " << fileName
+             << " clashes with an existing collection of a different type, dropped" << endl;
+      }
+      delete collection;
+      continue;
+    }
+    for ( size_t iElement = 0; iElement < source->size(); ++iElement ) {
+      target->addElement( source->getElementAt( iElement ) );
+    }
+    source->setSubset( true );
+    delete source;
+  }
+}
+
+int main( int argc, char ** argv ) {
+
+  unique_ptr< AnyOption > option( new AnyOption );
+
+  string usageString =
+    "\n"
+    "This program merges several LCIO files event by event, e.g. the telescope and \n"
+    "the DUT streams of a run, or re-chunks a file by event range. Every input is \n"
+    "read by its own thread, events are matched by event number or timestamp and \n"
+    "their collections are combined without copying. Collections with the same name \n"
+    "and type are concatenated.\n"
+    "\n"
+    "lciomerge [option] -o outputfile.slcio file1.slcio [file2.slcio ... fileN.slcio]\n"
+    "\n"
+    "-h --help         Print this help\n"
+    "-t --timestamp    Match events by timestamp instead of event number\n"
+    "-w --window N     Largest timestamp difference of matched events (default 0)\n"
+    "-a --all          Also write events not found in all the inputs\n"
+    "-f --first N      Skip merged events with a number below N\n"
+    "-l --last N       Stop after the merged event with number N\n"
+    "-s --split N      Start a new output file every N events\n";
+
+  option->addUsage( usageString.c_str() );
+  option->setFlag( "help", 'h' );
+  option->setFlag( "timestamp", 't' );
+  option->setFlag( "all", 'a' );
+  option->setOption( "output", 'o' );
+  option->setOption( "window", 'w' );
+  option->setOption( "first", 'f' );
+  option->setOption( "last", 'l' );
+  option->setOption( "split", 's' );
+
+  option->processCommandArgs( argc, argv );
+
+  if ( option->getFlag( 'h' ) || option->getFlag( "help" ) ) {
+    option->printUsage();
+    return 0;
+  }
+
+  if ( option->getValue( "output" ) == NULL ) {
+    cerr << "Please provide an output file name using -o option" << endl;
+    return 2;
+  }
+
+  if ( ! eutelescope::EUTelAsyncLCIOReader::isSupported() ) {
+    cerr << "lciomerge reads its inputs on several threads, which needs LCIO 2.13 or later" << endl;
+    return 2;
+  }
+
+  string outputFileName = option->getValue( "output" );
+  // check if the output lcio file has the extension
+  if ( outputFileName.rfind( ".slcio", string::npos ) == string::npos ) {
+    outputFileName.append( ".slcio" );
+  }
+
+  const bool byTimestamp = option->getFlag( "timestamp" );
+  const bool writeAll    = option->getFlag( "all" );
+  long long window = 0;
+  long long first  = numeric_limits< long long >::min();
+  long long last   = numeric_limits< long long >::max();
+  size_t    split  = 0;
+  if ( option->getValue( "window" ) ) window = atoll( option->getValue( "window" ) );
+  if ( option->getValue( "first" ) )  first  = atoll( option->getValue( "first" ) );
+  if ( option->getValue( "last" ) )   last   = atoll( option->getValue( "last" ) );
+  if ( option->getValue( "split" ) )  split  = strtoul( option->getValue( "split" ), NULL, 10 );
+
+  // the input files may be using wildcards
+  glob_t globbuf;
+  for ( size_t iArg = 0 ; iArg < static_cast<size_t>(option->getArgc()); ++iArg ) {
+    if ( iArg == 0 ) glob( option->getArgv( iArg ), 0, NULL, &globbuf);
+    else  glob( option->getArgv( iArg ), GLOB_APPEND, NULL, &globbuf);
+  }
+
+  if ( option->getArgc() == 0 || globbuf.gl_pathc == 0 ) {
+    cerr << "Please provide at least one valid input file" << endl;
+    return 1;
+  }
+
+  // moving to a vector of string because it's easier
+  vector< string > inputFileNames( &globbuf.gl_pathv[0], &globbuf.gl_pathv[ globbuf.gl_pathc ] );
+  globfree( &globbuf );
+
+  // print some information
+  cout << "Target file: " << outputFileName << endl;
+  for ( size_t iFile = 0; iFile < inputFileNames.size() ; ++iFile ) {
+    cout << "Input file: " << inputFileNames.at( iFile ) << endl;
+  }
+
+  // number of events buffered per input and before the writer
+  const size_t queueDepth = 16;
+
+  vector< unique_ptr< InputStream > > inputs;
+  for ( size_t iFile = 0; iFile < inputFileNames.size(); ++iFile ) {
+    inputs.emplace_back( new InputStream( inputFileNames[iFile], queueDepth ) );
+  }
+
+  OutputStream output( outputFileName, split );
+
+  auto key = [byTimestamp]( LCEventImpl * event ) -> long long {
+    return byTimestamp ? static_cast< long long >( event->getTimeStamp() ) : event->getEventNumber();
+  };
+
+  // Reading and matching, merging and writing run on their own threads,
+  // with at most queueDepth merged events in flight.
+  eutelescope::EUTelEventPipeline< MatchedEvents > pipeline( queueDepth );
+
+  // The inputs are assumed to be ordered by the key. The events with the
+  // smallest key are merged if all inputs have one within the window,
+  // otherwise they are dropped (or written anyway with --all).
+  size_t nMerged = 0;
+  bool done = false;
+  pipeline.setSource( [&]( MatchedEvents & matchedEvents ) -> bool {
+    matchedEvents.events.clear();
+    matchedEvents.fileNames.clear();
+    while ( ! done ) {
+      long long minKey = numeric_limits< long long >::max();
+      size_t nAlive = 0;
+      for ( size_t iFile = 0; iFile < inputs.size(); ++iFile ) {
+        if ( inputs[iFile]->fetch() ) {
+          ++nAlive;
+          minKey = min( minKey, key( inputs[iFile]->head ) );
+        }
+      }
+      if ( nAlive == 0 || ( ! writeAll && nAlive < inputs.size() ) ) return false;
+
+      vector< InputStream * > matched;
+      for ( size_t iFile = 0; iFile < inputs.size(); ++iFile ) {
+        if ( inputs[iFile]->head && key( inputs[iFile]->head ) - minKey <= window ) {
+          matched.push_back( inputs[iFile].get() );
+        }
+      }
+
+      const bool complete = matched.size() == inputs.size();
+      const long long eventNumber = matched.front()->head->getEventNumber();
+      if ( eventNumber > last ) {
+        done = true;
+      }
+      if ( done || ( ! complete && ! writeAll ) || eventNumber < first ) {
+        for ( size_t i = 0; i < matched.size(); ++i ) {
+          if ( ! done ) ++matched[i]->nDropped;
+          delete matched[i]->head;
+          matched[i]->head = NULL;
+        }
+        continue;
+      }
+
+      for ( size_t i = 0; i < matched.size(); ++i ) {
+        matchedEvents.events.emplace_back( matched[i]->head );
+        matchedEvents.fileNames.push_back( &matched[i]->fileName );
+        matched[i]->head = NULL;
+      }
+      ++nMerged;
+      return true;
+    }
+    return false;
+  } );
+
+  // the first matched event is the base of the merged one
+  pipeline.addStage( "merge", []( MatchedEvents & matchedEvents ) {
+    for ( size_t i = 1; i < matchedEvents.events.size(); ++i ) {
+      mergeInto( matchedEvents.events.front().get(), matchedEvents.events[i].get(), *matchedEvents.fileNames[i] );
+      matchedEvents.events[i].reset();
+    }
+  }, eutelescope::EUTelEventPipeline< MatchedEvents >::kSerialStage );
+
+  pipeline.setCommit( [&output]( MatchedEvents & matchedEvents ) {
+    output.write( matchedEvents.events.front().get() );
+    matchedEvents.events.front().reset();
+  } );
+
+  try {
+    pipeline.run();
+    output.close();
+  } catch ( lcio::Exception & e ) {
+    // the events in flight are dropped
+    output.error = e.what();
+  }
+
+  // stop the readers
+  for ( size_t iFile = 0; iFile < inputs.size(); ++iFile ) {
+    InputStream & input = *inputs[iFile];
+    input.reader.close();
+    delete input.head;
+  }
+
+  int status = 0;
+  for ( size_t iFile = 0; iFile < inputs.size(); ++iFile ) {
+    InputStream & input = *inputs[iFile];
+    cout << input.fileName << ": " << input.nRead << " events read, "
+         << input.nDropped << " dropped" << endl;
+    if ( ! input.error.empty() ) {
+      cerr << input.error << endl;
+      status = 3;
+    }
+  }
+  cout << nMerged << " merged events, " << output.nWritten << " written to "
+       << output.nFiles << " file(s)" << endl;
+  if ( ! output.error.empty() ) {
+    cerr << output.error << endl;
+    status = 3;
+  }
+
+  return status;
+
+}
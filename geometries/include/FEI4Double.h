@@ -11,7 +11,7 @@
   */
 
 // EUTELESCOPE
-#include "EUTelGenericPixGeoDescr.h"
+#include "EUTelAnalyticPixGeoDescr.h"
 
 // ROOT
 #include "TGeoMaterial.h"
@@ -21,7 +21,15 @@
 namespace eutelescope {
   namespace geo {
 
-    class FEI4Double : public EUTelGenericPixGeoDescr {
+    class FEI4Double;
+
+    template <> struct EUTelPixelLayout<FEI4Double> {
+      static const size_t nRegionsX = 3, nRegionsY = 1;
+      static EUTelPixelAxisRegion const regionsX[nRegionsX];
+      static EUTelPixelAxisRegion const regionsY[nRegionsY];
+    };
+
+    class FEI4Double : public EUTelAnalyticPixGeoDescr<FEI4Double> {
 
     public:
       FEI4Double();
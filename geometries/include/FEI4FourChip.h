@@ -13,7 +13,7 @@
   */
 
 // EUTELESCOPE
-#include "EUTelGenericPixGeoDescr.h"
+#include "EUTelAnalyticPixGeoDescr.h"
 
 // ROOT
 #include "TGeoMaterial.h"
@@ -23,7 +23,15 @@
 namespace eutelescope {
   namespace geo {
 
-    class FEI4FourChip : public EUTelGenericPixGeoDescr {
+    class FEI4FourChip;
+
+    template <> struct EUTelPixelLayout<FEI4FourChip> {
+      static const size_t nRegionsX = 3, nRegionsY = 2;
+      static EUTelPixelAxisRegion const regionsX[nRegionsX];
+      static EUTelPixelAxisRegion const regionsY[nRegionsY];
+    };
+
+    class FEI4FourChip : public EUTelAnalyticPixGeoDescr<FEI4FourChip> {
 
     public:
       FEI4FourChip();
@@ -7,7 +7,7 @@
   */
 
 // EUTELESCOPE
-#include "EUTelGenericPixGeoDescr.h"
+#include "EUTelAnalyticPixGeoDescr.h"
 
 // ROOT
 #include "TGeoMaterial.h"
@@ -17,7 +17,15 @@
 namespace eutelescope {
   namespace geo {
 
-    class FEI4Single : public EUTelGenericPixGeoDescr {
+    class FEI4Single;
+
+    template <> struct EUTelPixelLayout<FEI4Single> {
+      static const size_t nRegionsX = 1, nRegionsY = 1;
+      static EUTelPixelAxisRegion const regionsX[nRegionsX];
+      static EUTelPixelAxisRegion const regionsY[nRegionsY];
+    };
+
+    class FEI4Single : public EUTelAnalyticPixGeoDescr<FEI4Single> {
 
     public:
       FEI4Single();
@@ -9,7 +9,7 @@
   */
 
 // EUTELESCOPE
-#include "EUTelGenericPixGeoDescr.h"
+#include "EUTelAnalyticPixGeoDescr.h"
 
 // ROOT
 #include "TGeoMaterial.h"
@@ -19,7 +19,16 @@
 namespace eutelescope {
   namespace geo {
 
-    class FEI4Single400uEdge : public EUTelGenericPixGeoDescr {
+    class FEI4Single400uEdge;
+
+    template <> struct EUTelPixelLayout<FEI4Single400uEdge> {
+      static const size_t nRegionsX = 3, nRegionsY = 1;
+      static EUTelPixelAxisRegion const regionsX[nRegionsX];
+      static EUTelPixelAxisRegion const regionsY[nRegionsY];
+    };
+
+    class FEI4Single400uEdge
+        : public EUTelAnalyticPixGeoDescr<FEI4Single400uEdge> {
 
     public:
       FEI4Single400uEdge();
@@ -14,7 +14,7 @@
 #include <utility> //std::pair
 
 // EUTELESCOPE
-#include "EUTelGenericPixGeoDescr.h"
+#include "EUTelAnalyticPixGeoDescr.h"
 
 // ROOT
 #include "TGeoMaterial.h"
@@ -24,7 +24,15 @@
 namespace eutelescope {
   namespace geo {
 
-    class Mimosa26 : public EUTelGenericPixGeoDescr {
+    class Mimosa26;
+
+    template <> struct EUTelPixelLayout<Mimosa26> {
+      static const size_t nRegionsX = 1, nRegionsY = 1;
+      static EUTelPixelAxisRegion const regionsX[nRegionsX];
+      static EUTelPixelAxisRegion const regionsY[nRegionsY];
+    };
+
+    class Mimosa26 : public EUTelAnalyticPixGeoDescr<Mimosa26> {
 
     public:
       Mimosa26();
@@ -3,10 +3,18 @@
 namespace eutelescope {
   namespace geo {
 
+    // Two chips of 79 columns of 250 microns with the two 450 micron columns
+    // in between, rows counted from the top
+    EUTelPixelAxisRegion const EUTelPixelLayout<FEI4Double>::regionsX[] = {
+        {0, 79, -20.2, 0.25}, {79, 2, -0.45, 0.45}, {81, 79, 0.45, 0.25}};
+    EUTelPixelAxisRegion const EUTelPixelLayout<FEI4Double>::regionsY[] = {
+        {0, 336, 8.4, -0.05}};
+
     FEI4Double::FEI4Double()
-        : EUTelGenericPixGeoDescr(40.40, 16.8, 0.025, // size X, Y, Z
-                                  0, 159, 0, 335,     // min max X,Y
-                                  93.660734)          // rad length
+        : EUTelAnalyticPixGeoDescr<FEI4Double>(
+              40.40, 16.8, 0.025, // size X, Y, Z
+              0, 159, 0, 335,     // min max X,Y
+              93.660734)          // rad length
     {
       // Create the material for the sensor
       matSi =
@@ -4,10 +4,17 @@
 namespace eutelescope {
   namespace geo {
 
+    // Two double chips, with 1.58 mm between them in y
+    EUTelPixelAxisRegion const EUTelPixelLayout<FEI4FourChip>::regionsX[] = {
+        {0, 79, -20.2, 0.25}, {79, 2, -0.45, 0.45}, {81, 79, 0.45, 0.25}};
+    EUTelPixelAxisRegion const EUTelPixelLayout<FEI4FourChip>::regionsY[] = {
+        {0, 336, -17.59, 0.05}, {336, 336, 0.79, 0.05}};
+
     FEI4FourChip::FEI4FourChip()
-        : EUTelGenericPixGeoDescr(40.4, 35.18, 0.025, // size X, Y, Z
-                                  0, 159, 0, 671,     // min max X,Y
-                                  93.660734)          // rad length
+        : EUTelAnalyticPixGeoDescr<FEI4FourChip>(
+              40.4, 35.18, 0.025, // size X, Y, Z
+              0, 159, 0, 671,     // min max X,Y
+              93.660734)          // rad length
     {
       // Create the material for the sensor
       matSi =
@@ -3,10 +3,17 @@
 namespace eutelescope {
   namespace geo {
 
+    // 80 columns of 250 microns, rows counted from the top
+    EUTelPixelAxisRegion const EUTelPixelLayout<FEI4Single>::regionsX[] = {
+        {0, 80, -10.0, 0.25}};
+    EUTelPixelAxisRegion const EUTelPixelLayout<FEI4Single>::regionsY[] = {
+        {0, 336, 8.4, -0.05}};
+
     FEI4Single::FEI4Single()
-        : EUTelGenericPixGeoDescr(20.00, 16.8, 0.025, // size X, Y, Z
-                                  0, 79, 0, 335,      // min max X,Y
-                                  93.660734)          // rad length
+        : EUTelAnalyticPixGeoDescr<FEI4Single>(
+              20.00, 16.8, 0.025, // size X, Y, Z
+              0, 79, 0, 335,      // min max X,Y
+              93.660734)          // rad length
     {
       // Create the material for the sensor
       matSi =
@@ -3,10 +3,20 @@
 namespace eutelescope {
   namespace geo {
 
+    // 400 micron edge columns around 78 columns of 250 microns, rows counted
+    // from the top
+    EUTelPixelAxisRegion const
+        EUTelPixelLayout<FEI4Single400uEdge>::regionsX[] = {
+            {0, 1, -10.15, 0.4}, {1, 78, -9.75, 0.25}, {79, 1, 9.75, 0.4}};
+    EUTelPixelAxisRegion const
+        EUTelPixelLayout<FEI4Single400uEdge>::regionsY[] = {
+            {0, 336, 8.4, -0.05}};
+
     FEI4Single400uEdge::FEI4Single400uEdge()
-        : EUTelGenericPixGeoDescr(20.30, 16.8, 0.025, // size X, Y, Z
-                                  0, 79, 0, 335,      // min max X,Y
-                                  93.660734)          // rad length
+        : EUTelAnalyticPixGeoDescr<FEI4Single400uEdge>(
+              20.30, 16.8, 0.025, // size X, Y, Z
+              0, 79, 0, 335,      // min max X,Y
+              93.660734)          // rad length
     {
       // Create the material for the sensor
       matSi =
@@ -3,10 +3,17 @@
 namespace eutelescope {
   namespace geo {
 
+    // 1152 x 576 pixels of equal size, both indices along the local axes
+    EUTelPixelAxisRegion const EUTelPixelLayout<Mimosa26>::regionsX[] = {
+        {0, 1152, -10.6, 21.2 / 1152}};
+    EUTelPixelAxisRegion const EUTelPixelLayout<Mimosa26>::regionsY[] = {
+        {0, 576, -5.3, 10.6 / 576}};
+
     Mimosa26::Mimosa26()
-        : EUTelGenericPixGeoDescr(21.2, 10.6, 0.02, // size X, Y, Z
-                                  0, 1151, 0, 575,  // min max X,Y
-                                  93.660734)        // rad length
+        : EUTelAnalyticPixGeoDescr<Mimosa26>(
+              21.2, 10.6, 0.02, // size X, Y, Z
+              0, 1151, 0, 575,  // min max X,Y
+              93.660734)        // rad length
     {
       // Create the material for the sensor
       matSi =
@@ -14,6 +14,7 @@
 // built only if GEAR is available
 #ifdef USE_GEAR
 // eutelescope includes ".h"
+#include "EUTelAlignmentChi2.h"
 
 // marlin includes ".h"
 #include "marlin/Processor.h"
@@ -136,6 +137,9 @@ namespace eutelescope {
   protected:
     static std::vector<HitsForFit> _hitsForFit;
 
+    //! The chi2 minimised in end(), filled from _hitsForFit
+    static EUTelAlignmentChi2 _chi2Objective;
+
     //! TrackerHit collection name
     /*! Input collection with measured hits.
      */
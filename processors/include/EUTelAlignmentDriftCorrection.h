@@ -0,0 +1,134 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELALIGNMENTDRIFTCORRECTION_H
+#define EUTELALIGNMENTDRIFTCORRECTION_H
+
+// eutelescope includes ".h"
+#include "EUTelUtility.h"
+
+// marlin includes ".h"
+#include "marlin/Processor.h"
+
+// lcio includes <.h>
+#include <EVENT/LCEvent.h>
+#include <EVENT/LCRunHeader.h>
+
+// system includes
+#include <set>
+#include <string>
+#include <vector>
+
+namespace eutelescope {
+
+  //! Processor serving the drift corrections of EUTelAlignmentDriftMonitor
+  /*! The AlignmentConstantFile written by EUTelAlignmentDriftMonitor
+   *  holds one LCIO event per window, with the first and last event
+   *  number of the window as FirstEvent and LastEvent parameters. A
+   *  condition handler like SimpleFileHandler serves the first of
+   *  them only.
+   *
+   *  This processor reads all the windows at init and adds the
+   *  constants of the window of the current event to every event as
+   *  a transient collection. An event between two windows, whose
+   *  window had too few tracks, gets the constants of the previous
+   *  window of the run, or of the next one at the run beginning. A
+   *  run without any window gets zero offsets.
+   *
+   *  The collection is meant to be the last of the
+   *  AlignmentConstantNames of EUTelProcessorTransformAndAlignHits,
+   *  after the alignment the monitor ran on, which rebuilds its
+   *  transforms when the window changes. It can as well be the
+   *  AlignmentConstantName of a second EUTelProcessorApplyAlignment.
+   */
+
+  class EUTelAlignmentDriftCorrection : public marlin::Processor {
+
+  public:
+    //! Returns a new instance of EUTelAlignmentDriftCorrection
+    virtual Processor *newProcessor() {
+      return new EUTelAlignmentDriftCorrection;
+    }
+
+    //! Default constructor
+    EUTelAlignmentDriftCorrection();
+
+    //! Called at the job beginning.
+    /*! Reads the constants of all the windows
+     *
+     *  @throw InvalidParameterException if AlignmentConstantFile has
+     *  no window
+     */
+    virtual void init();
+
+    //! Called for every run.
+    virtual void processRunHeader(LCRunHeader *run);
+
+    //! Called every event
+    /*! Adds the constants of the window of the event
+     */
+    virtual void processEvent(LCEvent *evt);
+
+    //! Prints how many events each window corrected
+    virtual void end();
+
+  protected:
+    //! Offsets and angles of a sensor
+    struct Constant {
+      int sensorID;
+      double xOffset;
+      double yOffset;
+      double zOffset;
+      double alpha;
+      double beta;
+      double gamma;
+    };
+
+    //! Constants of a window
+    struct Window {
+      int runNumber;
+      int firstEvent;
+      int lastEvent;
+      std::vector<Constant> constants;
+      long nEvents;
+    };
+
+    //! Index of the window for an event, -1 if the run has none
+    int findWindow(int runNumber, int eventNumber) const;
+
+    //! LCIO file written by EUTelAlignmentDriftMonitor
+    std::string _alignmentConstantFile;
+
+    //! Collection name of the constants in the file
+    std::string _inputCollectionName;
+
+    //! Collection name of the constants added to the events
+    std::string _outputCollectionName;
+
+  private:
+    DISALLOW_COPY_AND_ASSIGN(EUTelAlignmentDriftCorrection)
+
+    //! Windows ordered by run and first event
+    std::vector<Window> _windows;
+
+    //! Window of the previous event
+    int _lastWindow;
+
+    //! Sensor IDs for the zero offsets of runs without window
+    std::vector<int> _sensorIDs;
+
+    //! Runs without window, warned about once
+    std::set<int> _runsWithoutWindow;
+  };
+
+  //! A global instance of the processor
+  EUTelAlignmentDriftCorrection gEUTelAlignmentDriftCorrection;
+
+} // namespace eutelescope
+
+#endif // EUTELALIGNMENTDRIFTCORRECTION_H
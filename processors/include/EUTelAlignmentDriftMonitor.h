@@ -0,0 +1,209 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELALIGNMENTDRIFTMONITOR_H
+#define EUTELALIGNMENTDRIFTMONITOR_H
+
+// eutelescope includes ".h"
+#include "EUTELESCOPE.h"
+#include "EUTelCollectionCache.h"
+#include "EUTelTripletGBLUtility.h"
+#include "EUTelUtility.h"
+
+// marlin includes ".h"
+#include "marlin/Processor.h"
+
+// lcio includes <.h>
+#include <EVENT/LCEvent.h>
+#include <EVENT/LCRunHeader.h>
+#include <IO/LCWriter.h>
+
+// system includes
+#include <array>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace eutelescope {
+
+  //! Processor monitoring the telescope alignment during a run
+  /*! Tracks are found with the triplet finder of
+   *  EUTelTripletGBLUtility in the six telescope planes and fitted
+   *  with a straight line. For every plane, the mean and width of
+   *  the x and y residuals are accumulated with Welford's algorithm
+   *  over consecutive windows of WindowSize events.
+   *
+   *  The first window with at least MinTracks tracks is the
+   *  reference. The residual mean of each later window is compared
+   *  to it and a warning is issued if a plane moved by more than
+   *  DriftThreshold, and by more than three standard errors of the
+   *  mean.
+   *
+   *  The residuals of a straight line fit are blind to a common
+   *  shift and shear of all the planes, which no track based
+   *  alignment can see, but they are exactly the shifts which
+   *  remove the drift from the residuals. If AlignmentConstantFile
+   *  is set, they are written there for every window as
+   *  EUTelAlignmentConstant x/y offsets on top of the alignment
+   *  already applied to the input hits, one LCIO event per window
+   *  with the first and last event number of the window as
+   *  parameters. EUTelAlignmentDriftCorrection serves them to the
+   *  alignment processors window by window, so long runs can be
+   *  corrected instead of being split and realigned.
+   *
+   *  The input hits have to be in the global frame.
+   */
+
+  class EUTelAlignmentDriftMonitor : public marlin::Processor {
+
+  public:
+    //! Returns a new instance of EUTelAlignmentDriftMonitor
+    virtual Processor *newProcessor() {
+      return new EUTelAlignmentDriftMonitor;
+    }
+
+    //! Default constructor
+    EUTelAlignmentDriftMonitor();
+
+    //! Called at the job beginning.
+    /*! Checks the parameters and opens the output file, if any
+     *
+     *  @throw InvalidParameterException if TelescopePlanes does not
+     *  list six sensors
+     */
+    virtual void init();
+
+    //! Called for every run.
+    /*! Closes the window of the previous run
+     */
+    virtual void processRunHeader(LCRunHeader *run);
+
+    //! Called every event
+    virtual void processEvent(LCEvent *evt);
+
+    //! Closes the last window and prints the drift of every window
+    virtual void end();
+
+  protected:
+    //! Number of telescope planes used by the triplet finder
+    static size_t const kNPlanes = 6;
+
+    //! Incremental mean and variance (Welford)
+    struct RunningStatistics {
+      RunningStatistics() : n(0), mean(0.), m2(0.) {}
+      void add(double value) {
+        ++n;
+        double const delta = value - mean;
+        mean += delta / n;
+        m2 += delta * (value - mean);
+      }
+      double sigma() const { return n > 1 ? std::sqrt(m2 / (n - 1)) : 0.; }
+      double error() const { return n > 1 ? sigma() / std::sqrt(n) : 0.; }
+      long n;
+      double mean;
+      double m2;
+    };
+
+    //! Residual statistics of all planes, x and y
+    typedef std::array<std::array<RunningStatistics, 2>, kNPlanes>
+        PlaneStatistics;
+
+    //! Drift of a closed window
+    struct Window {
+      int runNumber;
+      int firstEvent;
+      int lastEvent;
+      long long timeStamp;
+      long nTracks;
+      std::array<std::array<double, 2>, kNPlanes> drift;
+      bool flagged;
+    };
+
+    //! Add the residuals of the matched tracks of the event
+    void addTracks(std::vector<EUTelTripletGBLUtility::hit> const &hits);
+
+    //! Evaluate the current window and start a new one
+    void closeWindow();
+
+    //! Write the drift of a window as alignment constants
+    void writeConstants(Window const &window);
+
+    //! Input hit collection name
+    std::string _hitCollectionName;
+
+    //! Sensor IDs of the telescope planes in beam order
+    std::vector<int> _telescopePlanes;
+
+    //! Window length in events
+    int _windowSize;
+
+    //! Minimum number of tracks to evaluate a window
+    int _minTracks;
+
+    //! Residual shift to flag a window [mm]
+    float _driftThreshold;
+
+    //! Triplet residual cut [mm]
+    float _tripletResidualCut;
+
+    //! Triplet slope cut [rad]
+    float _tripletSlopeCut;
+
+    //! Upstream/downstream triplet matching cut [mm]
+    float _matchingCut;
+
+    //! LCIO file for the constants of every window, none if empty
+    std::string _alignmentConstantFile;
+
+    //! Collection name of the written constants
+    std::string _alignmentCollectionName;
+
+  private:
+    DISALLOW_COPY_AND_ASSIGN(EUTelAlignmentDriftMonitor)
+
+    //! Triplet finder
+    EUTelTripletGBLUtility _tripletUtility;
+
+    //! Exception free lookup of the hit collection
+    EUTelCollectionCache _collectionCache;
+
+    //! Writer of the constants
+    std::unique_ptr<IO::LCWriter> _writer;
+
+    //! Statistics of the current window
+    PlaneStatistics _current;
+
+    //! Mean residuals of the reference window
+    std::array<std::array<double, 2>, kNPlanes> _reference;
+
+    //! A reference window was found
+    bool _hasReference;
+
+    //! Closed windows
+    std::vector<Window> _windows;
+
+    //! Events in the current window
+    int _nWindowEvents;
+
+    //! Run, first and last event and time stamp of the current window
+    int _windowRun;
+    int _windowFirstEvent;
+    int _windowLastEvent;
+    long long _windowTimeStamp;
+
+    //! Tracks in the current window
+    long _nWindowTracks;
+  };
+
+  //! A global instance of the processor
+  EUTelAlignmentDriftMonitor gEUTelAlignmentDriftMonitor;
+
+} // namespace eutelescope
+
+#endif // EUTELALIGNMENTDRIFTMONITOR_H
@@ -10,7 +10,9 @@
 #define EUTELCLUSTERFILTER_H 1
 
 // eutelescope includes ".h"
+#include "EUTelEventArena.h"
 #include "EUTelROI.h"
+#include "EUTelSelection.h"
 
 // marlin includes ".h"
 #include "marlin/Processor.h"
@@ -336,28 +338,31 @@ namespace eutelescope {
      */
     virtual void end();
 
-    //! Check if the total cluster charge is above a certain value
-    /*! This is used to select clusters having a total integrated
-     *  charge above a certain value. This threshold value is given on
-     *  a per detector basis and stored into the
-     *  _clusterMinTotalChargeVec.
+    //! Add a cluster to the selection table
+    /*! Only the columns of the switched on cuts are filled. A column
+     *  value which a cut does not apply to, like the total charge of
+     *  a digital cluster, is set so that the cut always passes.
      *
      *  @param cluster The cluster under test.
-     *  @return True if the @c cluster has a charge below its own threshold.
-     *
+     *  @param isDigital True for a EUTelDFFClusterImpl.
      */
-    bool isAboveMinTotalCharge(EUTelVirtualCluster *cluster) const;
+    void addSelectionRow(EUTelVirtualCluster *cluster, bool isDigital);
 
-    //! Check if the total cluster SNR is above a certain value
-    /*! This is used to select clusters having a total SNR above a
-     *  certain value. This threshold value is given on a per detector
-     *  basis and stored into the _minTotalSNRVec.
+    //! Apply the cuts expressed as selection predicates
+    /*! The minimum total charge, minimum total SNR, minimum hit pixel
+     *  and ROI cuts are evaluated over all the clusters of the event
+     *  in _selectionTable, one predicate per cut, so that the
+     *  rejections of every cut are still counted.
      *
-     *  @param cluster The cluster under test.
-     *  @return True if the @c cluster has a SNR below its own
-     *  threshold.
+     *  @param accepted One flag per cluster, cleared for the rejected
+     *  ones.
      */
-    bool isAboveMinTotalSNR(EUTelVirtualCluster *cluster) const;
+    void applySelection(std::vector<bool> &accepted) const;
+
+    //! Count the rejections of a cut and clear their flag
+    template <class P>
+    void applyCut(selection::Predicate<P> const &cut, std::string const &name,
+                  std::vector<bool> &accepted) const;
 
     //! Check if the total cluster charge is below a certain value
     /*! This is used to select clusters having a total integrated
@@ -372,20 +377,9 @@ namespace eutelescope {
       return true;
     }
 
-    //! Check if the total cluster charge is above a certain value
-    /*! This is used to select clusters having a total integrated
-     *  charge above a certain value. This threshold value is given on
-     *  a per detector basis and stored into the
-     *  _clusterMaxTotalChargeVec.    .
-     *
-     *  @param cluster The cluster under test.
-     *
-     */
-    bool isAboveNumberOfHitPixel(EUTelVirtualCluster *cluster) const;
-
     //! Check against the charge collected by N pixels
-    /*! This is working in a similar way to the isAboveMinTotalCharge
-     *  but is comparing not the total charge but the charge collected
+    /*! This is working in a similar way to the minimum total charge
+     *  cut but is comparing not the total charge but the charge collected
      *  by the first N most significant pixels
      *
      *  The thresholds are stored into a vector on a detector
@@ -494,26 +488,6 @@ namespace eutelescope {
      */
     bool areClusterTooMany(std::vector<int> clusterVec) const;
 
-    //! Inside the ROI
-    /*! This selection criterion can be used to get only clusters
-     *  having the center within a certain ROI.
-     *
-     *  @return True if the cluster center is inside the ROI
-     *  @param cluster The cluster under test.
-     *
-     */
-    bool isInsideROI(EUTelVirtualCluster *cluster) const;
-
-    //! Outside the ROI
-    /*! This selection criterion can be used to get only clusters
-     *  having the center outside a certain ROI.
-     *
-     *  @return True if the cluster center is outside the ROI
-     *  @param cluster The cluster under test.
-     *
-     */
-    bool isOutsideROI(EUTelVirtualCluster *cluster) const;
-
     //! Below the maximum cluster noise
     /*! This selection criterion is based on the full cluster noise.
      *
@@ -789,6 +763,9 @@ namespace eutelescope {
      */
     bool _noiseRelatedCuts;
 
+    //! Memory of the cluster objects of the current event
+    EUTelEventArena _eventArena;
+
     //! Switch for the minimum total cluster charge
     bool _minTotalChargeSwitch;
 
@@ -864,43 +841,13 @@ namespace eutelescope {
     // digital fixed frame cuts
     std::vector<int> _DFFNHitsCuts;
 
-  public:
-    //! Helper predicate class
-    /*! The main use of this class is to find a ROI having the same
-     *  detector ID as the current cluster. It is used as a predicate
-     *  in find_if.
-     *
-     *  @author Antonio Bulgheroni, INFN  <mailto:antonio.bulgheroni@gmail.com>
-     *  @version $Id$
-     */
-    class HasSameID {
-    public:
-      //! Default constructor.
-      /*!
-       *  @param id is the detector ID we want to check against
-       */
-      HasSameID(int id) : _id(id) { ; }
-
-      //! Overload operator()
-      /*! This is the operator used by the predicate function in the
-       *  find_if algorithm.
-       *
-       *  The idea is that I have a list or ROI's and I want to find
-       *  the first one having the same detector ID of the cluster I'm
-       *  testing.
-       *
-       *  @param roi The ROI under test
-       *  @return True if the ROI is located on the same sensor
-       *  identified by @c _id
-       */
-      bool operator()(EUTelROI roi) const {
-        return (roi.getDetectorID() == _id);
-      }
-
-    private:
-      //! The detector ID
-      int _id;
-    };
+    //! Thresholds of the selection predicates by sensor ID
+    std::map<int, float> _minTotalChargeMap;
+    std::map<int, float> _minTotalSNRMap;
+    std::map<int, int> _minHitPixelMap;
+
+    //! Properties of the clusters of the current event
+    selection::Table _selectionTable;
   };
 
   //! A global instance of the processor
@@ -10,6 +10,7 @@
 #define EUTELCLUSTERSEPARATIONPROCESSOR_H 1
 
 // eutelescope includes ".h"
+#include "EUTELESCOPE.h"
 
 // marlin includes ".h"
 #include "marlin/Processor.h"
@@ -48,6 +49,12 @@ namespace eutelescope {
    *  clusters with a distance between the seed pixels lesser of equal
    *  to the sum of the two radii.
    *
+   *  The cluster centers of each detector are sorted into a grid of
+   *  cells as large as the longest merging distance, so only clusters
+   *  in neighbouring cells are compared, and the pairs are grouped
+   *  with a disjoint set forest. Busy events with many close clusters
+   *  are therefore processed in linear time.
+   *
    *  Here comes a list of all implemented
    *  separation algorithm:
    *
@@ -160,7 +167,7 @@ namespace eutelescope {
      *
      *  @return true if the algorithm was successfully applied.
      */
-    bool applySeparationAlgorithm(std::vector<std::set<int>> setVector,
+    bool applySeparationAlgorithm(std::vector<std::set<int>> const &setVector,
                                   LCCollectionVec *inputCollectionVec,
                                   LCCollectionVec *outputCollectionVec) const;
 
@@ -175,7 +182,10 @@ namespace eutelescope {
      *  be grouped into a cluster of clusters.
      *
      *  Of course this method is called if, and only if, at least a
-     *  pair merging clusters have been found
+     *  pair merging clusters have been found. Each pair joins the
+     *  groups of its two clusters in a disjoint set forest, so the
+     *  grouping is linear in the number of pairs. The groups are
+     *  ordered by their smallest cluster index.
      *
      *  @param pairVector A STL vector of STL pairs. For each pairs,
      *  the two integers represent the cluster indices within the
@@ -186,8 +196,9 @@ namespace eutelescope {
      *  above and the int value_type of the set represents the cluster
      *  index in the clusterCollection
      */
-    void groupingMergingPairs(std::vector<std::pair<int, int>> pairVector,
-                              std::vector<std::set<int>> *setVector) const;
+    void
+    groupingMergingPairs(std::vector<std::pair<int, int>> const &pairVector,
+                         std::vector<std::set<int>> *setVector) const;
 
   protected:
     //! Input cluster collection name.
@@ -225,6 +236,9 @@ namespace eutelescope {
      * events are counted from 0 and on a run base
      */
     int _iEvt;
+
+    //! Pixel type of the sparse clusters in the current event
+    SparsePixelType _sparsePixelType;
   };
 
   //! A global instance of the processor
@@ -17,6 +17,7 @@
 #include "EUTELESCOPE.h"
 #include "EUTelExceptions.h"
 #include "EUTelGeometryTelescopeGeoDescription.h"
+#include "EUTelProcessorProfile.h"
 
 // marlin includes ".h"
 #include "marlin/EventModifier.h"
@@ -339,6 +340,21 @@ namespace eutelescope {
      */
     void resetStatus(IMPL::TrackerRawDataImpl *status);
 
+    //! Reset only the status entries touched by the previous event
+    /*! The ZS clustering algorithms only mark the pixels around
+     *  their seeds as EUTELESCOPE::HITPIXEL or
+     *  EUTELESCOPE::MISSINGPIXEL. The indices of these pixels are
+     *  recorded in _touchedStatusMap and only those are set back to
+     *  EUTELESCOPE::GOODPIXEL, instead of walking through the full
+     *  sensor frame as resetStatus does. The first time a status
+     *  object is seen in a run, resetStatus is called.
+     *
+     *  @param status A pointer to the TrackerRawData with the status
+     *  to be reset
+     *  @return The list where the touched indices have to be recorded
+     */
+    std::vector<int> &resetTouchedStatus(IMPL::TrackerRawDataImpl *status);
+
 #if defined(USE_AIDA) || defined(MARLIN_USE_AIDA)
     //! Book histograms
     /*! This method is used to prepare the needed directory structure
@@ -856,7 +872,18 @@ namespace eutelescope {
 
     std::vector<std::map<int, int>> _hitIndexMapVec;
 
+    //! Status entries modified by the ZS clustering
+    /*! Key is the status object of a sensor, value the list of the
+     *  indices changed to EUTELESCOPE::HITPIXEL or
+     *  EUTELESCOPE::MISSINGPIXEL in the last event. Cleared at every
+     *  new run.
+     */
+    std::map<IMPL::TrackerRawDataImpl *, std::vector<int>> _touchedStatusMap;
+
     int ID;
+
+    //! Hot path timing and counters, summarised in end()
+    EUTelProcessorProfile _profile;
   };
 
   //! A global instance of the processor
@@ -11,6 +11,7 @@
 #if defined(USE_GEAR)
 
 // eutelescope includes ".h"
+#include "EUTelCollectionCache.h"
 
 // ROOT includes
 #include "TVector3.h"
@@ -384,6 +385,9 @@ namespace eutelescope {
 
     std::vector<int> _sensorIDVec;
     std::map<int, int> _sensorIDtoZ;
+
+    //! Exception free collection lookup
+    EUTelCollectionCache _collectionCache;
   };
 
   //! A global instance of the processor
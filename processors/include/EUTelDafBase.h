@@ -12,7 +12,9 @@
 
 // eutelescope includes
 #include "EUTelAlignmentConstant.h"
+#include "EUTelCollectionCache.h"
 #include "EUTelDafTrackerSystem.h"
+#include "EUTelProcessorProfile.h"
 #include "EUTelUtility.h"
 
 // marlin includes ".h"
@@ -113,6 +115,16 @@ namespace eutelescope {
      * measurement to be included in the fit.
      */
     float _chi2cutoff;
+
+    //! Adaptive DAF annealing
+    /*!
+     * Instead of the fixed annealing schedule, jump to the final temperature
+     * once no weight changes by more than _dafWeightTolerance, start
+     * candidates from the combinatorialKF at _dafWarmStartT and skip planes
+     * without weight in the filters.
+     */
+    bool _adaptiveDaf;
+    float _dafWeightTolerance, _dafWarmStartT;
     float _nXdz, _nYdz, _nXdzMaxDeviance, _nYdzMaxDeviance;
     int _nDutHits;
 
@@ -184,6 +196,10 @@ namespace eutelescope {
     bool _histogramSwitch;
     //! LCIO switch
     bool _addToLCIO;
+    //! Exception free collection lookup
+    EUTelCollectionCache _collectionCache;
+    //! Hot path timing and counters, summarised in end()
+    EUTelProcessorProfile _profile;
   };
 }
 #endif
@@ -68,6 +68,8 @@ namespace eutelescope {
                    LCCollectionVec *lcvec);
     //! LCIO switch
     bool _addToLCIO, _fitDuts;
+    //! DAF iterations of all candidates
+    long _nDafIterations;
   };
   //! A global instance of the processor
   EUTelDafFitter gEUTelDafFitter;
@@ -56,6 +56,10 @@ namespace daffitter {
     // Results from fit
     T chi2, ndof;
     std::vector<TrackEstimate<T, N>> estimates;
+    // Indexes were found and chi2 checked by the CKF, the DAF may warm start
+    bool warmStart;
+    // Number of DAF iterations of the last fit
+    size_t dafIterations;
     void print();
     void init(int nPlanes);
     TrackCandidate(int nPlanes);
@@ -209,10 +213,19 @@ namespace daffitter {
     T m_nXdz, m_nYdz, m_nXdzdeviance, m_nYdzdeviance;
     T m_dafChi2, m_ckfChi2, m_chi2OverNdof, m_sqrClusterRadius;
     size_t m_skipMax;
+    // Adaptive DAF: stop annealing on converged weights, warm start CKF
+    // candidates and skip planes without weight
+    bool m_adaptiveDaf;
+    T m_dafWeightTolerance, m_dafWarmStartT, m_dafMinWeight;
+    // Weights before the last DAF iteration
+    std::vector<Eigen::Matrix<T, Eigen::Dynamic, 1>> m_prevWeights;
 
     int addNeighbors(std::vector<PlaneHit<T>> &candidate,
                      std::list<PlaneHit<T>> &hits);
     T runTweight(T t, daffitter::TrackCandidate<T, N> &candidate);
+    T getMaxWeightChange(daffitter::TrackCandidate<T, N> &candidate);
+    void updateInfoDaf(size_t plane, TrackEstimate<T, N> &e,
+                       daffitter::TrackCandidate<T, N> &candidate);
     T fitPlanesInfoDafInner(daffitter::TrackCandidate<T, N> &candidate);
     T fitPlanesInfoDafBiased(daffitter::TrackCandidate<T, N> &candidate);
     size_t getMinClusterSize() const { return (m_minClusterSize); }
@@ -269,6 +282,19 @@ namespace daffitter {
     T getXdzMaxDeviance() const { return (m_nXdzdeviance); }
     T getYdzMaxDeviance() const { return (m_nYdzdeviance); }
 
+    // Adaptive DAF, off by default
+    void setAdaptiveDaf(bool adaptive) { m_adaptiveDaf = adaptive; }
+    bool isAdaptiveDaf() const { return (m_adaptiveDaf); }
+    // Largest weight change for which the annealing is considered converged
+    void setDafWeightTolerance(T tol) { m_dafWeightTolerance = tol; }
+    T getDafWeightTolerance() const { return (m_dafWeightTolerance); }
+    // First temperature for candidates with warmStart set
+    void setDafWarmStartT(T t) { m_dafWarmStartT = t; }
+    T getDafWarmStartT() const { return (m_dafWarmStartT); }
+    // Planes with a lower sum of weights are left out of the filters
+    void setDafMinWeight(T weight) { m_dafMinWeight = weight; }
+    T getDafMinWeight() const { return (m_dafMinWeight); }
+
     // Track finders
     void clusterTracker();
     void truthTracker();
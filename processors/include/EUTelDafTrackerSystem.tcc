@@ -71,6 +71,8 @@ void TrackCandidate<T,N>::init(int nPlanes){
   indexes.resize(nPlanes);
   weights.resize(nPlanes);
   estimates.resize(nPlanes);
+  warmStart = false;
+  dafIterations = 0;
 }
 
 template<typename T, size_t N>
@@ -144,7 +146,9 @@ void PlaneHit<T>::print() {
 
 template <typename T, size_t N>
 TrackerSystem<T, N>::TrackerSystem() : m_inited(false), m_maxCandidates(100), m_minClusterSize(3), m_nXdz(0.0f), m_nYdz(0.0),
-				       m_nXdzdeviance(0.01),m_nYdzdeviance(0.01), m_skipMax(2) {
+				       m_nXdzdeviance(0.01),m_nYdzdeviance(0.01), m_skipMax(2),
+				       m_adaptiveDaf(false), m_dafWeightTolerance(1e-2), m_dafWarmStartT(4.0),
+				       m_dafMinWeight(1e-6) {
   //Constructor for the system of detector planes.
 }
 
@@ -155,7 +159,9 @@ TrackerSystem<T, N>::TrackerSystem(const TrackerSystem<T,N>& sys) : m_inited(fal
 								    m_nXdzdeviance(sys.m_nXdzdeviance), m_nYdzdeviance(sys.m_nYdzdeviance),
 								    m_dafChi2(sys.m_dafChi2), m_ckfChi2(sys.m_ckfChi2), 
 								    m_chi2OverNdof(sys.m_chi2OverNdof), m_sqrClusterRadius(sys.m_sqrClusterRadius),
-								    m_skipMax(sys.m_skipMax){
+								    m_skipMax(sys.m_skipMax), m_adaptiveDaf(sys.m_adaptiveDaf),
+								    m_dafWeightTolerance(sys.m_dafWeightTolerance),
+								    m_dafWarmStartT(sys.m_dafWarmStartT), m_dafMinWeight(sys.m_dafMinWeight){
   //Copy constructor. Copy relevant info from sys, add planes and init.
   for(size_t ii = 0; ii < sys.planes.size(); ii++){
     //const FitPlane<T>& pl = sys.planes.at(ii);
@@ -581,6 +587,20 @@ T TrackerSystem<T, N>::runTweight(T t, TrackCandidate<T, N>& candidate){
   return( ndof );
 }
 
+template <typename T,size_t N>
+T TrackerSystem<T, N>::getMaxWeightChange(TrackCandidate<T, N>& candidate){
+  //Largest change of a measurement weight in the last DAF iteration
+  T maxChange(0.0f);
+  for(size_t plane = 0; plane < planes.size(); plane++){
+    const Eigen::Matrix<T, Eigen::Dynamic, 1>& prev = m_prevWeights.at(plane);
+    const Eigen::Matrix<T, Eigen::Dynamic, 1>& cur = candidate.weights.at(plane);
+    if(cur.size() == 0) { continue; }
+    if(prev.size() != cur.size()) { return( 1.0f ); }
+    maxChange = std::max(maxChange, (cur - prev).cwiseAbs().maxCoeff());
+  }
+  return( maxChange );
+}
+
 template <typename T,size_t N>
 void TrackerSystem<T, N>::fitPlanesInfoDaf(TrackCandidate<T, N>& candidate){
   // Get smoothed estimates for all planes using the unbiased DAF
@@ -601,13 +621,31 @@ void TrackerSystem<T, N>::fitPlanesInfoDaf(TrackCandidate<T, N>& candidate){
   fitPlanesInfoDafInner(candidate);
   if(isnan(ndof)) { ndof = -10.0; }
 
-  // Running with fixed annealing schedule.
-  if(ndof > -1.0f) { ndof = runTweight(25.0, candidate); }
-  if(ndof > -1.0f) { ndof = runTweight(20.0, candidate); }
-  if(ndof > -1.9f) { ndof = runTweight(14.0, candidate); }
-  if(ndof > -1.9f) { ndof = runTweight( 8.0, candidate); }
-  if(ndof > -1.9f) { ndof = runTweight( 4.0, candidate); }
-  if(ndof > -1.9f) { ndof = runTweight( 1.0, candidate); }
+  // Annealing schedule, and the minimum ndof for running each temperature.
+  const T temperatures[] = { 25.0, 20.0, 14.0, 8.0, 4.0, 1.0 };
+  const T minNdof[] = { -1.0f, -1.0f, -1.9f, -1.9f, -1.9f, -1.9f };
+  const size_t nSteps = sizeof(temperatures) / sizeof(temperatures[0]);
+
+  // A CKF candidate is already close to the final assignment, the fit of its
+  // hard weights above is the CKF estimate. Start at a lower temperature.
+  size_t step = 0;
+  if(m_adaptiveDaf and candidate.warmStart){
+    while(step < nSteps - 1 and temperatures[step] > m_dafWarmStartT){ step++; }
+  }
+
+  candidate.dafIterations = 0;
+  for(; step < nSteps; step++){
+    if(not (ndof > minNdof[step])) { continue; }
+    if(m_adaptiveDaf) { m_prevWeights = candidate.weights; }
+    ndof = runTweight(temperatures[step], candidate);
+    candidate.dafIterations++;
+    // Weights are stable, only the final temperature is left to run. It drops
+    // the outliers a high temperature still gives weight to.
+    if(m_adaptiveDaf and step + 2 < nSteps and
+       getMaxWeightChange(candidate) < m_dafWeightTolerance){
+      step = nSteps - 2;
+    }
+  }
   
   if(ndof > -1.9f) {
     for(int ii = 0; ii <(int)  planes.size() ; ii++ ){
@@ -640,6 +678,14 @@ void TrackerSystem<T, N>::checkNan(TrackEstimate<T, N>& e){
   }
 }
 
+template <typename T,size_t N>
+inline void TrackerSystem<T, N>::updateInfoDaf(size_t plane, TrackEstimate<T, N>& e,
+					       TrackCandidate<T, N>& candidate){
+  //Weighted update, planes without weight add nothing and are skipped in adaptive mode
+  if(m_adaptiveDaf and planes.at(plane).getTotWeight() < m_dafMinWeight) { return; }
+  m_fitter.updateInfoDaf( planes.at(plane), e, candidate.weights.at(plane) );
+}
+
 template <typename T,size_t N>
 T TrackerSystem<T, N>::fitPlanesInfoDafInner(TrackCandidate<T, N>& candidate){
   // Get smoothed estimates for all planes using the weighted information filter
@@ -649,7 +695,7 @@ T TrackerSystem<T, N>::fitPlanesInfoDafInner(TrackCandidate<T, N>& candidate){
 
   //Forward fitter
   m_fitter.forward.at(0) = e;
-  m_fitter.updateInfoDaf( planes.at(0), e, candidate.weights.at(0));
+  updateInfoDaf( 0, e, candidate );
   T ndof( -1.0f * e.params.size());
   ndof += 2 * planes.at(0).getTotWeight();
   for(size_t ii = 1; ii < nPlanes ; ii++ ){
@@ -658,7 +704,7 @@ T TrackerSystem<T, N>::fitPlanesInfoDafInner(TrackCandidate<T, N>& candidate){
     }
     m_fitter.predictInfo( planes.at( ii - 1), planes.at(ii), e );
     m_fitter.forward.at(ii) = e;
-    m_fitter.updateInfoDaf( planes.at(ii), e, candidate.weights.at(ii) );
+    updateInfoDaf( ii, e, candidate );
     m_fitter.addScatteringInfo( planes.at(ii), e);
   }
   //No reason to complete unless >1 measurements are in
@@ -667,12 +713,12 @@ T TrackerSystem<T, N>::fitPlanesInfoDafInner(TrackCandidate<T, N>& candidate){
   //Backward fitter, never bias
   e.makeSeedInfo();
   m_fitter.backward.at( nPlanes -1 ) = e;
-  m_fitter.updateInfoDaf( planes.at(nPlanes -1 ), e, candidate.weights.at(nPlanes - 1) );
+  updateInfoDaf( nPlanes - 1, e, candidate );
   for(int ii = nPlanes -2; ii >= 0; ii-- ){
     m_fitter.predictInfo( planes.at( ii + 1 ), planes.at(ii), e );
     m_fitter.addScatteringInfo( planes.at(ii), e);
     m_fitter.backward.at(ii) = e;
-    m_fitter.updateInfoDaf( planes.at(ii), e, candidate.weights.at(ii) );
+    updateInfoDaf( ii, e, candidate );
   }
 
   m_fitter.smoothInfo();
@@ -855,6 +901,8 @@ void TrackerSystem<T, N>::finalizeCKFTrack(TrackEstimate<T, N>& est, vector<int>
     candidate.indexes.at(plane) = indexes.at(plane);
   }
   indexToWeight( candidate );
+  //The hard assignment passed the chi2 cut, the DAF does not need to anneal from scratch
+  candidate.warmStart = true;
   tracks.push_back(candidate);
   m_nTracks++;
 }
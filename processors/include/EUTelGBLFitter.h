@@ -12,6 +12,9 @@
 #ifndef EUTelGBLFitter_h
 #define EUTelGBLFitter_h 1
 
+#include "EUTelCollectionCache.h"
+#include "EUTelGeometryPlaneTable.h"
+#include "EUTelProcessorProfile.h"
 #include "EUTelTripletGBLUtility.h"
 
 #include <memory>
@@ -130,6 +133,15 @@ namespace eutelescope {
     void fillTrackhitHisto(EUTelTripletGBLUtility::hit const & hit, int ipl);
   protected:
     std::string _inputCollectionTelescope;
+
+    //! Exception free collection lookup
+    EUTelCollectionCache _collectionCache;
+
+    //! Hot path timing and counters, summarised in end()
+    EUTelProcessorProfile _profile;
+
+    //! Geometry snapshot of the current run
+    std::shared_ptr<geo::PlaneTable const> _planeTable;
   
     std::map<size_t, bool> _excludedSensorMap;
 
@@ -37,6 +37,7 @@
 #endif
 
 // system includes <>
+#include <cmath>
 #include <map>
 #include <string>
 #include <vector>
@@ -194,6 +195,101 @@ namespace eutelescope {
       unsigned int n;
     };
 
+    //! Analytic straight line fit for the XYShiftsAllRot mode
+    /*! The track is parametrised as x = b0 + ax * z and y = b1 + ay * z.
+     *  Minimising the weighted squared x and y distances at the hit
+     *  positions is a linear least squares problem for each
+     *  projection, solved in closed form via its 2x2 normal
+     *  equations. The result is given in the same (b0, b1, c) form as
+     *  the Minuit fit of trackfitter: the line passes through
+     *  (b0, b1, 0) with unit direction c, c[2] > 0.
+     *
+     *  Hits without a measurement (x and y both zero) do not enter
+     *  the fit.
+     */
+    class linefitter {
+    public:
+      linefitter() : b0(0.), b1(0.), nMeasured(0), ok(false) {
+        c[0] = 0.;
+        c[1] = 0.;
+        c[2] = 1.;
+        chi2[0] = 0.;
+        chi2[1] = 0.;
+      }
+
+      //! Fit the first num hits
+      /*! @return false if there are less than two distinct z
+       *  positions
+       */
+      bool fit(hit const *hits, unsigned int num) {
+        // normal equations: sums over w, w*z, w*z^2, w*u, w*z*u
+        double sx[5] = {0., 0., 0., 0., 0.};
+        double sy[5] = {0., 0., 0., 0., 0.};
+        unsigned int nFit = 0;
+        for (unsigned int i = 0; i < num; i++) {
+          const hit &h = hits[i];
+          if (std::abs(h.x) < 1e-06 && std::abs(h.y) < 1e-06) {
+            continue;
+          }
+          const double wx = 1.0 / (h.resolution_x * h.resolution_x);
+          const double wy = 1.0 / (h.resolution_y * h.resolution_y);
+          sx[0] += wx;
+          sx[1] += wx * h.z;
+          sx[2] += wx * h.z * h.z;
+          sx[3] += wx * h.x;
+          sx[4] += wx * h.z * h.x;
+          sy[0] += wy;
+          sy[1] += wy * h.z;
+          sy[2] += wy * h.z * h.z;
+          sy[3] += wy * h.y;
+          sy[4] += wy * h.z * h.y;
+          nFit++;
+        }
+
+        const double detx = sx[0] * sx[2] - sx[1] * sx[1];
+        const double dety = sy[0] * sy[2] - sy[1] * sy[1];
+        ok = nFit > 1 && detx > 0. && dety > 0.;
+        if (!ok) {
+          return false;
+        }
+
+        const double ax = (sx[0] * sx[4] - sx[1] * sx[3]) / detx;
+        const double ay = (sy[0] * sy[4] - sy[1] * sy[3]) / dety;
+        b0 = (sx[3] - ax * sx[1]) / sx[0];
+        b1 = (sy[3] - ay * sy[1]) / sy[0];
+
+        const double norm = std::sqrt(1.0 + ax * ax + ay * ay);
+        c[0] = ax / norm;
+        c[1] = ay / norm;
+        c[2] = 1.0 / norm;
+
+        chi2[0] = 0.;
+        chi2[1] = 0.;
+        for (unsigned int i = 0; i < num; i++) {
+          const hit &h = hits[i];
+          if (std::abs(h.x) < 1e-06 && std::abs(h.y) < 1e-06) {
+            continue;
+          }
+          const double rx = (b0 + ax * h.z - h.x) / h.resolution_x;
+          const double ry = (b1 + ay * h.z - h.y) / h.resolution_y;
+          chi2[0] += rx * rx;
+          chi2[1] += ry * ry;
+        }
+        return true;
+      }
+
+      double b0;
+      double b1;
+      double c[3];
+
+      //! chi2 of the x and y projection
+      double chi2[2];
+
+      //! Number of planes with a measured hit, set by the caller
+      size_t nMeasured;
+      bool ok;
+    };
+
     //! Variables for hit parameters
     class HitsInPlane {
     public:
@@ -321,6 +417,19 @@ namespace eutelescope {
     TVector3 Line2Plane(int iplane, const TVector3 &lpoint,
                         const TVector3 &lvector);
 
+    //! Collect the hits of a track candidate for the XYShiftsAllRot fit
+    /*! Excluded planes and hits outside the residual windows are
+     *  skipped, planes without a hit get a very large resolution.
+     *
+     *  @param track The track candidate
+     *  @param hits Output array, at least _nPlanes long
+     *  @param nMeasured Set to the number of planes with a hit
+     *  @param mean Set to the mean x, y and z of the measured hits
+     *  @return The number of hits written to hits
+     */
+    unsigned int collectTrackHits(int track, hit *hits, size_t &nMeasured,
+                                  double *mean);
+
     virtual inline int getAllowedMissingHits() { return _allowedMissingHits; }
     virtual inline int getMimosa26ClusterChargeMin() {
       return _mimosa26ClusterChargeMin;
@@ -395,6 +504,7 @@ namespace eutelescope {
     std::string _alignModeString;
     Utility::alignMode _alignMode;
     bool _useResidualCuts;
+    bool _useMinuitTrackFit;
 
     FloatVec _residualsXMin;
     FloatVec _residualsYMin;
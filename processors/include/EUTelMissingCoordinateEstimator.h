@@ -148,6 +148,16 @@ namespace eutelescope {
      */
     float _maxResidual;
 
+    //! Indexed pairing
+    /*! If true, the second reference plane hits are sorted by the
+     *  known coordinate, and for each hit on the first reference
+     *  plane and DUT hit only the ones which can give a residual below
+     *  MaxResidual are tested. The created hits are the same as with
+     *  the loop over all hit combinations, but the time grows with the
+     *  square of the occupancy instead of its third power.
+     */
+    bool _indexedPairing;
+
     //! Clone Hit
     /*! This method is used to clone TrackerHitImpl object
      */
@@ -12,6 +12,7 @@
 #define EUTELPROCESSORAPPLYALIGNMENT_H
 
 // eutelescope includes ".h"
+#include "EUTelProcessorProfile.h"
 
 // marlin includes ".h"
 #include "marlin/Processor.h"
@@ -167,6 +168,9 @@ namespace eutelescope {
 
     //! Look Up Table for the sensor ID
     std::map<int, int> _lookUpTable;
+
+    //! Hot path timing and counters, summarised in end()
+    EUTelProcessorProfile _profile;
   };
 
   //! A global instance of the processor
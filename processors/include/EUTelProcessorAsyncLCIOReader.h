@@ -0,0 +1,91 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELPROCESSORASYNCLCIOREADER_H
+#define EUTELPROCESSORASYNCLCIOREADER_H
+
+// eutelescope includes ".h"
+#include "EUTELESCOPE.h"
+
+// marlin includes ".h"
+#include "marlin/DataSourceProcessor.h"
+
+// lcio includes <.h>
+#include <LCIOTypes.h>
+
+// system includes
+#include <string>
+#include <vector>
+
+namespace eutelescope {
+
+  //! Data source reading LCIO files ahead of the processing
+  /*! A replacement for the LCIOInputFiles of the global section: the
+   *  files are read by an EUTelAsyncLCIOReader, so the decompression
+   *  and construction of the next events run on background threads
+   *  while the processors work on the current one. Run headers and
+   *  events are passed to the processors in file order, as by
+   *  Marlin.
+   *
+   *  It has to be the first processor of the steering file, and
+   *  LCIOInputFiles has to be left empty. MaxRecordNumber is
+   *  respected, SkipNEvents is not: use the event selection of the
+   *  processors instead.
+   *
+   *  DecodingThreads files are decoded at the same time, which only
+   *  helps jobs over several files. Needs a thread safe LCIO (2.13 or
+   *  later), init() throws with an older one.
+   */
+
+  class EUTelProcessorAsyncLCIOReader : public marlin::DataSourceProcessor {
+
+  public:
+    //! Returns a new instance of EUTelProcessorAsyncLCIOReader
+    virtual EUTelProcessorAsyncLCIOReader *newProcessor() {
+      return new EUTelProcessorAsyncLCIOReader;
+    }
+
+    //! Default constructor
+    EUTelProcessorAsyncLCIOReader();
+
+    //! Reads the files and calls the processors
+    /*! @param numEvents Maximum number of events, all if not positive
+     *
+     *  @throw lcio::IOException if a file cannot be read
+     */
+    virtual void readDataSource(int numEvents);
+
+    //! Prints the parameters
+    virtual void init();
+
+    //! Prints the number of records read
+    virtual void end();
+
+  protected:
+    //! Input files, read in this order
+    std::vector<std::string> _fileNames;
+
+    //! Records decoded ahead per thread
+    int _readAhead;
+
+    //! Files decoded at the same time
+    int _nThreads;
+
+    //! Number of run headers read
+    long _nRunHeaders;
+
+    //! Number of events read
+    long _nEvents;
+  };
+
+  //! A global instance of the processor
+  EUTelProcessorAsyncLCIOReader gEUTelProcessorAsyncLCIOReader;
+
+} // namespace eutelescope
+
+#endif // EUTELPROCESSORASYNCLCIOREADER_H
@@ -0,0 +1,103 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELPROCESSORCONVERTSPARSEPIXELS_H
+#define EUTELPROCESSORCONVERTSPARSEPIXELS_H
+
+// eutelescope includes ".h"
+#include "EUTELESCOPE.h"
+
+// marlin includes ".h"
+#include "marlin/Processor.h"
+
+// lcio includes <.h>
+#include <LCIOTypes.h>
+
+// system includes
+#include <string>
+
+namespace eutelescope {
+
+  //! Processor converting a sparse pixel collection to another type
+  /*! Every TrackerData of the input collection is copied into the
+   *  output collection with all its pixels converted to the
+   *  OutputPixelType, and the sparsePixelType field of the cell ID
+   *  changed accordingly.
+   *
+   *  Its main use is to convert existing files to the compact
+   *  EUTelPackedPixel encoding (the default) and back: a job with
+   *  only the reader, this processor and an LCIO output processor
+   *  dropping the input collection rewrites a file. The sizes of the
+   *  pixel data before and after the conversion are printed at the
+   *  end.
+   *
+   *  Any pixel type except EUTelGeometricPixel converts to the packed
+   *  one. Otherwise the output type has to be the input type or one
+   *  of its base classes, e.g. EUTelMuPixel or EUTelGeometricPixel to
+   *  EUTelGenericSparsePixel, whose fields are kept and the others
+   *  dropped.
+   */
+
+  class EUTelProcessorConvertSparsePixels : public marlin::Processor {
+
+  public:
+    //! Returns a new instance of EUTelProcessorConvertSparsePixels
+    virtual Processor *newProcessor() {
+      return new EUTelProcessorConvertSparsePixels;
+    }
+
+    //! Default constructor
+    EUTelProcessorConvertSparsePixels();
+
+    //! Called at the job beginning.
+    /*! Prints the parameters and checks the output pixel type
+     *
+     *  @throw InvalidParameterException for an unknown pixel type
+     */
+    virtual void init();
+
+    //! Called for every run.
+    virtual void processRunHeader(LCRunHeader *run);
+
+    //! Called every event
+    /*! Converts the input collection, if present
+     *
+     *  @throw InvalidParameterException if the pixels of a sensor
+     *  cannot be converted to the OutputPixelType
+     */
+    virtual void processEvent(LCEvent *evt);
+
+    //! Prints the size of the pixel data
+    virtual void end();
+
+  protected:
+    //! Input sparse pixel collection name
+    std::string _inputCollectionName;
+
+    //! Output sparse pixel collection name
+    std::string _outputCollectionName;
+
+    //! Pixel type of the output collection (SparsePixelType enum)
+    int _outputPixelType;
+
+    //! Number of pixels converted
+    long long _nPixels;
+
+    //! Number of floats of the pixel data in the input collections
+    long long _nInputValues;
+
+    //! Number of floats of the pixel data in the output collections
+    long long _nOutputValues;
+  };
+
+  //! A global instance of the processor
+  EUTelProcessorConvertSparsePixels gEUTelProcessorConvertSparsePixels;
+
+} // namespace eutelescope
+
+#endif // EUTELPROCESSORCONVERTSPARSEPIXELS_H
@@ -15,6 +15,7 @@
 
 // eutelescope includes ".h"
 #include "EUTelEventImpl.h"
+#include "EUTelProcessorProfile.h"
 #include "EUTelUtility.h"
 
 // marlin includes ".h"
@@ -87,6 +88,9 @@ namespace eutelescope {
     std::string _hitCollectionNameOutput;
     bool _undoAlignment;
 
+    //! Hot path timing and counters, summarised in end()
+    EUTelProcessorProfile _profile;
+
   }; // close class declaration
 
   //! A global instance of the processor
@@ -33,6 +33,7 @@ protected:
   LCCollectionVec *zsInputDataCollectionVec;
   std::string _deadColumnFile;
   std::string _deadColumnCollectionName;
+  std::string _maskDBFile;
   bool _fillHistos;
 
 private:
@@ -12,7 +12,9 @@
 
 // eutelescope includes ".h"
 #include "EUTELESCOPE.h"
+#include "EUTelEventArena.h"
 #include "EUTelExceptions.h"
+#include "EUTelProcessorProfile.h"
 
 // marlin includes ".h"
 #include "marlin/EventModifier.h"
@@ -342,6 +344,12 @@ namespace eutelescope {
 
     //! pulse Collection
     LCCollectionVec *_pulseCollectionVec;
+
+    //! Memory of the cluster objects filled into the histograms
+    EUTelEventArena _eventArena;
+
+    //! Hot path timing and counters, summarised in end()
+    EUTelProcessorProfile _profile;
   };
 
   //! A global instance of the processor
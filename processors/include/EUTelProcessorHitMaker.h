@@ -12,6 +12,10 @@
 // built only if GEAR is available
 #ifdef USE_GEAR
 // eutelescope includes ".h"
+#include "EUTelCollectionCache.h"
+#include "EUTelEtaTable.h"
+#include "EUTelGeometryPlaneTable.h"
+#include "EUTelProcessorProfile.h"
 #include "EUTelUtility.h"
 
 // marlin includes ".h"
@@ -34,7 +38,9 @@
 #include <IMPL/LCCollectionVec.h>
 
 // system includes <>
+#include <array>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -303,6 +309,25 @@ namespace eutelescope {
     void bookHistos(int sensorID);
 
   protected:
+    //! Load the eta tables from the condition collections
+    /*! @return false if the collections are not available
+     */
+    bool loadEtaTables(LCEvent *event);
+
+    //! Eta corrected CoG of all generic sparse clusters
+    /*! The charge center of gravity (in pixel units) of all clusters
+     *  made of kEUTelGenericSparsePixel is computed and then the eta
+     *  correction is applied sensor by sensor with one batch call per
+     *  sensor and direction.
+     *
+     *  @param pulseCollection The input pulse collection
+     *  @param cog The corrected CoG, indexed as the pulse collection
+     *  @param valid Flags the entries of @a cog which have been filled
+     */
+    void etaCorrectedCoG(LCCollectionVec *pulseCollection,
+                         std::vector<std::array<double, 2>> &cog,
+                         std::vector<bool> &valid);
+
     //! TrackerPulse collection name
     /*! This is the name of the collection holding the pulse
      *  information. The other collection containing the original
@@ -320,6 +345,12 @@ namespace eutelescope {
     //! Coordinates reference frame switch
     bool _wantLocalCoordinates;
 
+    //! Eta correction switch
+    bool _etaSwitch;
+
+    //! Eta collection names along x and y
+    std::vector<std::string> _etaCollectionNames;
+
   private:
     //! Run number
     int _iRun;
@@ -413,6 +444,18 @@ namespace eutelescope {
      */
     std::vector<int> _orderedSensorIDVec;
 
+    //! Exception free collection lookup
+    EUTelCollectionCache _collectionCache;
+
+    //! Hot path timing and counters, summarised in end()
+    EUTelProcessorProfile _profile;
+
+    //! Geometry snapshot, refreshed in processRunHeader
+    std::shared_ptr<geo::PlaneTable const> _planeTable;
+
+    //! Eta tables along x and y per sensor ID
+    std::map<int, std::array<EUTelEtaTable, 2>> _etaTables;
+
     void DumpReferenceHitDB();
   };
 
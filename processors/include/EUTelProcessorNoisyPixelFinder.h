@@ -229,6 +229,9 @@ namespace eutelescope {
      */
     int _iEvt;
 
+    //! Number of the (last) run seen, stored as mask provenance
+    int _runNumber;
+
     //! Sensor ID vector
     /*! Passed as a argument via the steering file, here you
      *  specify for which sensors hot pixels should be determined
@@ -238,6 +241,12 @@ namespace eutelescope {
     //! Hot Pixel DB output file
     std::string _noisyPixelDBFile;
 
+    //! Optional compact mask DB output file
+    /*! If set, the noisy pixels are also written in the
+     *  EUTelPixelMaskDB format.
+     */
+    std::string _maskDBFile;
+
     //! write out the list of hot pixels
     void noisyPixelDBWriter();
 
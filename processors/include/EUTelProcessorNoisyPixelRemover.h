@@ -11,6 +11,7 @@
 
 // eutelescope includes ".h"
 #include "EUTelEventImpl.h"
+#include "EUTelPixelMaskDB.h"
 
 // marlin includes ".h"
 #include "marlin/Processor.h"
@@ -95,6 +96,12 @@ namespace eutelescope {
     //! Collection name for noisy pixel collection
     std::string _noisyPixelCollectionName;
 
+    //! Optional compact mask file used instead of the collection
+    std::string _maskDBFile;
+
+    //! The masks read from _maskDBFile
+    EUTelPixelMaskDB _maskDB;
+
     std::map<int, std::vector<int>> _noisyPixelMap;
     bool _firstEvent = true;
   };
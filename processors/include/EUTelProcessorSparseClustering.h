@@ -12,7 +12,10 @@
 
 // eutelescope includes ".h"
 #include "EUTELESCOPE.h"
+#include "EUTelCollectionCache.h"
+#include "EUTelEventArena.h"
 #include "EUTelExceptions.h"
+#include "EUTelProcessorProfile.h"
 
 // marlin includes ".h"
 #include "marlin/EventModifier.h"
@@ -86,6 +89,13 @@ namespace eutelescope {
    *  @param TCut This is the time cut value used to determine if hits are in
    *  temporal proximity. Values are in your detector specific time unit
    *
+   *  @param TimeWindowClustering Cluster the pixels of each sensor in time
+   *  order, only joining pixels within TCut of each other. Meant for data
+   *  driven sensors (Timepix3, MuPix) reading out long frames: clusters are
+   *  completed as the time window slides on, see
+   *  Utility::TimeWindowClusterer. The time is the hit time for
+   *  EUTelMuPixel and the time of the generic pixels.
+   *
    *  @param HistoInfoFileName This is the name of the XML file
    *  containing the histogram booking information.
    *
@@ -272,6 +282,9 @@ namespace eutelescope {
     //! The time cut value as provided by the user.
     float _cutT;
 
+    //! Switch for the time ordered sliding window clustering
+    bool _timeWindowClustering;
+
   private:
     DISALLOW_COPY_AND_ASSIGN(EUTelProcessorSparseClustering)
 
@@ -348,6 +361,16 @@ namespace eutelescope {
 
     //! Squared cut value for distance in pixel index count (integer!)
     int _sparseMinDistanceSquared;
+
+    //! Exception free collection lookup
+    EUTelCollectionCache _collectionCache;
+
+    //! Hot path timing and counters, summarised in end()
+    EUTelProcessorProfile _profile;
+
+    //! Memory of the time window clustering temporaries and of the
+    //! cluster objects filled into the histograms
+    EUTelEventArena _eventArena;
   };
 
   //! A global instance of the processor
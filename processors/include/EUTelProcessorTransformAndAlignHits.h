@@ -0,0 +1,170 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+#ifndef EUTELPROCESSORTRANSFORMANDALIGNHITS_H
+#define EUTELPROCESSORTRANSFORMANDALIGNHITS_H
+
+// built only if GEAR is available
+#ifdef USE_GEAR
+
+// eutelescope includes ".h"
+#include "EUTELESCOPE.h"
+#include "EUTelCollectionCache.h"
+#include "EUTelGeometryPlaneTable.h"
+#include "EUTelProcessorProfile.h"
+#include "EUTelUtility.h"
+
+// marlin includes ".h"
+#include "marlin/Processor.h"
+
+// lcio includes <.h>
+#include <EVENT/LCEvent.h>
+#include <EVENT/LCRunHeader.h>
+#include <IMPL/LCCollectionVec.h>
+#include <IMPL/TrackerHitImpl.h>
+
+// Eigen
+#include <Eigen/Core>
+
+// system includes
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace eutelescope {
+
+  //! Processor placing and aligning hits in a single pass
+  /*! Replaces the chain of EUTelProcessorCoordinateTransformHits
+   *  followed by one EUTelProcessorApplyAlignment per alignment
+   *  constant collection. For every sensor the GEAR placement and
+   *  all the corrections listed in AlignmentConstantNames (applied
+   *  in that order, as by consecutive EUTelProcessorApplyAlignment
+   *  passes) are composed into a single affine transform, so that
+   *  each hit costs one matrix multiplication and no std::map lookup.
+   *
+   *  The transforms are built on the first event of a run and again
+   *  whenever the constants of an alignment collection change, as
+   *  they may within a run with a time stamped LCCD handler.
+   *
+   *  Hits in the local frame get the full transform and are flagged
+   *  with kHitInGlobalCoord, hits already in the global frame only
+   *  get the alignment corrections.
+   *
+   *  If OutputHitCollectionName is the same as
+   *  HitCollectionNameInput, the hits are modified in place and no
+   *  collection is created. Otherwise the hits are copied once into
+   *  the output collection.
+   *
+   *  Unlike the separate processors, which copy it unchanged, the
+   *  covariance matrix is rotated along with the position unless
+   *  TransformCovariance is false.
+   */
+
+  class EUTelProcessorTransformAndAlignHits : public marlin::Processor {
+
+  public:
+    //! Returns a new instance of EUTelProcessorTransformAndAlignHits
+    virtual Processor *newProcessor() {
+      return new EUTelProcessorTransformAndAlignHits;
+    }
+
+    //! Default constructor
+    EUTelProcessorTransformAndAlignHits();
+
+    //! Called at the job beginning.
+    /*! Prints the parameters and initialises the TGeo geometry
+     */
+    virtual void init();
+
+    //! Called for every run.
+    /*! The transforms are rebuilt on the first event of the run, the
+     *  geometry may have changed
+     */
+    virtual void processRunHeader(LCRunHeader *run);
+
+    //! Called every event
+    /*! @throw InvalidGeometryException for a local hit on a sensor
+     *  not in the geometry
+     */
+    virtual void processEvent(LCEvent *evt);
+
+    //! Prints the collection usage
+    virtual void end();
+
+  protected:
+    //! Affine transform of the hits of a sensor
+    struct Transform {
+      Eigen::Matrix3d rotation;
+      Eigen::Vector3d translation;
+    };
+
+    //! Read the alignment collections of the event
+    /*! Rebuilds the transforms if it is the first event of the run or
+     *  if the constants differ from those of the previous event.
+     *
+     *  @return false if an alignment collection is missing
+     */
+    bool updateTransforms(LCEvent *event);
+
+    //! Compose the transforms of all sensors from _alignmentCollections
+    void buildTransforms();
+
+    //! Apply a transform to the position and covariance of a hit
+    void transformHit(Transform const &transform, IMPL::TrackerHitImpl *hit,
+                      double const *position, float const *covariance);
+
+    //! Input hit collection name
+    std::string _hitCollectionNameInput;
+
+    //! Output hit collection name
+    std::string _hitCollectionNameOutput;
+
+    //! Alignment constant collection names, applied in this order
+    std::vector<std::string> _alignmentCollectionNames;
+
+    //! Rotate the covariance matrix too
+    bool _transformCovariance;
+
+  private:
+    DISALLOW_COPY_AND_ASSIGN(EUTelProcessorTransformAndAlignHits)
+
+    //! Exception free lookup of the input and alignment collections
+    EUTelCollectionCache _collectionCache;
+
+    //! Hot path timing and counters, summarised in end()
+    EUTelProcessorProfile _profile;
+
+    //! Geometry of the current run
+    std::shared_ptr<geo::PlaneTable const> _planeTable;
+
+    //! Placement and alignment, by plane ordinal
+    std::vector<Transform> _localTransforms;
+
+    //! Alignment only, by plane ordinal
+    std::vector<Transform> _globalTransforms;
+
+    //! The transforms have to be built on the next event
+    bool _isFirstEvent;
+
+    //! Alignment collections of the current event
+    std::vector<IMPL::LCCollectionVec *> _alignmentCollections;
+
+    //! Constants of the current event and those the transforms were
+    //! built from: the size of each collection followed by sensor
+    //! ID, offsets and angles of its elements
+    std::vector<double> _alignmentValues;
+    std::vector<double> _builtAlignmentValues;
+  };
+
+  //! A global instance of the processor
+  EUTelProcessorTransformAndAlignHits gEUTelProcessorTransformAndAlignHits;
+
+} // namespace eutelescope
+
+#endif // USE_GEAR
+#endif // EUTELPROCESSORTRANSFORMANDALIGNHITS_H
@@ -17,13 +17,8 @@
 #include <Eigen/Core>
 #include <Eigen/LU>
 
-#ifdef DOTHREAD
-#include <boost/bind.hpp>
-#include <boost/thread.hpp>
-#include <boost/thread/detail/thread_group.hpp>
-#endif
-
 #include "EUTelDafTrackerSystem.h"
+#include "EUTelThreadPool.h"
 //#include "simutils.h"
 #include <stdexcept>
 
@@ -49,8 +44,10 @@ private:
   // newtons method
   FITTERTYPE stepVector(gsl_vector *vc, size_t index, FITTERTYPE value,
                         bool doMSE, Minimizer *minimize);
-  // data
-  std::vector<std::vector<Measurement<FITTERTYPE>>> tracks;
+  // data, the measurements of all tracks back to back. Track i is
+  // [trackOffsets[i], trackOffsets[i+1]) in trackMeasurements
+  std::vector<Measurement<FITTERTYPE>> trackMeasurements;
+  std::vector<size_t> trackOffsets;
 
 public:
   int fitCount;
@@ -66,9 +63,12 @@ public:
   double eBeam;
   TrackerSystem<FITTERTYPE, 4> system;
 
+  EstMat() : trackOffsets(1, 0), fitCount(0), itMax(0) { ; }
+
   // Fake constructor
   void init(double eBeam, size_t nPlanes) {
     fitCount = 0;
+    clear();
     this->eBeam = eBeam;
     radLengths.assign(nPlanes, 0.01);
     resX.assign(nPlanes, 4.3);
@@ -104,7 +104,11 @@ public:
   void readTracksToArray(float **measX, float **measY, int nTracks,
                          int nPlanes);
   void readTracksToDoubleArray(float **measX, int nTracks, int nPlanes);
-  void clear() { tracks.clear(); }
+  size_t nTracks() const { return trackOffsets.size() - 1; }
+  void clear() {
+    trackMeasurements.clear();
+    trackOffsets.assign(1, 0);
+  }
   void getExplicitEstimate(TrackEstimate<FITTERTYPE, 4> &estim);
   void printParams(std::string name, std::vector<FITTERTYPE> &params, bool plot,
                    const char *valString);
@@ -113,25 +117,38 @@ public:
 
 class Minimizer {
   bool inited;
+  eutelescope::EUTelThreadPool *pool;
+
+protected:
+  // Partial sums of every job, filled by operator()(offset, stride) in
+  // slot offset and combined in job order by reduce()
+  std::vector<std::vector<double>> partialSums;
+  std::vector<double> sumPartials() const;
 
 public:
   EstMat &mat;
   FITTERTYPE retVal2;
+  // Number of jobs and TrackerSystem copies, 0 for the number of
+  // hardware threads
   size_t nThreads;
   FITTERTYPE result;
-#ifdef DOTHREAD
-  boost::mutex resultGurad;
-#endif
   vector<TrackerSystem<FITTERTYPE, 4>> systems;
 
   // Minimizer(EstMat& mat) : mat(mat) {;}
-  Minimizer(EstMat &mat) : inited(false), mat(mat), nThreads(4) { ; }
-  virtual ~Minimizer() { ; };
+  Minimizer(EstMat &mat)
+      : inited(false), pool(NULL), mat(mat), nThreads(0) {
+    ;
+  }
+  virtual ~Minimizer() { delete pool; };
 
   FITTERTYPE operator()(void);
   virtual void operator()(size_t offset, size_t stride) = 0;
   void prepareThreads();
   virtual void init();
+  // Called on the main thread before the jobs are started
+  virtual void prepare() { ; }
+  // Combine the partial sums into result (and retVal2)
+  virtual void reduce();
   virtual bool twoRetVals() { return (false); }
 };
 
@@ -153,6 +170,7 @@ public:
   FakeChi2(EstMat &mat) : Minimizer(mat), firstRun(false) { ; }
   void calibrate(TrackerSystem<FITTERTYPE, 4> &system);
   virtual void init();
+  virtual void prepare();
   virtual void operator()(size_t offset, size_t stride);
 };
 
@@ -170,6 +188,7 @@ public:
     ;
   }
   virtual void operator()(size_t offset, size_t stride);
+  virtual void reduce();
 };
 
 class FwBw : public Minimizer {
@@ -177,6 +196,7 @@ public:
   vector<FITTERTYPE> results2;
   FwBw(EstMat &mat) : Minimizer(mat), results2(vector<FITTERTYPE>(4, 0.0)) { ; }
   virtual void operator()(size_t offset, size_t stride);
+  virtual void reduce();
   virtual bool twoRetVals() { return (true); };
 };
 
@@ -20,6 +20,7 @@
 // eutelescope includes ".h"
 #include "EUTelAlign.h"
 #include "EUTELESCOPE.h"
+#include "EUTelAlignmentChi2.h"
 #include "EUTelDFFClusterImpl.h"
 #include "EUTelEventImpl.h"
 #include "EUTelFFClusterImpl.h"
@@ -82,6 +83,7 @@ void fitFunctionWrapper(Int_t &npar, Double_t *gin, Double_t &f, Double_t *par,
 }
 
 vector<EUTelAlign::HitsForFit> EUTelAlign::_hitsForFit;
+EUTelAlignmentChi2 EUTelAlign::_chi2Objective;
 
 EUTelAlign::EUTelAlign() : Processor("EUTelAlign") {
 
@@ -903,51 +905,20 @@ void EUTelAlign::Chi2Function(Int_t &npar, Double_t *gin, Double_t &f,
   // par[2]:       theta_x
   // par[3]:       theta_y
   // par[4]:       theta_z
-
-  double x, y, distance;
-  double chi2 = 0.0;
-  int usedevents = 0;
-
-  // loop over all events
-  for (size_t i = 0; i < _hitsForFit.size(); i++) {
-
-    // just to be sure
-    distance = 0.0;
-
-    x = (cos(par[3]) * cos(par[4])) * _hitsForFit[i].secondLayerMeasuredX +
-        ((-1) * sin(par[2]) * sin(par[3]) * cos(par[4]) +
-         cos(par[2]) * sin(par[4])) *
-            _hitsForFit[i].secondLayerMeasuredY +
-        par[0];
-    y = ((-1) * cos(par[3]) * sin(par[4])) *
-            _hitsForFit[i].secondLayerMeasuredX +
-        (sin(par[2]) * sin(par[3]) * sin(par[4]) + cos(par[2]) * cos(par[4])) *
-            _hitsForFit[i].secondLayerMeasuredY +
-        par[1];
-
-    distance = ((x - _hitsForFit[i].secondLayerPredictedX) *
-                    (x - _hitsForFit[i].secondLayerPredictedX) +
-                (y - _hitsForFit[i].secondLayerPredictedY) *
-                    (y - _hitsForFit[i].secondLayerPredictedY)) /
-               100;
-
-    // add chi2 cut here later?
-    if (par[5] == 0.0) {
-
-      chi2 = chi2 + distance;
-      usedevents++;
-
-    } else if (distance < par[5]) {
-
-      chi2 = chi2 + distance;
-      usedevents++;
-    }
-
-  } // end loop over all events
+  // par[5]:       chi2 cut, 0 for no cut
+  //
+  // With iflag == 2 Minuit asks for the derivatives as well, gin is
+  // indexed by the parameter number. The chi2 cut only selects the
+  // hit pairs, its derivative is set to 0.
+
+  size_t usedevents = 0;
+  f = _chi2Objective.evaluate(par, par[5], (iflag == 2) ? gin : nullptr,
+                              &usedevents);
+  if (iflag == 2) {
+    gin[5] = 0.0;
+  }
 
   // streamlog_out ( MESSAGE2) << usedevents << " ";
-
-  f = chi2;
 }
 
 void EUTelAlign::end() {
@@ -955,6 +926,16 @@ void EUTelAlign::end() {
   streamlog_out(MESSAGE2) << "Number of Events used in the fit: "
                           << _hitsForFit.size() << endl;
 
+  // copy the hit pairs into the chi2 objective
+  _chi2Objective.clear();
+  _chi2Objective.reserve(_hitsForFit.size());
+  for (size_t i = 0; i < _hitsForFit.size(); i++) {
+    _chi2Objective.addHitPair(_hitsForFit[i].secondLayerMeasuredX,
+                              _hitsForFit[i].secondLayerMeasuredY,
+                              _hitsForFit[i].secondLayerPredictedX,
+                              _hitsForFit[i].secondLayerPredictedY);
+  }
+
   streamlog_out(MESSAGE2) << "Minuit will soon be started" << endl;
 
   // run MINUIT
@@ -982,6 +963,11 @@ void EUTelAlign::end() {
   arglist[0] = 1;
   gMinuit->mnexcm("SET ERR", arglist, 1, ierflag);
 
+  // use the analytic derivatives of Chi2Function (1 = do not check
+  // them against the numerical ones)
+  arglist[0] = 1;
+  gMinuit->mnexcm("SET GRA", arglist, 1, ierflag);
+
   double start_off_x = _startValuesForAlignment[0];
   double start_off_y = _startValuesForAlignment[1];
   double start_theta_x = _startValuesForAlignment[2];
@@ -1098,8 +1084,10 @@ void EUTelAlign::end() {
                           << endl
                           << endl;
 
-  // release chi2
+  // set the chi2 cut. It is kept fixed: it is not a smooth function
+  // of the chi2 and the analytic gradient does not depend on it
   gMinuit->mnparm(5, "chi2", start_chi2, 1, 0, 0, ierflag);
+  gMinuit->FixParameter(5);
 
   // call migrad (2000 iterations, 0.1 = tolerance)
   arglist[0] = 2000;
@@ -0,0 +1,203 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+// eutelescope includes ".h"
+#include "EUTelAlignmentDriftCorrection.h"
+#include "EUTELESCOPE.h"
+#include "EUTelAlignmentConstant.h"
+#include "EUTelEventImpl.h"
+#include "EUTelExceptions.h"
+#include "EUTelRunHeaderImpl.h"
+
+// marlin includes ".h"
+#include "marlin/Processor.h"
+
+// lcio includes <.h>
+#include <IMPL/LCCollectionVec.h>
+#include <IO/LCReader.h>
+#include <IOIMPL/LCFactory.h>
+#include <Exceptions.h>
+
+// system includes
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+using namespace eutelescope;
+
+EUTelAlignmentDriftCorrection::EUTelAlignmentDriftCorrection()
+    : Processor("EUTelAlignmentDriftCorrection"), _alignmentConstantFile(""),
+      _inputCollectionName(""), _outputCollectionName(""), _windows(),
+      _lastWindow(-1), _sensorIDs(), _runsWithoutWindow() {
+  _description = "EUTelAlignmentDriftCorrection adds the alignment "
+                 "constants of the EUTelAlignmentDriftMonitor window of "
+                 "the current event to every event.";
+
+  registerProcessorParameter("AlignmentConstantFile",
+                             "LCIO file written by EUTelAlignmentDriftMonitor",
+                             _alignmentConstantFile,
+                             std::string("drift-alignment.slcio"));
+  registerOptionalParameter("InputCollectionName",
+                            "Collection name of the constants in the file",
+                            _inputCollectionName, std::string("alignment"));
+  registerOutputCollection(LCIO::LCGENERICOBJECT, "OutputCollectionName",
+                           "Collection name of the constants added to the "
+                           "events",
+                           _outputCollectionName,
+                           std::string("driftAlignment"));
+}
+
+void EUTelAlignmentDriftCorrection::init() {
+  printParameters();
+
+  _windows.clear();
+  _sensorIDs.clear();
+  _runsWithoutWindow.clear();
+  _lastWindow = -1;
+
+  std::unique_ptr<IO::LCReader> reader(
+      IOIMPL::LCFactory::getInstance()->createLCReader());
+  reader->open(_alignmentConstantFile);
+  while (LCEvent *event = reader->readNextEvent()) {
+    LCCollection *collection = nullptr;
+    try {
+      collection = event->getCollection(_inputCollectionName);
+    } catch (lcio::DataNotAvailableException &e) {
+      streamlog_out(WARNING2) << "Window " << event->getEventNumber()
+                              << " of " << _alignmentConstantFile
+                              << " has no " << _inputCollectionName
+                              << " collection, skipped" << std::endl;
+      continue;
+    }
+
+    Window window;
+    window.runNumber = event->getRunNumber();
+    window.firstEvent = event->getParameters().getIntVal("FirstEvent");
+    window.lastEvent = event->getParameters().getIntVal("LastEvent");
+    window.nEvents = 0;
+    for (int iPos = 0; iPos < collection->getNumberOfElements(); ++iPos) {
+      auto alignment = static_cast<EUTelAlignmentConstant const *>(
+          collection->getElementAt(iPos));
+      Constant constant;
+      constant.sensorID = alignment->getSensorID();
+      constant.xOffset = alignment->getXOffset();
+      constant.yOffset = alignment->getYOffset();
+      constant.zOffset = alignment->getZOffset();
+      constant.alpha = alignment->getAlpha();
+      constant.beta = alignment->getBeta();
+      constant.gamma = alignment->getGamma();
+      window.constants.push_back(constant);
+
+      if (std::find(_sensorIDs.begin(), _sensorIDs.end(), constant.sensorID) ==
+          _sensorIDs.end()) {
+        _sensorIDs.push_back(constant.sensorID);
+      }
+    }
+    _windows.push_back(window);
+  }
+  reader->close();
+
+  if (_windows.empty()) {
+    streamlog_out(ERROR4) << _alignmentConstantFile << " has no window"
+                          << std::endl;
+    throw InvalidParameterException("AlignmentConstantFile");
+  }
+
+  // the monitor writes them in order, unless several jobs were merged
+  std::stable_sort(_windows.begin(), _windows.end(),
+                   [](Window const &lhs, Window const &rhs) {
+                     return lhs.runNumber != rhs.runNumber
+                                ? lhs.runNumber < rhs.runNumber
+                                : lhs.firstEvent < rhs.firstEvent;
+                   });
+
+  streamlog_out(MESSAGE4) << "Read " << _windows.size() << " windows from "
+                          << _alignmentConstantFile << std::endl;
+}
+
+void EUTelAlignmentDriftCorrection::processRunHeader(LCRunHeader *rdr) {
+  auto runHeader = std::make_unique<EUTelRunHeaderImpl>(rdr);
+  runHeader->addProcessor(type());
+}
+
+int EUTelAlignmentDriftCorrection::findWindow(int runNumber,
+                                              int eventNumber) const {
+  // events come in order, most of them are in the previous window
+  if (_lastWindow >= 0) {
+    Window const &last = _windows[_lastWindow];
+    if (last.runNumber == runNumber && last.firstEvent <= eventNumber &&
+        eventNumber <= last.lastEvent) {
+      return _lastWindow;
+    }
+  }
+
+  // first window starting after the event
+  auto next = std::upper_bound(
+      _windows.begin(), _windows.end(), std::make_pair(runNumber, eventNumber),
+      [](std::pair<int, int> const &event, Window const &window) {
+        return event.first != window.runNumber
+                   ? event.first < window.runNumber
+                   : event.second < window.firstEvent;
+      });
+  if (next != _windows.begin() && (next - 1)->runNumber == runNumber) {
+    return static_cast<int>(next - 1 - _windows.begin());
+  }
+  if (next != _windows.end() && next->runNumber == runNumber) {
+    return static_cast<int>(next - _windows.begin());
+  }
+  return -1;
+}
+
+void EUTelAlignmentDriftCorrection::processEvent(LCEvent *event) {
+  EUTelEventImpl *evt = static_cast<EUTelEventImpl *>(event);
+  if (evt->getEventType() == kEORE) {
+    streamlog_out(DEBUG4) << "EORE found: nothing else to do." << std::endl;
+    return;
+  }
+
+  int const iWindow =
+      findWindow(event->getRunNumber(), event->getEventNumber());
+
+  // transient: the constants are in the drift file already
+  auto collection = std::make_unique<LCCollectionVec>(LCIO::LCGENERICOBJECT);
+  collection->setTransient(true);
+  if (iWindow >= 0) {
+    Window &window = _windows[iWindow];
+    ++window.nEvents;
+    for (Constant const &constant : window.constants) {
+      collection->push_back(new EUTelAlignmentConstant(
+          constant.sensorID, constant.xOffset, constant.yOffset,
+          constant.zOffset, constant.alpha, constant.beta, constant.gamma, 0.,
+          0., 0., 0., 0., 0.));
+    }
+  } else {
+    if (_runsWithoutWindow.insert(event->getRunNumber()).second) {
+      streamlog_out(WARNING2) << "Run " << event->getRunNumber()
+                              << " has no window in "
+                              << _alignmentConstantFile
+                              << ", its hits are not corrected" << std::endl;
+    }
+    for (int sensorID : _sensorIDs) {
+      collection->push_back(new EUTelAlignmentConstant(
+          sensorID, 0., 0., 0., 0., 0., 0., 0., 0., 0., 0., 0., 0.));
+    }
+  }
+  _lastWindow = iWindow;
+
+  event->addCollection(collection.release(), _outputCollectionName);
+}
+
+void EUTelAlignmentDriftCorrection::end() {
+  for (Window const &window : _windows) {
+    streamlog_out(MESSAGE4) << "Window of run " << window.runNumber
+                            << ", events " << window.firstEvent << " to "
+                            << window.lastEvent << ": " << window.nEvents
+                            << " events corrected" << std::endl;
+  }
+}
@@ -0,0 +1,344 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+// eutelescope includes ".h"
+#include "EUTelAlignmentDriftMonitor.h"
+#include "EUTELESCOPE.h"
+#include "EUTelAlignmentConstant.h"
+#include "EUTelEventImpl.h"
+#include "EUTelExceptions.h"
+#include "EUTelRunHeaderImpl.h"
+
+// marlin includes ".h"
+#include "marlin/Exceptions.h"
+#include "marlin/Processor.h"
+
+// lcio includes <.h>
+#include <IMPL/LCCollectionVec.h>
+#include <IMPL/LCEventImpl.h>
+#include <IMPL/LCRunHeaderImpl.h>
+#include <IMPL/TrackerHitImpl.h>
+#include <IOIMPL/LCFactory.h>
+#include <UTIL/CellIDDecoder.h>
+
+// system includes
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+using namespace eutelescope;
+
+EUTelAlignmentDriftMonitor::EUTelAlignmentDriftMonitor()
+    : Processor("EUTelAlignmentDriftMonitor"), _hitCollectionName(""),
+      _telescopePlanes(), _windowSize(10000), _minTracks(100),
+      _driftThreshold(0.005), _tripletResidualCut(0.1),
+      _tripletSlopeCut(0.005), _matchingCut(0.1), _alignmentConstantFile(""),
+      _alignmentCollectionName(""), _tripletUtility(), _collectionCache(),
+      _writer(), _current(), _reference(), _hasReference(false), _windows(),
+      _nWindowEvents(0), _windowRun(0), _windowFirstEvent(0),
+      _windowLastEvent(0), _windowTimeStamp(0), _nWindowTracks(0) {
+  _description = "EUTelAlignmentDriftMonitor follows the residuals of "
+                 "telescope tracks over windows of events and flags "
+                 "planes moving during a run.";
+
+  registerInputCollection(LCIO::TRACKERHIT, "InputHitCollectionName",
+                          "Input hit collection name, global frame",
+                          _hitCollectionName, std::string("hit"));
+
+  IntVec planes;
+  for (int sensorID = 0; sensorID < static_cast<int>(kNPlanes); ++sensorID) {
+    planes.push_back(sensorID);
+  }
+  registerOptionalParameter("TelescopePlanes",
+                            "Sensor IDs of the six telescope planes in beam "
+                            "order",
+                            _telescopePlanes, planes);
+  registerOptionalParameter("WindowSize", "Number of events per window",
+                            _windowSize, 10000);
+  registerOptionalParameter("MinTracks",
+                            "Minimum number of tracks to evaluate a window",
+                            _minTracks, 100);
+  registerOptionalParameter(
+      "DriftThreshold",
+      "Residual mean shift to the reference window flagged as a drift [mm]",
+      _driftThreshold, 0.005f);
+  registerOptionalParameter("TripletResidualCut",
+                            "Upstream/downstream triplet residual cut [mm]",
+                            _tripletResidualCut, 0.1f);
+  registerOptionalParameter("TripletSlopeCut",
+                            "Upstream/downstream triplet slope cut [rad]",
+                            _tripletSlopeCut, 0.005f);
+  registerOptionalParameter("MatchingCut",
+                            "Upstream/downstream triplet matching cut [mm]",
+                            _matchingCut, 0.1f);
+  registerOptionalParameter(
+      "AlignmentConstantFile",
+      "LCIO file for the correction of every window, none if empty",
+      _alignmentConstantFile, std::string(""));
+  registerOptionalParameter("AlignmentConstantCollectionName",
+                            "Collection name of the written corrections",
+                            _alignmentCollectionName,
+                            std::string("alignment"));
+}
+
+void EUTelAlignmentDriftMonitor::init() {
+  printParameters();
+
+  if (_telescopePlanes.size() != kNPlanes) {
+    streamlog_out(ERROR4) << "TelescopePlanes must list " << kNPlanes
+                          << " sensor IDs" << std::endl;
+    throw InvalidParameterException("TelescopePlanes");
+  }
+  if (_windowSize < 1) {
+    throw InvalidParameterException("WindowSize");
+  }
+
+  if (!_alignmentConstantFile.empty()) {
+    _writer.reset(IOIMPL::LCFactory::getInstance()->createLCWriter());
+    _writer->open(_alignmentConstantFile, LCIO::WRITE_NEW);
+
+    // an almost empty run header, as the alignment processors write
+    auto header = std::make_unique<LCRunHeaderImpl>();
+    header->setRunNumber(0);
+    _writer->writeRunHeader(header.get());
+  }
+
+  _hasReference = false;
+  _windows.clear();
+  _current = PlaneStatistics();
+  _nWindowEvents = 0;
+  _nWindowTracks = 0;
+}
+
+void EUTelAlignmentDriftMonitor::processRunHeader(LCRunHeader *rdr) {
+  auto runHeader = std::make_unique<EUTelRunHeaderImpl>(rdr);
+  runHeader->addProcessor(type());
+
+  // windows do not span runs
+  if (_nWindowEvents > 0) {
+    closeWindow();
+  }
+}
+
+void EUTelAlignmentDriftMonitor::processEvent(LCEvent *event) {
+  EUTelEventImpl *evt = static_cast<EUTelEventImpl *>(event);
+  if (evt->getEventType() == kEORE) {
+    streamlog_out(DEBUG4) << "EORE found: nothing else to do." << std::endl;
+    return;
+  }
+
+  if (_nWindowEvents == 0) {
+    _windowRun = event->getRunNumber();
+    _windowFirstEvent = event->getEventNumber();
+    _windowTimeStamp = event->getTimeStamp();
+  }
+  _windowLastEvent = event->getEventNumber();
+  ++_nWindowEvents;
+
+  LCCollectionVec *collection = _collectionCache.get(event, _hitCollectionName);
+  if (collection) {
+    std::string encoding =
+        collection->getParameters().getStringVal(LCIO::CellIDEncoding);
+    if (encoding.empty()) {
+      encoding = EUTELESCOPE::HITENCODING;
+    }
+    lcio::CellIDDecoder<TrackerHitImpl> hitDecoder(encoding);
+
+    std::vector<EUTelTripletGBLUtility::hit> hits;
+    for (size_t iHit = 0; iHit < collection->size(); ++iHit) {
+      TrackerHitImpl *meshit =
+          static_cast<TrackerHitImpl *>(collection->getElementAt(iHit));
+      int sensorID = hitDecoder(meshit)["sensorID"];
+      auto plane = std::find(_telescopePlanes.begin(), _telescopePlanes.end(),
+                             sensorID);
+      if (plane == _telescopePlanes.end()) {
+        continue;
+      }
+
+      EUTelTripletGBLUtility::hit newhit(meshit->getPosition(), sensorID);
+      newhit.plane =
+          static_cast<unsigned int>(plane - _telescopePlanes.begin());
+      newhit.id = static_cast<int>(iHit);
+      EVENT::FloatVec const &cov = meshit->getCovMatrix();
+      newhit.ex = std::sqrt(std::max(cov[0], 0.f));
+      newhit.ey = std::sqrt(std::max(cov[2], 0.f));
+      newhit.ez = 0.;
+      newhit.clustersize = newhit.clustersizex = newhit.clustersizey = 0;
+      newhit.locx = newhit.locy = 0.;
+      hits.push_back(newhit);
+    }
+    addTracks(hits);
+  }
+
+  if (_nWindowEvents >= _windowSize) {
+    closeWindow();
+  }
+}
+
+void EUTelAlignmentDriftMonitor::addTracks(
+    std::vector<EUTelTripletGBLUtility::hit> const &hits) {
+  std::vector<EUTelTripletGBLUtility::triplet> upstream;
+  std::vector<EUTelTripletGBLUtility::triplet> downstream;
+  _tripletUtility.FindTriplets(hits, 0, 1, 2, _tripletResidualCut,
+                               _tripletSlopeCut, upstream);
+  _tripletUtility.FindTriplets(hits, 3, 4, 5, _tripletResidualCut,
+                               _tripletSlopeCut, downstream);
+  if (upstream.empty() || downstream.empty()) {
+    return;
+  }
+
+  // matched between the two arms, as by the GBL processors
+  double const zMatch = 0.5 * (upstream.front().gethit(2).z +
+                               downstream.front().gethit(3).z);
+  std::vector<EUTelTripletGBLUtility::track> tracks;
+  _tripletUtility.MatchTriplets(upstream, downstream, zMatch, _matchingCut,
+                                tracks);
+
+  for (auto &track : tracks) {
+    std::array<EUTelTripletGBLUtility::hit, kNPlanes> points;
+    double zMean = 0.;
+    for (size_t ipl = 0; ipl < kNPlanes; ++ipl) {
+      points[ipl] = track.gethit(static_cast<int>(ipl));
+      zMean += points[ipl].z / kNPlanes;
+    }
+
+    // straight line fit in x and y, all planes weighted equally
+    double szz = 0., xMean = 0., yMean = 0.;
+    for (auto const &point : points) {
+      xMean += point.x / kNPlanes;
+      yMean += point.y / kNPlanes;
+    }
+    double szx = 0., szy = 0.;
+    for (auto const &point : points) {
+      double const dz = point.z - zMean;
+      szz += dz * dz;
+      szx += dz * (point.x - xMean);
+      szy += dz * (point.y - yMean);
+    }
+    double const xSlope = szx / szz;
+    double const ySlope = szy / szz;
+
+    for (size_t ipl = 0; ipl < kNPlanes; ++ipl) {
+      double const dz = points[ipl].z - zMean;
+      _current[ipl][0].add(points[ipl].x - xMean - xSlope * dz);
+      _current[ipl][1].add(points[ipl].y - yMean - ySlope * dz);
+    }
+    ++_nWindowTracks;
+  }
+}
+
+void EUTelAlignmentDriftMonitor::closeWindow() {
+  Window window;
+  window.runNumber = _windowRun;
+  window.firstEvent = _windowFirstEvent;
+  window.lastEvent = _windowLastEvent;
+  window.timeStamp = _windowTimeStamp;
+  window.nTracks = _nWindowTracks;
+  window.flagged = false;
+
+  PlaneStatistics const statistics = _current;
+  _current = PlaneStatistics();
+  _nWindowEvents = 0;
+  _nWindowTracks = 0;
+
+  if (window.nTracks < _minTracks) {
+    streamlog_out(MESSAGE4) << "Window of run " << window.runNumber
+                            << ", events " << window.firstEvent << " to "
+                            << window.lastEvent << " has only "
+                            << window.nTracks << " tracks, not evaluated"
+                            << std::endl;
+    return;
+  }
+
+  if (!_hasReference) {
+    for (size_t ipl = 0; ipl < kNPlanes; ++ipl) {
+      for (size_t axis = 0; axis < 2; ++axis) {
+        _reference[ipl][axis] = statistics[ipl][axis].mean;
+      }
+    }
+    _hasReference = true;
+  }
+
+  for (size_t ipl = 0; ipl < kNPlanes; ++ipl) {
+    for (size_t axis = 0; axis < 2; ++axis) {
+      RunningStatistics const &residuals = statistics[ipl][axis];
+      double const drift = residuals.mean - _reference[ipl][axis];
+      window.drift[ipl][axis] = drift;
+
+      streamlog_out(DEBUG4)
+          << "Sensor " << _telescopePlanes[ipl] << (axis ? " y" : " x")
+          << " residual mean " << residuals.mean << " +- "
+          << residuals.error() << " sigma " << residuals.sigma() << " mm"
+          << std::endl;
+
+      if (std::abs(drift) > _driftThreshold &&
+          std::abs(drift) > 3. * residuals.error()) {
+        window.flagged = true;
+        streamlog_out(WARNING5)
+            << "Sensor " << _telescopePlanes[ipl] << " moved by " << drift
+            << " mm in " << (axis ? "y" : "x") << " in run "
+            << window.runNumber << ", events " << window.firstEvent << " to "
+            << window.lastEvent << std::endl;
+      }
+    }
+  }
+
+  _windows.push_back(window);
+  if (_writer) {
+    writeConstants(window);
+  }
+}
+
+void EUTelAlignmentDriftMonitor::writeConstants(Window const &window) {
+  auto event = std::make_unique<LCEventImpl>();
+  event->setRunNumber(window.runNumber);
+  event->setEventNumber(static_cast<int>(_windows.size()) - 1);
+  event->setTimeStamp(window.timeStamp);
+  event->parameters().setValue("FirstEvent", window.firstEvent);
+  event->parameters().setValue("LastEvent", window.lastEvent);
+
+  // the offsets are subtracted from the hit positions
+  auto constants = std::make_unique<LCCollectionVec>(LCIO::LCGENERICOBJECT);
+  for (size_t ipl = 0; ipl < kNPlanes; ++ipl) {
+    EUTelAlignmentConstant *constant = new EUTelAlignmentConstant;
+    constant->setSensorID(_telescopePlanes[ipl]);
+    constant->setXOffset(window.drift[ipl][0]);
+    constant->setYOffset(window.drift[ipl][1]);
+    constants->push_back(constant);
+  }
+  event->addCollection(constants.release(), _alignmentCollectionName);
+  _writer->writeEvent(event.get());
+}
+
+void EUTelAlignmentDriftMonitor::end() {
+  if (_nWindowEvents > 0) {
+    closeWindow();
+  }
+  if (_writer) {
+    _writer->close();
+    _writer.reset();
+  }
+
+  streamlog_out(MESSAGE4) << "Residual mean shifts per window [um]:"
+                          << std::endl;
+  for (auto const &window : _windows) {
+    std::ostringstream line;
+    line << "run " << window.runNumber << " events " << window.firstEvent
+         << "-" << window.lastEvent << " tracks " << window.nTracks << ":"
+         << std::fixed << std::setprecision(1);
+    for (size_t ipl = 0; ipl < kNPlanes; ++ipl) {
+      line << " (" << window.drift[ipl][0] * 1000. << ", "
+           << window.drift[ipl][1] * 1000. << ")";
+    }
+    streamlog_out(MESSAGE4) << line.str() << (window.flagged ? " moved" : "")
+                            << std::endl;
+  }
+  _collectionCache.printSummary(name());
+}
@@ -613,10 +613,12 @@ void EUTelCalculateEtaProcessor::finalizeProcessor() {
 
     int iDetector = iter->first;
 
+    // cumulative distribution in a single pass over the bins
+    integral = 0;
     for (int iBin = 1; iBin <= _cogHistogramX[iDetector]->getNumberOfBins();
          iBin++) {
       double x = _cogHistogramX[iDetector]->getBinCenter(iBin);
-      integral = _cogHistogramX[iDetector]->integral(1, iBin);
+      integral += _cogHistogramX[iDetector]->getBinContent(iBin);
       _integralHistoX[iDetector]->fill(x, integral);
     }
 
@@ -641,10 +643,12 @@ void EUTelCalculateEtaProcessor::finalizeProcessor() {
     etaBinCenter.clear();
     etaBinValue.clear();
 
+    // cumulative distribution in a single pass over the bins
+    integral = 0;
     for (int iBin = 1; iBin <= _cogHistogramY[iDetector]->getNumberOfBins();
          iBin++) {
       double y = _cogHistogramY[iDetector]->getBinCenter(iBin);
-      integral = _cogHistogramY[iDetector]->integral(1, iBin);
+      integral += _cogHistogramY[iDetector]->getBinContent(iBin);
       _integralHistoY[iDetector]->fill(y, integral);
     }
 
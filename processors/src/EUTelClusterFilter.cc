@@ -774,6 +774,22 @@ void EUTelClusterFilter::checkCriteria() {
     vector<unsigned int> rejectedCounter(_noOfDetectors, 0);
     _rejectionMap.insert(make_pair("SameNumberOfHitCut", rejectedCounter));
   }
+
+  // the selection predicates take their thresholds by sensor ID
+  _minTotalChargeMap.clear();
+  _minTotalSNRMap.clear();
+  _minHitPixelMap.clear();
+  for (auto const &entry : _ancillaryIndexMap) {
+    if (_minTotalChargeSwitch) {
+      _minTotalChargeMap[entry.first] = _minTotalChargeVec[entry.second];
+    }
+    if (_minTotalSNRSwitch) {
+      _minTotalSNRMap[entry.first] = _minTotalSNRVec[entry.second];
+    }
+    if (_dffnhitsswitch) {
+      _minHitPixelMap[entry.first] = _DFFNHitsCuts[entry.second];
+    }
+  }
 }
 
 void EUTelClusterFilter::processRunHeader(LCRunHeader *rdr) {
@@ -792,6 +808,9 @@ void EUTelClusterFilter::processEvent(LCEvent *event) {
 
   ++_iEvt;
 
+  // the cluster objects of the previous event are released here
+  _eventArena.reset();
+
   if (isFirstEvent()) {
     // try to guess the total number of sensors
     initializeGeometry(event);
@@ -822,6 +841,8 @@ void EUTelClusterFilter::processEvent(LCEvent *event) {
 
     vector<int> acceptedClusterVec;
     vector<int> clusterNoVec(_noOfDetectors, 0);
+    vector<bool> clusterAcceptedVec;
+    _selectionTable.clear();
 
     // CLUSTER BASED CUTS
     for (int iPulse = 0; iPulse < pulseCollectionVec->getNumberOfElements();
@@ -837,10 +858,10 @@ void EUTelClusterFilter::processEvent(LCEvent *event) {
       SparsePixelType pixelType;
 
       if (type == kEUTelDFFClusterImpl) {
-        cluster = new EUTelDFFClusterImpl(
+        cluster = _eventArena.create<EUTelDFFClusterImpl>(
             static_cast<TrackerDataImpl *>(pulse->getTrackerData()));
       } else if (type == kEUTelBrickedClusterImpl) {
-        cluster = new EUTelBrickedClusterImpl(
+        cluster = _eventArena.create<EUTelBrickedClusterImpl>(
             static_cast<TrackerDataImpl *>(pulse->getTrackerData()));
 
         if (_noiseRelatedCuts) {
@@ -929,7 +950,7 @@ void EUTelClusterFilter::processEvent(LCEvent *event) {
           }
         }
       } else if (type == kEUTelFFClusterImpl) {
-        cluster = new EUTelFFClusterImpl(
+        cluster = _eventArena.create<EUTelFFClusterImpl>(
             static_cast<TrackerDataImpl *>(pulse->getTrackerData()));
 
         if (_noiseRelatedCuts) {
@@ -1020,7 +1041,8 @@ void EUTelClusterFilter::processEvent(LCEvent *event) {
             static_cast<int>(anotherDecoder(oneCluster)["sparsePixelType"]));
 
         if (pixelType == kEUTelGenericSparsePixel) {
-          cluster = new EUTelSparseClusterImpl<EUTelGenericSparsePixel>(
+          cluster = _eventArena.create<
+              EUTelSparseClusterImpl<EUTelGenericSparsePixel>>(
               static_cast<TrackerDataImpl *>(pulse->getTrackerData()));
 
           auto recasted =
@@ -1074,13 +1096,13 @@ void EUTelClusterFilter::processEvent(LCEvent *event) {
       // increment the event counter
       _totalClusterCounter[_ancillaryIndexMap[cluster->getDetectorID()]]++;
 
+      // the cuts available as selection predicates are applied to
+      // all the clusters at once after the loop
+      addSelectionRow(cluster, type == kEUTelDFFClusterImpl);
+
       bool isAccepted = true;
 
-      if (type == kEUTelDFFClusterImpl) {
-        isAccepted &= isAboveNumberOfHitPixel(cluster);
-      } else {
-        isAccepted &= isAboveMinTotalCharge(cluster);
-        isAccepted &= isAboveMinTotalSNR(cluster);
+      if (type != kEUTelDFFClusterImpl) {
         isAccepted &= isAboveNMinCharge(cluster);
         isAccepted &= isAboveNMinSNR(cluster);
         isAccepted &= isAboveNxNMinCharge(cluster);
@@ -1090,13 +1112,13 @@ void EUTelClusterFilter::processEvent(LCEvent *event) {
         isAccepted &= isBelowMaxClusterNoise(cluster);
       }
       isAccepted &= hasQuality(cluster);
-      isAccepted &= isInsideROI(cluster);
-      isAccepted &= isOutsideROI(cluster);
+      clusterAcceptedVec.push_back(isAccepted);
+    }
 
-      if (isAccepted)
+    applySelection(clusterAcceptedVec);
+    for (size_t iPulse = 0; iPulse < clusterAcceptedVec.size(); ++iPulse) {
+      if (clusterAcceptedVec[iPulse])
         acceptedClusterVec.push_back(iPulse);
-
-      delete cluster;
     }
 
     vector<int>::iterator cluIter = acceptedClusterVec.begin();
@@ -1253,76 +1275,6 @@ bool EUTelClusterFilter::hasSameNumberOfHit(
   return hasSameNumber;
 }
 
-bool EUTelClusterFilter::isAboveNumberOfHitPixel(
-    EUTelVirtualCluster *cluster) const {
-  if (!_dffnhitsswitch) {
-    return true;
-  }
-  streamlog_out(DEBUG1)
-      << "Filtering against number of hit pixel inside a cluster " << endl;
-
-  int detectorID = cluster->getDetectorID();
-  int detectorPos = _ancillaryIndexMap[detectorID];
-
-  if (static_cast<int>(cluster->getTotalCharge()) >= _DFFNHitsCuts[detectorPos])
-    return true;
-  else {
-    streamlog_out(DEBUG2)
-        << "Rejected cluster because the number of hit pixel is "
-        << static_cast<int>(cluster->getTotalCharge())
-        << " and the threshold is " << _DFFNHitsCuts[detectorPos] << endl;
-    _rejectionMap["MinHitPixel"][detectorPos]++;
-    return false;
-  }
-}
-
-bool EUTelClusterFilter::isAboveMinTotalCharge(
-    EUTelVirtualCluster *cluster) const {
-
-  if (!_minTotalChargeSwitch) {
-    return true;
-  }
-  streamlog_out(DEBUG1) << "Filtering against the total charge " << endl;
-
-  int detectorID = cluster->getDetectorID();
-  int detectorPos = _ancillaryIndexMap[detectorID];
-
-  if (cluster->getTotalCharge() > _minTotalChargeVec[detectorPos])
-    return true;
-  else {
-    streamlog_out(DEBUG2) << "Rejected cluster because its charge is "
-                          << cluster->getTotalCharge()
-                          << " and the threshold is "
-                          << _minTotalChargeVec[detectorPos] << endl;
-    _rejectionMap["MinTotalChargeCut"][detectorPos]++;
-    return false;
-  }
-}
-
-bool EUTelClusterFilter::isAboveMinTotalSNR(
-    EUTelVirtualCluster *cluster) const {
-
-  if (!_noiseRelatedCuts)
-    return true;
-  if (!_minTotalSNRSwitch)
-    return true;
-
-  int detectorID = cluster->getDetectorID();
-  int detectorPos = _ancillaryIndexMap[detectorID];
-
-  streamlog_out(DEBUG1) << "Filtering against the minimum total SNR " << endl;
-  if (cluster->getClusterSNR() > _minTotalSNRVec[detectorPos])
-    return true;
-  else {
-    streamlog_out(DEBUG2) << "Rejected cluster because its SNR is "
-                          << cluster->getClusterSNR()
-                          << " and the threshold is "
-                          << _minTotalSNRVec[detectorPos] << endl;
-    _rejectionMap["MinTotalSNRCut"][detectorPos]++;
-    return false;
-  }
-}
-
 bool EUTelClusterFilter::isAboveNMinCharge(EUTelVirtualCluster *cluster) const {
 
   if (!_minNChargeSwitch)
@@ -1532,65 +1484,82 @@ bool EUTelClusterFilter::isBelowMaxClusterNoise(
   }
 }
 
-bool EUTelClusterFilter::isInsideROI(EUTelVirtualCluster *cluster) const {
-
-  if (!_insideROISwitch)
-    return true;
+void EUTelClusterFilter::addSelectionRow(EUTelVirtualCluster *cluster,
+                                         bool isDigital) {
+  float const notCut = numeric_limits<float>::infinity();
 
-  int detectorID = cluster->getDetectorID();
-  int detectorPos = _ancillaryIndexMap[detectorID];
-  float x, y;
-  cluster->getCenterOfGravity(x, y);
-
-  bool tempAccepted = true;
-  vector<EUTelROI>::const_iterator iter = _insideROIVec.begin();
-  vector<EUTelROI>::const_iterator end = _insideROIVec.end();
-  while (true) {
-
-    // the HasSameID requires the sensorID, so don't replace it with
-    // detectorPos
-    iter = find_if(iter, end, HasSameID(detectorID));
-    if (iter != end) {
-      if ((*iter).isInside(x, y)) {
-        tempAccepted &= true;
-      } else {
-        _rejectionMap["InsideROICut"][detectorPos]++;
-        tempAccepted &= false;
-      }
-      ++iter;
-    } else
-      break;
+  _selectionTable.sensorID.push_back(cluster->getDetectorID());
+  if (_minTotalChargeSwitch) {
+    _selectionTable.charge.push_back(isDigital ? notCut
+                                               : cluster->getTotalCharge());
+  }
+  if (_minTotalSNRSwitch) {
+    // no SNR without the noise values
+    bool const hasSNR = !isDigital && _noiseRelatedCuts;
+    _selectionTable.snr.push_back(hasSNR ? cluster->getClusterSNR() : notCut);
+  }
+  if (_dffnhitsswitch) {
+    // the charge of a digital cluster is its number of hit pixels
+    _selectionTable.nPixels.push_back(
+        isDigital ? static_cast<int>(cluster->getTotalCharge())
+                  : numeric_limits<int>::max());
+  }
+  if (_insideROISwitch || _outsideROISwitch) {
+    float x, y;
+    cluster->getCenterOfGravity(x, y);
+    _selectionTable.x.push_back(x);
+    _selectionTable.y.push_back(y);
   }
-  return tempAccepted;
 }
 
-bool EUTelClusterFilter::isOutsideROI(EUTelVirtualCluster *cluster) const {
+template <class P>
+void EUTelClusterFilter::applyCut(selection::Predicate<P> const &cut,
+                                  string const &name,
+                                  vector<bool> &accepted) const {
+  selection::Mask const passed = selection::select(cut, _selectionTable);
+  for (size_t row = 0; row < passed.size(); ++row) {
+    if (!passed[row]) {
+      int detectorPos = _ancillaryIndexMap[_selectionTable.sensorID[row]];
+      _rejectionMap[name][detectorPos]++;
+      accepted[row] = false;
+    }
+  }
+}
 
-  if (!_outsideROISwitch)
-    return true;
+void EUTelClusterFilter::applySelection(vector<bool> &accepted) const {
+  if (_minTotalChargeSwitch) {
+    applyCut(selection::ChargeAbove(_minTotalChargeMap), "MinTotalChargeCut",
+             accepted);
+  }
+  if (_minTotalSNRSwitch) {
+    applyCut(selection::SNRAbove(_minTotalSNRMap), "MinTotalSNRCut",
+             accepted);
+  }
+  if (_dffnhitsswitch) {
+    applyCut(selection::SizeAtLeast(_minHitPixelMap), "MinHitPixel",
+             accepted);
+  }
 
-  int detectorID = cluster->getDetectorID();
-  int detectorPos = _ancillaryIndexMap[detectorID];
-  float x, y;
-  cluster->getCenterOfGravity(x, y);
-
-  bool tempAccepted = true;
-  vector<EUTelROI>::const_iterator iter = _outsideROIVec.begin();
-  vector<EUTelROI>::const_iterator end = _outsideROIVec.end();
-  while (true) {
-    iter = find_if(iter, end, HasSameID(detectorID));
-    if (iter != end) {
-      if (!(*iter).isInside(x, y)) {
-        tempAccepted &= true;
-      } else {
-        _rejectionMap["OutsideROICut"][detectorPos]++;
-        tempAccepted &= false;
+  // every ROI of the sensor of a cluster is checked, a ROI without
+  // sensor ID is never applied
+  if (_insideROISwitch) {
+    for (EUTelROI const &roi : _insideROIVec) {
+      if (roi.getDetectorID() < 0) {
+        continue;
       }
-      ++iter;
-    } else
-      break;
+      vector<int> const sensor(1, roi.getDetectorID());
+      applyCut(!selection::SensorIn(sensor) || selection::InsideROI(roi),
+               "InsideROICut", accepted);
+    }
+  }
+  if (_outsideROISwitch) {
+    for (EUTelROI const &roi : _outsideROIVec) {
+      if (roi.getDetectorID() < 0) {
+        continue;
+      }
+      applyCut(!selection::InsideROI(roi), "OutsideROICut", accepted);
+    }
   }
-  return tempAccepted;
 }
 
 void EUTelClusterFilter::check(LCEvent * /* evt */) {
@@ -1600,6 +1569,7 @@ void EUTelClusterFilter::check(LCEvent * /* evt */) {
 
 void EUTelClusterFilter::end() {
   streamlog_out(MESSAGE4) << printSummary() << endl;
+  _eventArena.summarize(name());
 }
 
 string EUTelClusterFilter::printSummary() const {
@@ -16,6 +16,7 @@
 #include "EUTelEventImpl.h"
 #include "EUTelExceptions.h"
 #include "EUTelFFClusterImpl.h"
+#include "EUTelMergingClusters.h"
 #include "EUTelRunHeaderImpl.h"
 #include "EUTelSparseClusterImpl.h"
 
@@ -29,6 +30,7 @@
 #include <UTIL/CellIDEncoder.h>
 
 // system includes <>
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <memory>
@@ -41,8 +43,48 @@ using namespace lcio;
 using namespace marlin;
 using namespace eutelescope;
 
+namespace {
+  //! Call f with the cluster stored in data, built on the stack
+  template <class F>
+  void withCluster(ClusterType type, SparsePixelType pixelType,
+                   TrackerDataImpl *data, F f) {
+    if (type == kEUTelFFClusterImpl) {
+      EUTelFFClusterImpl cluster(data);
+      f(cluster);
+    } else if (type == kEUTelBrickedClusterImpl) {
+      EUTelBrickedClusterImpl cluster(data);
+      f(cluster);
+    } else if (type == kEUTelSparseClusterImpl) {
+      if (pixelType == kEUTelGenericSparsePixel) {
+        EUTelSparseClusterImpl<EUTelGenericSparsePixel> cluster(data);
+        f(cluster);
+      } else {
+        streamlog_out(ERROR4) << "Unknown pixel type. Sorry for quitting."
+                              << endl;
+        throw UnknownDataTypeException("Pixel type unknown");
+      }
+    } else {
+      streamlog_out(ERROR4) << "Unknown cluster type. Sorry for quitting"
+                            << endl;
+      throw UnknownDataTypeException("Cluster type unknown");
+    }
+  }
+
+  //! Pixel type of the sparse clusters, from the original data
+  SparsePixelType originalSparsePixelType(LCEvent *evt) {
+    LCCollectionVec *sparseClusterCollectionVec =
+        dynamic_cast<LCCollectionVec *>(evt->getCollection("original_zsdata"));
+    TrackerDataImpl *oneCluster = dynamic_cast<TrackerDataImpl *>(
+        sparseClusterCollectionVec->getElementAt(0));
+    CellIDDecoder<TrackerDataImpl> anotherDecoder(sparseClusterCollectionVec);
+    return static_cast<SparsePixelType>(
+        static_cast<int>(anotherDecoder(oneCluster)["sparsePixelType"]));
+  }
+}
+
 EUTelClusterSeparationProcessor::EUTelClusterSeparationProcessor()
-    : Processor("EUTelClusterSeparationProcessor") {
+    : Processor("EUTelClusterSeparationProcessor"),
+      _sparsePixelType(kUnknownPixelType) {
 
   // modify processor description
   _description = "EUTelClusterSeparationProcessor separates merging clusters";
@@ -118,7 +160,12 @@ void EUTelClusterSeparationProcessor::processEvent(LCEvent *event) {
       EUTELESCOPE::PULSEDEFAULTENCODING, outputCollectionVec);
   CellIDDecoder<TrackerPulseImpl> cellDecoder(clusterCollectionVec);
 
-  vector<pair<int, int>> mergingPairVector;
+  // only the center, radius and detector of each cluster are needed
+  // to find the merging pairs. The cluster objects live on the stack
+  // while they are measured.
+  vector<Utility::ClusterFootprint> footprints;
+  footprints.reserve(clusterCollectionVec->getNumberOfElements());
+  _sparsePixelType = kUnknownPixelType;
 
   for (int iCluster = 0; iCluster < clusterCollectionVec->getNumberOfElements();
        iCluster++) {
@@ -128,103 +175,28 @@ void EUTelClusterSeparationProcessor::processEvent(LCEvent *event) {
     ClusterType type =
         static_cast<ClusterType>(static_cast<int>(cellDecoder(pulse)["type"]));
 
-    // all clusters have to inherit from the virtual cluster (that is
-    // a TrackerDataImpl with some utility methods).
-    EUTelVirtualCluster *cluster;
-
-    if (type == kEUTelFFClusterImpl) {
-      cluster = new EUTelFFClusterImpl(
-          static_cast<TrackerDataImpl *>(pulse->getTrackerData()));
-    } else if (type == kEUTelBrickedClusterImpl) {
-      cluster = new EUTelBrickedClusterImpl(
-          static_cast<TrackerDataImpl *>(pulse->getTrackerData()));
-    } else if (type == kEUTelSparseClusterImpl) {
-
-      // ok the cluster is of sparse type, but we also need to know
-      // the kind of pixel description used. This information is
-      // stored in the corresponding original data collection.
-
-      LCCollectionVec *sparseClusterCollectionVec =
-          dynamic_cast<LCCollectionVec *>(
-              evt->getCollection("original_zsdata"));
-      TrackerDataImpl *oneCluster = dynamic_cast<TrackerDataImpl *>(
-          sparseClusterCollectionVec->getElementAt(0));
-      CellIDDecoder<TrackerDataImpl> anotherDecoder(sparseClusterCollectionVec);
-      SparsePixelType pixelType = static_cast<SparsePixelType>(
-          static_cast<int>(anotherDecoder(oneCluster)["sparsePixelType"]));
-
-      // now we know the pixel type. So we can properly create a new
-      // instance of the sparse cluster
-      if (pixelType == kEUTelGenericSparsePixel) {
-        cluster = new EUTelSparseClusterImpl<EUTelGenericSparsePixel>(
-            static_cast<TrackerDataImpl *>(pulse->getTrackerData()));
-      } else {
-        streamlog_out(ERROR4) << "Unknown pixel type. Sorry for quitting."
-                              << endl;
-        throw UnknownDataTypeException("Pixel type unknown");
-      }
-
-    } else {
-      streamlog_out(ERROR4) << "Unknown cluster type. Sorry for quitting"
-                            << endl;
-      throw UnknownDataTypeException("Cluster type unknown");
+    // ok the cluster is of sparse type, but we also need to know the
+    // kind of pixel description used. This information is stored in
+    // the corresponding original data collection.
+    if (type == kEUTelSparseClusterImpl &&
+        _sparsePixelType == kUnknownPixelType) {
+      _sparsePixelType = originalSparsePixelType(evt);
     }
 
-    int iOtherCluster = iCluster + 1;
-    bool isExisisting =
-        (iOtherCluster < clusterCollectionVec->getNumberOfElements());
-    bool isOnSameDetector = true;
-
-    while (isOnSameDetector && isExisisting) {
-
-      // get the next cluster in the collection
-      TrackerPulseImpl *otherPulse = dynamic_cast<TrackerPulseImpl *>(
-          clusterCollectionVec->getElementAt(iOtherCluster));
-      EUTelVirtualCluster *otherCluster;
-
-      if (type == kEUTelFFClusterImpl)
-        otherCluster = new EUTelFFClusterImpl(
-            static_cast<TrackerDataImpl *>(otherPulse->getTrackerData()));
-      else if (type == kEUTelBrickedClusterImpl)
-        otherCluster = new EUTelBrickedClusterImpl(
-            static_cast<TrackerDataImpl *>(otherPulse->getTrackerData()));
-      else {
-        streamlog_out(ERROR4) << "Unknown cluster type. Sorry for quitting"
-                              << endl;
-        throw UnknownDataTypeException("Cluster type unknown");
-      }
-
-      // check if the two are on the same detector
-      if (cluster->getDetectorID() == otherCluster->getDetectorID()) {
-
-        if (_minimumDistance == 0) {
-          // ok we need to calculate the touching distance
-          float radius = cluster->getExternalRadius();
-          float otherRadius = otherCluster->getExternalRadius();
-          _minimumDistance = radius + otherRadius;
-        }
-
-        // ok they are on the same plane, so it makes sense check it
-        // they are merging
-        float distance = cluster->getDistance(otherCluster);
-
-        if (distance < _minimumDistance) {
-          // they are merging! we need to apply the separation
-          // algorithm
-          mergingPairVector.push_back(make_pair(iCluster, iOtherCluster));
-        }
-
-      } else {
-        isOnSameDetector = false;
-      }
-      isExisisting =
-          (++iOtherCluster < clusterCollectionVec->getNumberOfElements());
-      delete otherCluster;
-    }
-
-    delete cluster;
+    withCluster(type, _sparsePixelType,
+                static_cast<TrackerDataImpl *>(pulse->getTrackerData()),
+                [&footprints](EUTelVirtualCluster &cluster) {
+                  Utility::ClusterFootprint footprint;
+                  footprint.sensorID = cluster.getDetectorID();
+                  cluster.getCenterCoord(footprint.xCenter, footprint.yCenter);
+                  footprint.radius = cluster.getExternalRadius();
+                  footprints.push_back(footprint);
+                });
   }
 
+  vector<pair<int, int>> mergingPairVector =
+      Utility::findMergingPairs(footprints, _minimumDistance);
+
   // at this point we have inserted into the mergingPairVector all the
   // pairs of merging clusters. we can try to put together all groups
   // of clusters, but only in the case the mergingPairVector has a non
@@ -262,11 +234,10 @@ void EUTelClusterSeparationProcessor::processEvent(LCEvent *event) {
 }
 
 bool EUTelClusterSeparationProcessor::applySeparationAlgorithm(
-    std::vector<std::set<int>> setVector, LCCollectionVec *inputCollectionVec,
+    std::vector<std::set<int>> const &setVector,
+    LCCollectionVec *inputCollectionVec,
     LCCollectionVec *outputCollectionVec) const {
 
-  //  message<DEBUG5> ( log() << "Applying cluster separation algorithm
-  //  " << _separationAlgo );
   streamlog_out(DEBUG0) << "Found " << setVector.size()
                         << " group(s) of merging clusters " << endl;
 
@@ -297,53 +268,28 @@ bool EUTelClusterSeparationProcessor::applySeparationAlgorithm(
     CellIDDecoder<TrackerPulseImpl> cellDecoder(outputCollectionVec);
 
     int iCounter = 0;
-
-    vector<set<int>>::iterator vectorIterator = setVector.begin();
-    while (vectorIterator != setVector.end()) {
+    for (auto const &group : setVector) {
 
       streamlog_out(DEBUG4) << "     Group " << (iCounter++)
                             << " with the following clusters " << endl;
 
-      set<int>::iterator setIterator = (*vectorIterator).begin();
-      while (setIterator != (*vectorIterator).end()) {
+      for (int iCluster : group) {
         TrackerPulseImpl *pulse = dynamic_cast<TrackerPulseImpl *>(
-            outputCollectionVec->getElementAt(*setIterator));
+            outputCollectionVec->getElementAt(iCluster));
         ClusterType type = static_cast<ClusterType>(
             static_cast<int>(cellDecoder(pulse)["type"]));
 
-        EUTelVirtualCluster *cluster;
-
-        if (type == kEUTelFFClusterImpl)
-          cluster = new EUTelFFClusterImpl(
-              static_cast<TrackerDataImpl *>(pulse->getTrackerData()));
-        else if (type == kEUTelBrickedClusterImpl)
-          cluster = new EUTelBrickedClusterImpl(
-              static_cast<TrackerDataImpl *>(pulse->getTrackerData()));
-        else {
-          message<ERROR5>("Unknown cluster type. Sorry for quitting");
-          throw UnknownDataTypeException("Cluster type unknown");
-        }
-
-        streamlog_out(DEBUG4) << (*cluster) << endl;
-
-        try {
-          // TODO: FIxMe//cluster->setClusterQuality (
-          // cluster->getClusterQuality() | kMergedCluster );
-        } catch (lcio::ReadOnlyException &e) {
-          streamlog_out(WARNING2)
-              << "Attempt to change the cluster quality on the original data\n"
-                 "This is possible only when the "
-              << name() << " is not applied to data already on tape\n"
-                           "In this case only the pulse containing this "
-                           "cluster will have the proper quality"
-              << endl;
-        }
+        withCluster(type, _sparsePixelType,
+                    static_cast<TrackerDataImpl *>(pulse->getTrackerData()),
+                    [](EUTelVirtualCluster &cluster) {
+                      streamlog_out(DEBUG4) << cluster << endl;
+                    });
+
+        // TODO: FIxMe//cluster->setClusterQuality (
+        // cluster->getClusterQuality() | kMergedCluster );
         pulse->setQuality(static_cast<int>(
             ClusterQuality(pulse->getQuality() | kMergedCluster)));
-        ++setIterator;
-        delete cluster;
       }
-      ++vectorIterator;
     }
     return true;
   }
@@ -352,43 +298,23 @@ bool EUTelClusterSeparationProcessor::applySeparationAlgorithm(
 }
 
 void EUTelClusterSeparationProcessor::groupingMergingPairs(
-    std::vector<std::pair<int, int>> pairVector,
+    std::vector<std::pair<int, int>> const &pairVector,
     std::vector<std::set<int>> *setVector) const {
 
   streamlog_out(DEBUG0) << "Grouping merging pairs of clusters " << endl;
 
-  vector<pair<int, int>>::iterator iter = pairVector.begin();
-  while (iter != pairVector.end()) {
-
-    set<int> tempSet;
-    // add the pair to the tempSet
-    tempSet.insert(pairVector.front().first);
-    tempSet.insert(pairVector.front().second);
-
-    vector<vector<pair<int, int>>::iterator> tempIterVec;
-    tempIterVec.push_back(iter);
-
-    if (iter + 1 != pairVector.end()) {
-      vector<pair<int, int>>::iterator otherIter = iter + 1;
-      while (otherIter != pairVector.end()) {
-        if ((tempSet.find(otherIter->first) != tempSet.end()) ||
-            (tempSet.find(otherIter->second) != tempSet.end())) {
-          tempSet.insert(otherIter->first);
-          tempSet.insert(otherIter->second);
-          tempIterVec.push_back(otherIter);
-        }
-        ++otherIter;
-      }
-    }
-    setVector->push_back(tempSet);
-
-    // remove the pairs already grouped starting from the last
-    vector<vector<pair<int, int>>::iterator>::reverse_iterator iterIter =
-        tempIterVec.rbegin();
-    while (iterIter != tempIterVec.rend()) {
-      pairVector.erase(*iterIter);
-      ++iterIter;
-    }
+  int nClusters = 0;
+  for (auto const &mergingPair : pairVector) {
+    nClusters = max(nClusters, max(mergingPair.first, mergingPair.second) + 1);
+  }
+
+  // each pair joins the groups of its two clusters
+  Utility::DisjointSets groups(nClusters);
+  for (auto const &mergingPair : pairVector) {
+    groups.unite(mergingPair.first, mergingPair.second);
+  }
+  for (auto const &group : groups.groups()) {
+    setVector->emplace_back(group.begin(), group.end());
   }
 }
 
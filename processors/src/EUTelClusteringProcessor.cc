@@ -68,6 +68,44 @@ using namespace eutelescope;
 
 static const int MAXCLUSTERSIZE = 4096;
 
+//! Hit pixels of one sensor as (index, signal), sorted by index
+typedef vector<pair<int, float>> SparseSignalVec;
+
+//! Sort the hit pixels by index keeping the input order of duplicates
+static void sortSparseSignals(SparseSignalVec &signals) {
+  stable_sort(signals.begin(), signals.end(),
+              [](pair<int, float> const &a, pair<int, float> const &b) {
+                return a.first < b.first;
+              });
+}
+
+//! Signal of a pixel, missingValue if it was not transmitted
+/*! If a pixel was transmitted more than once, the last occurrence
+ *  wins, as when filling a full frame data vector.
+ */
+static float sparseSignal(SparseSignalVec const &signals, int index,
+                          float missingValue) {
+  auto it = upper_bound(
+      signals.begin(), signals.end(), index,
+      [](int i, pair<int, float> const &pixel) { return i < pixel.first; });
+  if (it == signals.begin() || (it - 1)->first != index) {
+    return missingValue;
+  }
+  return (it - 1)->second;
+}
+
+//! Order seed candidates (signal, index) by decreasing signal
+/*! Candidates with the same signal end up in reverse input order,
+ *  i.e. the order of a reverse iteration through a multimap.
+ */
+static void sortSeedCandidates(vector<pair<float, int>> &seeds) {
+  stable_sort(seeds.begin(), seeds.end(),
+              [](pair<float, int> const &a, pair<float, int> const &b) {
+                return a.first < b.first;
+              });
+  reverse(seeds.begin(), seeds.end());
+}
+
 EUTelClusteringProcessor::EUTelClusteringProcessor()
     : Processor("EUTelClusteringProcessor"), _nzsDataCollectionName(""),
       _zsDataCollectionName(""), _noiseCollectionName(""),
@@ -91,7 +129,7 @@ EUTelClusteringProcessor::EUTelClusteringProcessor()
       nzsInputDataCollectionVec(NULL), pulseCollectionVec(NULL),
       noiseCollectionVec(NULL), statusCollectionVec(NULL),
       hotPixelCollectionVec(NULL), hasNZSData(false), hasZSData(false),
-      _hitIndexMapVec() {
+      _hitIndexMapVec(), _touchedStatusMap() {
 
   // modify processor description
   _description = "EUTelClusteringProcessor is looking for clusters into a "
@@ -291,6 +329,10 @@ void EUTelClusteringProcessor::processRunHeader(LCRunHeader *rdr) {
   auto runHeader = std::make_unique<EUTelRunHeaderImpl>(rdr);
   runHeader->addProcessor(type());
   ++_iRun;
+
+  // the status collection may change with the run, the first ZS
+  // event has to do a full reset
+  _touchedStatusMap.clear();
 }
 
 void EUTelClusteringProcessor::initializeGeometry(LCEvent *event) throw(
@@ -646,6 +688,8 @@ void EUTelClusteringProcessor::readCollections(LCEvent *event) {
 }
 
 void EUTelClusteringProcessor::processEvent(LCEvent *event) {
+  EUTelProcessorProfile::EventTimer eventTimer(_profile);
+
   ID = 0;
   ++_iEvt;
 
@@ -698,6 +742,8 @@ void EUTelClusteringProcessor::processEvent(LCEvent *event) {
     pulseCollection = new LCCollectionVec(LCIO::TRACKERPULSE);
   }
 
+  EUTelProcessorProfile::PhaseTimer clusteringTimer(_profile, "clustering");
+
   //
   // non Zero Suppresed (RAW data)
   //
@@ -729,6 +775,9 @@ void EUTelClusteringProcessor::processEvent(LCEvent *event) {
     else if (_zsClusteringAlgo == EUTELESCOPE::BRICKEDCLUSTER)
       zsBrickedClustering(evt, pulseCollection); // force 3x3 clusters
   }
+  clusteringTimer.stop();
+  _profile.count("clusters",
+                 pulseCollection->size() - _initialPulseCollectionSize);
 
   // if the pulseCollection is not empty add it to the event
   if (!pulseCollectionExists &&
@@ -886,6 +935,7 @@ void EUTelClusteringProcessor::digitalFixedFrameClustering(
       streamlog_out(DEBUG1) << "Processing sparse data on detector "
                             << _sensorID << " with " << sparseData->size()
                             << " pixels " << endl;
+      _profile.count("pixels", sparseData->size());
 
       for (auto &sparsePixel : pixelVec) {
         int index = matrixDecoder.getIndexFromXY(sparsePixel.getXCoord(),
@@ -1330,18 +1380,18 @@ void EUTelClusteringProcessor::zsFixedFrameClustering(
     TrackerRawDataImpl *status = dynamic_cast<TrackerRawDataImpl *>(
         statusCollectionVec->getElementAt(_ancillaryIndexMap[sensorID]));
 
-    // reset the status
-    resetStatus(status);
+    // reset the status entries touched in the previous event
+    vector<int> &touchedIndices = resetTouchedStatus(status);
 
     // prepare the matrix decoder
     EUTelMatrixDecoder matrixDecoder(noiseDecoder, noise);
 
-    // prepare a data vector mimicking the TrackerData data of the
-    // standard FixedFrameClustering. Initialize all the entries to zero.
-    vector<float> dataVec(noise->getChargeValues().size(), 0.);
+    // keep only the transmitted pixels, the others have a signal of
+    // zero as in the standard FixedFrameClustering
+    SparseSignalVec signalVec;
 
-    // prepare a multimap for the seed candidates
-    multimap<float, int> seedCandidateMap;
+    // seed candidates, (signal, index)
+    vector<pair<float, int>> seedCandidateVec;
 
     if (type == kEUTelGenericSparsePixel) {
 
@@ -1353,37 +1403,40 @@ void EUTelClusteringProcessor::zsFixedFrameClustering(
       streamlog_out(DEBUG1) << "Processing sparse data on detector " << sensorID
                             << " with " << sparseData->size() << " pixels "
                             << endl;
+      _profile.count("pixels", sparseData->size());
 
       for (auto &sparsePixel : pixelVec) {
         int index = matrixDecoder.getIndexFromXY(sparsePixel.getXCoord(),
                                                  sparsePixel.getYCoord());
         float signal = sparsePixel.getSignal();
-        dataVec[index] = signal;
+        signalVec.push_back(make_pair(index, signal));
         if (static_cast<int>(status->getADCValues().size()) < index) {
           status->adcValues().resize(index + 1);
         }
         if ((signal > _ffSeedCut * noise->getChargeValues()[index]) &&
             (status->getADCValues()[index] == EUTELESCOPE::GOODPIXEL)) {
-          seedCandidateMap.insert(make_pair(signal, index));
+          seedCandidateVec.push_back(make_pair(signal, index));
           streamlog_out(DEBUG1) << "Added pixel " << sparsePixel.getXCoord()
                                 << ", " << sparsePixel.getYCoord()
                                 << " with signal " << signal
-                                << " to the seedCandidateMap" << endl;
+                                << " to the seed candidates" << endl;
         }
       }
     } else {
       throw UnknownDataTypeException("Unknown sparsified pixel");
     }
+    sortSparseSignals(signalVec);
 
-    if (!seedCandidateMap.empty()) {
+    if (!seedCandidateVec.empty()) {
 
-      streamlog_out(DEBUG0) << "There are " << seedCandidateMap.size()
+      streamlog_out(DEBUG0) << "There are " << seedCandidateVec.size()
                             << " seed candidates." << endl;
 
-      // now build up a cluster for each seed candidate
-      multimap<float, int>::reverse_iterator rMapIter =
-          seedCandidateMap.rbegin();
-      while (rMapIter != seedCandidateMap.rend()) {
+      // now build up a cluster for each seed candidate, starting from
+      // the highest signal
+      sortSeedCandidates(seedCandidateVec);
+      vector<pair<float, int>>::iterator rMapIter = seedCandidateVec.begin();
+      while (rMapIter != seedCandidateVec.end()) {
 
         // Remove hot pixel:
         if (_hitIndexMapVec.size() > static_cast<unsigned int>(sensorID)) {
@@ -1435,12 +1488,15 @@ void EUTelClusteringProcessor::zsFixedFrameClustering(
                 if (isGood && !isHit) {
                   // if the pixel wasn't selected, then its signal
                   // will be 0.0. Mark it in the status
-                  if (dataVec[index] == 0.0)
+                  float signal = sparseSignal(signalVec, index, 0.);
+                  if (signal == 0.0) {
                     status->adcValues()[index] = EUTELESCOPE::MISSINGPIXEL;
-                  clusterCandidateSignal += dataVec[index];
+                    touchedIndices.push_back(index);
+                  }
+                  clusterCandidateSignal += signal;
                   clusterCandidateNoise2 +=
                       pow(noise->getChargeValues()[index], 2);
-                  clusterCandidateCharges.push_back(dataVec[index]);
+                  clusterCandidateCharges.push_back(signal);
                 } else if (isHit) {
                   // this can be a good place to flag the current
                   // cluster as kMergedCluster, but it would introduce
@@ -1496,8 +1552,10 @@ void EUTelClusteringProcessor::zsFixedFrameClustering(
                                   << seedX << " seedY " << seedY << endl;
 
             while (indexIter != clusterCandidateIndeces.end()) {
-              if ((*indexIter) != -1)
+              if ((*indexIter) != -1) {
                 status->adcValues()[(*indexIter)] = EUTELESCOPE::HITPIXEL;
+                touchedIndices.push_back(*indexIter);
+              }
               ++indexIter;
             }
 
@@ -1617,25 +1675,24 @@ void EUTelClusteringProcessor::zsBrickedClustering(
     TrackerRawDataImpl *status = dynamic_cast<TrackerRawDataImpl *>(
         statusCollectionVec->getElementAt(_ancillaryIndexMap[sensorID]));
 
-    // reset the status
-    resetStatus(status);
+    // reset the status entries touched in the previous event
+    vector<int> &touchedIndices = resetTouchedStatus(status);
 
     // prepare the matrix decoder
     EUTelMatrixDecoder matrixDecoder(noiseDecoder, noise);
 
-    // prepare a data vector mimicking the TrackerData data of the
-    // standard FixedFrameClustering. Initialize all the entries to zero.
+    // keep only the transmitted pixels.
     // NOTE
-    // TAKI 0.0001 instead of 0.0, because we have integers coming in from the
-    // DUT.
+    // TAKI 0.0001 instead of 0.0 for the pixels not transmitted,
+    // because we have integers coming in from the DUT.
     // And these might very well be 0 -> 0.0 quite often! So 0.0001 is used
     // here.
     // If the 0.0001 value is found here later on again, then we know that the
     // corresponding pixel was not transmitted!
-    vector<float> dataVec(status->getADCValues().size(), 0.0001);
+    SparseSignalVec signalVec;
 
-    // prepare a multimap for the seed candidates
-    multimap<float, int> seedCandidateMap;
+    // seed candidates, (signal, index)
+    vector<pair<float, int>> seedCandidateVec;
 
     if (type == kEUTelGenericSparsePixel) {
 
@@ -1647,21 +1704,22 @@ void EUTelClusteringProcessor::zsBrickedClustering(
       streamlog_out(DEBUG1) << "Processing sparse data on detector " << sensorID
                             << " with " << sparseData->size() << " pixels "
                             << endl;
+      _profile.count("pixels", sparseData->size());
 
       for (auto &sparsePixel : pixelVec) {
         int index = matrixDecoder.getIndexFromXY(sparsePixel.getXCoord(),
                                                  sparsePixel.getYCoord());
         float signal = sparsePixel.getSignal();
-        dataVec[index] = signal;
+        signalVec.push_back(make_pair(index, signal));
 
         //! CUT 1
         if ((signal > _ffSeedCut * noise->getChargeValues()[index]) &&
             (status->getADCValues()[index] == EUTELESCOPE::GOODPIXEL)) {
-          seedCandidateMap.insert(make_pair(signal, index));
+          seedCandidateVec.push_back(make_pair(signal, index));
           streamlog_out(DEBUG1) << "Added pixel " << sparsePixel.getXCoord()
                                 << ", " << sparsePixel.getYCoord()
                                 << " with signal " << signal
-                                << " to the seedCandidateMap" << endl;
+                                << " to the seed candidates" << endl;
 
           if (noise->getChargeValues()[index] < 0.01) {
             streamlog_out(ERROR2)
@@ -1680,16 +1738,18 @@ void EUTelClusteringProcessor::zsBrickedClustering(
     } else {
       throw UnknownDataTypeException("Unknown sparsified pixel");
     }
+    sortSparseSignals(signalVec);
 
-    if (!seedCandidateMap.empty()) {
+    if (!seedCandidateVec.empty()) {
 
-      streamlog_out(DEBUG0) << "  Seed candidates " << seedCandidateMap.size()
+      streamlog_out(DEBUG0) << "  Seed candidates " << seedCandidateVec.size()
                             << endl;
 
-      // now build up a cluster for each seed candidate
-      multimap<float, int>::reverse_iterator rMapIter =
-          seedCandidateMap.rbegin();
-      while (rMapIter != seedCandidateMap.rend()) {
+      // now build up a cluster for each seed candidate, starting from
+      // the highest signal
+      sortSeedCandidates(seedCandidateVec);
+      vector<pair<float, int>>::iterator rMapIter = seedCandidateVec.begin();
+      while (rMapIter != seedCandidateVec.end()) {
         if (status->adcValues()[(*rMapIter).second] == EUTELESCOPE::GOODPIXEL) {
           // if we enter here, this means that at least the seed pixel
           // wasn't added yet to another cluster.  Note that now we need
@@ -1738,16 +1798,17 @@ void EUTelClusteringProcessor::zsBrickedClustering(
                 if (isGood) // normal case, good means not marked as used by
                             // another cluster, yet
                 {
-                  clusterCandidateCharges.push_back(dataVec[index]);
+                  // If the pixel wasn't selected (zs), then its signal
+                  // is 0.0001.
+                  float signal = sparseSignal(signalVec, index, 0.0001);
+                  clusterCandidateCharges.push_back(signal);
                   clusterCandidateIndeces.push_back(
                       index); // used to flag used pixels afterwards!
 
-                  // If the pixel wasn't selected (zs), then its signal
-                  // will still be 0.0001, because dataVec was initialized this
-                  // way.
                   // Mark this in the status!
-                  if (dataVec[index] == 0.0001) {
+                  if (signal == 0.0001) {
                     status->adcValues()[index] = EUTELESCOPE::MISSINGPIXEL;
+                    touchedIndices.push_back(index);
                   }
 
                   //! HACK TAKI
@@ -1908,6 +1969,7 @@ void EUTelClusteringProcessor::zsBrickedClustering(
               } else {
                 if ((*indexIter) != -1) {
                   status->adcValues()[(*indexIter)] = EUTELESCOPE::HITPIXEL;
+                  touchedIndices.push_back(*indexIter);
                 }
               }
               ++indexIter;
@@ -1960,9 +2022,9 @@ void EUTelClusteringProcessor::zsBrickedClustering(
 
         ++rMapIter;
 
-      } // END: while (not all seed candidates in the map have been processed)
-        // ((while ( rMapIter != seedCandidateMap.rend() )))
-    } // END: if ( seedCandidateMap.size() != 0 )
+      } // END: while (not all seed candidates in the vector have been processed)
+        // ((while ( rMapIter != seedCandidateVec.end() )))
+    } // END: if ( !seedCandidateVec.empty() )
   }   // for ( unsigned int i = 0 ; i < zsInputDataCollectionVec->size(); i++ )
 
   // if the sparseClusterCollectionVec isn't empty add it to the
@@ -2037,6 +2099,7 @@ void EUTelClusteringProcessor::sparseClustering(
       streamlog_out(DEBUG2) << "Processing sparse data on detector " << sensorID
                             << " with " << sparseData->size() << " pixels "
                             << endl;
+      _profile.count("pixels", sparseData->size());
 
       std::vector<EUTelGenericSparsePixel> hitPixelVec =
           sparseData->getPixels();
@@ -2292,6 +2355,7 @@ void EUTelClusteringProcessor::fixedFrameClustering(
     short limitExceed = 0;
 
     _seedCandidateMap.clear();
+    _profile.count("pixels", nzsData->getChargeValues().size());
 
     for (unsigned int iPixel = 0; iPixel < nzsData->getChargeValues().size();
          iPixel++) {
@@ -2907,6 +2971,7 @@ void EUTelClusteringProcessor::end() {
                             << " clusters on detector " << iter->first << endl;
     ++iter;
   }
+  _profile.summarize(name());
 }
 
 void EUTelClusteringProcessor::resetStatus(IMPL::TrackerRawDataImpl *status) {
@@ -2924,6 +2989,26 @@ void EUTelClusteringProcessor::resetStatus(IMPL::TrackerRawDataImpl *status) {
   }
 }
 
+std::vector<int> &
+EUTelClusteringProcessor::resetTouchedStatus(IMPL::TrackerRawDataImpl *status) {
+
+  auto it = _touchedStatusMap.find(status);
+  if (it == _touchedStatusMap.end()) {
+    resetStatus(status);
+    return _touchedStatusMap[status];
+  }
+
+  ShortVec &adcValues = status->adcValues();
+  for (int index : it->second) {
+    if (adcValues[index] == EUTELESCOPE::HITPIXEL ||
+        adcValues[index] == EUTELESCOPE::MISSINGPIXEL) {
+      adcValues[index] = EUTELESCOPE::GOODPIXEL;
+    }
+  }
+  it->second.clear();
+  return it->second;
+}
+
 #if defined(USE_AIDA) || defined(MARLIN_USE_AIDA)
 void EUTelClusteringProcessor::fillHistos(LCEvent *evt) {
 
@@ -89,7 +89,7 @@ std::string EUTelCorrelator::_hitYCorrShiftProjectionHistoName =
 
 EUTelCorrelator::EUTelCorrelator()
     : Processor("EUTelCorrelator"), _histoInfoFileName("histoinfo.xml"),
-      _sensorIDVec() {
+      _sensorIDVec(), _collectionCache() {
 
   // modify processor description
   _description = "EUTelCorrelator fills histograms with correlation plots";
@@ -271,41 +271,24 @@ void EUTelCorrelator::processEvent(LCEvent *event) {
   for (size_t i = 0; i < _clusterCollectionVec.size(); i++) {
     std::string _inputClusterCollectionName = _clusterCollectionVec[i];
 
-    try {
-      // let's check if we have cluster collections
-      event->getCollection(_inputClusterCollectionName);
-
-      _hasClusterCollection = true;
+    // let's check if we have cluster collections
+    _hasClusterCollection =
+        _collectionCache.has(event, _inputClusterCollectionName);
+    if (_hasClusterCollection) {
       streamlog_out(DEBUG5) << "found " << i << " name "
                             << _inputClusterCollectionName.c_str() << endl;
-
-    } catch (lcio::Exception &e) {
-
-      _hasClusterCollection = false;
+    } else {
       streamlog_out(WARNING) << "NOT found " << i << " name "
                              << _inputClusterCollectionName.c_str() << endl;
-
       break;
     }
   }
 
-  try {
-    // let's check if we have hit collections
-
-    event->getCollection(_inputHitCollectionName);
-
-    _hasHitCollection = true;
-    streamlog_out(DEBUG5) << "found "
-                          << " name " << _inputHitCollectionName.c_str()
-                          << endl;
-
-  } catch (lcio::Exception &e) {
-
-    _hasHitCollection = false;
-    streamlog_out(DEBUG5) << "NOT found "
-                          << " name " << _inputHitCollectionName.c_str()
-                          << endl;
-  }
+  // let's check if we have hit collections
+  _hasHitCollection = _collectionCache.has(event, _inputHitCollectionName);
+  streamlog_out(DEBUG5) << (_hasHitCollection ? "found " : "NOT found ")
+                        << " name " << _inputHitCollectionName.c_str()
+                        << endl;
 
   // check if we have at least one collection.
   if (!_hasClusterCollection && !_hasHitCollection) {
@@ -331,8 +314,7 @@ void EUTelCorrelator::processEvent(LCEvent *event) {
           _clusterCollectionVec[eCol];
 
       LCCollectionVec *externalInputClusterCollection =
-          static_cast<LCCollectionVec *>(
-              event->getCollection(_ExternalInputClusterCollectionName));
+          _collectionCache.get(event, _ExternalInputClusterCollectionName);
       CellIDDecoder<TrackerPulseImpl> pulseCellDecoder(
           externalInputClusterCollection);
 
@@ -397,8 +379,7 @@ void EUTelCorrelator::processEvent(LCEvent *event) {
               _clusterCollectionVec[iCol];
 
           LCCollectionVec *internalInputClusterCollection =
-              static_cast<LCCollectionVec *>(
-                  event->getCollection(_InternalInputClusterCollectionName));
+              _collectionCache.get(event, _InternalInputClusterCollectionName);
           CellIDDecoder<TrackerPulseImpl> pulseCellDecoder(
               internalInputClusterCollection);
 
@@ -497,8 +478,8 @@ void EUTelCorrelator::processEvent(LCEvent *event) {
 
   if (_hasHitCollection) {
 
-    LCCollectionVec *inputHitCollection = static_cast<LCCollectionVec *>(
-        event->getCollection(_inputHitCollectionName));
+    LCCollectionVec *inputHitCollection =
+        _collectionCache.get(event, _inputHitCollectionName);
     UTIL::CellIDDecoder<TrackerHitImpl> hitDecoder(EUTELESCOPE::HITENCODING);
 
     streamlog_out(MESSAGE2) << "inputHitCollection "
@@ -642,6 +623,8 @@ void EUTelCorrelator::processEvent(LCEvent *event) {
 
 void EUTelCorrelator::end() {
 
+  _collectionCache.printSummary(name());
+
   if (_hasHitCollection) {
     streamlog_out(MESSAGE5) << "The input CollectionVec contains "
                                "HitCollection, calculating offset values "
@@ -199,6 +199,19 @@ EUTelDafBase::EUTelDafBase(std::string name) : marlin::Processor(name) {
                                           "measurement to be included in the "
                                           "fit.",
                             _chi2cutoff, static_cast<float>(300.0f));
+  registerOptionalParameter("AdaptiveDaf",
+                            "DAF fitter: Stop the annealing once the weights "
+                            "converged, and start combinatorialKF candidates "
+                            "at DafWarmStartTemperature.",
+                            _adaptiveDaf, static_cast<bool>(false));
+  registerOptionalParameter("DafWeightTolerance",
+                            "DAF fitter: Largest weight change of a converged "
+                            "iteration in adaptive mode.",
+                            _dafWeightTolerance, static_cast<float>(0.01f));
+  registerOptionalParameter("DafWarmStartTemperature",
+                            "DAF fitter: First annealing temperature of "
+                            "combinatorialKF candidates in adaptive mode.",
+                            _dafWarmStartT, static_cast<float>(4.0f));
   registerOptionalParameter(
       "RequireNTelPlanes",
       "How many telescope planes do we require to be included in the fit?",
@@ -476,6 +489,7 @@ void EUTelDafBase::init() {
 
   size_t index = 0;
   size_t nActive = 0;
+  auto materialBudget = geo::gGeometry().materialBudget();
   for (int sensorID : geo::gGeometry().sensorIDsVec()) {
     _nRef.push_back(3);
     //   int sensorID = _siPlanesLayerLayout->getID( (*zit).second );
@@ -486,8 +500,7 @@ void EUTelDafBase::init() {
     bool excluded = true;
 
     // Get scatter using x / x0
-    float radLength = geo::gGeometry().siPlaneZSize(sensorID) /
-                      (geo::gGeometry().siPlaneRadLength(sensorID));
+    float radLength = materialBudget->planeX0(sensorID);
     /*
             _siPlanesLayerLayout->getLayerThickness( (*zit).second ) /
        _siPlanesLayerLayout->getLayerRadLength( (*zit).second );
@@ -564,6 +577,9 @@ void EUTelDafBase::init() {
   // Prepare and preallocate memory for track fitter
   _system.setChi2OverNdofCut(_maxChi2);
   _system.setDAFChi2Cut(_chi2cutoff);
+  _system.setAdaptiveDaf(_adaptiveDaf);
+  _system.setDafWeightTolerance(_dafWeightTolerance);
+  _system.setDafWarmStartT(_dafWarmStartT);
   _system.init();
 
   // Fuzzy assignment by DAF might make a plane only partially included, This
@@ -639,9 +655,8 @@ void EUTelDafBase::readHitCollection(LCEvent *event) {
   for (size_t i = 0; i < _hitCollectionName.size(); i++) {
     streamlog_out(DEBUG5) << " hit collection name: " << _hitCollectionName[i]
                           << " found for event " << event->getEventNumber();
-    try {
-      _hitCollection = event->getCollection(_hitCollectionName[i]);
-    } catch (DataNotAvailableException &e) {
+    _hitCollection = _collectionCache.get(event, _hitCollectionName[i]);
+    if (!_hitCollection) {
       streamlog_out(WARNING2) << "No input collection " << _hitCollectionName[i]
                               << " found for event " << event->getEventNumber()
                               << " in run " << event->getRunNumber() << endl;
@@ -659,8 +674,7 @@ void EUTelDafBase::readHitCollection(LCEvent *event) {
       int planeIndex = -1;
 
       if (_mcCollectionStr.size() > 0) {
-        _mcCollection = dynamic_cast<LCCollectionVec *>(
-            event->getCollection(_mcCollectionStr[i]));
+        _mcCollection = _collectionCache.get(event, _mcCollectionStr[i]);
         SimTrackerHitImpl *simhit = 0;
         if (_mcCollection != 0)
           simhit = static_cast<SimTrackerHitImpl *>(
@@ -732,6 +746,7 @@ int EUTelDafBase::checkInTime(daffitter::TrackCandidate<float, 4> &track) {
 
 void EUTelDafBase::processEvent(LCEvent *event) {
   // Called once per event, read data, fit, save
+  EUTelProcessorProfile::EventTimer eventTimer(_profile);
   EUTelEventImpl *evt = static_cast<EUTelEventImpl *>(event);
   if (event->getEventNumber() % 1000 == 0) {
     streamlog_out(MESSAGE) << "Accepted " << _nTracks << " tracks at event "
@@ -807,6 +822,7 @@ void EUTelDafBase::processEvent(LCEvent *event) {
   }
 
   // Run track finder
+  EUTelProcessorProfile::PhaseTimer finderTimer(_profile, "trackfinder");
   switch (_trackFinderType) {
   case combinatorialKF:
     _system.combinatorialKF();
@@ -815,9 +831,13 @@ void EUTelDafBase::processEvent(LCEvent *event) {
     _system.clusterTracker();
     break;
   }
+  finderTimer.stop();
+  _profile.count("candidates", _system.getNtracks());
 
   // Child specific actions
+  EUTelProcessorProfile::PhaseTimer dafTimer(_profile, "daf");
   dafEvent(event);
+  dafTimer.stop();
 
   streamlog_out(MESSAGE1) << " dafEvent is OVER " << std::endl;
 
@@ -1116,6 +1136,8 @@ void EUTelDafBase::end() {
   streamlog_out(MESSAGE5) << "Tracks with NaNs: " << n_failedIsnan << endl;
   streamlog_out(MESSAGE5) << "Number of fitted tracks: " << _nTracks << endl;
   streamlog_out(MESSAGE5) << "Successfully finished" << endl;
+  _collectionCache.printSummary(name());
+  _profile.summarize(name());
   for (size_t ii = 0; ii < _system.planes.size(); ii++) {
     daffitter::FitPlane<float> &plane = _system.planes.at(ii);
     char iden[4];
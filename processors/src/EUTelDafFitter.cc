@@ -125,6 +125,7 @@ void EUTelDafFitter::dafParams() {
 }
 
 void EUTelDafFitter::dafInit() {
+  _nDafIterations = 0;
   if (_fitDuts) {
     for (size_t ii = 0; ii < _system.planes.size(); ii++) {
       if (find(_dutPlanes.begin(), _dutPlanes.end(),
@@ -154,6 +155,8 @@ void EUTelDafFitter::dafEvent(LCEvent *event) {
     _nCandidates++;
     // Prepare track for DAF fit
     _system.fitPlanesInfoDaf(_system.tracks.at(ii));
+    _nDafIterations += _system.tracks.at(ii).dafIterations;
+    _profile.count("dafIterations", _system.tracks.at(ii).dafIterations);
     // Check resids, intime, angles
     if (not checkTrack(_system.tracks.at(ii))) {
       continue;
@@ -302,5 +305,12 @@ double EUTelDafFitter::getZfromRefHit(int plane, int sensorID, double *pos) {
   return point(2);
 }
 
-void EUTelDafFitter::dafEnd() {}
+void EUTelDafFitter::dafEnd() {
+  double const meanIterations =
+      _nCandidates > 0 ? static_cast<double>(_nDafIterations) / _nCandidates
+                       : 0.;
+  streamlog_out(MESSAGE5) << "DAF iterations per candidate: " << meanIterations
+                          << (_adaptiveDaf ? " (adaptive)" : " (fixed)")
+                          << endl;
+}
 #endif // USE_GEAR
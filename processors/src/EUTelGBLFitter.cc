@@ -91,7 +91,7 @@ using namespace marlin;
 using namespace eutelescope;
 
 
-EUTelGBLFitter::EUTelGBLFitter() : Processor("EUTelGBLFitter"), _inputCollectionTelescope(""), _isFirstEvent(0), _eBeam(0), _nEvt(0), _nPlanes(0), _track_match_cut(0.15),  _planePosition() {
+EUTelGBLFitter::EUTelGBLFitter() : Processor("EUTelGBLFitter"), _inputCollectionTelescope(""), _collectionCache(), _profile(), _planeTable(), _isFirstEvent(0), _eBeam(0), _nEvt(0), _nPlanes(0), _track_match_cut(0.15),  _planePosition() {
   // modify processor description
   _description = "Analysis for DATURA reference analysis ";
 
@@ -131,27 +131,33 @@ void EUTelGBLFitter::init() {
   _printEventCounter= 0;
   _ngbl = 0;
 
+  //The material budget is taken from TGeo, independent of the processors run before
+  geo::gGeometry().initializeTGeoDescription(EUTELESCOPE::GEOFILENAME, EUTELESCOPE::DUMPGEOROOT);
+
   //This is the vector of sensorIDs ordered alogn the gloabl z-axis, 
   //this is guranteed by the framework 
   _sensorIDVec = geo::gGeometry().sensorIDsVec();
   _nPlanes = _sensorIDVec.size();
 
+  auto materialBudget = geo::gGeometry().materialBudget();
   for(auto& sensorID: _sensorIDVec) {
     auto const & pos = geo::gGeometry().siPlaneZPosition(sensorID);
     _planePosition.emplace_back( pos );
-    auto const & z = geo::gGeometry().siPlaneZSize(sensorID);
-    auto const & rad = geo::gGeometry().siPlaneRadLength(sensorID);
+    auto const & rad = materialBudget->planeX0(sensorID);
 
     if(sensorID < 6) {
-        _planeRadLength.emplace_back(z/rad + 0.050 / 286.6); // Plane from GEAR + Kapton
+        _planeRadLength.emplace_back(rad + 0.050 / 286.6); // Plane + Kapton, which the TGeo description does not contain
     } else {
-        _planeRadLength.emplace_back(z/rad);
+        _planeRadLength.emplace_back(rad);
     }
   }
 
   //to compute the total radiation length we will loop over all planes and add radiation
-  //length for air from the first to the last plane
-  double totalRadLength = (_planePosition.back()-_planePosition.front())/304200; //Radiation length for air is 30420 cm
+  //length for the air gaps from the first to the last plane
+  double totalRadLength = 0;
+  for(size_t gap = 0; gap < materialBudget->nGaps(); gap++) {
+    totalRadLength += materialBudget->gapX0(gap);
+  }
   for(auto& radLen: _planeRadLength) {
     totalRadLength += radLen;
   }
@@ -163,8 +169,7 @@ void EUTelGBLFitter::init() {
   }
 
   for(size_t ipl = 0; ipl < _nPlanes-1; ipl++) {
-    auto distplane = _planePosition[ipl+1] - _planePosition[ipl];
-    double epsAir =   0.5*distplane  / 304200.;  // in [mm]
+    double epsAir = 0.5*materialBudget->gapX0(ipl);
     double tetAir = _kappa*0.0136 * sqrt(epsAir) / _eBeam * ( 1 + 0.038*std::log(totalRadLength) );
     _planeWscatAir.emplace_back( 1.0/(tetAir*tetAir), 1.0/(tetAir*tetAir) );
   }
@@ -276,11 +281,14 @@ void EUTelGBLFitter::processRunHeader( LCRunHeader* runHeader) {
   // Decode and print out Run Header information - just a check
   _nRun = runHeader->getRunNumber();
   streamlog_out( MESSAGE2 )  << "Processing run header, run nr: " << runHeader->getRunNumber() << std::endl;
+  _planeTable = geo::gGeometry().planeTable();
 } // processRunHeader
 
 //----------------------------------------------------------------------------
 void EUTelGBLFitter::processEvent( LCEvent * event ) {
 
+  EUTelProcessorProfile::EventTimer eventTimer( _profile );
+
   if( _nEvt % 1000 == 0 ) {
     streamlog_out( MESSAGE2 ) << "Processing event "
       << setw(6) << setiosflags(ios::right)
@@ -307,11 +315,8 @@ void EUTelGBLFitter::processEvent( LCEvent * event ) {
   //----------------------------------------------------------------------------
   // check input collection (aligned hits):
 
-  LCCollection* collection = nullptr;
-  try {
-    collection = event->getCollection( _inputCollectionTelescope );
-  }
-  catch( lcio::DataNotAvailableException& e) {
+  LCCollection* collection = _collectionCache.get( event, _inputCollectionTelescope );
+  if( !collection ) {
     streamlog_out( DEBUG1 ) << "Not able to get collections "
       << _inputCollectionTelescope << " "
       << "\nfrom event " << event->getEventNumber()
@@ -371,6 +376,7 @@ void EUTelGBLFitter::processEvent( LCEvent * event ) {
   } // end loop over all hits in given collection
 
   nAllTelHitHisto->fill( hits.size() );
+  _profile.count( "hits", hits.size() );
   nAllDUTHitHisto->fill( DUThits.size() );
 
   streamlog_out(DEBUG4) << "Event " << event->getEventNumber() << " contains " << hits.size() << " telscope and " << DUThits.size() << " DUT hits" << std::endl;
@@ -390,7 +396,10 @@ void EUTelGBLFitter::processEvent( LCEvent * event ) {
   // Downstream Telescope Triplets ("driplets")
   // Generate new triplet set for the Telescope Downstream Arm:
   std::vector<EUTelTripletGBLUtility::triplet> downstream_triplets;
+  EUTelProcessorProfile::PhaseTimer dripletTimer( _profile, "triplets" );
   gblutil.FindTriplets(hits, 3, 4, 5, _triplet_res_cut, _slope_cut, downstream_triplets);
+  dripletTimer.stop();
+  _profile.count( "driplets", downstream_triplets.size() );
   streamlog_out(DEBUG4) << "Found " << downstream_triplets.size() << " driplets." << endl;
 
   // Iterate over all found downstream triplets to fill histograms and match them to the REF and DUT:
@@ -427,7 +436,10 @@ void EUTelGBLFitter::processEvent( LCEvent * event ) {
 
   // Generate new triplet set for the Telescope Upstream Arm:
   std::vector<EUTelTripletGBLUtility::triplet> upstream_triplets;
+  EUTelProcessorProfile::PhaseTimer tripletTimer( _profile, "triplets" );
   gblutil.FindTriplets(hits, 0, 1, 2, _triplet_res_cut, _slope_cut, upstream_triplets);
+  tripletTimer.stop();
+  _profile.count( "triplets", upstream_triplets.size() );
   streamlog_out(DEBUG4) << "Found " << upstream_triplets.size() << " triplets." << endl;
 
   // Iterate over all found upstream triplets to fill histograms and match them to the REF and DUT:
@@ -588,10 +600,15 @@ void EUTelGBLFitter::processEvent( LCEvent * event ) {
   //Match half way between the upstream and downstream arms
   double zMid = 0.5*(_planePosition[_nPlanes-3] + _planePosition[2]);
   std::vector<EUTelTripletGBLUtility::track> telescope_tracks;
+  EUTelProcessorProfile::PhaseTimer matchingTimer( _profile, "matching" );
   gblutil.MatchTriplets(upstream_triplets,downstream_triplets, zMid, _track_match_cut, telescope_tracks);
+  matchingTimer.stop();
+  _profile.count( "tracks", telescope_tracks.size() );
 
   streamlog_out(DEBUG4) << "Found " << telescope_tracks.size() << " tracks from matching t/driplets." << endl;
-  
+
+  // GBL fit of the matched tracks, timed until the end of the event
+  EUTelProcessorProfile::PhaseTimer gblTimer( _profile, "gbl" );
   for( auto& tr: telescope_tracks ){
     //unused: auto const & trip = tr.get_upstream();
     auto const & drip = tr.get_downstream();
@@ -898,7 +915,7 @@ void EUTelGBLFitter::processEvent( LCEvent * event ) {
         std::array<double, 3> globalCorrPos {corrPos[0], corrPos[1], _planePosition[ipl]};
         std::array<double, 3> localCorrPos;
  
-        geo::gGeometry().master2Local(currentSensor, globalCorrPos, localCorrPos);
+        geo::PlaneTable::master2Local(_planeTable->plane(currentSensor), globalCorrPos, localCorrPos);
         corrPos[0] = localCorrPos[0];
         corrPos[1] = localCorrPos[1];
 
@@ -1040,6 +1057,8 @@ void EUTelGBLFitter::end(){
     << "Processed events:    "
     << std::setw(10) << std::setiosflags(std::ios::right)
     << _nEvt << std::resetiosflags(std::ios::right) << std::endl;
+  _collectionCache.printSummary( name() );
+  _profile.summarize( name() );
 }
 
 void EUTelGBLFitter::fillTrackhitHisto(EUTelTripletGBLUtility::hit const & hit, int ipl){
@@ -264,6 +264,12 @@ EUTelMille::EUTelMille() : Processor("EUTelMille") {
       "Use cuts on the residuals to reduce the combinatorial background.",
       _useResidualCuts, static_cast<bool>(false));
 
+  registerOptionalParameter(
+      "UseMinuitTrackFit",
+      "In the XYShiftsAllRot mode, fit the tracks with Minuit instead of the "
+      "analytic straight line fit.",
+      _useMinuitTrackFit, static_cast<bool>(false));
+
   registerOptionalParameter(
       "AlignmentConstantLCIOFile",
       "This is the name of the LCIO file name with the output alignment"
@@ -1596,6 +1602,21 @@ void EUTelMille::processEvent(LCEvent *event) {
     double Chiquare[2] = {0, 0};
     double angle[2] = {0, 0};
 
+    // the analytic straight line fit is done for all track candidates
+    // at once, the Minuit fit is done track by track below
+    std::vector<linefitter> lineFits;
+    if (_alignMode == Utility::alignMode::XYShiftsAllRot &&
+        !_useMinuitTrackFit) {
+      std::vector<hit> trackHits(_nPlanes);
+      lineFits.resize(_nTracks);
+      for (int track = 0; track < _nTracks; track++) {
+        double mean[3];
+        const unsigned int nHits = collectTrackHits(
+            track, trackHits.data(), lineFits[track].nMeasured, mean);
+        lineFits[track].fit(trackHits.data(), nHits);
+      }
+    }
+
     // loop over all track candidates
     for (int track = 0; track < _nTracks; track++) {
 
@@ -1654,75 +1675,13 @@ void EUTelMille::processEvent(LCEvent *event) {
                                   << " _inputMode = " << _inputMode
                                   << std::endl;
 
-          // use minuit to find tracks
           size_t mean_n = 0;
-          double mean_x = 0.0;
-          double mean_y = 0.0;
-          double mean_z = 0.0;
-          int index_hitsarray = 0;
-          double x0 = -1.;
-          double y0 = -1.;
-          // double z0 = -1.;
-          for (unsigned int help = 0; help < _nPlanes; help++) {
-            bool excluded = false;
-            // check if actual plane is excluded
-            if (_nExcludePlanes > 0) {
-              for (int helphelp = 0; helphelp < _nExcludePlanes; helphelp++) {
-                if (help == _excludePlanes[helphelp]) {
-                  excluded = true;
-                }
-              }
-            }
-            const double x = _xPos[track][help];
-            const double y = _yPos[track][help];
-            const double z = _zPos[track][help];
-            if (abs(x) > 1e-06 && abs(y) > 1e-06) {
-              x0 = _xPos[track][help];
-              y0 = _yPos[track][help];
-              // z0 = _zPos[track][help];
-            }
-            const double xresid = x0 - x;
-            const double yresid = y0 - y;
-            streamlog_out(DEBUG9) << " x0 = " << x0 << " x= " << x
-                                    << " ;; y0 = " << y0 << " y = " << y
-                                    << std::endl;
-
-            if (xresid < _residualsXMin[help] ||
-                xresid > _residualsXMax[help]) {
-              continue;
-            }
-            if (yresid < _residualsYMin[help] ||
-                yresid > _residualsYMax[help]) {
-              continue;
-            }
-
-            if (!excluded) {
-              double sigmax = _resolutionX[help];
-              double sigmay = _resolutionY[help];
-              double sigmaz = _resolutionZ[help];
-
-              if (!(abs(x) < 1e-06 && abs(y) < 1e-06)) {
-                mean_z += z;
-                mean_x += x;
-                mean_y += y;
-                mean_n++;
-              }
-
-              if (abs(x) < 1e-06 && abs(y) < 1e-06) {
-                sigmax = 1000000.;
-                sigmay = 1000000.;
-                sigmaz = 1000000.;
-              }
-
-              hitsarray[index_hitsarray] =
-                  (hit(x, y, z, sigmax, sigmay, sigmaz, help));
-
-              index_hitsarray++;
-            }
+          double mean[3] = {0., 0., 0.};
+          if (_useMinuitTrackFit) {
+            collectTrackHits(track, hitsarray, mean_n, mean);
+          } else {
+            mean_n = lineFits[track].nMeasured;
           }
-          mean_z = mean_z / static_cast<double>(mean_n);
-          mean_x = mean_x / static_cast<double>(mean_n);
-          mean_y = mean_y / static_cast<double>(mean_n);
 
           int diff_mean = _nPlanes - mean_n;
           streamlog_out(DEBUG9) << " diff_mean: " << diff_mean
@@ -1733,110 +1692,136 @@ void EUTelMille::processEvent(LCEvent *event) {
             continue;
           }
 
-          static bool firstminuitcall = true;
+          bool ok = true;
+          double b0 = 0.0;
+          double b1 = 0.0;
+          double c0 = 1.0;
+          double c1 = 1.0;
+          double c2 = 1.0;
 
-          if (firstminuitcall) {
-            gSystem->Load("libMinuit"); // is this really needed?
-            firstminuitcall = false;
-          }
-          TMinuit *gMinuit =
-              new TMinuit(4); // initialize TMinuit with a maximum of 4 params
+          if (_useMinuitTrackFit) {
+            const double mean_x = mean[0];
+            const double mean_y = mean[1];
+            const double mean_z = mean[2];
 
-          //  set print level (-1 = quiet, 0 = normal, 1 = verbose)
-          gMinuit->SetPrintLevel(-1);
+            static bool firstminuitcall = true;
 
-          gMinuit->SetFCN(fcn_wrapper);
+            if (firstminuitcall) {
+              gSystem->Load("libMinuit"); // is this really needed?
+              firstminuitcall = false;
+            }
+            TMinuit *gMinuit =
+                new TMinuit(4); // initialize TMinuit with a maximum of 4 params
 
-          double arglist[10];
-          int ierflg = 0;
+            //  set print level (-1 = quiet, 0 = normal, 1 = verbose)
+            gMinuit->SetPrintLevel(-1);
 
-          // minimization strategy (1 = standard, 2 = slower)
-          arglist[0] = 2;
-          gMinuit->mnexcm("SET STR", arglist, 2, ierflg);
+            gMinuit->SetFCN(fcn_wrapper);
 
-          // set error definition (1 = for chi square)
-          arglist[0] = 1;
-          gMinuit->mnexcm("SET ERR", arglist, 1, ierflg);
+            double arglist[10];
+            int ierflg = 0;
 
-          // analytic track fit to guess the starting parameters
-          double sxx = 0.0;
-          double syy = 0.0;
-          double szz = 0.0;
+            // minimization strategy (1 = standard, 2 = slower)
+            arglist[0] = 2;
+            gMinuit->mnexcm("SET STR", arglist, 2, ierflg);
 
-          double szx = 0.0;
-          double szy = 0.0;
+            // set error definition (1 = for chi square)
+            arglist[0] = 1;
+            gMinuit->mnexcm("SET ERR", arglist, 1, ierflg);
 
-          for (size_t i = 0; i < number_of_datapoints; i++) {
-            const double x = hitsarray[i].x;
-            const double y = hitsarray[i].y;
-            const double z = hitsarray[i].z;
-            if (!(abs(x) < 1e-06 && abs(y) < 1e-06)) {
-              sxx += pow(x - mean_x, 2);
-              syy += pow(y - mean_y, 2);
-              szz += pow(z - mean_z, 2);
+            // analytic track fit to guess the starting parameters
+            double sxx = 0.0;
+            double syy = 0.0;
+            double szz = 0.0;
 
-              szx += (x - mean_x) * (z - mean_z);
-              szy += (y - mean_y) * (z - mean_z);
-            }
-          }
-          double linfit_x_a1 = szx / szz; // slope
-          double linfit_y_a1 = szy / szz; // slope
-
-          double linfit_x_a0 = mean_x - linfit_x_a1 * mean_z; // offset
-          double linfit_y_a0 = mean_y - linfit_y_a1 * mean_z; // offset
-
-          double del = -1.0 * atan(linfit_y_a1); // guess of delta
-          double ps = atan(linfit_x_a1 /
-                           sqrt(1.0 + linfit_y_a1 * linfit_y_a1)); // guess
-          // of psi
-
-          //  Set starting values and step sizes for parameters
-          Double_t vstart[4] = {linfit_x_a0, linfit_y_a0, del, ps};
-          // duble vstart[4] = {0.0, 0.0, 0.0, 0.0};
-          double step[4] = {0.01, 0.01, 0.01, 0.01};
-
-          gMinuit->mnparm(0, "b0", vstart[0], step[0], 0, 0, ierflg);
-          gMinuit->mnparm(1, "b1", vstart[1], step[1], 0, 0, ierflg);
-          gMinuit->mnparm(2, "delta", vstart[2], step[2], -1.0 * TMath::Pi(),
-                          1.0 * TMath::Pi(), ierflg);
-          gMinuit->mnparm(3, "psi", vstart[3], step[3], -1.0 * TMath::Pi(),
-                          1.0 * TMath::Pi(), ierflg);
-
-          //  Now ready for minimization step
-          arglist[0] = 2000;
-          arglist[1] = 0.01;
-          gMinuit->mnexcm("MIGRAD", arglist, 1, ierflg);
+            double szx = 0.0;
+            double szy = 0.0;
 
-          bool ok = true;
+            for (size_t i = 0; i < number_of_datapoints; i++) {
+              const double x = hitsarray[i].x;
+              const double y = hitsarray[i].y;
+              const double z = hitsarray[i].z;
+              if (!(abs(x) < 1e-06 && abs(y) < 1e-06)) {
+                sxx += pow(x - mean_x, 2);
+                syy += pow(y - mean_y, 2);
+                szz += pow(z - mean_z, 2);
 
-          if (ierflg != 0) {
-            ok = false;
-          }
+                szx += (x - mean_x) * (z - mean_z);
+                szy += (y - mean_y) * (z - mean_z);
+              }
+            }
+            double linfit_x_a1 = szx / szz; // slope
+            double linfit_y_a1 = szy / szz; // slope
+
+            double linfit_x_a0 = mean_x - linfit_x_a1 * mean_z; // offset
+            double linfit_y_a0 = mean_y - linfit_y_a1 * mean_z; // offset
+
+            double del = -1.0 * atan(linfit_y_a1); // guess of delta
+            double ps = atan(linfit_x_a1 /
+                             sqrt(1.0 + linfit_y_a1 * linfit_y_a1)); // guess
+            // of psi
+
+            //  Set starting values and step sizes for parameters
+            Double_t vstart[4] = {linfit_x_a0, linfit_y_a0, del, ps};
+            // duble vstart[4] = {0.0, 0.0, 0.0, 0.0};
+            double step[4] = {0.01, 0.01, 0.01, 0.01};
+
+            gMinuit->mnparm(0, "b0", vstart[0], step[0], 0, 0, ierflg);
+            gMinuit->mnparm(1, "b1", vstart[1], step[1], 0, 0, ierflg);
+            gMinuit->mnparm(2, "delta", vstart[2], step[2], -1.0 * TMath::Pi(),
+                            1.0 * TMath::Pi(), ierflg);
+            gMinuit->mnparm(3, "psi", vstart[3], step[3], -1.0 * TMath::Pi(),
+                            1.0 * TMath::Pi(), ierflg);
+
+            //  Now ready for minimization step
+            arglist[0] = 2000;
+            arglist[1] = 0.01;
+            gMinuit->mnexcm("MIGRAD", arglist, 1, ierflg);
+
+            if (ierflg != 0) {
+              ok = false;
+            }
 
-          //   get results from migrad
-          double b0 = 0.0;
-          double b1 = 0.0;
-          double delta = 0.0;
-          double psi = 0.0;
-          double b0_error = 0.0;
-          double b1_error = 0.0;
-          double delta_error = 0.0;
-          double psi_error = 0.0;
-
-          gMinuit->GetParameter(0, b0, b0_error);
-          gMinuit->GetParameter(1, b1, b1_error);
-          gMinuit->GetParameter(2, delta, delta_error);
-          gMinuit->GetParameter(3, psi, psi_error);
+            //   get results from migrad
+            double delta = 0.0;
+            double psi = 0.0;
+            double b0_error = 0.0;
+            double b1_error = 0.0;
+            double delta_error = 0.0;
+            double psi_error = 0.0;
+
+            gMinuit->GetParameter(0, b0, b0_error);
+            gMinuit->GetParameter(1, b1, b1_error);
+            gMinuit->GetParameter(2, delta, delta_error);
+            gMinuit->GetParameter(3, psi, psi_error);
+
+            if (ok) {
+              c0 = TMath::Sin(psi);
+              c1 = -1.0 * TMath::Cos(psi) * TMath::Sin(delta);
+              c2 = TMath::Cos(delta) * TMath::Cos(psi);
+              // cout << " b0: " << b0 << ", b1: " << b1 << ", c2: " << c2 <<
+              // endl;
+            }
+            delete gMinuit;
+          } else {
+            // the hits have already been fitted for all track candidates
+            const linefitter &lineFit = lineFits[track];
+            ok = lineFit.ok;
+            if (ok) {
+              b0 = lineFit.b0;
+              b1 = lineFit.b1;
+              c0 = lineFit.c[0];
+              c1 = lineFit.c[1];
+              c2 = lineFit.c[2];
+              Chiquare[0] = lineFit.chi2[0];
+              Chiquare[1] = lineFit.chi2[1];
+            }
+            streamlog_out(DEBUG9) << " analytic fit: ok = " << ok
+                                    << " b0 = " << b0 << " b1 = " << b1
+                                    << std::endl;
+          }
 
-          double c0 = 1.0;
-          double c1 = 1.0;
-          double c2 = 1.0;
           if (ok) {
-            c0 = TMath::Sin(psi);
-            c1 = -1.0 * TMath::Cos(psi) * TMath::Sin(delta);
-            c2 = TMath::Cos(delta) * TMath::Cos(psi);
-            // cout << " b0: " << b0 << ", b1: " << b1 << ", c2: " << c2 <<
-            // endl;
             validminuittrack = true;
 
             for (unsigned int help = 0; help < _nPlanes; help++) {
@@ -1868,12 +1853,8 @@ void EUTelMille::processEvent(LCEvent *event) {
                 _waferResidY[help] = 0.;
                 _waferResidZ[help] = 0.;
               }
-              /*
-              }
-              */
             }
           }
-          delete gMinuit;
         } else {
           streamlog_out(DEBUG9) << " AlignMode = " << static_cast<int>(_alignMode)
                                   << " _inputMode = " << _inputMode
@@ -2518,6 +2499,71 @@ TVector3 EUTelMille::Line2Plane(int iplane, const TVector3 &lpoint,
   return point;
 }
 
+unsigned int EUTelMille::collectTrackHits(int track, hit *hits,
+                                          size_t &nMeasured, double *mean) {
+  unsigned int nHits = 0;
+  nMeasured = 0;
+  mean[0] = 0.;
+  mean[1] = 0.;
+  mean[2] = 0.;
+
+  double x0 = -1.;
+  double y0 = -1.;
+  for (unsigned int help = 0; help < _nPlanes; help++) {
+    bool excluded = false;
+    // check if actual plane is excluded
+    if (_nExcludePlanes > 0) {
+      for (int helphelp = 0; helphelp < _nExcludePlanes; helphelp++) {
+        if (help == _excludePlanes[helphelp]) {
+          excluded = true;
+        }
+      }
+    }
+    const double x = _xPos[track][help];
+    const double y = _yPos[track][help];
+    const double z = _zPos[track][help];
+    if (abs(x) > 1e-06 && abs(y) > 1e-06) {
+      x0 = _xPos[track][help];
+      y0 = _yPos[track][help];
+    }
+    const double xresid = x0 - x;
+    const double yresid = y0 - y;
+    streamlog_out(DEBUG9) << " x0 = " << x0 << " x= " << x
+                          << " ;; y0 = " << y0 << " y = " << y << std::endl;
+
+    if (xresid < _residualsXMin[help] || xresid > _residualsXMax[help]) {
+      continue;
+    }
+    if (yresid < _residualsYMin[help] || yresid > _residualsYMax[help]) {
+      continue;
+    }
+
+    if (!excluded) {
+      double sigmax = _resolutionX[help];
+      double sigmay = _resolutionY[help];
+      double sigmaz = _resolutionZ[help];
+
+      if (!(abs(x) < 1e-06 && abs(y) < 1e-06)) {
+        mean[0] += x;
+        mean[1] += y;
+        mean[2] += z;
+        nMeasured++;
+      } else {
+        sigmax = 1000000.;
+        sigmay = 1000000.;
+        sigmaz = 1000000.;
+      }
+
+      hits[nHits] = hit(x, y, z, sigmax, sigmay, sigmaz, help);
+      nHits++;
+    }
+  }
+  for (int i = 0; i < 3; i++) {
+    mean[i] /= static_cast<double>(nMeasured);
+  }
+  return nHits;
+}
+
 bool EUTelMille::hitContainsHotPixels(TrackerHitImpl *hit) {
   try {
     try {
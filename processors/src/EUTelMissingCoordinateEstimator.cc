@@ -39,14 +39,162 @@ using namespace marlin;
 using namespace gear;
 using namespace eutelescope;
 
+namespace {
+  //! A DUT hit close to the line through two reference plane hits
+  struct LineMatch {
+    size_t refHit1;
+    size_t refHit2;
+    size_t dutHit;
+
+    bool operator<(LineMatch const &other) const {
+      if (refHit1 != other.refHit1) {
+        return refHit1 < other.refHit1;
+      }
+      if (refHit2 != other.refHit2) {
+        return refHit2 < other.refHit2;
+      }
+      return dutHit < other.dutHit;
+    }
+  };
+
+  /*
+   The line that passes through 2 points can be written as L(t)= P1 + V*t
+   where V is the displacement vector and P1 is the starting point
+   so L(t) becomes: L(t) = (x1,y1,z1) + (x2-x1, y2-y1, z2-z1)*t
+   * x=x1+(x2−x1)t
+   * y=y1+(y2−y1)t
+   * z=z1+(z2−z1)t
+   */
+
+  //! t value of the Z position of the DUT hit
+  double lineParameter(double const *refHit1Pos, double const *refHit2Pos,
+                       double const *dutHitPos) {
+    // t = (z-z1)/(z2-z1)
+    return (dutHitPos[2] - refHit1Pos[2]) / (refHit2Pos[2] - refHit1Pos[2]);
+  }
+
+  //! Whether the line passes the DUT hit closer than maxResidual
+  bool isMatching(double const *refHit1Pos, double const *refHit2Pos,
+                  double const *dutHitPos, unsigned int knownHitPos,
+                  float maxResidual) {
+    double t = lineParameter(refHit1Pos, refHit2Pos, dutHitPos);
+
+    // find the known coordinate value correcponds to that z on the line
+    double knownHitPosOnLine =
+        refHit1Pos[knownHitPos] +
+        (refHit2Pos[knownHitPos] - refHit1Pos[knownHitPos]) * t;
+
+    return fabs(knownHitPosOnLine - dutHitPos[knownHitPos]) < maxResidual;
+  }
+
+  //! All the matches, ordered as by the loops over the hits
+  std::vector<LineMatch>
+  findAllMatches(std::vector<double const *> const &refHits1,
+                 std::vector<double const *> const &refHits2,
+                 std::vector<double const *> const &dutHits,
+                 unsigned int knownHitPos, float maxResidual) {
+    std::vector<LineMatch> matches;
+    for (size_t i1 = 0; i1 < refHits1.size(); i1++) {
+      for (size_t i2 = 0; i2 < refHits2.size(); i2++) {
+        for (size_t iDut = 0; iDut < dutHits.size(); iDut++) {
+          if (isMatching(refHits1[i1], refHits2[i2], dutHits[iDut],
+                         knownHitPos, maxResidual)) {
+            matches.push_back(LineMatch{i1, i2, iDut});
+          }
+        }
+      }
+    }
+    return matches;
+  }
+
+  //! Same result as findAllMatches, using the sorted second plane hits
+  /*! The residual condition |a + (k2 - a) t - d| < R, with a, k2 and d
+   *  the known coordinates of the hits, bounds k2 to an interval for
+   *  each t. All the second plane hits have z between the smallest
+   *  and largest one, so t is between the values for these two and
+   *  k2 is in the union of the intervals, whose ends are given by
+   *  the ends of the t range. The candidates in it, widened against
+   *  rounding, are then tested exactly as in findAllMatches. If the
+   *  t range is not bounded, all hits are tested.
+   */
+  std::vector<LineMatch>
+  findIndexedMatches(std::vector<double const *> const &refHits1,
+                     std::vector<double const *> const &refHits2,
+                     std::vector<double const *> const &dutHits,
+                     unsigned int knownHitPos, float maxResidual) {
+    std::vector<LineMatch> matches;
+    if (refHits2.empty()) {
+      return matches;
+    }
+
+    std::vector<size_t> order(refHits2.size());
+    for (size_t i2 = 0; i2 < order.size(); i2++) {
+      order[i2] = i2;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return refHits2[a][knownHitPos] < refHits2[b][knownHitPos];
+    });
+    std::vector<double> sortedKnown;
+    sortedKnown.reserve(order.size());
+    double zMin = refHits2[0][2];
+    double zMax = refHits2[0][2];
+    for (size_t i2 : order) {
+      sortedKnown.push_back(refHits2[i2][knownHitPos]);
+      zMin = std::min(zMin, refHits2[i2][2]);
+      zMax = std::max(zMax, refHits2[i2][2]);
+    }
+
+    for (size_t i1 = 0; i1 < refHits1.size(); i1++) {
+      double const *refHit1Pos = refHits1[i1];
+      double const a = refHit1Pos[knownHitPos];
+      for (size_t iDut = 0; iDut < dutHits.size(); iDut++) {
+        double const *dutHitPos = dutHits[iDut];
+        double const dz = dutHitPos[2] - refHit1Pos[2];
+        double const tFirst = dz / (zMin - refHit1Pos[2]);
+        double const tLast = dz / (zMax - refHit1Pos[2]);
+
+        size_t begin = 0;
+        size_t end = order.size();
+        if (dz != 0 && (zMin - refHit1Pos[2]) * (zMax - refHit1Pos[2]) > 0) {
+          double const d = dutHitPos[knownHitPos];
+          double const bounds[4] = {
+              (d - a - maxResidual) / tFirst, (d - a + maxResidual) / tFirst,
+              (d - a - maxResidual) / tLast, (d - a + maxResidual) / tLast};
+          double const low = *std::min_element(bounds, bounds + 4);
+          double const high = *std::max_element(bounds, bounds + 4);
+          double const margin =
+              1e-9 * (fabs(a) + fabs(low) + fabs(high) + maxResidual);
+          begin = std::lower_bound(sortedKnown.begin(), sortedKnown.end(),
+                                   a + low - margin) -
+                  sortedKnown.begin();
+          end = std::upper_bound(sortedKnown.begin() + begin,
+                                 sortedKnown.end(), a + high + margin) -
+                sortedKnown.begin();
+        }
+
+        for (size_t i = begin; i < end; i++) {
+          if (isMatching(refHit1Pos, refHits2[order[i]], dutHitPos,
+                         knownHitPos, maxResidual)) {
+            matches.push_back(LineMatch{i1, order[i], iDut});
+          }
+        }
+      }
+    }
+
+    std::sort(matches.begin(), matches.end());
+    return matches;
+  }
+}
+
 // definition of static members mainly used to name histograms
 
 EUTelMissingCoordinateEstimator::EUTelMissingCoordinateEstimator()
     : Processor("EUTelMissingCoordinateEstimator"), _inputHitCollectionName(),
       _outputHitCollectionName(), _referencePlanes(), _dutPlanes(),
-      _missingCoordinate(), _maxResidual(0), _iRun(0), _iEvt(0),
-      _missingHitPos(0), _knownHitPos(0), _nDutHits(0), _nDutHitsCreated(0),
-      _maxExpectedCreatedHitPerDUTHit(10), _numberOfCreatedHitPerDUTHit() {
+      _missingCoordinate(), _maxResidual(0), _indexedPairing(false), _iRun(0),
+      _iEvt(0), _missingHitPos(0), _knownHitPos(0), _nDutHits(0),
+      _nDutHitsCreated(0), _maxExpectedCreatedHitPerDUTHit(10),
+      _numberOfCreatedHitPerDUTHit() {
   // modify processor description
   _description = "EUTelMissingCoordinateEstimator As the name suggest this "
                  "processor is finds the position of the missing coordinate on "
@@ -90,6 +238,14 @@ EUTelMissingCoordinateEstimator::EUTelMissingCoordinateEstimator()
                      "hits will be considered as correlated if the residual is "
                      "smaller than MaxResidual",
       _maxResidual, float(0));
+
+  registerOptionalParameter(
+      "IndexedPairing", "Only test the reference plane hit pairs which can "
+                        "give a residual below MaxResidual, using the hits "
+                        "sorted by the known coordinate. Creates the same hits "
+                        "as the test of all combinations, but much faster at "
+                        "high occupancy",
+      _indexedPairing, false);
 }
 
 void EUTelMissingCoordinateEstimator::init() {
@@ -238,88 +394,68 @@ void EUTelMissingCoordinateEstimator::processEvent(LCEvent *event) {
     }
   }
 
-  /*
-   The line that passes through 2 points can be written as L(t)= P1 + V*t
-   where V is the displacement vector and P1 is the starting point
-   so L(t) becomes: L(t) = (x1,y1,z1) + (x2-x1, y2-y1, z2-z1)*t
-   * x=x1+(x2−x1)t
-   * y=y1+(y2−y1)t
-   * z=z1+(z2−z1)t
-   */
+  // collect the hit positions
+  auto positions = [inputHitCollection](vector<int> const &hits)
+      -> vector<double const *> {
+    vector<double const *> hitPositions;
+    hitPositions.reserve(hits.size());
+    for (int iHit : hits) {
+      hitPositions.push_back(dynamic_cast<TrackerHitImpl *>(
+                                 inputHitCollection->getElementAt(iHit))
+                                 ->getPosition());
+    }
+    return hitPositions;
+  };
+  vector<double const *> refHit1Positions = positions(referencePlaneHits1);
+  vector<double const *> refHit2Positions = positions(referencePlaneHits2);
+  vector<double const *> dutHitPositions = positions(dutPlaneHits);
+
+  vector<LineMatch> matches =
+      _indexedPairing
+          ? findIndexedMatches(refHit1Positions, refHit2Positions,
+                               dutHitPositions, _knownHitPos, _maxResidual)
+          : findAllMatches(refHit1Positions, refHit2Positions,
+                           dutHitPositions, _knownHitPos, _maxResidual);
 
   // with countCreatedDutHits vector we will count how many hits we create out
   // of one DUT hit
-  vector<unsigned int> countCreatedDutHits;
-  countCreatedDutHits.clear();
-  for (unsigned int iDutHit = 0; iDutHit < dutPlaneHits.size(); iDutHit++) {
-    countCreatedDutHits.push_back(0);
+  vector<unsigned int> countCreatedDutHits(dutPlaneHits.size(), 0);
+
+  for (LineMatch const &match : matches) {
+    const double *refHit1Pos = refHit1Positions[match.refHit1];
+    const double *refHit2Pos = refHit2Positions[match.refHit2];
+    const double *dutHitPos = dutHitPositions[match.dutHit];
+    TrackerHitImpl *dutHit = dynamic_cast<TrackerHitImpl *>(
+        inputHitCollection->getElementAt(dutPlaneHits[match.dutHit]));
+    double t = lineParameter(refHit1Pos, refHit2Pos, dutHitPos);
+
+    // first copy old DUT hit position to the new one
+    double newDutHitPos[3];
+    newDutHitPos[0] = dutHitPos[0];
+    newDutHitPos[1] = dutHitPos[1];
+    newDutHitPos[2] = dutHitPos[2];
+
+    // then replace the unknown one with the estimated one
+    double estimatedHitPos =
+        refHit1Pos[_missingHitPos] +
+        (refHit2Pos[_missingHitPos] - refHit1Pos[_missingHitPos]) * t;
+
+    newDutHitPos[_missingHitPos] = estimatedHitPos;
+
+    // now store new hit position in the TrackerHit, copy and store in the
+    // collection
+    TrackerHitImpl *newHit = cloneHit(dutHit);
+    const double *hitpos = newDutHitPos;
+    newHit->setPosition(&hitpos[0]);
+    outputHitCollection->push_back(newHit);
+
+    // count new created hits
+    _nDutHitsCreated++;
+
+    // increase the created DUT hits
+    countCreatedDutHits[match.dutHit]++;
   }
 
-  // loop over first reference plane hits
-  for (unsigned int iHitRefPlane1 = 0;
-       iHitRefPlane1 < referencePlaneHits1.size(); iHitRefPlane1++) {
-    TrackerHitImpl *refHit1 = dynamic_cast<TrackerHitImpl *>(
-        inputHitCollection->getElementAt(referencePlaneHits1[iHitRefPlane1]));
-    const double *refHit1Pos = refHit1->getPosition();
-
-    // loop over second reference plane hits
-    for (unsigned int iHitRefPlane2 = 0;
-         iHitRefPlane2 < referencePlaneHits2.size(); iHitRefPlane2++) {
-      TrackerHitImpl *refHit2 = dynamic_cast<TrackerHitImpl *>(
-          inputHitCollection->getElementAt(referencePlaneHits2[iHitRefPlane2]));
-      const double *refHit2Pos = refHit2->getPosition();
-
-      // loop over second dut plane hits
-      for (unsigned int iDutHit = 0; iDutHit < dutPlaneHits.size(); iDutHit++) {
-        TrackerHitImpl *dutHit = dynamic_cast<TrackerHitImpl *>(
-            inputHitCollection->getElementAt(dutPlaneHits[iDutHit]));
-        const double *dutHitPos = dutHit->getPosition();
-        double newDutHitPos[3];
-
-        // find t value of the Z position of DUT
-        // t = (z-z1)/(z2-z1)
-        double t =
-            (dutHitPos[2] - refHit1Pos[2]) / (refHit2Pos[2] - refHit1Pos[2]);
-
-        // find the known coordinate value correcponds to that z on the line
-        double knownHitPosOnLine =
-            refHit1Pos[_knownHitPos] +
-            (refHit2Pos[_knownHitPos] - refHit1Pos[_knownHitPos]) * t;
-
-        // if knownHitPosOnLine is close to the knownHitPos
-        if (fabs(knownHitPosOnLine - dutHitPos[_knownHitPos]) < _maxResidual) {
-          // first copy old DUT hit position to the new one
-          newDutHitPos[0] = dutHitPos[0];
-          newDutHitPos[1] = dutHitPos[1];
-          newDutHitPos[2] = dutHitPos[2];
-
-          // then replace the unknown one with the estimated one
-          double estimatedHitPos =
-              refHit1Pos[_missingHitPos] +
-              (refHit2Pos[_missingHitPos] - refHit1Pos[_missingHitPos]) * t;
-
-          newDutHitPos[_missingHitPos] = estimatedHitPos;
-
-          // now store new hit position in the TrackerHit, copy and store in the
-          // collection
-
-          TrackerHitImpl *newHit = cloneHit(dutHit);
-          const double *hitpos = newDutHitPos;
-          newHit->setPosition(&hitpos[0]);
-          outputHitCollection->push_back(newHit);
-
-          // count new created hits
-          _nDutHitsCreated++;
-
-          // increase the created DUT hits
-          countCreatedDutHits[iDutHit]++;
-        }
-
-      } // end of loop over first dut plane hits
-
-    } // end of loop over second reference plane hits
-  }   // end of loop over first reference plane hits
-
   for (unsigned int iDutHit = 0; iDutHit < dutPlaneHits.size(); iDutHit++) {
     if (_maxExpectedCreatedHitPerDUTHit < countCreatedDutHits[iDutHit]) {
       _numberOfCreatedHitPerDUTHit[_maxExpectedCreatedHitPerDUTHit]++;
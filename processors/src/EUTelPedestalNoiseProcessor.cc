@@ -12,6 +12,7 @@
 // eutelescope includes ".h"
 #include "EUTelPedestalNoiseProcessor.h"
 #include "EUTELESCOPE.h"
+#include "EUTelCommonMode.h"
 #include "EUTelEventImpl.h"
 #include "EUTelExceptions.h"
 #include "EUTelHistogramManager.h"
@@ -1220,47 +1221,26 @@ void EUTelPedestalNoiseProcessor::otherLoop(LCEvent *event) {
 
         size_t detectorOffset = (iCol == 0) ? 0 : _noOfDetectorVec.at(iCol - 1);
 
+        size_t const iSensor = iDetector + detectorOffset;
+        size_t const rowLength = _maxX[iSensor] - _minX[iSensor] + 1;
+        size_t const nRows = _maxY[iSensor] - _minY[iSensor] + 1;
+
         if (_commonModeAlgo == EUTELESCOPE::FULLFRAME) {
 
-          double pixelSum = 0.;
           double commonMode = 0.;
-          int goodPixel = 0;
-          int iPixel = 0;
-
-          // start looping on all pixels for hit rejection
-          for (int yPixel = _minY[iDetector + detectorOffset];
-               yPixel <= _maxY[iDetector + detectorOffset]; yPixel++) {
-            for (int xPixel = _minX[iDetector + detectorOffset];
-                 xPixel <= _maxX[iDetector + detectorOffset]; xPixel++) {
-              bool isHit = ((adcValues[iPixel] -
-                             _pedestal[iDetector + detectorOffset][iPixel]) >
-                            _hitRejectionCut *
-                                _noise[iDetector + detectorOffset][iPixel]);
-              bool isGood = (_status[iDetector + detectorOffset][iPixel] ==
-                             EUTELESCOPE::GOODPIXEL);
-              if (!isHit && isGood) {
-                pixelSum += adcValues[iPixel] -
-                            _pedestal[iDetector + detectorOffset][iPixel];
-                ++goodPixel;
-              } else if (isHit) {
-                ++skippedPixel;
-              }
-              ++iPixel;
-            }
-          }
-
-          if ((skippedPixel < _maxNoOfRejectedPixels) && (goodPixel != 0)) {
+          if (Utility::fullFrameCommonMode(
+                  adcValues, _pedestal[iSensor], _noise[iSensor],
+                  _status[iSensor], nRows * rowLength, _hitRejectionCut,
+                  _maxNoOfRejectedPixels, commonMode, skippedPixel)) {
 
-            commonMode = pixelSum / goodPixel;
-            commonModeCorVec.insert(commonModeCorVec.begin(), iPixel + 1,
-                                    commonMode);
+            commonModeCorVec.insert(commonModeCorVec.begin(),
+                                    nRows * rowLength + 1, commonMode);
             isEventValid = true;
 
 #if defined(USE_AIDA) || defined(MARLIN_USE_AIDA)
-            string histoname =
-                _commonModeHistoName + "_d" +
-                to_string(_orderedSensorIDVec.at(iDetector + detectorOffset)) +
-                "_l" + to_string(_iLoop);
+            string histoname = _commonModeHistoName + "_d" +
+                               to_string(_orderedSensorIDVec.at(iSensor)) +
+                               "_l" + to_string(_iLoop);
             AIDA::IHistogram1D *histo =
                 (dynamic_cast<AIDA::IHistogram1D *>(_aidaHistoMap[histoname]));
             if (histo) {
@@ -1275,68 +1255,25 @@ void EUTelPedestalNoiseProcessor::otherLoop(LCEvent *event) {
 
         } else if (_commonModeAlgo == EUTELESCOPE::ROWWISE) {
 
-          int iPixel = 0;
-          int colCounter = 0;
-          int rowLength = _maxX[iDetector + detectorOffset] -
-                          _minX[iDetector + detectorOffset] + 1;
-
-          for (int yPixel = _minY[iDetector + detectorOffset];
-               yPixel <= _maxY[iDetector + detectorOffset]; yPixel++) {
-
-            double pixelSum = 0.;
-            double commonMode = 0.;
-            int goodPixel = 0;
-            int skippedPixelPerRow = 0;
-
-            for (int xPixel = _minX[iDetector + detectorOffset];
-                 xPixel <= _maxX[iDetector + detectorOffset]; xPixel++) {
-              bool isHit = ((adcValues[iPixel] -
-                             _pedestal[iDetector + detectorOffset][iPixel]) >
-                            _hitRejectionCut *
-                                _noise[iDetector + detectorOffset][iPixel]);
-              bool isGood = (_status[iDetector + detectorOffset][iPixel] ==
-                             EUTELESCOPE::GOODPIXEL);
-              if (!isHit && isGood) {
-                pixelSum += adcValues[iPixel] -
-                            _pedestal[iDetector + detectorOffset][iPixel];
-                ++goodPixel;
-              } else if (isHit) {
-                ++skippedPixelPerRow;
-                ++skippedPixel;
-              }
-              ++iPixel;
-            }
-
-            // we are now at the end of the row, so let's calculate the
-            // common mode
-            if ((skippedPixelPerRow < _maxNoOfRejectedPixelPerRow) &&
-                (goodPixel != 0)) {
-              commonMode = pixelSum / goodPixel;
-              commonModeCorVec.insert(commonModeCorVec.begin() +
-                                          colCounter * rowLength,
-                                      rowLength, commonMode);
+          vector<double> rowCommonModes;
+          skippedRow = Utility::rowWiseCommonMode(
+              adcValues, _pedestal[iSensor], _noise[iSensor],
+              _status[iSensor], nRows, rowLength, _hitRejectionCut,
+              _maxNoOfRejectedPixelPerRow, commonModeCorVec, rowCommonModes,
+              skippedPixel);
 
 #if defined(USE_AIDA) || defined(MARLIN_USE_AIDA)
-              string histoname = _commonModeHistoName + "_d" +
-                                 to_string(_orderedSensorIDVec.at(
-                                     iDetector + detectorOffset)) +
-                                 "_l" + to_string(_iLoop);
-              AIDA::IHistogram1D *histo = (dynamic_cast<AIDA::IHistogram1D *>(
-                  _aidaHistoMap[histoname]));
-              if (histo) {
-                histo->fill(commonMode);
-              }
-#endif
-
-            } else {
-              commonModeCorVec.insert(commonModeCorVec.begin() +
-                                          colCounter * rowLength,
-                                      rowLength, 0.);
-              ++skippedRow;
+          string histoname = _commonModeHistoName + "_d" +
+                             to_string(_orderedSensorIDVec.at(iSensor)) +
+                             "_l" + to_string(_iLoop);
+          AIDA::IHistogram1D *histo =
+              (dynamic_cast<AIDA::IHistogram1D *>(_aidaHistoMap[histoname]));
+          if (histo) {
+            for (double commonMode : rowCommonModes) {
+              histo->fill(commonMode);
             }
-
-            ++colCounter;
           }
+#endif
 
           if (skippedRow < _maxNoOfSkippedRow) {
 
@@ -2468,11 +2468,12 @@ bool EUTelProcessorAnalysisPALPIDEfs::RemoveAlign(
     double &xposfit, double &yposfit) {
   // Remove the alignment in the same way it was applied by the
   // EUTelProcessorApplyAlignment.cc
-  double xPlaneCenter = geo::gGeometry().siPlaneXPosition(_dutID);
-  double yPlaneCenter = geo::gGeometry().siPlaneYPosition(_dutID);
-  double zPlaneThickness = geo::gGeometry().siPlaneZSize(_dutID);
-  double zPlaneCenter =
-      geo::gGeometry().siPlaneZPosition(_dutID) + zPlaneThickness / 2.;
+  auto planeTable = geo::gGeometry().planeTable();
+  auto const &dut = planeTable->plane(_dutID);
+  double xPlaneCenter = dut.position(0);
+  double yPlaneCenter = dut.position(1);
+  double zPlaneThickness = dut.zSize;
+  double zPlaneCenter = dut.position(2) + zPlaneThickness / 2.;
   TVector3 inputVec(fitpos[0] - xPlaneCenter, fitpos[1] - yPlaneCenter,
                     fitpos[2] - zPlaneCenter);
   // cerr << zPlaneThickness << "\t" << zPlaneCenter << endl;
@@ -64,7 +64,7 @@ EUTelProcessorApplyAlign::EUTelProcessorApplyAlign()
     : Processor("EUTelProcessorApplyAlignment"), _inputHitCollectionName("hit"),
       _alignmentCollectionName("alignment"),
       _outputHitCollectionName("correctedHit"), _correctionMethod(0), _iRun(0),
-      _iEvt(0), _lookUpTable() {
+      _iEvt(0), _lookUpTable(), _profile() {
   _description = "Apply alignment constants to hit collection";
 
   registerInputCollection(LCIO::TRACKERHIT, "InputHitCollectionName",
@@ -104,6 +104,8 @@ void EUTelProcessorApplyAlign::processRunHeader(LCRunHeader *rdr) {
 }
 
 void EUTelProcessorApplyAlign::processEvent(LCEvent *event) {
+  EUTelProcessorProfile::EventTimer eventTimer(_profile);
+
   ++_iEvt;
 
   EUTelEventImpl *evt = static_cast<EUTelEventImpl *>(event);
@@ -154,16 +156,13 @@ void EUTelProcessorApplyAlign::processEvent(LCEvent *event) {
       TrackerHitImpl *inputHit = dynamic_cast<TrackerHitImpl *>(
           inputCollectionVec->getElementAt(iHit));
       // now we have to understand which layer this hit belongs to.
-
-      UTIL::CellIDDecoder<TrackerHitImpl> hitDecoder(EUTELESCOPE::HITENCODING);
       const int sensorID = hitDecoder(inputHit)["sensorID"];
 
       // copy the input to the output, at least for the common part
       TrackerHitImpl *outputHit = new TrackerHitImpl;
       outputHit->setType(inputHit->getType());
       outputHit->rawHits() = inputHit->getRawHits();
-      FloatVec cov = inputHit->getCovMatrix();
-      outputHit->setCovMatrix(cov);
+      outputHit->setCovMatrix(inputHit->getCovMatrix());
       outputHit->setCellID0(inputHit->getCellID0());
       outputHit->setCellID1(inputHit->getCellID1());
       outputHit->setTime(inputHit->getTime());
@@ -219,6 +218,7 @@ void EUTelProcessorApplyAlign::processEvent(LCEvent *event) {
       outputCollectionVec->push_back(outputHit);
     }
     evt->addCollection(outputCollectionVec, _outputHitCollectionName);
+    _profile.count("hits", outputCollectionVec->size());
   } catch (DataNotAvailableException &e) {
     streamlog_out(WARNING2) << "No input collection " << _inputHitCollectionName
                             << " found on event " << event->getEventNumber()
@@ -228,6 +228,7 @@ void EUTelProcessorApplyAlign::processEvent(LCEvent *event) {
 
 void EUTelProcessorApplyAlign::end() {
   streamlog_out(MESSAGE2) << "Successfully finished" << endl;
+  _profile.summarize(name());
 }
 
 #endif
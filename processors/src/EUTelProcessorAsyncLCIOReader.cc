@@ -0,0 +1,78 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+// eutelescope includes ".h"
+#include "EUTelProcessorAsyncLCIOReader.h"
+#include "EUTelAsyncLCIOReader.h"
+#include "EUTelExceptions.h"
+
+// marlin includes ".h"
+#include "marlin/Exceptions.h"
+#include "marlin/ProcessorMgr.h"
+
+using namespace eutelescope;
+
+EUTelProcessorAsyncLCIOReader::EUTelProcessorAsyncLCIOReader()
+    : DataSourceProcessor("EUTelProcessorAsyncLCIOReader"), _fileNames(),
+      _readAhead(16), _nThreads(1), _nRunHeaders(0), _nEvents(0) {
+  _description = "EUTelProcessorAsyncLCIOReader reads LCIO files, "
+                 "decoding the next events on background threads.";
+
+  registerProcessorParameter("LCIOInputFiles", "Input files, in this order",
+                             _fileNames, StringVec());
+  registerOptionalParameter("ReadAhead",
+                            "Number of records decoded ahead per thread",
+                            _readAhead, 16);
+  registerOptionalParameter("DecodingThreads",
+                            "Number of files decoded at the same time",
+                            _nThreads, 1);
+}
+
+void EUTelProcessorAsyncLCIOReader::init() {
+  printParameters();
+
+  if (!EUTelAsyncLCIOReader::isSupported()) {
+    throw MissingLibraryException(this, "LCIO 2.13 or later");
+  }
+  if (_readAhead < 1) {
+    throw InvalidParameterException("ReadAhead");
+  }
+  if (_nThreads < 1) {
+    throw InvalidParameterException("DecodingThreads");
+  }
+  _nRunHeaders = 0;
+  _nEvents = 0;
+}
+
+void EUTelProcessorAsyncLCIOReader::readDataSource(int numEvents) {
+  EUTelAsyncLCIOReader reader(_fileNames, static_cast<size_t>(_readAhead),
+                              static_cast<unsigned int>(_nThreads));
+
+  // the records are owned here and deleted after the processors are
+  // done with them
+  EUTelAsyncLCIOReader::Record record;
+  while ((numEvents <= 0 || _nEvents < numEvents) &&
+         reader.readNextRecord(record)) {
+    if (record.runHeader) {
+      ++_nRunHeaders;
+      marlin::ProcessorMgr::instance()->processRunHeader(
+          record.runHeader.get());
+      record.runHeader.reset();
+    } else {
+      ++_nEvents;
+      marlin::ProcessorMgr::instance()->processEvent(record.event.get());
+      record.event.reset();
+    }
+  }
+}
+
+void EUTelProcessorAsyncLCIOReader::end() {
+  streamlog_out(MESSAGE4) << "Read " << _nRunHeaders << " run headers and "
+                          << _nEvents << " events" << std::endl;
+}
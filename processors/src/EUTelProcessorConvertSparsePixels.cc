@@ -0,0 +1,144 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+// eutelescope includes ".h"
+#include "EUTelProcessorConvertSparsePixels.h"
+#include "EUTELESCOPE.h"
+#include "EUTelExceptions.h"
+#include "EUTelRunHeaderImpl.h"
+#include "EUTelTrackerDataInterfacerImpl.h"
+#include "EUTelUtility.h"
+
+// marlin includes ".h"
+#include "marlin/Exceptions.h"
+#include "marlin/Processor.h"
+
+// lcio includes <.h>
+#include <IMPL/LCCollectionVec.h>
+#include <IMPL/TrackerDataImpl.h>
+#include <UTIL/CellIDDecoder.h>
+#include <UTIL/CellIDEncoder.h>
+
+#include <EVENT/LCCollection.h>
+#include <EVENT/LCEvent.h>
+
+// system includes
+#include <memory>
+#include <sstream>
+#include <typeinfo>
+
+using namespace eutelescope;
+
+EUTelProcessorConvertSparsePixels::EUTelProcessorConvertSparsePixels()
+    : Processor("EUTelProcessorConvertSparsePixels"), _inputCollectionName(""),
+      _outputCollectionName(""), _outputPixelType(kEUTelPackedPixel),
+      _nPixels(0), _nInputValues(0), _nOutputValues(0) {
+  _description = "EUTelProcessorConvertSparsePixels copies a sparse pixel "
+                 "collection converting the pixels to another type, by "
+                 "default the compact EUTelPackedPixel encoding.";
+
+  registerInputCollection(LCIO::TRACKERDATA, "InputCollectionName",
+                          "Input sparse pixel collection",
+                          _inputCollectionName, std::string("zsdata"));
+  registerOutputCollection(LCIO::TRACKERDATA, "OutputCollectionName",
+                           "Output collection with the converted pixels",
+                           _outputCollectionName,
+                           std::string("zsdata_packed"));
+  registerProcessorParameter(
+      "OutputPixelType",
+      "Type of the output sparse pixels (use SparsePixelType enum, 5 for "
+      "the packed encoding)",
+      _outputPixelType, static_cast<int>(kEUTelPackedPixel));
+}
+
+void EUTelProcessorConvertSparsePixels::init() {
+  printParameters();
+
+  // throws for an unknown pixel type
+  IMPL::TrackerDataImpl test;
+  try {
+    Utility::getSparseData(&test, _outputPixelType);
+  } catch (UnknownDataTypeException &e) {
+    throw InvalidParameterException("OutputPixelType");
+  }
+  _nPixels = 0;
+  _nInputValues = 0;
+  _nOutputValues = 0;
+}
+
+void EUTelProcessorConvertSparsePixels::processRunHeader(LCRunHeader *rdr) {
+  auto runHeader = std::make_unique<EUTelRunHeaderImpl>(rdr);
+  runHeader->addProcessor(type());
+}
+
+void EUTelProcessorConvertSparsePixels::processEvent(LCEvent *event) {
+
+  LCCollectionVec *inputCollection = nullptr;
+  try {
+    inputCollection = dynamic_cast<LCCollectionVec *>(
+        event->getCollection(_inputCollectionName));
+  } catch (lcio::DataNotAvailableException &e) {
+    return;
+  }
+
+  auto outputCollection =
+      std::make_unique<LCCollectionVec>(LCIO::TRACKERDATA);
+
+  // keep the encoding and all the other cell ID fields of the input
+  CellIDDecoder<TrackerDataImpl> inputDecoder(inputCollection);
+  std::string encodingString =
+      inputCollection->getParameters().getStringVal(LCIO::CellIDEncoding);
+  CellIDEncoder<TrackerDataImpl> outputEncoder(encodingString,
+                                               outputCollection.get());
+
+  for (size_t iEntry = 0; iEntry < inputCollection->size(); ++iEntry) {
+    TrackerDataImpl *inputData =
+        dynamic_cast<TrackerDataImpl *>(inputCollection->getElementAt(iEntry));
+    SparsePixelType pixelType = static_cast<SparsePixelType>(
+        static_cast<int>(inputDecoder(inputData)["sparsePixelType"]));
+
+    auto outputData = std::make_unique<TrackerDataImpl>();
+    outputEncoder.setValue(inputDecoder(inputData).getValue());
+    outputEncoder["sparsePixelType"] = _outputPixelType;
+    outputEncoder.setCellID(outputData.get());
+    outputData->setTime(inputData->getTime());
+
+    auto inputPixels = Utility::getSparseData(inputData, pixelType);
+    auto outputPixels =
+        Utility::getSparseData(outputData.get(), _outputPixelType);
+    try {
+      for (auto &pixel : *inputPixels) {
+        outputPixels->push_back(pixel.get());
+      }
+    } catch (std::bad_cast &) {
+      std::stringstream ss;
+      ss << "OutputPixelType: the pixels of sensor "
+         << static_cast<int>(inputDecoder(inputData)["sensorID"])
+         << " of type " << pixelType << " cannot be converted to "
+         << static_cast<SparsePixelType>(_outputPixelType);
+      streamlog_out(ERROR4) << ss.str() << std::endl;
+      throw InvalidParameterException(ss.str());
+    }
+
+    _nPixels += inputPixels->size();
+    _nInputValues += inputData->getChargeValues().size();
+    _nOutputValues += outputData->getChargeValues().size();
+    outputCollection->push_back(outputData.release());
+  }
+
+  event->addCollection(outputCollection.release(), _outputCollectionName);
+}
+
+void EUTelProcessorConvertSparsePixels::end() {
+  streamlog_out(MESSAGE4)
+      << "Converted " << _nPixels << " pixels to type "
+      << static_cast<SparsePixelType>(_outputPixelType) << ": "
+      << _nInputValues * sizeof(float) << " bytes of pixel data before, "
+      << _nOutputValues * sizeof(float) << " bytes after" << std::endl;
+}
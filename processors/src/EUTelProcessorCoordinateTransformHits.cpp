@@ -34,7 +34,8 @@ EUTelProcessorCoordinateTransformHits::EUTelProcessorCoordinateTransformHits():
 Processor("EUTelProcessorCoordinateTransformHits"),
 _hitCollectionNameInput(), 
 _hitCollectionNameOutput(),
-_undoAlignment(false)
+_undoAlignment(false),
+_profile()
 {
 		_description ="EUTelLocaltoGlobalHitMaker is responsible to change local coordinates to global. This is done using the EUTelGeometryClass";
 
@@ -74,6 +75,8 @@ void EUTelProcessorCoordinateTransformHits::processRunHeader(LCRunHeader* rdr)
 
 void EUTelProcessorCoordinateTransformHits::processEvent(LCEvent* event)
 {
+		EUTelProcessorProfile::EventTimer eventTimer(_profile);
+
 		//Check the event type and if it is the last event.
 		EUTelEventImpl* evt	= static_cast<EUTelEventImpl*>(event);				
 		if( evt->getEventType() == kEORE )
@@ -168,6 +171,7 @@ void EUTelProcessorCoordinateTransformHits::processEvent(LCEvent* event)
 
 			outputCollection->push_back(outputHit);
 		}
+		_profile.count("hits", inputCollection->getNumberOfElements());
 	
 		//Now push the hit for this event onto the collection
 		try
@@ -183,4 +187,5 @@ void EUTelProcessorCoordinateTransformHits::processEvent(LCEvent* event)
 void EUTelProcessorCoordinateTransformHits::end()
 {
 	streamlog_out(MESSAGE4) << "Successfully finished" << std::endl;
+	_profile.summarize(name());
 }
@@ -2,6 +2,7 @@
 #include "EUTELESCOPE.h"
 #include "EUTelGenericSparsePixel.h"
 #include "EUTelGeometryTelescopeGeoDescription.h"
+#include "EUTelPixelMaskDB.h"
 #include "EUTelTrackerDataInterfacerImpl.h"
 
 #include "marlin/Global.h"
@@ -16,7 +17,7 @@ EUTelProcessorDeadColumnFinder aEUTelProcessorDeadColumnFinder;
 
 EUTelProcessorDeadColumnFinder::EUTelProcessorDeadColumnFinder()
     : Processor("EUTelProcessorDeadColumnFinder"), _zsDataCollectionName(""),
-      _fillHistos(false), _nLayer(0), _xPixel(), _yPixel(), _nEvent(0),
+      _maskDBFile(""), _fillHistos(false), _nLayer(0), _xPixel(), _yPixel(), _nEvent(0),
       isDead(0) {
   _description = "Search of dead columns in the chip";
   registerInputCollection(LCIO::TRACKERDATA, "ZSDataCollectionName",
@@ -33,6 +34,10 @@ EUTelProcessorDeadColumnFinder::EUTelProcessorDeadColumnFinder()
                             "This is the name of the dead column collection",
                             _deadColumnCollectionName,
                             static_cast<string>("deadColumn"));
+  registerOptionalParameter("MaskDBFile",
+                            "If set, the dead columns are also written into "
+                            "this compact mask file (see EUTelPixelMaskDB)",
+                            _maskDBFile, static_cast<string>(""));
   _isFirstEvent = true;
 }
 
@@ -201,4 +206,28 @@ for (int x = 0; x < _xPixel[iLayer]; x++) {
   lcWriter->writeEvent(event);
   delete event;
   lcWriter->close();
+
+  if (!_maskDBFile.empty()) {
+    EUTelPixelMaskDB maskDB;
+    for (int iLayer = 0; iLayer < _nLayer; iLayer++) {
+      EUTelPixelMask &mask =
+          maskDB.addSensor(iLayer, 0, 0, _xPixel[iLayer], _yPixel[iLayer]);
+      for (int x = 0; x < _xPixel[iLayer]; x++) {
+        if (isDead[iLayer][x]) {
+          for (int y = 0; y < _yPixel[iLayer]; y++) {
+            mask.mask(x, y);
+          }
+        }
+      }
+    }
+    maskDB.setProvenance("producer", name());
+    maskDB.setProvenance("events", to_string(_nEvent));
+    maskDB.setProvenance("lcioFile", _deadColumnFile);
+    maskDB.setProvenance("date", LCTime().getDateString());
+    try {
+      maskDB.write(_maskDBFile);
+    } catch (IOException &e) {
+      streamlog_out(ERROR4) << e.what() << endl;
+    }
+  }
 }
@@ -23,6 +23,7 @@
 // eutel data specific
 #include "EUTelGenericSparseClusterImpl.h"
 #include "EUTelGeometricClusterImpl.h"
+#include "EUTelNeighbourClustering.h"
 #include "EUTelTrackerDataInterfacerImpl.h"
 
 // eutel geometry
@@ -183,6 +184,8 @@ void EUTelProcessorGeometricClustering::readCollections(LCEvent *event) {
 }
 
 void EUTelProcessorGeometricClustering::processEvent(LCEvent *event) {
+  EUTelProcessorProfile::EventTimer eventTimer(_profile);
+
   // increment event counter
   ++_iEvt;
 
@@ -236,7 +239,9 @@ void EUTelProcessorGeometricClustering::processEvent(LCEvent *event) {
   }  
 
   // HERE WE ACTUALLY CALL THE CLUSTERING ROUTINE:
+  EUTelProcessorProfile::PhaseTimer clusteringTimer(_profile, "clustering");
   geometricClustering(evt, pulseCollection);
+  clusteringTimer.stop();
 
   // if the pulseCollection is not empty add it to the event
   if (!pulseCollectionExists &&
@@ -318,6 +323,7 @@ void EUTelProcessorGeometricClustering::geometricClustering(
 
     // now prepare the EUTelescope interface to sparsified data.
     auto sparseData = Utility::getSparseData(zsData, type);
+    _profile.count("pixels", sparseData->size());
 
     streamlog_out(DEBUG2) << "Processing sparse data on detector " << sensorID
                           << " with " << sparseData->size() << " pixels "
@@ -332,6 +338,20 @@ void EUTelProcessorGeometricClustering::geometricClustering(
       EUTelGeometricPixel hitPixel(
           dynamic_cast<EUTelGenericSparsePixel const &>(pixel));
 
+      // Descriptions with an analytic pixel layout give position and size
+      // directly, no need to navigate TGeo
+      double posX, posY, pitchX, pitchY;
+      if (geoDescr->getPixelCenter(hitPixel.getXCoord(), hitPixel.getYCoord(),
+                                   posX, posY, pitchX, pitchY)) {
+        // the boundaries are the half sizes, as TGeoBBox::GetDX()
+        hitPixel.setBoundaryX(pitchX / 2.);
+        hitPixel.setBoundaryY(pitchY / 2.);
+        hitPixel.setPosX(posX);
+        hitPixel.setPosY(posY);
+        hitPixelVec.push_back(hitPixel);
+        continue;
+      }
+
       // And get the path to the given pixel
       std::string pixelPath =
           geoDescr->getPixName(hitPixel.getXCoord(), hitPixel.getYCoord());
@@ -381,9 +401,11 @@ void EUTelProcessorGeometricClustering::geometricClustering(
       hitPixelVec.push_back(hitPixel);
     }
 
-    std::vector<EUTelGeometricPixel> newlyAdded;
     // We now cluster those hits together
-    while (!hitPixelVec.empty()) {
+    auto clusters = Utility::findNeighbourClusters(
+        std::move(hitPixelVec), Utility::GeometricPixelNeighbours{_cutT});
+
+    for (auto const &clusterPixels : clusters) {
       // prepare a TrackerData to store the cluster candidate
       std::unique_ptr<TrackerDataImpl> zsCluster =
           std::make_unique<TrackerDataImpl>();
@@ -392,68 +414,8 @@ void EUTelProcessorGeometricClustering::geometricClustering(
           sparseCluster = std::make_unique<
               EUTelGenericSparseClusterImpl<EUTelGeometricPixel>>(
               zsCluster.get());
-
-      // First we need to take any pixel, so let's take the first one
-      // Add it to the cluster as well as the newly added pixels
-      newlyAdded.push_back(hitPixelVec.front());
-      sparseCluster->push_back(hitPixelVec.front());
-      // And remove it from the original collection
-      hitPixelVec.erase(hitPixelVec.begin());
-
-      // Now process all newly added pixels, initially this is the just
-      // previously added one
-      // but in the process of neighbour finding we continue to add new pixels
-      while (!newlyAdded.empty()) {
-        bool newlyDone = true;
-        float x1, x2, y1, y2, dX, dY, cx1, cy1, cx2, cy2, cutX, cutY, t1, t2,
-            dT;
-
-        // check against all pixels in the hitPixelVec
-        for (std::vector<EUTelGeometricPixel>::iterator hitVec =
-                 hitPixelVec.begin();
-             hitVec != hitPixelVec.end(); ++hitVec) {
-          // get the relevant infos from the newly added pixel
-          x1 = newlyAdded.front().getPosX();
-          y1 = newlyAdded.front().getPosY();
-          t1 = newlyAdded.front().getTime();
-          cx1 = newlyAdded.front().getBoundaryX();
-          cy1 = newlyAdded.front().getBoundaryY();
-
-          // and the pixel we test against
-          x2 = hitVec->getPosX();
-          y2 = hitVec->getPosY();
-          t2 = hitVec->getTime();
-          cx2 = hitVec->getBoundaryX();
-          cy2 = hitVec->getBoundaryY();
-
-          dX = x1 - x2;
-          dY = y1 - y2;
-          dT = t1 - t2;
-          cutX = (cx1 + cx2) *
-                 1.01; // this additional 1% is accounting for precision
-          cutY = (cy1 + cy2) * 1.01; // uncertainty with the geo framework
-
-          // if they pass the spatial and temporal cuts, we add them
-          if ((dX * dX <= cutX * cutX) && (dY * dY <= cutY * cutY) &&
-              (dT * dT <= _cutT * _cutT)) {
-            // add them to the cluster as well as to the newly added ones
-            newlyAdded.push_back(*hitVec);
-            sparseCluster->push_back(*hitVec);
-            // and remove it from the original collection
-            hitPixelVec.erase(hitVec);
-            // for the pixel we test there might be other neighbours, we still
-            // have to check
-            newlyDone = false;
-            break;
-          }
-        }
-
-        // if no neighbours are found, we can delete the pixel from the newly
-        // added
-        // we tested against _ALL_ non cluster pixels, there are no other pixels
-        // which could be neighbours
-        if (newlyDone)
-          newlyAdded.erase(newlyAdded.begin());
+      for (auto const &pixel : clusterPixels) {
+        sparseCluster->push_back(pixel);
       }
 
       // Now we need to process the found cluster
@@ -489,6 +451,7 @@ void EUTelProcessorGeometricClustering::geometricClustering(
 
         // last but not least increment the totClusterMap
         _totClusterMap[sensorID] += 1;
+        _profile.count("clusters");
 
       } // cluster processing if
 
@@ -519,6 +482,8 @@ void EUTelProcessorGeometricClustering::check(LCEvent * /* evt */) {
 void EUTelProcessorGeometricClustering::end() {
 
   streamlog_out(MESSAGE4) << "Successfully finished" << std::endl;
+  _eventArena.summarize(name());
+  _profile.summarize(name());
 
   std::map<int, int>::iterator iter = _totClusterMap.begin();
   while (iter != _totClusterMap.end()) {
@@ -544,6 +509,9 @@ void EUTelProcessorGeometricClustering::fillHistos(LCEvent *evt) {
     // correct, so no harm to continue...
   }
 
+  // the cluster objects of the previous event are released here
+  _eventArena.reset();
+
   try {
     LCCollectionVec *_pulseCollectionVec = dynamic_cast<LCCollectionVec *>(
         evt->getCollection(_pulseCollectionName));
@@ -563,7 +531,7 @@ void EUTelProcessorGeometricClustering::fillHistos(LCEvent *evt) {
       EUTelGeometricClusterImpl *cluster;
 
       if (type == kEUTelGenericSparseClusterImpl) {
-        cluster = new EUTelGeometricClusterImpl(
+        cluster = _eventArena.create<EUTelGeometricClusterImpl>(
             static_cast<TrackerDataImpl *>(pulse->getTrackerData()));
       } else {
         streamlog_out(ERROR4) << "Unknown cluster type. Sorry for quitting"
@@ -606,8 +574,6 @@ void EUTelProcessorGeometricClustering::fillHistos(LCEvent *evt) {
           ->fill(static_cast<int>(cluster->size()));
       (dynamic_cast<AIDA::IHistogram1D *>(_clusterSignalHistos[detectorID]))
           ->fill(cluster->getTotalCharge());
-
-      delete cluster;
     }
 
     // fill the event multiplicity here
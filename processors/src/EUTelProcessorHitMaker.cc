@@ -28,6 +28,7 @@
 #include "EUTelSparseClusterImpl.h"
 
 #include "EUTelAlignmentConstant.h"
+#include "EUTelEtaFunctionImpl.h"
 #include "EUTelExceptions.h"
 
 // marlin includes ".h"
@@ -52,6 +53,8 @@
 
 // system includes <>
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstdio>
 #include <iomanip>
 #include <iostream>
@@ -76,9 +79,11 @@ std::string EUTelProcessorHitMaker::_clusterCenterYHistoName = "ClusterCenterY";
 
 EUTelProcessorHitMaker::EUTelProcessorHitMaker()
     : Processor("EUTelProcessorHitMaker"), _pulseCollectionName(),
-      _hitCollectionName(), _wantLocalCoordinates(false), _iRun(0), _iEvt(0),
+      _hitCollectionName(), _wantLocalCoordinates(false), _etaSwitch(false),
+      _etaCollectionNames(), _iRun(0), _iEvt(0),
       _conversionIdMap(), _alreadyBookedSensorID(), _aidaHistoMap(),
-      _histogramSwitch(true), _orderedSensorIDVec() {
+      _histogramSwitch(true), _orderedSensorIDVec(), _collectionCache(),
+      _profile(), _planeTable(), _etaTables() {
   // modify processor description
   _description = "EUTelProcessorHitMaker is responsible to translate cluster "
                  "centers from the local frame of reference \nto the external "
@@ -96,6 +101,19 @@ EUTelProcessorHitMaker::EUTelProcessorHitMaker()
       "EnableLocalCoordidates",
       "Hit coordinates are calculated in local reference frame of sensor",
       _wantLocalCoordinates, static_cast<bool>(false));
+
+  registerOptionalParameter("EtaSwitch",
+                            "Apply the eta correction to the cluster centers "
+                            "of generic sparse clusters",
+                            _etaSwitch, static_cast<bool>(false));
+
+  std::vector<std::string> etaNames;
+  etaNames.push_back("xEtaCondition");
+  etaNames.push_back("yEtaCondition");
+  registerOptionalParameter("EtaCollectionName",
+                            "The name of the eta collections along x and y, "
+                            "loaded as condition data",
+                            _etaCollectionNames, etaNames);
 }
 
 void EUTelProcessorHitMaker::init() {
@@ -128,11 +146,15 @@ void EUTelProcessorHitMaker::processRunHeader(LCRunHeader *rdr) {
         << "The geometry ID in the run header is set to zero." << endl
         << "This may mean that the GeoID parameter was not set" << endl;
 
+  // take the geometry snapshot for this run
+  _planeTable = geo::gGeometry().planeTable();
+
   // increment the run counter
   ++_iRun;
 }
 
 void EUTelProcessorHitMaker::processEvent(LCEvent *event) {
+  EUTelProcessorProfile::EventTimer eventTimer(_profile);
 
   ++_iEvt;
 
@@ -149,23 +171,20 @@ void EUTelProcessorHitMaker::processEvent(LCEvent *event) {
                             << endl;
   }
 
-  LCCollectionVec *pulseCollection = 0;
-  LCCollectionVec *hitCollection = 0;
-
-  try {
-    pulseCollection = static_cast<LCCollectionVec *>(
-        event->getCollection(_pulseCollectionName));
-  } catch (DataNotAvailableException &e) {
+  LCCollectionVec *pulseCollection =
+      _collectionCache.get(event, _pulseCollectionName);
+  if (!pulseCollection) {
     streamlog_out(MESSAGE2) << "No input collection " << _pulseCollectionName
                             << " found on event " << event->getEventNumber()
                             << " in run " << event->getRunNumber() << endl;
     return;
   }
+  _profile.count("clusters", pulseCollection->getNumberOfElements());
 
-  try {
-    hitCollection = static_cast<LCCollectionVec *>(
-        event->getCollection(_hitCollectionName));
-  } catch (...) {
+  LCCollectionVec *hitCollection =
+      _collectionCache.get(event, _hitCollectionName);
+  bool hitCollectionExists = (hitCollection != nullptr);
+  if (!hitCollectionExists) {
     hitCollection = new LCCollectionVec(LCIO::TRACKERHIT);
   }
 
@@ -178,6 +197,20 @@ void EUTelProcessorHitMaker::processEvent(LCEvent *event) {
 
   int oldDetectorID = -100;
 
+  if (!_planeTable) {
+    _planeTable = geo::gGeometry().planeTable();
+  }
+  geo::PlaneConstants const *plane = nullptr;
+
+  // with the eta correction the cluster centers are computed upfront,
+  // so that all clusters of a sensor are corrected in one go
+  std::vector<std::array<double, 2>> etaCoG;
+  std::vector<bool> etaCoGValid;
+  if (_etaSwitch && (!_etaTables.empty() || loadEtaTables(event))) {
+    EUTelProcessorProfile::PhaseTimer etaTimer(_profile, "eta");
+    etaCorrectedCoG(pulseCollection, etaCoG, etaCoGValid);
+  }
+
   double xSize = 0., ySize = 0.;
   double resolutionX = 0., resolutionY = 0.;
   double xPitch = 0., yPitch = 0.;
@@ -209,14 +242,16 @@ void EUTelProcessorHitMaker::processEvent(LCEvent *event) {
         bookHistos(sensorID);
       }
 
-      resolutionX = geo::gGeometry().siPlaneXResolution(sensorID); // mm
-      resolutionY = geo::gGeometry().siPlaneYResolution(sensorID); // mm
+      plane = &_planeTable->plane(sensorID);
 
-      xSize = geo::gGeometry().siPlaneXSize(sensorID); // mm
-      ySize = geo::gGeometry().siPlaneYSize(sensorID); // mm
+      resolutionX = plane->xResolution; // mm
+      resolutionY = plane->yResolution; // mm
 
-      xPitch = geo::gGeometry().siPlaneXPitch(sensorID); // mm
-      yPitch = geo::gGeometry().siPlaneYPitch(sensorID); // mm
+      xSize = plane->xSize; // mm
+      ySize = plane->ySize; // mm
+
+      xPitch = plane->xPitch; // mm
+      yPitch = plane->yPitch; // mm
     }
 
     // LOCAL coordinate system !!!!!!
@@ -229,9 +264,14 @@ void EUTelProcessorHitMaker::processEvent(LCEvent *event) {
       // in the case of genericSparseCluster we need to know the underlying
       // pixel type
       if (pixelType == kEUTelGenericSparsePixel) {
-        EUTelGenericSparseClusterImpl<EUTelGenericSparsePixel> cluster(
-            trackerData);
-        cluster.getCenterOfGravity(xPos, yPos);
+        if (!etaCoGValid.empty() && etaCoGValid[iCluster]) {
+          xPos = etaCoG[iCluster][0];
+          yPos = etaCoG[iCluster][1];
+        } else {
+          EUTelGenericSparseClusterImpl<EUTelGenericSparsePixel> cluster(
+              trackerData);
+          cluster.getCenterOfGravity(xPos, yPos);
+        }
 
         // For non geometric clusters, getCenterOfGravity will return it in
         // pixel indices space, i.e.
@@ -360,8 +400,10 @@ void EUTelProcessorHitMaker::processEvent(LCEvent *event) {
       // NOW !!
       // GLOBAL coordinate system !!!
 
-      const double localPos[3] = {telPos[0], telPos[1], telPos[2]};
-      geo::gGeometry().local2Master(sensorID, localPos, telPos);
+      std::array<double, 3> const localPos{{telPos[0], telPos[1], telPos[2]}};
+      std::array<double, 3> globalPos;
+      geo::PlaneTable::local2Master(*plane, localPos, globalPos);
+      std::copy(globalPos.begin(), globalPos.end(), telPos);
     }
 
 #if defined(USE_AIDA) || defined(MARLIN_USE_AIDA)
@@ -413,20 +455,119 @@ void EUTelProcessorHitMaker::processEvent(LCEvent *event) {
 
     // add the new hit to the hit collection
     hitCollection->push_back(hit);
+    _profile.count("hits");
   }
 
-  try {
-    event->getCollection(_hitCollectionName);
-  } catch (...) {
-    event->addCollection(hitCollection, _hitCollectionName);
+  if (!hitCollectionExists) {
+    _collectionCache.add(event, hitCollection, _hitCollectionName);
   }
 
   if (isFirstEvent())
     _isFirstEvent = false;
 }
 
+bool EUTelProcessorHitMaker::loadEtaTables(LCEvent *event) {
+  if (_etaCollectionNames.size() != 2) {
+    streamlog_out(ERROR4) << "EtaCollectionName needs exactly two entries, "
+                             "switching off the eta correction"
+                          << endl;
+    _etaSwitch = false;
+    return false;
+  }
+
+  for (size_t iAxis = 0; iAxis < 2; ++iAxis) {
+    LCCollectionVec *etaCollection =
+        _collectionCache.get(event, _etaCollectionNames[iAxis]);
+    if (!etaCollection) {
+      streamlog_out(ERROR4) << "Eta collection " << _etaCollectionNames[iAxis]
+                            << " not available, switching off the eta "
+                               "correction"
+                            << endl;
+      _etaTables.clear();
+      _etaSwitch = false;
+      return false;
+    }
+    for (int iEta = 0; iEta < etaCollection->getNumberOfElements(); ++iEta) {
+      EUTelEtaFunctionImpl *etaFunction = static_cast<EUTelEtaFunctionImpl *>(
+          etaCollection->getElementAt(iEta));
+      _etaTables[etaFunction->getSensorID()][iAxis] =
+          EUTelEtaTable(*etaFunction);
+    }
+  }
+  streamlog_out(MESSAGE4) << "Loaded eta tables for " << _etaTables.size()
+                          << " sensor(s)" << endl;
+  return true;
+}
+
+void EUTelProcessorHitMaker::etaCorrectedCoG(
+    LCCollectionVec *pulseCollection, std::vector<std::array<double, 2>> &cog,
+    std::vector<bool> &valid) {
+
+  int const nClusters = pulseCollection->getNumberOfElements();
+  cog.assign(nClusters, std::array<double, 2>{{0., 0.}});
+  valid.assign(nClusters, false);
+
+  CellIDDecoder<TrackerPulseImpl> clusterCellDecoder(pulseCollection);
+  CellIDDecoder<TrackerDataImpl> cellDecoder(
+      EUTELESCOPE::ZSDATADEFAULTENCODING);
+
+  // cluster indices per sensor
+  std::map<int, std::vector<int>> sensorClusters;
+  for (int iCluster = 0; iCluster < nClusters; iCluster++) {
+    TrackerPulseImpl *pulse = dynamic_cast<TrackerPulseImpl *>(
+        pulseCollection->getElementAt(iCluster));
+    TrackerDataImpl *trackerData =
+        dynamic_cast<TrackerDataImpl *>(pulse->getTrackerData());
+
+    ClusterType clusterType = static_cast<ClusterType>(
+        static_cast<int>(clusterCellDecoder(pulse)["type"]));
+    SparsePixelType pixelType = static_cast<SparsePixelType>(
+        static_cast<int>(cellDecoder(trackerData)["sparsePixelType"]));
+    if (clusterType != kEUTelGenericSparseClusterImpl ||
+        pixelType != kEUTelGenericSparsePixel) {
+      continue;
+    }
+
+    float xPos = 0, yPos = 0;
+    EUTelGenericSparseClusterImpl<EUTelGenericSparsePixel> cluster(
+        trackerData);
+    cluster.getCenterOfGravity(xPos, yPos);
+    cog[iCluster] = {{xPos, yPos}};
+    valid[iCluster] = true;
+    int sensorID = clusterCellDecoder(pulse)["sensorID"];
+    sensorClusters[sensorID].push_back(iCluster);
+  }
+
+  // the eta function maps the CoG shift with respect to the closest
+  // pixel center onto the corrected shift
+  std::vector<double> shifts;
+  std::vector<double> pixels;
+  for (auto const &entry : sensorClusters) {
+    auto etaIt = _etaTables.find(entry.first);
+    if (etaIt == _etaTables.end()) {
+      continue;
+    }
+    auto const &indices = entry.second;
+    for (size_t iAxis = 0; iAxis < 2; ++iAxis) {
+      shifts.clear();
+      pixels.clear();
+      for (int index : indices) {
+        double pixel = std::floor(cog[index][iAxis] + 0.5);
+        pixels.push_back(pixel);
+        shifts.push_back(cog[index][iAxis] - pixel);
+      }
+      etaIt->second[iAxis].getEtaFromCoG(shifts);
+      for (size_t i = 0; i < indices.size(); ++i) {
+        cog[indices[i]][iAxis] = pixels[i] + shifts[i];
+      }
+    }
+  }
+}
+
 void EUTelProcessorHitMaker::end() {
   streamlog_out(MESSAGE4) << "Successfully finished" << endl;
+  _collectionCache.printSummary(name());
+  _profile.summarize(name());
 }
 
 void EUTelProcessorHitMaker::bookHistos(int sensorID) {
@@ -444,15 +585,16 @@ void EUTelProcessorHitMaker::bookHistos(int sensorID) {
   // want this to look for hits in the -x/y direction, as well at the + axis.
   // We add and subtract a constant so we know for sure we can see all hits on
   // the histogram.
+  geo::PlaneConstants const &plane = _planeTable->plane(sensorID);
   double constant = 5;
-  double xMin = -(geo::gGeometry().siPlaneXSize(sensorID) / 2) - constant;
-  double xMax = (geo::gGeometry().siPlaneXSize(sensorID) / 2) + constant;
+  double xMin = -(plane.xSize / 2) - constant;
+  double xMax = (plane.xSize / 2) + constant;
 
-  double yMin = -(geo::gGeometry().siPlaneYSize(sensorID) / 2) - constant;
-  double yMax = (geo::gGeometry().siPlaneYSize(sensorID) / 2) + constant;
+  double yMin = -(plane.ySize / 2) - constant;
+  double yMax = (plane.ySize / 2) + constant;
 
-  int xNBin = geo::gGeometry().siPlaneXNpixels(sensorID);
-  int yNBin = geo::gGeometry().siPlaneYNpixels(sensorID);
+  int xNBin = plane.xNpixels;
+  int yNBin = plane.yNpixels;
 
   AIDA::IHistogram2D *hitHistoLocal =
       AIDAProcessor::histogramFactory(this)->createHistogram2D(
@@ -474,12 +616,12 @@ void EUTelProcessorHitMaker::bookHistos(int sensorID) {
   // means that the sensor is wrong
   // by all its size.
   double safetyFactor = 1.2;
-  double xPosition = geo::gGeometry().siPlaneXPosition(sensorID);
-  double yPosition = geo::gGeometry().siPlaneYPosition(sensorID);
-  double xSize = geo::gGeometry().siPlaneXSize(sensorID);
-  double ySize = geo::gGeometry().siPlaneYSize(sensorID);
-  int xBin = geo::gGeometry().siPlaneXNpixels(sensorID);
-  int yBin = geo::gGeometry().siPlaneYNpixels(sensorID);
+  double xPosition = plane.position(0);
+  double yPosition = plane.position(1);
+  double xSize = plane.xSize;
+  double ySize = plane.ySize;
+  int xBin = plane.xNpixels;
+  int yBin = plane.yNpixels;
 
   xMin = safetyFactor * (xPosition - (0.5 * xSize));
   xMax = safetyFactor * (xPosition + (0.5 * xSize));
@@ -10,6 +10,7 @@
 // eutelescope includes ".h"
 #include "EUTelProcessorNoisyPixelFinder.h"
 #include "EUTELESCOPE.h"
+#include "EUTelPixelMaskDB.h"
 #include "EUTelRunHeaderImpl.h"
 #include "EUTelTrackerDataInterfacerImpl.h"
 
@@ -63,8 +64,8 @@ namespace eutelescope {
   EUTelProcessorNoisyPixelFinder::EUTelProcessorNoisyPixelFinder()
       : Processor("EUTelProcessorNoisyPixelFinder"), _zsDataCollectionName(""),
         _noisyPixelCollectionName(""), _excludedPlanes(), _noOfEvents(0),
-        _maxAllowedFiringFreq(0.0), _iRun(0), _iEvt(0), _sensorIDVec(),
-        _noisyPixelDBFile(""), _finished(false) {
+        _maxAllowedFiringFreq(0.0), _iRun(0), _iEvt(0), _runNumber(0), _sensorIDVec(),
+        _noisyPixelDBFile(""), _maskDBFile(""), _finished(false) {
     // processor description
     _description = "EUTelProcessorNoisyPixelFinder computes the firing "
                    "frequency of pixels and applies a cut on this value to "
@@ -105,6 +106,11 @@ namespace eutelescope {
                               _noisyPixelCollectionName,
                               std::string("noisyPixel"));
 
+    registerOptionalParameter("MaskDBFile",
+                              "If set, the noisy pixels are also written into "
+                              "this compact mask file (see EUTelPixelMaskDB)",
+                              _maskDBFile, std::string(""));
+
   registerOptionalParameter("NoisyPixelNoHistogramUpperLimit",
                               "Upper limit for noisy pixel count versus noise cut histogram",
                               _noisyPixelVsCutHistUpperLimit, static_cast<double>(0.0006));
@@ -187,9 +193,10 @@ namespace eutelescope {
     initializeHitMaps();
   }
 
-  void EUTelProcessorNoisyPixelFinder::processRunHeader(LCRunHeader * /*rdr*/) {
+  void EUTelProcessorNoisyPixelFinder::processRunHeader(LCRunHeader *rdr) {
     // increment the run counter
     ++_iRun;
+    _runNumber = rdr->getRunNumber();
     // reset the event counter
     _iEvt = 0;
   }
@@ -479,6 +486,33 @@ namespace eutelescope {
     }
     lcWriter->writeEvent(event.get());
     lcWriter->close();
+
+    if (!_maskDBFile.empty()) {
+      EUTelPixelMaskDB maskDB;
+      for (auto &mapEntry : _noisyPixelMap) {
+        sensor const &thisSensor = _sensorMap[mapEntry.first];
+        EUTelPixelMask &mask =
+            maskDB.addSensor(mapEntry.first, thisSensor.offX, thisSensor.offY,
+                             thisSensor.sizeX, thisSensor.sizeY);
+        for (auto &pixel : mapEntry.second) {
+          mask.mask(pixel.getXCoord(), pixel.getYCoord());
+        }
+      }
+      maskDB.setProvenance("producer", name());
+      maskDB.setProvenance("run", std::to_string(_runNumber));
+      maskDB.setProvenance("events", std::to_string(_noOfEvents));
+      maskDB.setProvenance("maxAllowedFiringFreq",
+                           std::to_string(_maxAllowedFiringFreq));
+      maskDB.setProvenance("lcioFile", _noisyPixelDBFile);
+      maskDB.setProvenance("date", LCTime().getDateString());
+      try {
+        maskDB.write(_maskDBFile);
+        streamlog_out(MESSAGE5) << "Noisy pixels also written into "
+                                << _maskDBFile << std::endl;
+      } catch (IOException &e) {
+        streamlog_out(ERROR4) << e.what() << std::endl;
+      }
+    }
   }
 
 #if defined(USE_AIDA) || defined(MARLIN_USE_AIDA)
@@ -40,7 +40,8 @@ namespace eutelescope {
 
   EUTelProcessorNoisyPixelRemover::EUTelProcessorNoisyPixelRemover()
       : Processor("EUTelProcessorNoisyPixelRemover"), _inputCollectionName(""),
-        _outputCollectionName(""), _noisyPixelCollectionName("") {
+        _outputCollectionName(""), _noisyPixelCollectionName(""),
+        _maskDBFile(""), _maskDB() {
     _description = "EUTelProcessorNoisyPixelRemover removes noisy pixels "
                    "(TrackerData) from a collection. This processor requires a "
                    "noisy pixel collection.";
@@ -56,12 +57,26 @@ namespace eutelescope {
     registerProcessorParameter(
         "NoisyPixelCollectionName", "Name of the noisy pixel collection.",
         _noisyPixelCollectionName, std::string("noisypixel"));
+    registerOptionalParameter(
+        "MaskDBFile",
+        "Compact mask file (see EUTelPixelMaskDB) to be used instead of the "
+        "noisy pixel collection. Leave empty to use the collection.",
+        _maskDBFile, std::string(""));
   }
 
   void EUTelProcessorNoisyPixelRemover::init() {
     // this method is called only once even when the rewind is active
     // usually a good idea to
     printParameters();
+
+    if (!_maskDBFile.empty()) {
+      _maskDB = EUTelPixelMaskDB::read(_maskDBFile);
+      for (auto const &entry : _maskDB.getMasks()) {
+        streamlog_out(MESSAGE4) << "Read in " << entry.second.count()
+                                << " noisy pixels on plane " << entry.first
+                                << " from " << _maskDBFile << std::endl;
+      }
+    }
   }
 
   void EUTelProcessorNoisyPixelRemover::processRunHeader(LCRunHeader *rdr) {
@@ -71,7 +86,7 @@ namespace eutelescope {
 
   void EUTelProcessorNoisyPixelRemover::processEvent(LCEvent *event) {
 
-    if (_firstEvent) {
+    if (_firstEvent && _maskDBFile.empty()) {
       // The noisy pixel collection stores all thot pixels in event #1
       // Thus we have to read it in in that case
       _noisyPixelMap =
@@ -134,8 +149,9 @@ namespace eutelescope {
       trackerData->setCellID1(inputData->getCellID1());
       trackerData->setTime(inputData->getTime());
 
-      // get the noise vector for the given plane
+      // get the noise vector or mask for the given plane
       std::vector<int> *noiseVector = &(_noisyPixelMap[sensorID]);
+      EUTelPixelMask const *mask = _maskDB.getMask(sensorID);
 
       // interface to sparsified data
       auto sparseDataInterface = Utility::getSparseData(inputData, pixelType);
@@ -144,9 +160,12 @@ namespace eutelescope {
 
       for (auto &pixelRef : *sparseDataInterface) {
         auto &pixel = pixelRef.get();
-        if (!std::binary_search(
-                noiseVector->begin(), noiseVector->end(),
-                Utility::cantorEncode(pixel.getXCoord(), pixel.getYCoord()))) {
+        bool isNoisy =
+            mask ? mask->isMasked(pixel.getXCoord(), pixel.getYCoord())
+                 : std::binary_search(noiseVector->begin(), noiseVector->end(),
+                                      Utility::cantorEncode(pixel.getXCoord(),
+                                                            pixel.getYCoord()));
+        if (!isNoisy) {
           sparseOutputData->push_back(pixel);
         }
       }
@@ -20,6 +20,7 @@
 #include "EUTelRunHeaderImpl.h"
 
 // eutel data specific
+#include "EUTelNeighbourClustering.h"
 #include "EUTelSparseClusterImpl.h"
 #include "EUTelTrackerDataInterfacerImpl.h"
 
@@ -52,7 +53,9 @@
 #endif
 
 // system includes
+#include <algorithm>
 #include <cmath>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -66,11 +69,12 @@ EUTelProcessorSparseClustering::EUTelProcessorSparseClustering()
     : Processor("EUTelProcessorSparseClustering"), _zsDataCollectionName(""),
       _pulseCollectionName(""), _initialPulseCollectionSize(0), _iRun(0),
       _iEvt(0), _fillHistos(false), _histoInfoFileName(""), _cutT(0.0),
-      _totClusterMap(), _noOfDetector(0), _ExcludedPlanes(),
+      _timeWindowClustering(false), _totClusterMap(), _noOfDetector(0), _ExcludedPlanes(),
       _clusterSignalHistos(), _clusterSizeXHistos(), _clusterSizeYHistos(),
       _seedSignalHistos(), _hitMapHistos(), _eventMultiplicityHistos(),
       _isGeometryReady(false), _sensorIDVec(), _zsInputDataCollectionVec(NULL),
-      _pulseCollectionVec(NULL), _sparseMinDistanceSquared(2) {
+      _pulseCollectionVec(NULL), _sparseMinDistanceSquared(2),
+      _collectionCache(), _profile() {
 
   // modify processor description
   _description = "EUTelProcessorSparseClustering is looking for clusters into "
@@ -90,6 +94,12 @@ EUTelProcessorSparseClustering::EUTelProcessorSparseClustering()
       "TCut", "Time cut in time units of your sensor", _cutT,
       static_cast<float>(std::numeric_limits<float>::max()));
 
+  registerProcessorParameter(
+      "TimeWindowClustering",
+      "Cluster the pixels in time order within a sliding window of TCut, "
+      "for data driven sensors",
+      _timeWindowClustering, static_cast<bool>(false));
+
   registerProcessorParameter(
       "HistoInfoFileName", "This is the name of the histogram information file",
       _histoInfoFileName, std::string("histoinfo.xml"));
@@ -149,26 +159,24 @@ void EUTelProcessorSparseClustering::initializeGeometry(LCEvent *event) throw(
 
   streamlog_out(DEBUG5) << "Initializing geometry" << std::endl;
 
-  try {
-    _zsInputDataCollectionVec = dynamic_cast<LCCollectionVec *>(
-        event->getCollection(_zsDataCollectionName));
-    _noOfDetector += _zsInputDataCollectionVec->getNumberOfElements();
-    CellIDDecoder<TrackerDataImpl> cellDecoder(_zsInputDataCollectionVec);
-
-    for (size_t i = 0; i < _zsInputDataCollectionVec->size(); ++i) {
-      TrackerDataImpl *data = dynamic_cast<TrackerDataImpl *>(
-          _zsInputDataCollectionVec->getElementAt(i));
-      _sensorIDVec.push_back(cellDecoder(data)["sensorID"]);
-      _totClusterMap.insert(std::make_pair(cellDecoder(data)["sensorID"], 0));
-    }
-  }
-
-  catch (lcio::DataNotAvailableException) {
+  _zsInputDataCollectionVec =
+      _collectionCache.get(event, _zsDataCollectionName);
+  if (!_zsInputDataCollectionVec) {
     streamlog_out(DEBUG5) << "Could not find the input collection: "
                           << _zsDataCollectionName.c_str() << " !" << std::endl;
     return;
   }
-    _isGeometryReady = true;
+
+  _noOfDetector += _zsInputDataCollectionVec->getNumberOfElements();
+  CellIDDecoder<TrackerDataImpl> cellDecoder(_zsInputDataCollectionVec);
+
+  for (size_t i = 0; i < _zsInputDataCollectionVec->size(); ++i) {
+    TrackerDataImpl *data = dynamic_cast<TrackerDataImpl *>(
+        _zsInputDataCollectionVec->getElementAt(i));
+    _sensorIDVec.push_back(cellDecoder(data)["sensorID"]);
+    _totClusterMap.insert(std::make_pair(cellDecoder(data)["sensorID"], 0));
+  }
+  _isGeometryReady = true;
 }
 
 void EUTelProcessorSparseClustering::modifyEvent(LCEvent * /* event */) {
@@ -176,33 +184,29 @@ void EUTelProcessorSparseClustering::modifyEvent(LCEvent * /* event */) {
 }
 
 void EUTelProcessorSparseClustering::readCollections(LCEvent *event) {
-  try {
-    _zsInputDataCollectionVec = dynamic_cast<LCCollectionVec *>(
-        event->getCollection(_zsDataCollectionName));
-    streamlog_out(DEBUG4) << "_zsInputDataCollectionVec: "
-                          << _zsDataCollectionName.c_str() << " found "
-                          << std::endl;
-  } catch (lcio::DataNotAvailableException) // do nothing
-  {
-    streamlog_out(DEBUG4) << "_zsInputDataCollectionVec: "
-                          << _zsDataCollectionName.c_str() << " not found "
-                          << std::endl;
-  }
-
-  try {
-    event->getCollection(_zsDataCollectionName);
-  } catch (lcio::DataNotAvailableException &e) {
+  _zsInputDataCollectionVec =
+      _collectionCache.get(event, _zsDataCollectionName);
+  if (!_zsInputDataCollectionVec) {
     streamlog_out(MESSAGE2)
         << "The current event doesn't contain nZS data collections: skip # "
         << event->getEventNumber() << std::endl;
     throw SkipEventException(this);
   }
+  streamlog_out(DEBUG4) << "_zsInputDataCollectionVec: "
+                        << _zsDataCollectionName.c_str() << " found "
+                        << std::endl;
 }
 
 void EUTelProcessorSparseClustering::processEvent(LCEvent *event) {
+  EUTelProcessorProfile::EventTimer eventTimer(_profile);
+
   // increment event counter
   ++_iEvt;
 
+  // the temporaries and cluster objects of the previous event are
+  // released here
+  _eventArena.reset();
+
   // first of all we need to be sure that the geometry is properly initialized!
   if (!_isGeometryReady) {
     initializeGeometry(event);
@@ -231,15 +235,13 @@ void EUTelProcessorSparseClustering::processEvent(LCEvent *event) {
 
   // prepare a pulse collection to add all clusters found this can be either a
   // new collection or already existing in the event
-  LCCollectionVec *pulseCollection;
-  bool pulseCollectionExists = false;
+  LCCollectionVec *pulseCollection =
+      _collectionCache.get(evt, _pulseCollectionName);
+  bool pulseCollectionExists = (pulseCollection != nullptr);
   _initialPulseCollectionSize = 0;
-  try {
-    pulseCollection = dynamic_cast<LCCollectionVec *>(
-        evt->getCollection(_pulseCollectionName));
-    pulseCollectionExists = true;
+  if (pulseCollectionExists) {
     _initialPulseCollectionSize = pulseCollection->size();
-  } catch (lcio::DataNotAvailableException &e) {
+  } else {
     pulseCollection = new LCCollectionVec(LCIO::TRACKERPULSE);
   }
   if(isFirstEvent()) {
@@ -251,12 +253,14 @@ void EUTelProcessorSparseClustering::processEvent(LCEvent *event) {
   }  
 
   // HERE WE ACTUALLY CALL THE CLUSTERING ROUTINE:
+  EUTelProcessorProfile::PhaseTimer clusteringTimer(_profile, "clustering");
   sparseClustering(evt, pulseCollection);
+  clusteringTimer.stop();
 
   // if the pulseCollection is not empty add it to the event
   if (!pulseCollectionExists &&
 	((pulseCollection->size() != _initialPulseCollectionSize) || _initialPulseCollectionSize == 0)) {  
-    evt->addCollection(pulseCollection, _pulseCollectionName);
+    _collectionCache.add(evt, pulseCollection, _pulseCollectionName);
   }
 
 #if defined(USE_AIDA) || defined(MARLIN_USE_AIDA)
@@ -279,16 +283,11 @@ void EUTelProcessorSparseClustering::sparseClustering(
   // prepare some decoders
   CellIDDecoder<TrackerDataImpl> cellDecoder(_zsInputDataCollectionVec);
 
-  bool isDummyAlreadyExisting = false;
-  LCCollectionVec *sparseClusterCollectionVec = NULL;
-
-  try {
-    sparseClusterCollectionVec =
-        dynamic_cast<LCCollectionVec *>(evt->getCollection("original_zsdata"));
-    isDummyAlreadyExisting = true;
-  } catch (lcio::DataNotAvailableException &e) {
+  LCCollectionVec *sparseClusterCollectionVec =
+      _collectionCache.get(evt, "original_zsdata");
+  bool isDummyAlreadyExisting = (sparseClusterCollectionVec != nullptr);
+  if (!isDummyAlreadyExisting) {
     sparseClusterCollectionVec = new LCCollectionVec(LCIO::TRACKERDATA);
-    isDummyAlreadyExisting = false;
   }
 
   CellIDEncoder<TrackerDataImpl> idZSClusterEncoder(
@@ -325,11 +324,10 @@ void EUTelProcessorSparseClustering::sparseClustering(
     // std::make_unique<EUTelTrackerDataInterfacerImpl<EUTelGenericSparsePixel>>(zsData);
 
     auto sparseData = Utility::getSparseData(zsData, type);
-    auto hitPixelVec = sparseData->getPixels();
-    std::vector<std::reference_wrapper<EUTelBaseSparsePixel const>> newlyAdded;
+    _profile.count("pixels", sparseData->size());
 
-    // We now cluster those hits together
-    while (!hitPixelVec.empty()) {
+    typedef std::reference_wrapper<EUTelBaseSparsePixel const> PixelRef;
+    auto storeCluster = [&](std::vector<PixelRef> const &clusterPixels) {
       // prepare a TrackerData to store the cluster candidate
       std::unique_ptr<TrackerDataImpl> zsCluster =
           std::make_unique<TrackerDataImpl>();
@@ -337,53 +335,8 @@ void EUTelProcessorSparseClustering::sparseClustering(
       auto sparseCluster = Utility::getClusterData(
           zsCluster.get(),
           type); // std::make_unique<EUTelSparseClusterImpl<EUTelGenericSparsePixel>>(zsCluster.get());
-
-      // First we need to take any pixel, so let's take the first one
-      // Add it to the cluster as well as the newly added pixels
-      newlyAdded.push_back(hitPixelVec.front());
-      sparseCluster->push_back(hitPixelVec.front().get());
-      // And remove it from the original collection
-      hitPixelVec.erase(hitPixelVec.begin());
-
-      // Now process all newly added pixels, initially this is the just
-      // previously added one
-      // but in the process of neighbour finding we continue to add new pixels
-      while (!newlyAdded.empty()) {
-        bool newlyDone = true;
-        // check against all pixels in the hitPixelVec
-        for (auto hitVec = hitPixelVec.begin(); hitVec != hitPixelVec.end();
-             ++hitVec) {
-          // get the relevant infos from the newly added pixel
-          auto x1 = newlyAdded.front().get().getXCoord();
-          auto y1 = newlyAdded.front().get().getYCoord();
-
-          // and the pixel we test against
-          auto x2 = (hitVec->get()).getXCoord();
-          auto y2 = (hitVec->get()).getYCoord();
-
-          auto dX = x1 - x2;
-          auto dY = y1 - y2;
-          int distance = dX * dX + dY * dY;
-          // if they pass the spatial and temporal cuts, we add them
-          if (distance <= _sparseMinDistanceSquared) {
-            // add them to the cluster as well as to the newly added ones
-            newlyAdded.push_back(*hitVec);
-            sparseCluster->push_back(*hitVec);
-            // and remove it from the original collection
-            hitPixelVec.erase(hitVec);
-            // for the pixel we test there might be other neighbours, we still
-            // have to check
-            newlyDone = false;
-            break;
-          }
-        }
-
-        // if no neighbours are found, we can delete the pixel from the newly
-        // added
-        // we tested against _ALL_ non cluster pixels, there are no other pixels
-        // which could be neighbours
-        if (newlyDone)
-          newlyAdded.erase(newlyAdded.begin());
+      for (auto const &pixel : clusterPixels) {
+        sparseCluster->push_back(pixel.get());
       }
 
       // Now we need to process the found cluster
@@ -410,20 +363,57 @@ void EUTelProcessorSparseClustering::sparseClustering(
 
         // last but not least increment the totClusterMap
         _totClusterMap[sensorID] += 1;
+        _profile.count("clusters");
       } // cluster processing if
       else {
         // in the case the cluster candidate is not passing the threshold ...
         // forget about them, the memory should be automatically cleaned by
         // smart ptr's
       }
-    } // loop over all found clusters
-  }   // this is the end of the loop over all ZS detectors
+    };
+
+    // We now cluster those hits together
+    if (_timeWindowClustering) {
+      std::vector<PixelRef> const &pixels = sparseData->getPixels();
+      // per sensor temporaries, taken from the arena
+      std::vector<double, EUTelArenaAllocator<double>> times(
+          (EUTelArenaAllocator<double>(_eventArena)));
+      times.reserve(pixels.size());
+      for (auto const &pixel : pixels) {
+        times.push_back(Utility::sparsePixelTime(pixel.get(), type));
+      }
+      std::vector<size_t, EUTelArenaAllocator<size_t>> order(
+          pixels.size(), EUTelArenaAllocator<size_t>(_eventArena));
+      for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+      }
+      std::stable_sort(order.begin(), order.end(),
+                       [&times](size_t a, size_t b) {
+                         return times[a] < times[b];
+                       });
+
+      Utility::TimeWindowClusterer<PixelRef> clusterer(
+          _sparseMinDistanceSquared, _cutT);
+      for (size_t i : order) {
+        clusterer.add(pixels[i], pixels[i].get().getXCoord(),
+                      pixels[i].get().getYCoord(), times[i], storeCluster);
+      }
+      clusterer.flush(storeCluster);
+    } else {
+      auto clusters = Utility::findNeighbourClusters(
+          sparseData->getPixels(),
+          Utility::SparsePixelNeighbours{_sparseMinDistanceSquared});
+      for (auto const &clusterPixels : clusters) {
+        storeCluster(clusterPixels);
+      }
+    }
+  } // this is the end of the loop over all ZS detectors
 
   // if the sparseClusterCollectionVec isn't empty add it to the
   // current event. The pulse collection will be added afterwards
   if (!isDummyAlreadyExisting) {
     if (sparseClusterCollectionVec->size() != 0) {
-      evt->addCollection(sparseClusterCollectionVec, "original_zsdata");
+      _collectionCache.add(evt, sparseClusterCollectionVec, "original_zsdata");
     } else {
       delete sparseClusterCollectionVec;
     }
@@ -438,6 +428,9 @@ void EUTelProcessorSparseClustering::check(LCEvent * /* evt */) {
 void EUTelProcessorSparseClustering::end() {
 
   streamlog_out(MESSAGE4) << "Successfully finished" << std::endl;
+  _eventArena.summarize(name());
+  _collectionCache.printSummary(name());
+  _profile.summarize(name());
 
   std::map<int, int>::iterator iter = _totClusterMap.begin();
   while (iter != _totClusterMap.end()) {
@@ -483,7 +476,8 @@ void EUTelProcessorSparseClustering::fillHistos(LCEvent *evt) {
       EUTelSparseClusterImpl<EUTelGenericSparsePixel> *cluster;
 
       if (type == kEUTelSparseClusterImpl) {
-        cluster = new EUTelSparseClusterImpl<EUTelGenericSparsePixel>(
+        cluster = _eventArena.create<
+            EUTelSparseClusterImpl<EUTelGenericSparsePixel>>(
             static_cast<TrackerDataImpl *>(pulse->getTrackerData()));
       } else {
         streamlog_out(ERROR4) << "Unknown cluster type. Sorry for quitting"
@@ -524,8 +518,6 @@ void EUTelProcessorSparseClustering::fillHistos(LCEvent *evt) {
           ->fill(static_cast<int>(cluster->size()));
       (dynamic_cast<AIDA::IHistogram1D *>(_clusterSignalHistos[detectorID]))
           ->fill(cluster->getTotalCharge());
-
-      delete cluster;
     }
 
     // fill the event multiplicity here
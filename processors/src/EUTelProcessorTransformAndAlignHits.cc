@@ -0,0 +1,327 @@
+/*
+ *   This source code is part of the Eutelescope package of Marlin.
+ *   You are free to use this source files for your own development as
+ *   long as it stays in a public research context. You are not
+ *   allowed to use it for commercial purpose. You must put this
+ *   header with author names in all development based on this file.
+ *
+ */
+
+#ifdef USE_GEAR
+// eutelescope includes ".h"
+#include "EUTelProcessorTransformAndAlignHits.h"
+#include "CellIDReencoder.h"
+#include "EUTELESCOPE.h"
+#include "EUTelAlignmentConstant.h"
+#include "EUTelEventImpl.h"
+#include "EUTelExceptions.h"
+#include "EUTelGeometryTelescopeGeoDescription.h"
+#include "EUTelRunHeaderImpl.h"
+
+// marlin includes ".h"
+#include "marlin/Processor.h"
+
+// lcio includes <.h>
+#include <IMPL/LCCollectionVec.h>
+#include <UTIL/CellIDDecoder.h>
+
+// Eigen
+#include <Eigen/Geometry>
+
+// system includes
+#include <algorithm>
+#include <memory>
+#include <string>
+
+using namespace eutelescope;
+
+EUTelProcessorTransformAndAlignHits::EUTelProcessorTransformAndAlignHits()
+    : Processor("EUTelProcessorTransformAndAlignHits"),
+      _hitCollectionNameInput(""), _hitCollectionNameOutput(""),
+      _alignmentCollectionNames(), _transformCovariance(true),
+      _collectionCache(), _profile(), _planeTable(), _localTransforms(),
+      _globalTransforms(), _isFirstEvent(true), _alignmentCollections(),
+      _alignmentValues(), _builtAlignmentValues() {
+  _description = "EUTelProcessorTransformAndAlignHits transforms local hits "
+                 "to global and applies any number of alignment constant "
+                 "collections in a single pass.";
+
+  registerInputCollection(LCIO::TRACKERHIT, "HitCollectionNameInput",
+                          "Input hit collection name", _hitCollectionNameInput,
+                          std::string("local_hit"));
+  registerOutputCollection(
+      LCIO::TRACKERHIT, "OutputHitCollectionName",
+      "Output hit collection name, the input one to transform in place",
+      _hitCollectionNameOutput, std::string("hit"));
+  registerOptionalParameter(
+      "AlignmentConstantNames",
+      "Alignment constant collections from the condition files, applied in "
+      "this order",
+      _alignmentCollectionNames, StringVec());
+  registerOptionalParameter("TransformCovariance",
+                            "Rotate the hit covariance matrix as well",
+                            _transformCovariance, true);
+}
+
+void EUTelProcessorTransformAndAlignHits::init() {
+  printParameters();
+
+  // the same local to global transforms as
+  // EUTelProcessorCoordinateTransformHits
+  geo::gGeometry().initializeTGeoDescription(EUTELESCOPE::GEOFILENAME,
+                                             EUTELESCOPE::DUMPGEOROOT);
+  _isFirstEvent = true;
+}
+
+void EUTelProcessorTransformAndAlignHits::processRunHeader(LCRunHeader *rdr) {
+  auto runHeader = std::make_unique<EUTelRunHeaderImpl>(rdr);
+  runHeader->addProcessor(type());
+
+  // the geometry and the conditions may change from run to run
+  _isFirstEvent = true;
+}
+
+bool EUTelProcessorTransformAndAlignHits::updateTransforms(LCEvent *event) {
+  _alignmentCollections.clear();
+  _alignmentValues.clear();
+  for (auto const &name : _alignmentCollectionNames) {
+    LCCollectionVec *alignmentCollection = _collectionCache.get(event, name);
+    if (!alignmentCollection) {
+      streamlog_out(WARNING2) << "No alignment collection " << name
+                              << " found on event " << event->getEventNumber()
+                              << " in run " << event->getRunNumber()
+                              << std::endl;
+      return false;
+    }
+    _alignmentCollections.push_back(alignmentCollection);
+
+    // the collection may be replaced or updated by the conditions
+    // handler, compare the constants themselves
+    _alignmentValues.push_back(alignmentCollection->size());
+    for (size_t iPos = 0; iPos < alignmentCollection->size(); ++iPos) {
+      auto alignment = static_cast<EUTelAlignmentConstant const *>(
+          alignmentCollection->getElementAt(iPos));
+      _alignmentValues.insert(
+          _alignmentValues.end(),
+          {static_cast<double>(alignment->getSensorID()),
+           alignment->getXOffset(), alignment->getYOffset(),
+           alignment->getZOffset(), alignment->getAlpha(),
+           alignment->getBeta(), alignment->getGamma()});
+    }
+  }
+
+  if (_isFirstEvent || _alignmentValues != _builtAlignmentValues) {
+    if (!_isFirstEvent) {
+      streamlog_out(MESSAGE2) << "Alignment constants changed on event "
+                              << event->getEventNumber() << " in run "
+                              << event->getRunNumber() << std::endl;
+    }
+    EUTelProcessorProfile::PhaseTimer buildTimer(_profile, "transforms");
+    buildTransforms();
+    buildTimer.stop();
+    _builtAlignmentValues.swap(_alignmentValues);
+    _isFirstEvent = false;
+  }
+  return true;
+}
+
+void EUTelProcessorTransformAndAlignHits::buildTransforms() {
+  _planeTable = geo::gGeometry().planeTable();
+
+  Transform identity;
+  identity.rotation.setIdentity();
+  identity.translation.setZero();
+  _globalTransforms.assign(_planeTable->size(), identity);
+
+  for (size_t iCol = 0; iCol < _alignmentCollections.size(); ++iCol) {
+    LCCollectionVec *alignmentCollection = _alignmentCollections[iCol];
+    std::string const &name = _alignmentCollectionNames[iCol];
+
+    // as in EUTelProcessorApplyAlignment, the last constant of a
+    // sensor wins if there are several
+    std::vector<EUTelAlignmentConstant const *> constants(
+        _planeTable->size(), nullptr);
+    for (size_t iPos = 0; iPos < alignmentCollection->size(); ++iPos) {
+      auto alignment = static_cast<EUTelAlignmentConstant const *>(
+          alignmentCollection->getElementAt(iPos));
+      int ordinal = _planeTable->ordinal(alignment->getSensorID());
+      if (ordinal < 0) {
+        streamlog_out(WARNING2) << "Sensor ID " << alignment->getSensorID()
+                                << " of " << name
+                                << " is not in the geometry" << std::endl;
+        continue;
+      }
+      constants[ordinal] = alignment;
+    }
+
+    // x' = R_z(-gamma) R_y(-beta) R_x(-alpha) (x - c) + c - offset with
+    // c the plane centre, exactly what EUTelProcessorApplyAlignment does
+    for (size_t ordinal = 0; ordinal < constants.size(); ++ordinal) {
+      EUTelAlignmentConstant const *alignment = constants[ordinal];
+      if (!alignment) {
+        continue;
+      }
+      int sensorID = (*_planeTable)[ordinal].sensorID;
+      Eigen::Vector3d const centre(
+          geo::gGeometry().siPlaneXPosition(sensorID),
+          geo::gGeometry().siPlaneYPosition(sensorID),
+          geo::gGeometry().siPlaneZPosition(sensorID) +
+              geo::gGeometry().siPlaneZSize(sensorID) / 2.);
+      Eigen::Vector3d const offset(alignment->getXOffset(),
+                                   alignment->getYOffset(),
+                                   alignment->getZOffset());
+      Eigen::Matrix3d const rotation =
+          (Eigen::AngleAxisd(-alignment->getGamma(), Eigen::Vector3d::UnitZ()) *
+           Eigen::AngleAxisd(-alignment->getBeta(), Eigen::Vector3d::UnitY()) *
+           Eigen::AngleAxisd(-alignment->getAlpha(), Eigen::Vector3d::UnitX()))
+              .toRotationMatrix();
+
+      Transform &transform = _globalTransforms[ordinal];
+      transform.rotation = rotation * transform.rotation;
+      transform.translation =
+          rotation * (transform.translation - centre) + centre - offset;
+    }
+  }
+
+  // alignment after the placement
+  _localTransforms.resize(_planeTable->size());
+  for (size_t ordinal = 0; ordinal < _planeTable->size(); ++ordinal) {
+    geo::PlaneConstants const &plane = (*_planeTable)[ordinal];
+    Transform const &alignment = _globalTransforms[ordinal];
+    _localTransforms[ordinal].rotation =
+        alignment.rotation * plane.local2Master;
+    _localTransforms[ordinal].translation =
+        alignment.rotation * plane.translation + alignment.translation;
+  }
+}
+
+void EUTelProcessorTransformAndAlignHits::transformHit(
+    Transform const &transform, IMPL::TrackerHitImpl *hit,
+    double const *position, float const *covariance) {
+  Eigen::Map<Eigen::Vector3d const> inputPos(position);
+  Eigen::Vector3d const outputPos =
+      transform.rotation * inputPos + transform.translation;
+  hit->setPosition(outputPos.data());
+
+  if (!_transformCovariance) {
+    hit->setCovMatrix(covariance);
+    return;
+  }
+
+  // LCIO stores the lower triangle: xx, yx, yy, zx, zy, zz
+  Eigen::Matrix3d inputCov;
+  inputCov << covariance[0], covariance[1], covariance[3], covariance[1],
+      covariance[2], covariance[4], covariance[3], covariance[4],
+      covariance[5];
+  Eigen::Matrix3d const outputCov =
+      transform.rotation * inputCov * transform.rotation.transpose();
+  float const cov[TRKHITNCOVMATRIX] = {
+      static_cast<float>(outputCov(0, 0)), static_cast<float>(outputCov(1, 0)),
+      static_cast<float>(outputCov(1, 1)), static_cast<float>(outputCov(2, 0)),
+      static_cast<float>(outputCov(2, 1)), static_cast<float>(outputCov(2, 2))};
+  hit->setCovMatrix(cov);
+}
+
+void EUTelProcessorTransformAndAlignHits::processEvent(LCEvent *event) {
+  EUTelProcessorProfile::EventTimer eventTimer(_profile);
+
+  EUTelEventImpl *evt = static_cast<EUTelEventImpl *>(event);
+  if (evt->getEventType() == kEORE) {
+    streamlog_out(DEBUG4) << "EORE found: nothing else to do." << std::endl;
+    return;
+  } else if (evt->getEventType() == kUNKNOWN) {
+    streamlog_out(WARNING2) << "Event number " << evt->getEventNumber()
+                            << " in run " << evt->getRunNumber()
+                            << " is of unknown type. Continue considering it "
+                               "as a normal Data Event."
+                            << std::endl;
+  }
+
+  LCCollectionVec *inputCollection =
+      _collectionCache.get(event, _hitCollectionNameInput);
+  if (!inputCollection) {
+    return;
+  }
+
+  if (!updateTransforms(event)) {
+    return;
+  }
+  _profile.count("hits", inputCollection->size());
+
+  bool const inPlace = (_hitCollectionNameOutput == _hitCollectionNameInput);
+  std::unique_ptr<LCCollectionVec> outputCollection;
+  if (!inPlace) {
+    outputCollection = std::make_unique<LCCollectionVec>(LCIO::TRACKERHIT);
+  }
+
+  std::string encoding =
+      inputCollection->getParameters().getStringVal(LCIO::CellIDEncoding);
+  if (encoding.empty()) {
+    encoding = EUTELESCOPE::HITENCODING;
+  }
+  lcio::CellIDDecoder<TrackerHitImpl> hitDecoder(encoding);
+  lcio::UTIL::CellIDReencoder<TrackerHitImpl> cellReencoder(
+      encoding, inPlace ? inputCollection : outputCollection.get());
+
+  for (size_t iHit = 0; iHit < inputCollection->size(); ++iHit) {
+    TrackerHitImpl *inputHit =
+        static_cast<TrackerHitImpl *>(inputCollection->getElementAt(iHit));
+    int properties = hitDecoder(inputHit)["properties"];
+    int sensorID = hitDecoder(inputHit)["sensorID"];
+    bool const isLocal = !(properties & kHitInGlobalCoord);
+
+    TrackerHitImpl *outputHit = inputHit;
+    if (!inPlace) {
+      outputHit = new TrackerHitImpl;
+      outputHit->setType(inputHit->getType());
+      outputHit->setTime(inputHit->getTime());
+      outputHit->setCellID0(inputHit->getCellID0());
+      outputHit->setCellID1(inputHit->getCellID1());
+      outputHit->setQuality(inputHit->getQuality());
+      outputHit->rawHits() = inputHit->getRawHits();
+      outputCollection->push_back(outputHit);
+    }
+
+    int ordinal = _planeTable->ordinal(sensorID);
+    if (ordinal < 0) {
+      if (isLocal) {
+        throw InvalidGeometryException("Local hit on sensor " +
+                                       std::to_string(sensorID) +
+                                       " which is not in the geometry");
+      }
+      // nothing to align, as EUTelProcessorApplyAlignment does
+      outputHit->setPosition(inputHit->getPosition());
+      outputHit->setCovMatrix(inputHit->getCovMatrix());
+      continue;
+    }
+
+    // copies, since in place the hit overwrites its own values
+    double const position[3] = {inputHit->getPosition()[0],
+                                inputHit->getPosition()[1],
+                                inputHit->getPosition()[2]};
+    float covariance[TRKHITNCOVMATRIX];
+    std::copy_n(inputHit->getCovMatrix().begin(), TRKHITNCOVMATRIX,
+                covariance);
+    transformHit(isLocal ? _localTransforms[ordinal]
+                         : _globalTransforms[ordinal],
+                 outputHit, position, covariance);
+
+    if (isLocal) {
+      cellReencoder.readValues(outputHit);
+      cellReencoder["properties"] = properties | kHitInGlobalCoord;
+      cellReencoder.setCellID(outputHit);
+    }
+  }
+
+  if (!inPlace) {
+    _collectionCache.add(event, outputCollection.release(),
+                         _hitCollectionNameOutput);
+  }
+}
+
+void EUTelProcessorTransformAndAlignHits::end() {
+  _collectionCache.printSummary(name());
+  _profile.summarize(name());
+}
+
+#endif
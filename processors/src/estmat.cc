@@ -4,6 +4,9 @@
 #include <TH2D.h>
 #include <gsl/gsl_multimin.h>
 
+#include <algorithm>
+#include <thread>
+
 //#include <thread>         // std::this_thread::sleep_for
 //#include <chrono>         // std::chrono::seconds
 
@@ -16,13 +19,15 @@ inline double getScatterSigma(double eBeam, double radLength) {
 
 void EstMat::addTrack(std::vector<Measurement<FITTERTYPE>> track) {
   // Add a track to memory
-  tracks.push_back(track);
+  trackMeasurements.insert(trackMeasurements.end(), track.begin(), track.end());
+  trackOffsets.push_back(trackMeasurements.size());
 }
 
 void EstMat::readTrack(int track, TrackerSystem<FITTERTYPE, 4> &system) {
   // Read a track into the tracker system into memory
-  for (size_t meas = 0; meas < tracks.at(track).size(); meas++) {
-    Measurement<FITTERTYPE> &m1 = tracks.at(track).at(meas);
+  const size_t end = trackOffsets.at(track + 1);
+  for (size_t meas = trackOffsets.at(track); meas < end; meas++) {
+    const Measurement<FITTERTYPE> &m1 = trackMeasurements[meas];
     for (size_t ii = 0; ii < system.planes.size(); ii++) {
       if ((int)m1.getIden() == (int)system.planes.at(ii).getSensorID()) {
         double x = m1.getX() * (1.0 + xScale.at(ii)) + m1.getY() * zRot.at(ii);
@@ -40,35 +45,37 @@ void EstMat::readTrack(int track, TrackerSystem<FITTERTYPE, 4> &system) {
 
 void EstMat::readTracksToArray(float **measX, float **measY, int nTracks,
                                int nPlanes) {
-  if (static_cast<size_t>(nTracks) > tracks.size()) {
+  if (static_cast<size_t>(nTracks) > this->nTracks()) {
     throw std::runtime_error("Trying to read too many tracks!");
   }
   for (int tr = 0; tr < nTracks; tr++) {
-    if (tracks.at(tr).size() != 9 or nPlanes != 9) {
+    const size_t first = trackOffsets.at(tr);
+    if (trackOffsets.at(tr + 1) - first != 9 or nPlanes != 9) {
       cout << "nPlanes = " << nPlanes << endl;
       throw std::runtime_error("SDR2CL currently needs exactly nine "
                                "measurements in all the tracks.");
     }
     for (int pl = 0; pl < nPlanes; pl++) {
-      measX[pl][tr] = tracks.at(tr).at(pl).getX();
-      measY[pl][tr] = tracks.at(tr).at(pl).getY();
+      measX[pl][tr] = trackMeasurements[first + pl].getX();
+      measY[pl][tr] = trackMeasurements[first + pl].getY();
     }
   }
 }
 
 void EstMat::readTracksToDoubleArray(float **measX, int nTracks, int nPlanes) {
-  if (static_cast<size_t>(nTracks) > tracks.size()) {
+  if (static_cast<size_t>(nTracks) > this->nTracks()) {
     throw std::runtime_error("Trying to read too many tracks!");
   }
   for (int tr = 0; tr < nTracks; tr++) {
-    if (tracks.at(tr).size() != 9 or nPlanes != 9) {
+    const size_t first = trackOffsets.at(tr);
+    if (trackOffsets.at(tr + 1) - first != 9 or nPlanes != 9) {
       cout << "nPlanes = " << nPlanes << endl;
       throw std::runtime_error("SDR2CL currently needs exactly nine "
                                "measurements in all the tracks.");
     }
     for (int pl = 0; pl < nPlanes; pl++) {
-      measX[pl][(2 * tr)] = tracks.at(tr).at(pl).getX();
-      measX[pl][(2 * tr) + 1] = tracks.at(tr).at(pl).getY();
+      measX[pl][(2 * tr)] = trackMeasurements[first + pl].getX();
+      measX[pl][(2 * tr) + 1] = trackMeasurements[first + pl].getY();
     }
   }
 }
@@ -96,6 +103,14 @@ void FakeChi2::init() {
   firstRun = true;
 }
 
+void FakeChi2::prepare() {
+  // The residual errors do not depend on the track, get them once before
+  // the jobs start
+  if (firstRun) {
+    calibrate(systems.at(0));
+  }
+}
+
 void FakeChi2::calibrate(TrackerSystem<FITTERTYPE, 4> &system) {
   cout << "Calculating residual errors" << endl;
   resFWErrorX.resize(system.planes.size());
@@ -143,15 +158,6 @@ void FakeChi2::operator()(size_t offset, size_t stride) {
   // Track candidate is the same for all tracks
   system.index0tracker();
   TrackCandidate<FITTERTYPE, 4> candidate = system.tracks.at(0);
-
-  {
-#ifdef DOTHREAD
-    boost::mutex::scoped_lock lock(resultGurad);
-#endif
-    if (firstRun) {
-      calibrate(system);
-    }
-  }
   Eigen::Matrix<FITTERTYPE, 2, 1> resv;
 
   FITTERTYPE chi2 = 0;
@@ -184,12 +190,7 @@ void FakeChi2::operator()(size_t offset, size_t stride) {
     }
   }
 
-  {
-#ifdef DOTHREAD
-    boost::mutex::scoped_lock lock(resultGurad);
-#endif
-    result += chi2;
-  }
+  partialSums.at(offset).assign(1, chi2);
 }
 
 void FakeAbsDev::operator()(size_t offset, size_t stride) {
@@ -199,15 +200,6 @@ void FakeAbsDev::operator()(size_t offset, size_t stride) {
   // Track candidate is the same for all tracks
   system.index0tracker();
   TrackCandidate<FITTERTYPE, 4> candidate = system.tracks.at(0);
-
-  {
-#ifdef DOTHREAD
-    boost::mutex::scoped_lock lock(resultGurad);
-#endif
-    if (firstRun) {
-      calibrate(system);
-    }
-  }
   Eigen::Matrix<FITTERTYPE, 2, 1> resv;
 
   FITTERTYPE chi2 = 0;
@@ -240,12 +232,7 @@ void FakeAbsDev::operator()(size_t offset, size_t stride) {
     }
   }
 
-  {
-#ifdef DOTHREAD
-    boost::mutex::scoped_lock lock(resultGurad);
-#endif
-    result += chi2;
-  }
+  partialSums.at(offset).assign(1, chi2);
 }
 
 void Chi2::operator()(size_t offset, size_t stride) {
@@ -265,12 +252,7 @@ void Chi2::operator()(size_t offset, size_t stride) {
     varchi2 += candidate.chi2;
   }
 
-  {
-#ifdef DOTHREAD
-    boost::mutex::scoped_lock lock(resultGurad);
-#endif
-    result += varchi2;
-  }
+  partialSums.at(offset).assign(1, varchi2);
 }
 
 void SDR::operator()(size_t offset, size_t stride) {
@@ -373,33 +355,52 @@ void SDR::operator()(size_t offset, size_t stride) {
     nTracks++;
   }
 
+  // Partial sums of this job, the pull variances are taken from the sums
+  // over all jobs in SDR::reduce()
+  std::vector<double> &sums = partialSums.at(offset);
+  sums.assign(1, nTracks);
+  sums.insert(sums.end(), sqrPullXFW.begin(), sqrPullXFW.end());
+  sums.insert(sums.end(), sqrPullYFW.begin(), sqrPullYFW.end());
+  sums.insert(sums.end(), sqrPullXBW.begin(), sqrPullXBW.end());
+  sums.insert(sums.end(), sqrPullYBW.begin(), sqrPullYBW.end());
+  for (size_t pl = 0; pl < sqrParams.size(); pl++) {
+    sums.insert(sums.end(), sqrParams.at(pl).begin(), sqrParams.at(pl).end());
+  }
+}
+
+void SDR::reduce() {
+  const std::vector<double> sums = sumPartials();
+  const size_t nPlanes = systems.at(0).planes.size();
+  const double nTracks = sums.at(0);
+  const double *sqrPullXFW = &sums.at(1);
+  const double *sqrPullYFW = sqrPullXFW + (nPlanes - 2);
+  const double *sqrPullXBW = sqrPullYFW + (nPlanes - 2);
+  const double *sqrPullYBW = sqrPullXBW + (nPlanes - 2);
+  const double *sqrParams = sqrPullYBW + (nPlanes - 2);
+
   double varvar(0.0);
   if (SDR2) {
-    for (size_t pl = 0; pl < system.planes.size() - 2; pl++) {
-      double resvar = 1.0f - (sqrPullXFW.at(pl) / (nTracks - 1));
+    for (size_t pl = 0; pl < nPlanes - 2; pl++) {
+      double resvar = 1.0f - (sqrPullXFW[pl] / (nTracks - 1));
       varvar += resvar * resvar;
-      resvar = 1.0f - (sqrPullYFW.at(pl) / (nTracks - 1));
+      resvar = 1.0f - (sqrPullYFW[pl] / (nTracks - 1));
       varvar += resvar * resvar;
-      resvar = 1.0f - (sqrPullXBW.at(pl) / (nTracks - 1));
+      resvar = 1.0f - (sqrPullXBW[pl] / (nTracks - 1));
       varvar += resvar * resvar;
-      resvar = 1.0f - (sqrPullYBW.at(pl) / (nTracks - 1));
+      resvar = 1.0f - (sqrPullYBW[pl] / (nTracks - 1));
       varvar += resvar * resvar;
     }
   }
   if (SDR1) {
-    for (size_t pl = 1; pl < system.planes.size() - 2; pl++) {
+    for (size_t pl = 1; pl < nPlanes - 2; pl++) {
       for (int param = 0; param < 4; param++) {
-        double resvar = 1.0f - (sqrParams.at(pl - 1).at(param) / (nTracks - 1));
+        double resvar =
+            1.0f - (sqrParams[(pl - 1) * 4 + param] / (nTracks - 1));
         varvar += resvar * resvar;
       }
     }
   }
-  {
-#ifdef DOTHREAD
-    boost::mutex::scoped_lock lock(resultGurad);
-#endif
-    result += varvar;
-  }
+  result = varvar;
 }
 
 void FwBw::operator()(size_t offset, size_t stride) {
@@ -482,34 +483,52 @@ void FwBw::operator()(size_t offset, size_t stride) {
       sqrPullYBW.at(pl) += pull2(1);
     }
   }
+  // Partial sums of this job, the pull variances are taken from the sums
+  // over all jobs in FwBw::reduce()
+  std::vector<double> &sums = partialSums.at(offset);
+  sums.assign(1, nTracks);
+  sums.push_back(logL);
+  sums.insert(sums.end(), sqrPullXFW.begin(), sqrPullXFW.end());
+  sums.insert(sums.end(), sqrPullYFW.begin(), sqrPullYFW.end());
+  sums.insert(sums.end(), sqrPullXBW.begin(), sqrPullXBW.end());
+  sums.insert(sums.end(), sqrPullYBW.begin(), sqrPullYBW.end());
+}
+
+void FwBw::reduce() {
+  const std::vector<double> sums = sumPartials();
+  const size_t nPlanes = systems.at(0).planes.size();
+  const double nTracks = sums.at(0);
+  const double logL = sums.at(1);
+  const double *sqrPullXFW = &sums.at(2);
+  const double *sqrPullYFW = sqrPullXFW + (nPlanes - 2);
+  const double *sqrPullXBW = sqrPullYFW + (nPlanes - 2);
+  const double *sqrPullYBW = sqrPullXBW + (nPlanes - 2);
+
   FITTERTYPE return2 = 0.0;
-  for (size_t pl = 0; pl < system.planes.size() - 2; pl++) {
-    double resvar = 1.0 - sqrPullXFW.at(pl) / (nTracks - 1);
+  for (size_t pl = 0; pl < nPlanes - 2; pl++) {
+    double resvar = 1.0 - sqrPullXFW[pl] / (nTracks - 1);
     return2 += resvar * resvar;
-    resvar = 1.0 - sqrPullYFW.at(pl) / (nTracks - 1);
+    resvar = 1.0 - sqrPullYFW[pl] / (nTracks - 1);
     return2 += resvar * resvar;
-    resvar = 1.0 - sqrPullXBW.at(pl) / (nTracks - 1);
+    resvar = 1.0 - sqrPullXBW[pl] / (nTracks - 1);
     return2 += resvar * resvar;
-    resvar = 1.0 - sqrPullYBW.at(pl) / (nTracks - 1);
+    resvar = 1.0 - sqrPullYBW[pl] / (nTracks - 1);
     return2 += resvar * resvar;
   }
-  {
-#ifdef DOTHREAD
-    boost::mutex::scoped_lock lock(resultGurad);
-#endif
-    result += -1.0 * logL;
-    retVal2 += return2;
-  }
+  result = -1.0 * logL;
+  retVal2 = return2;
 }
 
 void Minimizer::init() {
-// Initialize nThread threads
-#ifndef DOTHREAD
-  cout << "Not using threads!" << endl;
-  nThreads = 1;
-#endif
+  // Set up one TrackerSystem per job and the worker threads
   if (not inited) {
+    if (nThreads == 0) {
+      nThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    cout << "Using " << nThreads << " threads" << endl;
     systems.assign(nThreads, mat.system);
+    partialSums.assign(nThreads, std::vector<double>());
+    pool = new eutelescope::EUTelThreadPool(nThreads);
   }
   inited = true;
 }
@@ -525,23 +544,42 @@ void Minimizer::prepareThreads() {
       plT.setSigmas(plO.getSigmaX(), plO.getSigmaY());
     }
   }
+  for (size_t thread = 0; thread < nThreads; thread++) {
+    partialSums.at(thread).clear();
+  }
   result = 0;
   retVal2 = 0.0f;
 }
 
+std::vector<double> Minimizer::sumPartials() const {
+  // Element wise sum of the partial sums, always in job order so the
+  // result does not depend on the scheduling of the jobs
+  std::vector<double> sums;
+  for (size_t thread = 0; thread < partialSums.size(); thread++) {
+    const std::vector<double> &part = partialSums.at(thread);
+    if (sums.size() < part.size()) {
+      sums.resize(part.size(), 0.0);
+    }
+    for (size_t ii = 0; ii < part.size(); ii++) {
+      sums[ii] += part[ii];
+    }
+  }
+  return (sums);
+}
+
+void Minimizer::reduce() {
+  const std::vector<double> sums = sumPartials();
+  result = sums.empty() ? 0.0 : sums.at(0);
+}
+
 FITTERTYPE Minimizer::operator()(void) {
-  // Start threads if DOTHREAD, run job in main thread if not.
+  // Run job ii on tracks ii, ii + nThreads, ... with its own TrackerSystem,
+  // then combine the partial sums
   prepareThreads();
-#ifdef DOTHREAD
-  boost::thread_group threads;
-  for (int ii = 0; ii < nThreads; ii++) {
-    threads.create_thread(
-        boost::bind(&Minimizer::operator(), this, ii, nThreads));
-  }
-  threads.join_all();
-#else
-  (*this)(0, 1);
-#endif
+  prepare();
+  const size_t stride = nThreads;
+  pool->run([this, stride](size_t job) { (*this)(job, stride); }, nThreads);
+  reduce();
   return (result);
 }
 
@@ -717,7 +755,7 @@ void EstMat::plot(char *fname) {
   cout << "Inited plots" << endl;
 
   // Loop over all tracks
-  for (size_t track = 0; track < tracks.size(); track++) {
+  for (size_t track = 0; track < nTracks(); track++) {
     system.clear();
     readTrack(track, system);
     system.clusterTracker();
@@ -1020,8 +1058,8 @@ void EstMat::simplexSearch(Minimizer *minimizeMe, size_t iterations,
   cout << "Initial guesses" << endl;
   printAllFreeParams();
 
-  if (tracks.size() < maxIterations) {
-    itMax = tracks.size();
+  if (nTracks() < maxIterations) {
+    itMax = nTracks();
   } else {
     itMax = maxIterations;
   }
@@ -1106,7 +1144,7 @@ void EstMat::quasiNewtonHomeMade(Minimizer *minimizeMe, int iterations) {
 
   size_t nParams = getNSimplexParams();
   gsl_vector *vc = systemToEst();
-  itMax = tracks.size();
+  itMax = nTracks();
   double mseval = 0, fwbwval = 0;
 
   size_t resSize = resXIndex.size() + resYIndex.size();